@@ -66,7 +66,7 @@ DRV_INIT:
 ;       A = FLAG
 ;   OUT none
 ;   USE AF,BC,DE,HL,IX,IY
-;   STK 6byte
+;   STK 8byte
 ;==============================
         PUBLIC  DRV_START
 DRV_START:
@@ -81,18 +81,21 @@ DRV_START:
         XOR     A
         LD      (IX + WORK_PLAY_COUNT), A
 
-        ;
+        ; memset(&work->OPLL0E, 0, WORK_SIZE - WORK_OPLL0E);
         PUSH    IX
         POP     HL
-        LD      DE, WORK_CHWORK
+        LD      DE, WORK_OPLL0E
         ADD     HL, DE
         PUSH    HL
         POP     DE
         LD      (DE), A
         INC     DE
-        LD      BC, +CHWORK_SIZE * CH_COUNT - 1
+        LD      BC, +WORK_SIZE - WORK_OPLL0E - 1
         LDIR
 
+        ; OPLL registers = 0 (same as the shadow)
+        CALL    OPLL_RESET
+
         ;
         CALL    REPLAY
 
@@ -140,6 +143,41 @@ DRV_STOP:
         ; return;
         RET
 
+;==============================
+; RESET OPLL REGISTERS
+;   IN  none
+;   OUT none
+;   USE AF,BC,E
+;   STK 6byte
+;==============================
+OPLL_RESET:
+        ; KEY-OFF
+        LD      E, 0
+        LD      A, 0Eh
+        CALL    WRTOPL
+        LD      A, 20h
+        CALL    OPLL_RESET_CH
+
+        ; VOLUME, F-NUMBER, USER INST
+        LD      A, 30h
+        CALL    OPLL_RESET_CH
+        LD      A, 10h
+        CALL    OPLL_RESET_CH
+        XOR     A
+        LD      B, 8
+        JP      OPLL_RESET_LOOP
+
+OPLL_RESET_CH:
+        LD      B, CH_COUNT
+OPLL_RESET_LOOP:
+        ; WRTOPL(reg++, 0);
+        CALL    WRTOPL
+        INC     A
+
+        ; if(--cnt != 0) goto OPLL_RESET_LOOP;
+        DJNZ    OPLL_RESET_LOOP
+        RET
+
 ;==============================
 ; BGM END CHECK
 ;   IN  IX = WORK ADDRESS
@@ -157,7 +195,7 @@ DRV_CHECK:
 ;   IN  IX = WORK ADDRESS
 ;   OUT none
 ;   USE AF, BC, DE, HL, IX, IY
-;   STK 8byte
+;   STK 10byte
 ;==============================
         PUBLIC  DRV_HANDLER
 DRV_HANDLER:
@@ -423,7 +461,10 @@ RHYTHM_CHANNEL_PROC_VOL:
         OR      L
         LD      (IY + CHWORK_REG36), A
 
-        ; WRTOPL(0x36, ch->REG36);
+        ; if(ch->OPLL36 != ch->REG36) WRTOPL(0x36, ch->OPLL36 = ch->REG36);
+        CP      (IY + CHWORK_OPLL36)
+        JR      Z, BD_SKIP
+        LD      (IY + CHWORK_OPLL36), A
         LD      E, A
         LD      A, 36h
         CALL    WRTOPL
@@ -450,7 +491,10 @@ HH_SKIP:
 DS_SKIP:
         LD      (IY + CHWORK_REG37), A
 
-        ; WRTOPL(0x37, ch->REG37);
+        ; if(ch->OPLL37 != ch->REG37) WRTOPL(0x37, ch->OPLL37 = ch->REG37);
+        CP      (IY + CHWORK_OPLL37)
+        JR      Z, HH_DS_SKIP
+        LD      (IY + CHWORK_OPLL37), A
         LD      E, A
         LD      A, 37h
         CALL    WRTOPL
@@ -477,7 +521,10 @@ TM_SKIP:
 CY_SKIP:
         LD      (IY + CHWORK_REG38), A
 
-        ; WRTOPL(0x38, ch->REG38);
+        ; if(ch->OPLL38 != ch->REG38) WRTOPL(0x38, ch->OPLL38 = ch->REG38);
+        CP      (IY + CHWORK_OPLL38)
+        JR      Z, TM_CY_SKIP
+        LD      (IY + CHWORK_OPLL38), A
         LD      E, A
         LD      A, 38h
         CALL    WRTOPL
@@ -490,9 +537,14 @@ TM_CY_SKIP:
 ; KEY ON
 ;-------------------------------
 RHYTHM_CHANNEL_PROC_KEYON:
-        ; WRTOPL(0x0E, (cmd & 0x1F) | 0x20);
+        ; A = (cmd & 0x1F) | 0x20;
         AND     1Fh
         OR      20h
+
+        ; if(work->OPLL0E != A) WRTOPL(0x0E, work->OPLL0E = A);
+        CP      (IX + WORK_OPLL0E)
+        JP      Z, TONE_CHANNEL_PROC_LEN
+        LD      (IX + WORK_OPLL0E), A
         LD      E, A
         LD      A, 0Eh
         CALL    WRTOPL
@@ -507,7 +559,7 @@ RHYTHM_CHANNEL_PROC_KEYON:
 ;       IY = CHANNEL WORK ADDRESS
 ;   OUT none
 ;   USE none
-;   STK 4bye
+;   STK 8byte
 ;==============================
 TONE_CHANNEL_PROC:
 ;-------------------------------
@@ -533,9 +585,14 @@ TONE_CHANNEL_PROC_GATE:
         OR      C
         JP      NZ, TONE_CHANNEL_PROC_GATE_SKIP
 
-        ; WRTOPL(ch->NUM + 0x20, ch->REG2X & ~0x10);
+        ; A = ch->REG2X & ~0x10;
         LD      A, (IY + CHWORK_REG2X)
         AND     ~10h
+
+        ; if(ch->OPLL2X != A) WRTOPL(ch->NUM + 0x20, ch->OPLL2X = A);
+        CP      (IY + CHWORK_OPLL2X)
+        JP      Z, TONE_CHANNEL_PROC_GATE_SKIP
+        LD      (IY + CHWORK_OPLL2X), A
         LD      E, A
         LD      A, (IY + CHWORK_NUM)
         ADD     A, 20h
@@ -643,12 +700,18 @@ TONE_CHANNEL_PROC_KEYON:
         ADD     HL, HL
         ADD     HL, DE
 
-        ; WRTOPL(ch->NUM + 0x10, *HL++);
+        ; if(ch->OPLL1X != *HL) WRTOPL(ch->NUM + 0x10, ch->OPLL1X = *HL);
+        ; HL++;
+        LD      A, (HL)
+        INC     HL
+        CP      (IY + CHWORK_OPLL1X)
+        JR      Z, TONE_CHANNEL_PROC_KEYON_1X_SKIP
+        LD      (IY + CHWORK_OPLL1X), A
+        LD      E, A
         LD      A, (IY + CHWORK_NUM)
         ADD     A, 10h
-        LD      E, (HL)
-        INC     HL
         CALL    WRTOPL
+TONE_CHANNEL_PROC_KEYON_1X_SKIP:
 
         ; A = ch->FLAGS | 0x10 | *HL;
         LD      A, (IY + CHWORK_FLAGS)
@@ -661,7 +724,10 @@ TONE_CHANNEL_PROC_KEYON:
         ; ch->REG2X = A;
         LD      (IY + CHWORK_REG2X), A
 
-        ; WRTOPL(ch->NUM + 0x20, A);
+        ; if(ch->OPLL2X != A) WRTOPL(ch->NUM + 0x20, ch->OPLL2X = A);
+        CP      (IY + CHWORK_OPLL2X)
+        JR      Z, TONE_CHANNEL_PROC_REST
+        LD      (IY + CHWORK_OPLL2X), A
         LD      E, A
         LD      A, (IY + CHWORK_NUM)
         ADD     A, 20h
@@ -770,7 +836,10 @@ TONE_CHANNEL_PROC_VOLUME:
         OR      E
         LD      (IY + CHWORK_REG3X), A
 
-        ; WRTOPL(ch->num + 0x30, ch->REG3X);
+        ; if(ch->OPLL3X != ch->REG3X) WRTOPL(ch->num + 0x30, ch->OPLL3X = ch->REG3X);
+        CP      (IY + CHWORK_OPLL3X)
+        JP      Z, TONE_CHANNEL_PROC_LOOP
+        LD      (IY + CHWORK_OPLL3X), A
         LD      E, A
         LD      A, (IY + CHWORK_NUM)
         ADD     A, 30h
@@ -793,7 +862,10 @@ TONE_CHANNEL_PROC_INST:
         OR      E
         LD      (IY + CHWORK_REG3X), A
 
-        ; WRTOPL(ch->num + 0x30, ch->REG3X);
+        ; if(ch->OPLL3X != ch->REG3X) WRTOPL(ch->num + 0x30, ch->OPLL3X = ch->REG3X);
+        CP      (IY + CHWORK_OPLL3X)
+        JP      Z, TONE_CHANNEL_PROC_LOOP
+        LD      (IY + CHWORK_OPLL3X), A
         LD      E, A
         LD      A, (IY + CHWORK_NUM)
         ADD     A, 30h
@@ -862,18 +934,39 @@ TONE_CHANNEL_PROC_USR_INST:
 TONE_CHANNEL_PTR_INST:
         PUSH    BC
 
-        ; cnt = 9;
+        ; DE = &work->OPLL0X[0];
+        PUSH    HL
+        PUSH    IX
+        POP     HL
+        LD      DE, WORK_OPLL0X
+        ADD     HL, DE
+        EX      DE, HL
+        POP     HL
+
+        ; cnt = 8;
         LD      B, 8
 
         ; reg = 0;
-        LD      A, 0
+        LD      C, 0
 
 TONE_CHANNEL_PTR_INST_LOOP:
-        ; WRTOPL(reg++, *HL++);
-        LD      E, (HL)
-        INC     HL
+        ; if(*DE != *HL) WRTOPL(reg, *DE = *HL);
+        LD      A, (DE)
+        CP      (HL)
+        JR      Z, TONE_CHANNEL_PTR_INST_SKIP
+        LD      A, (HL)
+        LD      (DE), A
+        PUSH    DE
+        LD      E, A
+        LD      A, C
         CALL    WRTOPL
-        INC     A
+        POP     DE
+TONE_CHANNEL_PTR_INST_SKIP:
+
+        ; reg++; HL++; DE++;
+        INC     C
+        INC     HL
+        INC     DE
 
         ; if(--cnt != 0) goto TONE_CHANNEL_PTR_INST_LOOP;
         DJNZ    TONE_CHANNEL_PTR_INST_LOOP
@@ -0,0 +1,870 @@
+//
+// drvprof.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// gcc -O2 -o drvprof drvprof.c
+//
+// FM BIOS ドライバのプロファイラ
+//  Z80 エミュレータ上で fmbios.rom の INIOPL, MSTART を呼び出した後、
+//  タイマ割り込み毎の OPLDRV(DRV_HANDLER) の T ステート数と OPLL への書き込み回数を集計する
+//
+//  drvprof [-n ticks] [-m] [-t] [-v] fmbios.rom [song.bin]
+//   -n ticks   OPLDRV を呼び出す回数(既定値 3600 = 60秒)
+//   -m         MSX の M1 ウェイト(1 命令フェッチ毎に +1 T)を加算する
+//   -t         割り込み毎の T ステート数と書き込み回数を表示する
+//   -v         OPLL への書き込みを表示する
+//   song.bin   MSTART に渡す演奏データ(省略時は内蔵のテストデータ)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//
+// メモリマップ
+//
+#define ROM_ADDR        (0x4000)
+#define ROM_SIZE        (0x4000)
+#define SONG_ADDR       (0x9000)
+#define WORK_ADDR       (0xC010)
+#define STACK_ADDR      (0xF000)
+
+#define BIOS_RDSLT      (0x000C)
+#define BIOS_CALSLT     (0x001C)
+#define BIOS_RSLREG     (0x0138)
+
+#define FMBIOS_INIOPL   (0x4113)
+#define FMBIOS_MSTART   (0x4116)
+#define FMBIOS_OPLDRV   (0x411F)
+
+#define STEP_LIMIT      (10000000)
+
+/***************************************************************
+ * Z80
+ ***************************************************************/
+#define FLAG_S  (0x80)
+#define FLAG_Z  (0x40)
+#define FLAG_Y  (0x20)
+#define FLAG_H  (0x10)
+#define FLAG_X  (0x08)
+#define FLAG_P  (0x04)
+#define FLAG_N  (0x02)
+#define FLAG_C  (0x01)
+
+typedef struct {
+    uint8_t a, f, b, c, d, e, h, l;
+    uint8_t a_, f_, b_, c_, d_, e_, h_, l_;
+    uint16_t ix, iy, sp, pc;
+    uint8_t i, r, iff1, iff2;
+    uint64_t t;         // T ステート
+    uint64_t m1;        // M1 サイクル数
+} Z80;
+
+static Z80 cpu;
+static uint8_t mem[0x10000];
+static uint8_t parity[256];
+
+static int verbose = 0;
+static int trace = 0;
+static uint8_t opll_addr;
+static uint64_t opll_writes;
+
+static uint8_t rd8(uint16_t addr) { return mem[addr]; }
+static void wr8(uint16_t addr, uint8_t v)
+{
+    // ROM 領域への書き込みは無視
+    if(addr >= ROM_ADDR && addr < ROM_ADDR + ROM_SIZE) return;
+    mem[addr] = v;
+}
+static uint16_t rd16(uint16_t addr) { return rd8(addr) | (rd8(addr + 1) << 8); }
+static void wr16(uint16_t addr, uint16_t v) { wr8(addr, v); wr8(addr + 1, v >> 8); }
+
+static uint8_t io_in(uint8_t port)
+{
+    // A8h: ページ 1 はスロット 1
+    if(port == 0xA8) return 0x04;
+    return 0xFF;
+}
+
+static void io_out(uint8_t port, uint8_t v)
+{
+    if(port == 0x7C) {
+        opll_addr = v;
+    }
+    else if(port == 0x7D) {
+        opll_writes++;
+        if(verbose) printf("  OPLL %02X = %02X\n", opll_addr, v);
+    }
+}
+
+static uint8_t fetch8(void) { return rd8(cpu.pc++); }
+static uint16_t fetch16(void) { uint16_t v = rd16(cpu.pc); cpu.pc += 2; return v; }
+static uint8_t fetch_op(void) { cpu.m1++; cpu.r = (cpu.r & 0x80) | ((cpu.r + 1) & 0x7F); return fetch8(); }
+
+static void push16(uint16_t v) { cpu.sp -= 2; wr16(cpu.sp, v); }
+static uint16_t pop16(void) { uint16_t v = rd16(cpu.sp); cpu.sp += 2; return v; }
+
+#define BC  ((uint16_t)((cpu.b << 8) | cpu.c))
+#define DE  ((uint16_t)((cpu.d << 8) | cpu.e))
+#define HL  ((uint16_t)((cpu.h << 8) | cpu.l))
+#define AF  ((uint16_t)((cpu.a << 8) | cpu.f))
+static void set_bc(uint16_t v) { cpu.b = v >> 8; cpu.c = v; }
+static void set_de(uint16_t v) { cpu.d = v >> 8; cpu.e = v; }
+static void set_hl(uint16_t v) { cpu.h = v >> 8; cpu.l = v; }
+static void set_af(uint16_t v) { cpu.a = v >> 8; cpu.f = v; }
+
+//
+// フラグ演算
+//
+static uint8_t szp(uint8_t v) { return (v & (FLAG_S | FLAG_Y | FLAG_X)) | (v ? 0 : FLAG_Z) | parity[v]; }
+
+static void alu(int op, uint8_t v)
+{
+    int a = cpu.a, r, c;
+    switch(op) {
+    case 0: // ADD
+    case 1: // ADC
+        c = (op == 1) ? (cpu.f & FLAG_C) : 0;
+        r = a + v + c;
+        cpu.f = (r & (FLAG_S | FLAG_Y | FLAG_X)) | ((r & 0xFF) ? 0 : FLAG_Z) | ((a ^ v ^ r) & FLAG_H)
+              | ((((a ^ ~v) & (a ^ r)) & 0x80) ? FLAG_P : 0) | ((r > 0xFF) ? FLAG_C : 0);
+        cpu.a = r;
+        break;
+    case 2: // SUB
+    case 3: // SBC
+    case 7: // CP
+        c = (op == 3) ? (cpu.f & FLAG_C) : 0;
+        r = a - v - c;
+        cpu.f = (r & FLAG_S) | ((r & 0xFF) ? 0 : FLAG_Z) | ((a ^ v ^ r) & FLAG_H)
+              | ((((a ^ v) & (a ^ r)) & 0x80) ? FLAG_P : 0) | FLAG_N | ((r < 0) ? FLAG_C : 0);
+        if(op == 7) cpu.f |= v & (FLAG_Y | FLAG_X);
+        else      { cpu.f |= r & (FLAG_Y | FLAG_X); cpu.a = r; }
+        break;
+    case 4: // AND
+        cpu.a &= v; cpu.f = szp(cpu.a) | FLAG_H;
+        break;
+    case 5: // XOR
+        cpu.a ^= v; cpu.f = szp(cpu.a);
+        break;
+    case 6: // OR
+        cpu.a |= v; cpu.f = szp(cpu.a);
+        break;
+    }
+}
+
+static uint8_t inc8(uint8_t v)
+{
+    uint8_t r = v + 1;
+    cpu.f = (cpu.f & FLAG_C) | (r & (FLAG_S | FLAG_Y | FLAG_X)) | (r ? 0 : FLAG_Z)
+          | (((v & 0x0F) == 0x0F) ? FLAG_H : 0) | ((v == 0x7F) ? FLAG_P : 0);
+    return r;
+}
+
+static uint8_t dec8(uint8_t v)
+{
+    uint8_t r = v - 1;
+    cpu.f = (cpu.f & FLAG_C) | (r & (FLAG_S | FLAG_Y | FLAG_X)) | (r ? 0 : FLAG_Z)
+          | (((v & 0x0F) == 0x00) ? FLAG_H : 0) | ((v == 0x80) ? FLAG_P : 0) | FLAG_N;
+    return r;
+}
+
+static uint16_t add16(uint16_t a, uint16_t v)
+{
+    uint32_t r = a + v;
+    cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | ((r >> 8) & (FLAG_Y | FLAG_X))
+          | (((a ^ v ^ r) >> 8) & FLAG_H) | ((r > 0xFFFF) ? FLAG_C : 0);
+    return r;
+}
+
+static uint16_t adc16(uint16_t a, uint16_t v, int sub)
+{
+    int c = cpu.f & FLAG_C;
+    int r = sub ? (a - v - c) : (a + v + c);
+    uint16_t r16 = r;
+    cpu.f = ((r16 >> 8) & (FLAG_S | FLAG_Y | FLAG_X)) | (r16 ? 0 : FLAG_Z) | (((a ^ v ^ r) >> 8) & FLAG_H)
+          | (sub ? FLAG_N : 0) | ((sub ? (r < 0) : (r > 0xFFFF)) ? FLAG_C : 0);
+    if(sub) { if(((a ^ v) & (a ^ r16)) & 0x8000) cpu.f |= FLAG_P; }
+    else    { if(((a ^ ~v) & (a ^ r16)) & 0x8000) cpu.f |= FLAG_P; }
+    return r16;
+}
+
+static uint8_t rot(int op, uint8_t v)
+{
+    int c = cpu.f & FLAG_C;
+    uint8_t r;
+    switch(op) {
+    case 0:  r = (v << 1) | (v >> 7);   c = v >> 7;     break;  // RLC
+    case 1:  r = (v >> 1) | (v << 7);   c = v & 1;      break;  // RRC
+    case 2:  r = (v << 1) | c;          c = v >> 7;     break;  // RL
+    case 3:  r = (v >> 1) | (c << 7);   c = v & 1;      break;  // RR
+    case 4:  r = v << 1;                c = v >> 7;     break;  // SLA
+    case 5:  r = (v >> 1) | (v & 0x80); c = v & 1;      break;  // SRA
+    case 6:  r = (v << 1) | 1;          c = v >> 7;     break;  // SLL
+    default: r = v >> 1;                c = v & 1;      break;  // SRL
+    }
+    cpu.f = szp(r) | (c ? FLAG_C : 0);
+    return r;
+}
+
+//
+// レジスタアクセス(インデックスプレフィックス対応)
+//
+static int prefix;          // 0:なし 1:IX 2:IY
+
+static uint16_t get_hl(void) { return prefix == 1 ? cpu.ix : prefix == 2 ? cpu.iy : HL; }
+static void put_hl(uint16_t v) { if(prefix == 1) cpu.ix = v; else if(prefix == 2) cpu.iy = v; else set_hl(v); }
+
+static uint16_t get_rp(int p)
+{
+    switch(p) {
+    case 0:  return BC;
+    case 1:  return DE;
+    case 2:  return get_hl();
+    default: return cpu.sp;
+    }
+}
+
+static void put_rp(int p, uint16_t v)
+{
+    switch(p) {
+    case 0:  set_bc(v); break;
+    case 1:  set_de(v); break;
+    case 2:  put_hl(v); break;
+    default: cpu.sp = v; break;
+    }
+}
+
+// (HL) / (IX+d) のアドレス(d の読み込みを含む)
+static uint16_t mem_addr(void)
+{
+    if(prefix) {
+        int8_t d = fetch8();
+        cpu.t += 8;
+        return get_hl() + d;
+    }
+    return HL;
+}
+
+// r[i] の読み書き (mem は (HL) のアドレス, use_idx は IXH/IXL を使うか)
+static uint8_t get_r(int i, uint16_t mem_a, int use_idx)
+{
+    switch(i) {
+    case 0:  return cpu.b;
+    case 1:  return cpu.c;
+    case 2:  return cpu.d;
+    case 3:  return cpu.e;
+    case 4:  return use_idx ? get_hl() >> 8 : cpu.h;
+    case 5:  return use_idx ? get_hl() & 0xFF : cpu.l;
+    case 6:  return rd8(mem_a);
+    default: return cpu.a;
+    }
+}
+
+static void put_r(int i, uint8_t v, uint16_t mem_a, int use_idx)
+{
+    switch(i) {
+    case 0:  cpu.b = v; break;
+    case 1:  cpu.c = v; break;
+    case 2:  cpu.d = v; break;
+    case 3:  cpu.e = v; break;
+    case 4:  if(use_idx) put_hl((get_hl() & 0x00FF) | (v << 8)); else cpu.h = v; break;
+    case 5:  if(use_idx) put_hl((get_hl() & 0xFF00) | v); else cpu.l = v; break;
+    case 6:  wr8(mem_a, v); break;
+    default: cpu.a = v; break;
+    }
+}
+
+static int cond(int y)
+{
+    switch(y) {
+    case 0:  return !(cpu.f & FLAG_Z);
+    case 1:  return  (cpu.f & FLAG_Z);
+    case 2:  return !(cpu.f & FLAG_C);
+    case 3:  return  (cpu.f & FLAG_C);
+    case 4:  return !(cpu.f & FLAG_P);
+    case 5:  return  (cpu.f & FLAG_P);
+    case 6:  return !(cpu.f & FLAG_S);
+    default: return  (cpu.f & FLAG_S);
+    }
+}
+
+//
+// CB xx / DD CB d xx
+//
+static void exec_cb(void)
+{
+    uint16_t a = 0;
+    uint8_t op, v;
+    int x, y, z;
+
+    if(prefix) {
+        int8_t d = fetch8();
+        a = get_hl() + d;
+        op = fetch8();
+    }
+    else {
+        op = fetch_op();
+        a = HL;
+    }
+    x = op >> 6; y = (op >> 3) & 7; z = op & 7;
+
+    v = prefix ? rd8(a) : get_r(z, a, 0);
+    if(prefix)       cpu.t += (x == 1) ? 16 : 19;   // 4(DD) + 16/19 = 20/23
+    else if(z == 6)  cpu.t += (x == 1) ? 12 : 15;
+    else             cpu.t += 8;
+
+    switch(x) {
+    case 0:
+        v = rot(y, v);
+        break;
+    case 1:
+        cpu.f = (cpu.f & FLAG_C) | FLAG_H | ((v & (1 << y)) ? 0 : (FLAG_Z | FLAG_P))
+              | ((y == 7 && (v & 0x80)) ? FLAG_S : 0) | (v & (FLAG_Y | FLAG_X));
+        return;
+    case 2:
+        v &= ~(1 << y);
+        break;
+    default:
+        v |= (1 << y);
+        break;
+    }
+    if(prefix) {
+        wr8(a, v);
+        if(z != 6) put_r(z, v, 0, 0);
+    }
+    else {
+        put_r(z, v, a, 0);
+    }
+}
+
+//
+// ED xx
+//
+static void exec_ed(void)
+{
+    uint8_t op = fetch_op();
+    int x = op >> 6, y = (op >> 3) & 7, z = op & 7, p = y >> 1, q = y & 1;
+    uint16_t nn;
+    uint8_t v;
+
+    prefix = 0;
+    if(x == 1) {
+        switch(z) {
+        case 0: // IN r,(C)
+            v = io_in(cpu.c);
+            cpu.f = (cpu.f & FLAG_C) | szp(v);
+            if(y != 6) put_r(y, v, 0, 0);
+            cpu.t += 12;
+            return;
+        case 1: // OUT (C),r
+            io_out(cpu.c, y == 6 ? 0 : get_r(y, 0, 0));
+            cpu.t += 12;
+            return;
+        case 2: // SBC/ADC HL,rp
+            set_hl(adc16(HL, get_rp(p), !q));
+            cpu.t += 15;
+            return;
+        case 3: // LD (nn),rp / LD rp,(nn)
+            nn = fetch16();
+            if(q) put_rp(p, rd16(nn));
+            else  wr16(nn, get_rp(p));
+            cpu.t += 20;
+            return;
+        case 4: // NEG
+            v = cpu.a; cpu.a = 0; alu(2, v);
+            cpu.t += 8;
+            return;
+        case 5: // RETN/RETI
+            cpu.pc = pop16(); cpu.iff1 = cpu.iff2;
+            cpu.t += 14;
+            return;
+        case 6: // IM
+            cpu.t += 8;
+            return;
+        default:
+            switch(y) {
+            case 0: cpu.i = cpu.a; cpu.t += 9; return;
+            case 1: cpu.r = cpu.a; cpu.t += 9; return;
+            case 2: cpu.a = cpu.i; cpu.f = (cpu.f & FLAG_C) | (szp(cpu.a) & ~FLAG_P) | (cpu.iff2 ? FLAG_P : 0); cpu.t += 9; return;
+            case 3: cpu.a = cpu.r; cpu.f = (cpu.f & FLAG_C) | (szp(cpu.a) & ~FLAG_P) | (cpu.iff2 ? FLAG_P : 0); cpu.t += 9; return;
+            case 4: // RRD
+                v = rd8(HL);
+                wr8(HL, (cpu.a << 4) | (v >> 4));
+                cpu.a = (cpu.a & 0xF0) | (v & 0x0F);
+                cpu.f = (cpu.f & FLAG_C) | szp(cpu.a);
+                cpu.t += 18;
+                return;
+            case 5: // RLD
+                v = rd8(HL);
+                wr8(HL, (v << 4) | (cpu.a & 0x0F));
+                cpu.a = (cpu.a & 0xF0) | (v >> 4);
+                cpu.f = (cpu.f & FLAG_C) | szp(cpu.a);
+                cpu.t += 18;
+                return;
+            default:
+                cpu.t += 8;
+                return;
+            }
+        }
+    }
+    if(x == 2 && y >= 4 && z <= 1) {
+        int dir = (y & 1) ? -1 : 1;
+        int repeat = y >= 6;
+        if(z == 0) {    // LDI/LDD/LDIR/LDDR
+            wr8(DE, rd8(HL));
+            set_de(DE + dir);
+            set_hl(HL + dir);
+            set_bc(BC - 1);
+            cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_C)) | (BC ? FLAG_P : 0);
+        }
+        else {          // CPI/CPD/CPIR/CPDR
+            uint8_t c = cpu.f & FLAG_C;
+            v = rd8(HL);
+            alu(7, v);
+            set_hl(HL + dir);
+            set_bc(BC - 1);
+            cpu.f = (cpu.f & ~(FLAG_P | FLAG_C)) | (BC ? FLAG_P : 0) | c;
+        }
+        if(repeat && BC && !(z == 1 && (cpu.f & FLAG_Z))) {
+            cpu.pc -= 2;
+            cpu.t += 21;
+        }
+        else {
+            cpu.t += 16;
+        }
+        return;
+    }
+    cpu.t += 8;
+}
+
+//
+// 1 命令実行
+//
+static void step(void)
+{
+    uint8_t op = fetch_op();
+    int x, y, z, p, q;
+    uint16_t nn, a;
+    uint8_t v;
+
+    prefix = 0;
+    while(op == 0xDD || op == 0xFD) {
+        prefix = (op == 0xDD) ? 1 : 2;
+        cpu.t += 4;
+        op = fetch_op();
+    }
+    if(op == 0xCB) { exec_cb(); return; }
+    if(op == 0xED) { exec_ed(); return; }
+
+    x = op >> 6; y = (op >> 3) & 7; z = op & 7; p = y >> 1; q = y & 1;
+
+    switch(x) {
+    case 0:
+        switch(z) {
+        case 0:
+            if(y == 0) { cpu.t += 4; }                                          // NOP
+            else if(y == 1) {                                                   // EX AF,AF'
+                uint8_t t;
+                t = cpu.a; cpu.a = cpu.a_; cpu.a_ = t;
+                t = cpu.f; cpu.f = cpu.f_; cpu.f_ = t;
+                cpu.t += 4;
+            }
+            else if(y == 2) {                                                   // DJNZ
+                int8_t d = fetch8();
+                if(--cpu.b) { cpu.pc += d; cpu.t += 13; } else cpu.t += 8;
+            }
+            else {                                                              // JR / JR cc
+                int8_t d = fetch8();
+                if(y == 3 || cond(y - 4)) { cpu.pc += d; cpu.t += 12; } else cpu.t += 7;
+            }
+            break;
+        case 1:
+            if(!q) { put_rp(p, fetch16()); cpu.t += 10; }                       // LD rp,nn
+            else   { put_hl(add16(get_hl(), get_rp(p))); cpu.t += 11; }         // ADD HL,rp
+            break;
+        case 2:
+            switch(y) {
+            case 0: wr8(BC, cpu.a); cpu.t += 7; break;
+            case 1: cpu.a = rd8(BC); cpu.t += 7; break;
+            case 2: wr8(DE, cpu.a); cpu.t += 7; break;
+            case 3: cpu.a = rd8(DE); cpu.t += 7; break;
+            case 4: wr16(fetch16(), get_hl()); cpu.t += 16; break;
+            case 5: put_hl(rd16(fetch16())); cpu.t += 16; break;
+            case 6: wr8(fetch16(), cpu.a); cpu.t += 13; break;
+            default: cpu.a = rd8(fetch16()); cpu.t += 13; break;
+            }
+            break;
+        case 3:                                                                 // INC/DEC rp
+            put_rp(p, get_rp(p) + (q ? -1 : 1));
+            cpu.t += 6;
+            break;
+        case 4:                                                                 // INC r
+        case 5:                                                                 // DEC r
+            a = (y == 6) ? mem_addr() : 0;
+            v = get_r(y, a, 1);
+            put_r(y, (z == 4) ? inc8(v) : dec8(v), a, 1);
+            cpu.t += (y == 6) ? 11 : 4;
+            break;
+        case 6:                                                                 // LD r,n
+            a = (y == 6) ? mem_addr() : 0;
+            if(y == 6 && prefix) cpu.t -= 3;                                    // LD (IX+d),n は 19
+            put_r(y, fetch8(), a, 1);
+            cpu.t += (y == 6) ? 10 : 7;
+            break;
+        default:
+            switch(y) {
+            case 0: v = cpu.a >> 7; cpu.a = (cpu.a << 1) | v; cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | v; break;
+            case 1: v = cpu.a & 1;  cpu.a = (cpu.a >> 1) | (v << 7); cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | v; break;
+            case 2: v = cpu.a >> 7; cpu.a = (cpu.a << 1) | (cpu.f & FLAG_C); cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | v; break;
+            case 3: v = cpu.a & 1;  cpu.a = (cpu.a >> 1) | ((cpu.f & FLAG_C) << 7); cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | v; break;
+            case 4: {                                                           // DAA
+                uint8_t corr = 0, c = cpu.f & FLAG_C, r;
+                if((cpu.f & FLAG_H) || (cpu.a & 0x0F) > 9) corr |= 0x06;
+                if(c || cpu.a > 0x99) { corr |= 0x60; c = FLAG_C; }
+                r = (cpu.f & FLAG_N) ? cpu.a - corr : cpu.a + corr;
+                cpu.f = szp(r) | (cpu.f & FLAG_N) | c | ((cpu.a ^ r) & FLAG_H);
+                cpu.a = r;
+                break;
+            }
+            case 5: cpu.a = ~cpu.a; cpu.f |= FLAG_H | FLAG_N; break;            // CPL
+            case 6: cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | FLAG_C; break;  // SCF
+            default: cpu.f = (cpu.f & (FLAG_S | FLAG_Z | FLAG_P)) | ((cpu.f & FLAG_C) ? FLAG_H : FLAG_C); break; // CCF
+            }
+            cpu.t += 4;
+            break;
+        }
+        break;
+
+    case 1:
+        if(y == 6 && z == 6) {                                                  // HALT
+            cpu.pc--;
+            cpu.t += 4;
+        }
+        else if(y == 6 || z == 6) {                                             // LD r,(HL) / LD (HL),r
+            a = mem_addr();
+            put_r(y, get_r(z, a, 0), a, 0);
+            cpu.t += 7;
+        }
+        else {                                                                  // LD r,r'
+            put_r(y, get_r(z, 0, 1), 0, 1);
+            cpu.t += 4;
+        }
+        break;
+
+    case 2:                                                                     // ALU r
+        a = (z == 6) ? mem_addr() : 0;
+        alu(y, get_r(z, a, 1));
+        cpu.t += (z == 6) ? 7 : 4;
+        break;
+
+    default:
+        switch(z) {
+        case 0:                                                                 // RET cc
+            if(cond(y)) { cpu.pc = pop16(); cpu.t += 11; } else cpu.t += 5;
+            break;
+        case 1:
+            if(!q) {                                                            // POP
+                uint16_t v16 = pop16();
+                if(p == 3) set_af(v16); else put_rp(p, v16);
+                cpu.t += 10;
+            }
+            else if(p == 0) { cpu.pc = pop16(); cpu.t += 10; }                  // RET
+            else if(p == 1) {                                                   // EXX
+                uint8_t t;
+                t = cpu.b; cpu.b = cpu.b_; cpu.b_ = t;
+                t = cpu.c; cpu.c = cpu.c_; cpu.c_ = t;
+                t = cpu.d; cpu.d = cpu.d_; cpu.d_ = t;
+                t = cpu.e; cpu.e = cpu.e_; cpu.e_ = t;
+                t = cpu.h; cpu.h = cpu.h_; cpu.h_ = t;
+                t = cpu.l; cpu.l = cpu.l_; cpu.l_ = t;
+                cpu.t += 4;
+            }
+            else if(p == 2) { cpu.pc = get_hl(); cpu.t += 4; }                  // JP (HL)
+            else { cpu.sp = get_hl(); cpu.t += 6; }                             // LD SP,HL
+            break;
+        case 2:                                                                 // JP cc,nn
+            nn = fetch16();
+            if(cond(y)) cpu.pc = nn;
+            cpu.t += 10;
+            break;
+        case 3:
+            switch(y) {
+            case 0: cpu.pc = fetch16(); cpu.t += 10; break;                     // JP nn
+            case 2: io_out(fetch8(), cpu.a); cpu.t += 11; break;                // OUT (n),A
+            case 3: cpu.a = io_in(fetch8()); cpu.t += 11; break;                // IN A,(n)
+            case 4: {                                                           // EX (SP),HL
+                uint16_t t = rd16(cpu.sp);
+                wr16(cpu.sp, get_hl());
+                put_hl(t);
+                cpu.t += 19;
+                break;
+            }
+            case 5: {                                                           // EX DE,HL
+                uint16_t t = DE;
+                set_de(HL);
+                set_hl(t);
+                cpu.t += 4;
+                break;
+            }
+            case 6: cpu.iff1 = cpu.iff2 = 0; cpu.t += 4; break;                 // DI
+            default: cpu.iff1 = cpu.iff2 = 1; cpu.t += 4; break;                // EI
+            }
+            break;
+        case 4:                                                                 // CALL cc,nn
+            nn = fetch16();
+            if(cond(y)) { push16(cpu.pc); cpu.pc = nn; cpu.t += 17; } else cpu.t += 10;
+            break;
+        case 5:
+            if(!q) {                                                            // PUSH
+                push16(p == 3 ? AF : get_rp(p));
+                cpu.t += 11;
+            }
+            else {                                                              // CALL nn
+                nn = fetch16();
+                push16(cpu.pc);
+                cpu.pc = nn;
+                cpu.t += 17;
+            }
+            break;
+        case 6:                                                                 // ALU n
+            alu(y, fetch8());
+            cpu.t += 7;
+            break;
+        default:                                                                // RST
+            push16(cpu.pc);
+            cpu.pc = y * 8;
+            cpu.t += 11;
+            break;
+        }
+        break;
+    }
+}
+
+//
+// サブルーチン呼び出し(0000h に戻るまで実行)
+//
+static int call(uint16_t addr)
+{
+    long steps = 0;
+    cpu.sp = STACK_ADDR;
+    push16(0x0000);
+    cpu.pc = addr;
+    while(cpu.pc != 0x0000) {
+        step();
+        if(++steps > STEP_LIMIT) {
+            fprintf(stderr, "step limit exceeded (PC=%04X)\n", cpu.pc);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/***************************************************************
+ * テスト用の演奏データ
+ *  リズム + 6 チャンネル
+ *  MML コンパイラの出力によくある、音符毎に音色と音量を指定し直すデータ
+ ***************************************************************/
+static int song_size;
+
+static uint8_t *song_ptr;
+static void db(int v) { *song_ptr++ = v; }
+
+static void build_song(void)
+{
+    static const uint8_t melody[] = { 0x25, 0x27, 0x29, 0x2A, 0x2C, 0x2A, 0x29, 0x27 };
+    static const uint8_t bass[] = { 0x19, 0x19, 0x1E, 0x1E, 0x20, 0x20, 0x19, 0x19 };
+    static const uint8_t chord[3] = { 0x25, 0x29, 0x2C };
+    uint8_t *top = &mem[SONG_ADDR];
+    uint16_t offsets[7];
+    uint16_t usr_inst;
+    int ch, i, bar;
+
+    song_ptr = top + 7 * 2;
+
+    // ユーザー音色
+    usr_inst = SONG_ADDR + (song_ptr - top);
+    db(0x21); db(0x21); db(0x1C); db(0x07); db(0xF0); db(0xF0); db(0x0F); db(0x0F);
+
+    // リズム
+    offsets[0] = song_ptr - top;
+    for(bar = 0; bar < 4; bar++) {
+        for(i = 0; i < 8; i++) {
+            db(0x9F); db(0x02);                         // 全リズム音量
+            db((i & 1) ? 0x01 : ((i & 2) ? 0x08 : 0x10)); // HH / SD / BD
+            db(6);
+        }
+    }
+    db(0xFF);
+
+    // メロディ
+    offsets[1] = song_ptr - top;
+    for(bar = 0; bar < 4; bar++) {
+        for(i = 0; i < 8; i++) {
+            db(0x61); db(0x73); db(0x86); db(6);       // 音量, 音色, Q
+            db(melody[i]); db(6);
+        }
+    }
+    db(0xFF);
+
+    // ベース(ユーザー音色)
+    offsets[2] = song_ptr - top;
+    for(bar = 0; bar < 4; bar++) {
+        for(i = 0; i < 8; i++) {
+            db(0x83); db(usr_inst & 0xFF); db(usr_inst >> 8);
+            db(0x62); db(0x86); db(4);
+            db(bass[i]); db(6);
+        }
+    }
+    db(0xFF);
+
+    // 和音(レガートで同じ音を繰り返す)
+    for(ch = 0; ch < 3; ch++) {
+        offsets[3 + ch] = song_ptr - top;
+        for(bar = 0; bar < 4; bar++) {
+            for(i = 0; i < 4; i++) {
+                db(0x64); db(0x7A); db(0x85);           // 音量, 音色, レガート
+                db(chord[ch]); db(12);
+            }
+        }
+        db(0xFF);
+    }
+
+    // 休符と音量変化
+    offsets[6] = song_ptr - top;
+    for(bar = 0; bar < 4; bar++) {
+        for(i = 0; i < 8; i++) {
+            db(0x60 | (i & 3)); db(0x75); db(0x84); db(0x86); db(8);
+            db((i & 1) ? 0x00 : 0x31); db(6);
+        }
+    }
+    db(0xFF);
+
+    for(i = 0; i < 7; i++) {
+        top[i * 2 + 0] = offsets[i] & 0xFF;
+        top[i * 2 + 1] = offsets[i] >> 8;
+    }
+    song_size = song_ptr - top;
+}
+
+/***************************************************************
+ * main
+ ***************************************************************/
+static void usage(void)
+{
+    fprintf(stderr, "usage: drvprof [-n ticks] [-m] [-t] [-v] fmbios.rom [song.bin]\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *rom_name = NULL, *song_name = NULL;
+    long ticks = 3600, tick;
+    int m1_wait = 0;
+    uint64_t total = 0, max = 0, total_writes = 0, max_writes = 0;
+    long idle = 0, max_tick = 0;
+    FILE *fp;
+    int i;
+
+    for(i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "-n") && i + 1 < argc) ticks = strtol(argv[++i], NULL, 0);
+        else if(!strcmp(argv[i], "-m")) m1_wait = 1;
+        else if(!strcmp(argv[i], "-t")) trace = 1;
+        else if(!strcmp(argv[i], "-v")) verbose = 1;
+        else if(argv[i][0] == '-') usage();
+        else if(!rom_name) rom_name = argv[i];
+        else if(!song_name) song_name = argv[i];
+        else usage();
+    }
+    if(!rom_name) usage();
+
+    for(i = 0; i < 256; i++) {
+        int b, n = 0;
+        for(b = 0; b < 8; b++) n += (i >> b) & 1;
+        parity[i] = (n & 1) ? 0 : FLAG_P;
+    }
+
+    // ROM
+    if(!(fp = fopen(rom_name, "rb"))) { perror(rom_name); return 1; }
+    if(fread(&mem[ROM_ADDR], 1, ROM_SIZE, fp) != ROM_SIZE) { fprintf(stderr, "%s: short read\n", rom_name); return 1; }
+    fclose(fp);
+
+    // BIOS のスタブ
+    mem[BIOS_RDSLT + 0] = 0x7E;                                 // LD A,(HL)
+    mem[BIOS_RDSLT + 1] = 0xC9;                                 // RET
+    mem[BIOS_CALSLT + 0] = 0xDD; mem[BIOS_CALSLT + 1] = 0xE9;   // JP (IX)
+    mem[BIOS_RSLREG + 0] = 0xDB; mem[BIOS_RSLREG + 1] = 0xA8;   // IN A,(0A8h)
+    mem[BIOS_RSLREG + 2] = 0xC9;                                // RET
+
+    // 演奏データ
+    if(song_name) {
+        if(!(fp = fopen(song_name, "rb"))) { perror(song_name); return 1; }
+        song_size = fread(&mem[SONG_ADDR], 1, WORK_ADDR - SONG_ADDR, fp);
+        fclose(fp);
+    }
+    else {
+        build_song();
+    }
+
+    // INIOPL, MSTART
+    set_hl(WORK_ADDR);
+    if(call(FMBIOS_INIOPL)) return 1;
+    cpu.a = 0;
+    set_hl(SONG_ADDR);
+    if(call(FMBIOS_MSTART)) return 1;
+
+    // OPLDRV
+    for(tick = 0; tick < ticks; tick++) {
+        uint64_t t0 = cpu.t + (m1_wait ? cpu.m1 : 0);
+        uint64_t w0 = opll_writes;
+        uint64_t t, w;
+        if(verbose) printf("tick %ld\n", tick);
+        if(call(FMBIOS_OPLDRV)) return 1;
+        t = cpu.t + (m1_wait ? cpu.m1 : 0) - t0;
+        w = opll_writes - w0;
+        total += t;
+        total_writes += w;
+        if(trace) printf("tick %ld: %llu T, %llu writes\n", tick, (unsigned long long)t, (unsigned long long)w);
+        if(t > max) { max = t; max_tick = tick; }
+        if(w > max_writes) max_writes = w;
+        if(w == 0) idle++;
+    }
+
+    printf("song          : %s (%d bytes)\n", song_name ? song_name : "built-in", song_size);
+    printf("ticks         : %ld\n", ticks);
+    printf("T-states      : total %llu, avg %.1f, max %llu (tick %ld)%s\n",
+        (unsigned long long)total, (double)total / ticks, (unsigned long long)max, max_tick, m1_wait ? " (M1 wait)" : "");
+    printf("OPLL writes   : total %llu, avg %.2f, max %llu\n",
+        (unsigned long long)total_writes, (double)total_writes / ticks, (unsigned long long)max_writes);
+    printf("ticks w/o write: %ld\n", idle);
+    return 0;
+}
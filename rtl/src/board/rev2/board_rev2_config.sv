@@ -47,7 +47,7 @@ package CONFIG_BOARD;
     localparam          DAC_SCLK_SRC            = 0;                // SCLK source = CLK_BASE
     localparam          DAC_SCLK_DIV            = 0;                // not use SCLK
     localparam          DAC_BCLK_SRC            = 0;                // BCLK source = CLK_BASE
-    localparam          DAC_BCLK_DIV            = 38;               // BLCK = 107.4MHz / 2 / 38
+    localparam          DAC_BCLK_DIV            = 38;               // BLCK = 107.4MHz / 2 / 38(1ch 16bit の値, DAC_I2S_BIT_WIDTH=32 の時は半分の 19 で分周する)
 endpackage
 
 `default_nettype wire
@@ -40,13 +40,16 @@ interface PAC_IF #(parameter FlashBankCount = 8);
     logic                   SramEnable;
     logic [2:0]             FlashBankNumber;    // Flash bank number
     logic                   Busy;
+    logic [1:0]             Dirty;              // 4KB セクタ毎の書き込みフラグ
+    logic                   DirtyClear;
 
-    modport HOST  (input  FlashBankNumber, Busy, output SramEnable);
-    modport DEVICE(output FlashBankNumber, Busy, input  SramEnable);
+    modport HOST  (input  FlashBankNumber, Busy, DirtyClear, output SramEnable, Dirty);
+    modport DEVICE(output FlashBankNumber, Busy, DirtyClear, input  SramEnable, Dirty);
 
     // ダミー接続
     function automatic void connect_dummy();
         SramEnable = 0;
+        Dirty = 0;
     endfunction
 endinterface
 
@@ -54,16 +57,21 @@ endinterface
  * 転送モード
  ***********************************************************************/
 package XFER;
-    typedef enum logic[2:0]{
+    typedef enum logic[3:0]{
         XFER_MODE_FILL,
         XFER_MODE_READ_RAM,
         XFER_MODE_FLASH_TO_RAM,
         XFER_MODE_RAM_TO_FLASH,
-        XFER_MODE_ERASE,
+        XFER_MODE_ERASE,            // 64KB ブロック消去
         XFER_MODE_VERIFY,
         XFER_MODE_FF,
-        XFER_MODE_CRC
+        XFER_MODE_CRC,
+        XFER_MODE_ERASE_4K          // 4KB セクタ消去
     } XFER_MODE_t;
+
+    // FLASH_SPI へ渡すイレーズコマンド
+    localparam [7:0] ERASE_BLOCK_64K = 8'hD8;
+    localparam [7:0] ERASE_SECTOR_4K = 8'h20;
 endpackage
 
 /***********************************************************************
@@ -74,13 +82,14 @@ interface XFER_IF #(parameter RAM_ADDR_WIDTH = 24, FLASH_ADDR_WIDTH = 24);
     logic   [FLASH_ADDR_WIDTH-1:0]  FlashAddress;
     logic   [RAM_ADDR_WIDTH-1:0]    Size;
     logic   [7:0]                   RData;
+    logic   [31:0]                  Crc;            // XFER_MODE_CRC の CRC32 (RData は CRC7)
     logic   [7:0]                   WData;
     XFER::XFER_MODE_t               Mode;
     logic                           Start;
     logic                           Busy;
 
-    modport HOST  (output RamAddress, FlashAddress, Size, Mode, Start, WData, input  Busy, RData);
-    modport DEVICE(input  RamAddress, FlashAddress, Size, Mode, Start, WData, output Busy, RData);
+    modport HOST  (output RamAddress, FlashAddress, Size, Mode, Start, WData, input  Busy, RData, Crc);
+    modport DEVICE(input  RamAddress, FlashAddress, Size, Mode, Start, WData, output Busy, RData, Crc);
 
     // ダミー接続
     function automatic void connect_dummy();
@@ -112,7 +121,16 @@ module BOOTLOADER #(
 
     //
     parameter [23:0]        PAC_RAM_ADDR = 0,
-    parameter [23:0]        PAC_FLASH_ADDR = 0
+    parameter [23:0]        PAC_FLASH_ADDR = 0,
+    parameter [23:0]        PAC_WORK_ADDR = 0,
+
+    // メガロム SRAM の保存領域(SRAM_FLASH_ADDR = 0 なら保存しない)
+    parameter [23:0]        SRAM_RAM_ADDR = 0,
+    parameter [23:0]        SRAM_FLASH_ADDR = 0,
+
+    // ミキサー音量の保存領域
+    parameter [23:0]        MIXER_FLASH_ADDR = 0,
+    parameter [23:0]        MIXER_WORK_ADDR = 0
 ) (
     input wire              RESET_n,
     input wire              CLK,
@@ -121,6 +139,8 @@ module BOOTLOADER #(
     LED_IF.HOST             Led,
     XFER_IF.DEVICE          Xfer,
     PAC_IF.DEVICE           PAC,
+    PAC_IF.DEVICE           SRAM,
+    MIXER_IF.HOST           Mixer,
     input wire              ClearMegarom,
     input wire              BusReset_n,
     input wire              RD_n,
@@ -130,7 +150,158 @@ module BOOTLOADER #(
     output reg              READY
 );
     localparam PAC_BANK_SIZE = 8192;
+    localparam PAC_SECTOR_SIZE = 4096;
     logic [7:0] pac_crc;
+    logic [1:0] pac_dirty;      // 書き込み開始時の Dirty
+    logic [1:0] pac_retry;      // 保存に失敗したセクタ(次の保存で再試行)
+    logic       pac_page;       // 処理中のセクタ番号(PAC SRAM 4000h~4FFFh / 5000h~5FFFh)
+
+    /***************************************************************
+     * PAC ジャーナル
+     *  FLASH の PAC 領域(64KB)を 4KB セクタ x16 として使う
+     *   セクタ 0, 15 : ログ(交互に使用)
+     *   セクタ 1~14  : データスロット(PAC SRAM の 4KB 分を1つ保存)
+     *  ログエントリ(8バイト)
+     *   +0,+1 : シーケンス番号
+     *   +2    : 4000h~4FFFh のスロット番号
+     *   +3    : 5000h~5FFFh のスロット番号
+     *   +4    : 4000h~4FFFh の CRC
+     *   +5    : 5000h~5FFDh の CRC
+     *   +6    : +0~+5 の CRC
+     *   +7    : +6 の反転
+     *  データを消去済スロットへ書いてからエントリを追記するので、
+     *  エントリが書けるまでは前のデータが有効のまま
+     *  スロットとログの消去は書き込みの無い時に済ませておく
+     *  メガロム SRAM も SRAM_FLASH_ADDR の 64KB に同じ形式で保存する
+     *  処理中でない方のジャーナルの状態は pac_swap_* に退避し、対象を切り替える時に入れ替える
+     *  復元時はログを1回だけ走査し、スロット毎に最後に参照したエントリを pac_tbl_* に記録する
+     *  最新エントリのデータが壊れていたら、両方のスロットがまだそのエントリのままの
+     *  一つ古いエントリを pac_tbl_* から探して復元する
+     ***************************************************************/
+    localparam PAC_LOG_ENTRY_SIZE = 8;
+    localparam PAC_LOG_ENTRIES = PAC_SECTOR_SIZE / PAC_LOG_ENTRY_SIZE;
+    localparam [3:0] PAC_SLOT_FIRST = 1;
+    localparam [3:0] PAC_SLOT_LAST = 14;
+
+    logic        pac_journal;           // ジャーナルのデータが有効
+    logic [15:0] pac_seq;               // 最新エントリのシーケンス番号
+    logic [15:0] pac_seq_top;           // ログにある最も新しいシーケンス番号
+    logic [15:0] pac_seq_limit;         // 復元に失敗したエントリのシーケンス番号
+    logic [3:0]  pac_slot[0:1];         // 使用中のスロット
+    logic [7:0]  pac_page_crc[0:1];     // 使用中のスロットの CRC
+    logic [3:0]  pac_new_slot[0:1];     // 書き込み中のスロット
+    logic [7:0]  pac_new_crc[0:1];      // 書き込み中のスロットの CRC
+    logic        pac_log;               // 使用中のログ
+    logic [9:0]  pac_log_pos;           // 次に書くエントリの位置
+    logic        pac_log_ready;         // 次のログが消去済
+    logic        pac_log_idx;           // 走査中のログ
+    logic [9:0]  pac_ent_pos;           // 走査中のエントリ
+    logic [2:0]  pac_ent_idx;           // エントリのバイト位置
+    logic [7:0]  pac_ent[0:5];          // 読み込んだエントリ
+    logic [3:0]  pac_free[0:1];         // 消去済スロット
+    logic [1:0]  pac_free_ready;
+    logic        pac_free_idx;
+    logic [3:0]  pac_rr;                // 次に確認するスロット
+    logic        pac_bg;                // 書き込みの無い時に準備している
+    logic        pac_legacy;            // 旧形式のデータを読み込んだ
+
+    // スロット毎に最後に参照したエントリ
+    logic        pac_tbl_valid[PAC_SLOT_FIRST:PAC_SLOT_LAST];
+    logic [15:0] pac_tbl_seq[PAC_SLOT_FIRST:PAC_SLOT_LAST];     // シーケンス番号
+    logic        pac_tbl_page[PAC_SLOT_FIRST:PAC_SLOT_LAST];    // 4000h~4FFFh(0) / 5000h~5FFFh(1) のどちらか
+    logic [3:0]  pac_tbl_pair[PAC_SLOT_FIRST:PAC_SLOT_LAST];    // 同じエントリのもう一方のスロット
+    logic [7:0]  pac_tbl_crc[PAC_SLOT_FIRST:PAC_SLOT_LAST];     // CRC
+    logic [3:0]  pac_fb_slot;           // 古いエントリを探しているスロット
+    logic        pac_fb_found;          // 古いエントリが見つかった
+    logic [3:0]  pac_fb_cand;           // 見つかったエントリの 4000h~4FFFh のスロット
+    logic [2:0]  pac_legacy_bank;       // 読み込んだ旧形式のバンク
+
+    logic        pac_target;            // 処理中のジャーナル(0:PAC, 1:メガロム SRAM)
+    logic        pac_swap_restore;      // 切り替え後に復元する(起動時)
+    logic        pac_swap_journal;
+    logic [15:0] pac_swap_seq;
+    logic [3:0]  pac_swap_slot[0:1];
+    logic [7:0]  pac_swap_page_crc[0:1];
+    logic        pac_swap_log;
+    logic [9:0]  pac_swap_log_pos;
+    logic        pac_swap_log_ready;
+    logic [3:0]  pac_swap_free[0:1];
+    logic [1:0]  pac_swap_free_ready;
+    logic [3:0]  pac_swap_rr;
+    logic        pac_swap_legacy;
+    logic [2:0]  pac_swap_legacy_bank;
+    logic [1:0]  pac_swap_retry;
+
+    wire [23:0] pac_ram_base = pac_target ? SRAM_RAM_ADDR : PAC_RAM_ADDR;
+    wire [23:0] pac_flash_base = pac_target ? SRAM_FLASH_ADDR : PAC_FLASH_ADDR;
+
+    function automatic [23:0] pac_sector_addr(input [3:0] sector);
+        pac_sector_addr = {pac_flash_base[23:16], sector, 12'd0};
+    endfunction
+
+    function automatic [3:0] pac_log_sector(input idx);
+        pac_log_sector = idx ? 4'd15 : 4'd0;
+    endfunction
+
+    wire [23:0] pac_ent_addr = PAC_WORK_ADDR + {pac_ent_pos[8:0], 3'd0};
+    wire [23:0] pac_log_addr = pac_sector_addr(pac_log_sector(pac_log)) + {pac_log_pos[8:0], 3'd0};
+    wire [23:0] pac_page_ram_addr = pac_ram_base + (pac_page ? PAC_SECTOR_SIZE : 0);
+    wire [23:0] pac_page_size = (pac_page && !pac_target) ? PAC_SECTOR_SIZE - 2 : PAC_SECTOR_SIZE;     // PAC の 5FFEh/5FFFh はバンクレジスタなので除外
+    wire [15:0] pac_ent_seq = { pac_ent[1], pac_ent[0] };
+    wire [15:0] pac_seq_diff = pac_ent_seq - pac_seq;
+    wire [15:0] pac_next_seq = pac_seq + 1'd1;
+
+    // 読み込んだエントリのスロット番号が正しいか
+    wire pac_ent_valid = pac_ent[2] >= PAC_SLOT_FIRST && pac_ent[2] <= PAC_SLOT_LAST &&
+                         pac_ent[3] >= PAC_SLOT_FIRST && pac_ent[3] <= PAC_SLOT_LAST &&
+                         pac_ent[2] != pac_ent[3];
+
+    // 読み込んだエントリがスロットを最後に参照したエントリか
+    wire [15:0] pac_tbl_diff0 = pac_ent_seq - pac_tbl_seq[pac_ent[2][3:0]];
+    wire [15:0] pac_tbl_diff1 = pac_ent_seq - pac_tbl_seq[pac_ent[3][3:0]];
+    wire pac_tbl_newer0 = !pac_tbl_valid[pac_ent[2][3:0]] || (!pac_tbl_diff0[15] && pac_tbl_diff0 != 0);
+    wire pac_tbl_newer1 = !pac_tbl_valid[pac_ent[3][3:0]] || (!pac_tbl_diff1[15] && pac_tbl_diff1 != 0);
+
+    // pac_fb_slot を 4000h~4FFFh 側に持つエントリが、復元に失敗したエントリより古く、
+    // 両方のスロットがまだそのエントリのままで、これまでの候補より新しいか
+    wire [3:0]  pac_fb_pair = pac_tbl_pair[pac_fb_slot];
+    wire [15:0] pac_fb_limit_diff = pac_tbl_seq[pac_fb_slot] - pac_seq_limit;
+    wire [15:0] pac_fb_cand_diff = pac_tbl_seq[pac_fb_slot] - pac_tbl_seq[pac_fb_cand];
+    wire pac_fb_ok = pac_tbl_valid[pac_fb_slot] && !pac_tbl_page[pac_fb_slot] && pac_fb_limit_diff[15] &&
+                     pac_tbl_valid[pac_fb_pair] && pac_tbl_page[pac_fb_pair] &&
+                     pac_tbl_seq[pac_fb_pair] == pac_tbl_seq[pac_fb_slot] && pac_tbl_pair[pac_fb_pair] == pac_fb_slot &&
+                     (!pac_fb_found || (!pac_fb_cand_diff[15] && pac_fb_cand_diff != 0));
+
+    // 書き込むエントリの値
+    logic [7:0] pac_ent_value;
+    always_comb begin
+        case (pac_ent_idx)
+            0:       pac_ent_value = pac_next_seq[7:0];
+            1:       pac_ent_value = pac_next_seq[15:8];
+            2:       pac_ent_value = {4'd0, pac_new_slot[0]};
+            3:       pac_ent_value = {4'd0, pac_new_slot[1]};
+            4:       pac_ent_value = pac_new_crc[0];
+            default: pac_ent_value = pac_new_crc[1];
+        endcase
+    end
+
+    // 消去してはいけないスロット
+    wire pac_rr_used = (pac_journal && (pac_rr == pac_slot[0] || pac_rr == pac_slot[1])) ||
+                       (!pac_journal && pac_legacy && pac_rr[3:1] == pac_legacy_bank) ||
+                       (pac_free_ready[!pac_free_idx] && pac_rr == pac_free[!pac_free_idx]);
+
+    /***************************************************************
+     * ミキサー音量
+     *  フラッシュの MIXER_FLASH_ADDR に保存された音量を読み込む
+     *   +0~+(MIXER_GAIN_SIZE-1) : 音量(1ch あたり下位,上位の 2バイト)
+     *   +MIXER_GAIN_SIZE        : 音量の合計(下位 8bit)
+     *   +MIXER_GAIN_SIZE+1      : 合計の反転
+     *  消去済(FFh)や 00h のままの領域は合計が一致しないので無視する
+     ***************************************************************/
+    localparam MIXER_GAIN_SIZE = Mixer.COUNT * 2;
+    localparam MIXER_DATA_SIZE = MIXER_GAIN_SIZE + 2;
+    logic [4:0] mix_idx;
+    logic [7:0] mix_sum;
 
     /***************************************************************
      * メモリ転送
@@ -173,12 +344,34 @@ module BOOTLOADER #(
             // PAC.SramEnable が 1->0 で pac_detect を 1 にする
             pac_detect <= 1;
         end
-        else if(!pac_busy_prev && PAC.Busy) begin
-            // PAC.Busy が 0->1 で pac_detect を 0 にする
+        else if(!pac_busy_prev && PAC.Busy && !pac_target) begin
+            // PAC の保存で PAC.Busy が 0->1 で pac_detect を 0 にする
             pac_detect <= 0;
         end
     end
 
+    // メガロム SRAM も同様
+    logic sram_detect;
+    logic sram_enable_prev;
+    always @(posedge CLK) sram_enable_prev <= SRAM.SramEnable;
+    always @(posedge CLK or negedge RESET_n)
+    begin
+        if(!RESET_n) begin
+            sram_detect <= 0;
+        end
+        else if(SRAM_FLASH_ADDR == 0) begin
+            sram_detect <= 0;
+        end
+        else if(sram_enable_prev && !SRAM.SramEnable) begin
+            sram_detect <= 1;
+        end
+        else if(!pac_busy_prev && PAC.Busy && pac_target) begin
+            sram_detect <= 0;
+        end
+    end
+    assign SRAM.Busy = PAC.Busy;
+    assign SRAM.FlashBankNumber = 0;
+
     /***************************************************************
      * PAC データがあるフラッシュのアドレス
      ***************************************************************/
@@ -187,7 +380,7 @@ module BOOTLOADER #(
     /***************************************************************
      * 
      ***************************************************************/
-    enum logic [4:0] {
+    enum logic [5:0] {
         STATE_WAIT_POR = 0,
         STATE_WAIT_BOOT,
 
@@ -197,7 +390,27 @@ module BOOTLOADER #(
 
         STATE_CLEAR_MMAPPER,
 
+        STATE_READ_MIXER,
+        STATE_READ_MIXER_READ,
+        STATE_READ_MIXER_STORE,
+
         STATE_READ_PAC,
+        STATE_READ_PAC_LOG,
+        STATE_READ_PAC_ENTRY,
+        STATE_READ_PAC_ENTRY_CRC1,
+        STATE_READ_PAC_ENTRY_CRC2,
+        STATE_READ_PAC_ENTRY_CHECK,
+        STATE_READ_PAC_ENTRY_READ,
+        STATE_READ_PAC_ENTRY_STORE,
+        STATE_READ_PAC_ENTRY_SELECT,
+        STATE_READ_PAC_JOURNAL,
+        STATE_READ_PAC_SLOT,
+        STATE_READ_PAC_SLOT_CRC,
+        STATE_READ_PAC_SLOT_CHECK,
+        STATE_READ_PAC_FALLBACK,
+        STATE_READ_PAC_FALLBACK_SCAN,
+        STATE_READ_PAC_FALLBACK_SELECT,
+        STATE_READ_PAC_LEGACY,
         STATE_READ_PAC_READ,
         STATE_READ_PAC_CRC,
         STATE_READ_PAC_CRC1,
@@ -205,16 +418,29 @@ module BOOTLOADER #(
         STATE_READ_PAC_CHECK,
 
         STATE_CLEAR_PAC,
+        STATE_READ_PAC_DONE,
+        STATE_PAC_SWAP,
 
         STATE_WRITE_PAC,
+        STATE_WRITE_PAC_VERIFY,
         STATE_WRITE_PAC_CHECK_VERIFY,
-        STATE_WRITE_PAC_SEARCH_FREE,
-        STATE_WRITE_PAC_SEARCH_FREE_READ,
-        STATE_WRITE_PAC_SEARCH_FREE_CHECK,
+        STATE_WRITE_PAC_PREPARE,
         STATE_WRITE_PAC_CALC_CRC,
+        STATE_WRITE_PAC_WRITE,
+        STATE_WRITE_PAC_WRITE_VERIFY,
+        STATE_WRITE_PAC_WRITE_CHECK,
+        STATE_WRITE_PAC_LOG,
+        STATE_WRITE_PAC_LOG_FF,
+        STATE_WRITE_PAC_LOG_ENTRY,
+        STATE_WRITE_PAC_LOG_CRC,
         STATE_WRITE_PAC_SET_CRC1,
         STATE_WRITE_PAC_SET_CRC2,
-        STATE_WRITE_PAC_WRITE,
+        STATE_WRITE_PAC_LOG_WRITE,
+        STATE_WRITE_PAC_COMMIT,
+
+        STATE_PAC_PICK,
+        STATE_PAC_PICK_CHECK,
+        STATE_PAC_LOG_CHECK,
 
         STATE_SECONDARY,
 
@@ -229,9 +455,34 @@ module BOOTLOADER #(
             Cooperate <= 0;
 
             PAC.Busy <= 1;
+            PAC.DirtyClear <= 0;
+            SRAM.DirtyClear <= 0;
+            pac_dirty <= 0;
+            pac_retry <= 0;
+            pac_page <= 0;
+            pac_journal <= 0;
+            pac_seq <= 0;
+            pac_legacy <= 0;
+            pac_free_ready <= 0;
+            pac_rr <= PAC_SLOT_FIRST;
+
+            pac_target <= 0;
+            pac_swap_restore <= 0;
+            pac_swap_journal <= 0;
+            pac_swap_seq <= 0;
+            pac_swap_log <= 1;
+            pac_swap_log_pos <= PAC_LOG_ENTRIES;
+            pac_swap_log_ready <= 0;
+            pac_swap_free_ready <= 0;
+            pac_swap_rr <= PAC_SLOT_FIRST;
+            pac_swap_legacy <= 0;
+            pac_swap_retry <= 0;
+
+            Mixer.Load <= 0;
 
             Xfer.Busy  <= 0;
             Xfer.RData <= 0;
+            Xfer.Crc   <= 0;
 
             XferPrim.Start <= 0;
             state <= STATE_WAIT_POR;
@@ -314,15 +565,283 @@ module BOOTLOADER #(
                     XferPrim.Mode <= XFER::XFER_MODE_FILL;
                     XferPrim.WData <= 8'h00;
                     XferPrim.Start <= 1;
-                    state <= STATE_READ_PAC;
+                    state <= STATE_READ_MIXER;
+                end
+
+                //------------------------------
+                // read MIXER
+                //------------------------------
+                STATE_READ_MIXER:
+                begin
+                    // 保存領域を作業領域へ読み込む
+                    XferPrim.RamAddress <= MIXER_WORK_ADDR;
+                    XferPrim.FlashAddress <= MIXER_FLASH_ADDR;
+                    XferPrim.Size <= MIXER_DATA_SIZE;
+                    XferPrim.Mode <= XFER::XFER_MODE_FLASH_TO_RAM;
+                    XferPrim.Start <= 1;
+                    mix_idx <= 0;
+                    mix_sum <= 0;
+                    state <= STATE_READ_MIXER_READ;
+                end
+                STATE_READ_MIXER_READ:
+                begin
+                    XferPrim.RamAddress <= MIXER_WORK_ADDR + mix_idx;
+                    XferPrim.Mode <= XFER::XFER_MODE_READ_RAM;
+                    XferPrim.Start <= 1;
+                    state <= STATE_READ_MIXER_STORE;
+                end
+                STATE_READ_MIXER_STORE:
+                begin
+                    mix_idx <= mix_idx + 1'd1;
+                    if(mix_idx < MIXER_GAIN_SIZE) begin
+                        // 音量
+                        Mixer.LoadData[mix_idx] <= XferPrim.RData;
+                        mix_sum <= mix_sum + XferPrim.RData;
+                        state <= STATE_READ_MIXER_READ;
+                    end
+                    else if(mix_idx == MIXER_GAIN_SIZE && XferPrim.RData == mix_sum) begin
+                        // 合計
+                        state <= STATE_READ_MIXER_READ;
+                    end
+                    else begin
+                        // 合計の反転が一致したら音量レジスタへ読み込む
+                        Mixer.Load <= (mix_idx == MIXER_GAIN_SIZE + 1) && (XferPrim.RData == ~mix_sum);
+                        state <= STATE_READ_PAC;
+                    end
                 end
 
                 //------------------------------
                 // read PAC
                 //------------------------------
+                // ジャーナルのログセクタを2つとも走査して、最も新しいエントリを探す
                 STATE_READ_PAC:
                 begin
+                    Mixer.Load <= 0;
                     PAC.Busy <= 1;
+                    pac_journal <= 0;
+                    pac_legacy <= 0;
+                    for(int i = PAC_SLOT_FIRST; i <= PAC_SLOT_LAST; i++) pac_tbl_valid[i] <= 0;
+                    pac_log <= 1;
+                    pac_log_pos <= PAC_LOG_ENTRIES;
+                    pac_log_ready <= 0;
+                    pac_log_idx <= 0;
+                    state <= STATE_READ_PAC_LOG;
+                end
+                STATE_READ_PAC_LOG:
+                begin
+                    // ログセクタを作業領域へ読み込む
+                    XferPrim.RamAddress <= PAC_WORK_ADDR;
+                    XferPrim.FlashAddress <= pac_sector_addr(pac_log_sector(pac_log_idx));
+                    XferPrim.Size <= PAC_SECTOR_SIZE;
+                    XferPrim.Mode <= XFER::XFER_MODE_FLASH_TO_RAM;
+                    XferPrim.Start <= 1;
+                    pac_ent_pos <= 0;
+                    state <= STATE_READ_PAC_ENTRY;
+                end
+                STATE_READ_PAC_ENTRY:
+                begin
+                    if(pac_ent_pos == PAC_LOG_ENTRIES) begin
+                        if(pac_log_idx == 0) begin
+                            // 次のログセクタ
+                            pac_log_idx <= 1;
+                            state <= STATE_READ_PAC_LOG;
+                        end
+                        else begin
+                            state <= STATE_READ_PAC_JOURNAL;
+                        end
+                    end
+                    else begin
+                        // エントリの CRC を計算
+                        XferPrim.RamAddress <= pac_ent_addr;
+                        XferPrim.Size <= 6;
+                        XferPrim.Mode <= XFER::XFER_MODE_CRC;
+                        XferPrim.Start <= 1;
+                        state <= STATE_READ_PAC_ENTRY_CRC1;
+                    end
+                end
+                STATE_READ_PAC_ENTRY_CRC1:
+                begin
+                    // CRC を保存
+                    pac_crc <= XferPrim.RData;
+
+                    // CRC1 を読む
+                    XferPrim.RamAddress <= pac_ent_addr + 6;
+                    XferPrim.Mode <= XFER::XFER_MODE_READ_RAM;
+                    XferPrim.Start <= 1;
+                    state <= STATE_READ_PAC_ENTRY_CRC2;
+                end
+                STATE_READ_PAC_ENTRY_CRC2:
+                begin
+                    if(XferPrim.RData == pac_crc) begin
+                        // CRC2 を読む
+                        XferPrim.RamAddress <= pac_ent_addr + 7;
+                        XferPrim.Mode <= XFER::XFER_MODE_READ_RAM;
+                        XferPrim.Start <= 1;
+                        state <= STATE_READ_PAC_ENTRY_CHECK;
+                    end
+                    else begin
+                        // 未使用または壊れたエントリ
+                        pac_ent_pos <= pac_ent_pos + 1'd1;
+                        state <= STATE_READ_PAC_ENTRY;
+                    end
+                end
+                STATE_READ_PAC_ENTRY_CHECK:
+                begin
+                    if(XferPrim.RData == ~pac_crc) begin
+                        // 正常なエントリなので中身を読む
+                        pac_ent_idx <= 0;
+                        state <= STATE_READ_PAC_ENTRY_READ;
+                    end
+                    else begin
+                        pac_ent_pos <= pac_ent_pos + 1'd1;
+                        state <= STATE_READ_PAC_ENTRY;
+                    end
+                end
+                STATE_READ_PAC_ENTRY_READ:
+                begin
+                    XferPrim.RamAddress <= pac_ent_addr + pac_ent_idx;
+                    XferPrim.Mode <= XFER::XFER_MODE_READ_RAM;
+                    XferPrim.Start <= 1;
+                    state <= STATE_READ_PAC_ENTRY_STORE;
+                end
+                STATE_READ_PAC_ENTRY_STORE:
+                begin
+                    pac_ent[pac_ent_idx] <= XferPrim.RData;
+                    if(pac_ent_idx == 5) begin
+                        state <= STATE_READ_PAC_ENTRY_SELECT;
+                    end
+                    else begin
+                        pac_ent_idx <= pac_ent_idx + 1'd1;
+                        state <= STATE_READ_PAC_ENTRY_READ;
+                    end
+                end
+                STATE_READ_PAC_ENTRY_SELECT:
+                begin
+                    // シーケンス番号が最も新しいエントリを採用
+                    if(pac_ent_valid && (!pac_journal || (!pac_seq_diff[15] && pac_seq_diff != 0))) begin
+                        pac_journal <= 1;
+                        pac_seq <= pac_ent_seq;
+                        pac_slot[0] <= pac_ent[2][3:0];
+                        pac_slot[1] <= pac_ent[3][3:0];
+                        pac_page_crc[0] <= pac_ent[4];
+                        pac_page_crc[1] <= pac_ent[5];
+                        pac_rr <= pac_ent[3][3:0];
+                        // 追記位置は最も新しいエントリの後ろ
+                        pac_log <= pac_log_idx;
+                        pac_log_pos <= pac_ent_pos + 1'd1;
+                    end
+
+                    // スロット毎に最後に参照したエントリを記録
+                    if(pac_ent_valid && pac_tbl_newer0) begin
+                        pac_tbl_valid[pac_ent[2][3:0]] <= 1;
+                        pac_tbl_seq[pac_ent[2][3:0]] <= pac_ent_seq;
+                        pac_tbl_page[pac_ent[2][3:0]] <= 0;
+                        pac_tbl_pair[pac_ent[2][3:0]] <= pac_ent[3][3:0];
+                        pac_tbl_crc[pac_ent[2][3:0]] <= pac_ent[4];
+                    end
+                    if(pac_ent_valid && pac_tbl_newer1) begin
+                        pac_tbl_valid[pac_ent[3][3:0]] <= 1;
+                        pac_tbl_seq[pac_ent[3][3:0]] <= pac_ent_seq;
+                        pac_tbl_page[pac_ent[3][3:0]] <= 1;
+                        pac_tbl_pair[pac_ent[3][3:0]] <= pac_ent[2][3:0];
+                        pac_tbl_crc[pac_ent[3][3:0]] <= pac_ent[5];
+                    end
+                    pac_ent_pos <= pac_ent_pos + 1'd1;
+                    state <= STATE_READ_PAC_ENTRY;
+                end
+                STATE_READ_PAC_JOURNAL:
+                begin
+                    pac_seq_top <= pac_seq;
+
+                    if(pac_journal) begin
+                        // ジャーナルから復元
+                        pac_page <= 0;
+                        state <= STATE_READ_PAC_SLOT;
+                    end
+                    else begin
+                        // 旧形式のバンクから復元
+                        // メガロム SRAM には旧形式が無いのでクリアする
+                        state <= pac_target ? STATE_CLEAR_PAC : STATE_READ_PAC_LEGACY;
+                    end
+                end
+                STATE_READ_PAC_SLOT:
+                begin
+                    XferPrim.RamAddress <= pac_page_ram_addr;
+                    XferPrim.FlashAddress <= pac_sector_addr(pac_slot[pac_page]);
+                    XferPrim.Size <= PAC_SECTOR_SIZE;
+                    XferPrim.Mode <= XFER::XFER_MODE_FLASH_TO_RAM;
+                    XferPrim.Start <= 1;
+                    state <= STATE_READ_PAC_SLOT_CRC;
+                end
+                STATE_READ_PAC_SLOT_CRC:
+                begin
+                    XferPrim.RamAddress <= pac_page_ram_addr;
+                    XferPrim.Size <= pac_page_size;
+                    XferPrim.Mode <= XFER::XFER_MODE_CRC;
+                    XferPrim.Start <= 1;
+                    state <= STATE_READ_PAC_SLOT_CHECK;
+                end
+                STATE_READ_PAC_SLOT_CHECK:
+                begin
+                    if(XferPrim.RData != pac_page_crc[pac_page]) begin
+                        // データが壊れているので、このエントリより古いエントリを探す
+                        pac_seq_limit <= pac_seq;
+                        state <= STATE_READ_PAC_FALLBACK;
+                    end
+                    else if(pac_page == 0) begin
+                        pac_page <= 1;
+                        state <= STATE_READ_PAC_SLOT;
+                    end
+                    else begin
+                        // 次に書くエントリは最も新しいシーケンス番号に続ける
+                        pac_seq <= pac_seq_top;
+                        state <= STATE_READ_PAC_DONE;
+                    end
+                end
+
+                // スロット毎の記録から、復元に失敗したエントリより古いエントリを探す
+                STATE_READ_PAC_FALLBACK:
+                begin
+                    pac_fb_slot <= PAC_SLOT_FIRST;
+                    pac_fb_found <= 0;
+                    state <= STATE_READ_PAC_FALLBACK_SCAN;
+                end
+                STATE_READ_PAC_FALLBACK_SCAN:
+                begin
+                    if(pac_fb_ok) begin
+                        pac_fb_found <= 1;
+                        pac_fb_cand <= pac_fb_slot;
+                    end
+                    pac_fb_slot <= pac_fb_slot + 1'd1;
+                    if(pac_fb_slot == PAC_SLOT_LAST) state <= STATE_READ_PAC_FALLBACK_SELECT;
+                end
+                STATE_READ_PAC_FALLBACK_SELECT:
+                begin
+                    if(pac_fb_found) begin
+                        // 見つかったエントリから復元
+                        pac_seq <= pac_tbl_seq[pac_fb_cand];
+                        pac_slot[0] <= pac_fb_cand;
+                        pac_slot[1] <= pac_tbl_pair[pac_fb_cand];
+                        pac_page_crc[0] <= pac_tbl_crc[pac_fb_cand];
+                        pac_page_crc[1] <= pac_tbl_crc[pac_tbl_pair[pac_fb_cand]];
+                        pac_rr <= pac_tbl_pair[pac_fb_cand];
+                        pac_page <= 0;
+                        state <= STATE_READ_PAC_SLOT;
+                    end
+                    else begin
+                        // 見つからなければ旧形式を探す(シーケンス番号は最も新しいものを引き継ぐ)
+                        // メガロム SRAM には旧形式が無いのでクリアする
+                        pac_journal <= 0;
+                        pac_seq <= pac_seq_top;
+                        pac_log <= 1;
+                        pac_log_pos <= PAC_LOG_ENTRIES;
+                        state <= pac_target ? STATE_CLEAR_PAC : STATE_READ_PAC_LEGACY;
+                    end
+                end
+
+                // 旧形式(8KB バンク x8)を後ろから探す
+                STATE_READ_PAC_LEGACY:
+                begin
                     PAC.FlashBankNumber <= PAC.FlashBankCount - 1'd1;
                     state <= STATE_READ_PAC_READ;
                 end
@@ -374,7 +893,12 @@ module BOOTLOADER #(
                 begin
                     if(XferPrim.RData == ~pac_crc) begin
                         // 正常なバンクが見つかった
-                        state <= STATE_COMPLETE;
+                        // ジャーナルへ移行するまでこのバンクのセクタは消去しない
+                        // 最初のログはこのバンクと重ならないセクタに作る
+                        pac_legacy <= 1;
+                        pac_legacy_bank <= PAC.FlashBankNumber;
+                        pac_log <= (PAC.FlashBankNumber == 0) ? 1'd0 : 1'd1;
+                        state <= STATE_READ_PAC_DONE;
                     end
                     else if(PAC.FlashBankNumber == 0) begin
                         // 全てのバンクをチェックしたけど、正常なデータが見つからない
@@ -393,12 +917,50 @@ module BOOTLOADER #(
                 //------------------------------
                 STATE_CLEAR_PAC:
                 begin
-                    XferPrim.RamAddress <= PAC_RAM_ADDR;
+                    XferPrim.RamAddress <= pac_ram_base;
                     XferPrim.Size <= PAC_BANK_SIZE;
                     XferPrim.Mode <= XFER::XFER_MODE_FILL;
                     XferPrim.WData <= 8'h00;
                     XferPrim.Start <= 1;
-                    state <= STATE_COMPLETE;
+                    state <= STATE_READ_PAC_DONE;
+                end
+                STATE_READ_PAC_DONE:
+                begin
+                    if(SRAM_FLASH_ADDR != 0 && !pac_target) begin
+                        // 続けてメガロム SRAM を復元する
+                        pac_swap_restore <= 1;
+                        state <= STATE_PAC_SWAP;
+                    end
+                    else begin
+                        state <= STATE_COMPLETE;
+                    end
+                end
+
+                //------------------------------
+                // PAC/メガロム SRAM の切り替え
+                //------------------------------
+                STATE_PAC_SWAP:
+                begin
+                    pac_target <= !pac_target;
+                    pac_journal <= pac_swap_journal;            pac_swap_journal <= pac_journal;
+                    pac_seq <= pac_swap_seq;                    pac_swap_seq <= pac_seq;
+                    pac_slot[0] <= pac_swap_slot[0];            pac_swap_slot[0] <= pac_slot[0];
+                    pac_slot[1] <= pac_swap_slot[1];            pac_swap_slot[1] <= pac_slot[1];
+                    pac_page_crc[0] <= pac_swap_page_crc[0];    pac_swap_page_crc[0] <= pac_page_crc[0];
+                    pac_page_crc[1] <= pac_swap_page_crc[1];    pac_swap_page_crc[1] <= pac_page_crc[1];
+                    pac_log <= pac_swap_log;                    pac_swap_log <= pac_log;
+                    pac_log_pos <= pac_swap_log_pos;            pac_swap_log_pos <= pac_log_pos;
+                    pac_log_ready <= pac_swap_log_ready;        pac_swap_log_ready <= pac_log_ready;
+                    pac_free[0] <= pac_swap_free[0];            pac_swap_free[0] <= pac_free[0];
+                    pac_free[1] <= pac_swap_free[1];            pac_swap_free[1] <= pac_free[1];
+                    pac_free_ready <= pac_swap_free_ready;      pac_swap_free_ready <= pac_free_ready;
+                    pac_rr <= pac_swap_rr;                      pac_swap_rr <= pac_rr;
+                    pac_legacy <= pac_swap_legacy;              pac_swap_legacy <= pac_legacy;
+                    pac_legacy_bank <= pac_swap_legacy_bank;    pac_swap_legacy_bank <= pac_legacy_bank;
+                    pac_retry <= pac_swap_retry;                pac_swap_retry <= pac_retry;
+
+                    pac_swap_restore <= 0;
+                    state <= pac_swap_restore ? STATE_READ_PAC : STATE_COMPLETE;
                 end
 
                 //------------------------------
@@ -406,10 +968,31 @@ module BOOTLOADER #(
                 //------------------------------
                 STATE_WRITE_PAC: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
-                    // RAM と FLASH の内容を比較
-                    XferPrim.RamAddress <= PAC_RAM_ADDR;
-                    XferPrim.FlashAddress <= pac_addr;
-                    XferPrim.Size <= PAC_BANK_SIZE - 2;
+                    PAC.DirtyClear <= 0;
+                    SRAM.DirtyClear <= 0;
+
+                    if(pac_dirty == 0) begin
+                        // SRAM に書き込みが無い場合は何もしない
+                        PAC.Busy <= 0;
+                        state <= STATE_COMPLETE;
+                    end
+                    else if(!pac_journal) begin
+                        // ジャーナルが無い場合は両方のセクタを書く
+                        pac_dirty <= 2'b11;
+                        state <= STATE_WRITE_PAC_PREPARE;
+                    end
+                    else begin
+                        // 書き込みのあった最初のセクタから比較する
+                        pac_page <= !pac_dirty[0];
+                        state <= STATE_WRITE_PAC_VERIFY;
+                    end
+                end
+                STATE_WRITE_PAC_VERIFY: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    // 書き込みのあったセクタだけ RAM と FLASH の内容を比較
+                    XferPrim.RamAddress <= pac_page_ram_addr;
+                    XferPrim.FlashAddress <= pac_sector_addr(pac_slot[pac_page]);
+                    XferPrim.Size <= pac_page_size;
                     XferPrim.Mode <= XFER::XFER_MODE_VERIFY;
                     XferPrim.Start <= 1;
 
@@ -417,74 +1000,165 @@ module BOOTLOADER #(
                 end
                 STATE_WRITE_PAC_CHECK_VERIFY: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
+                    // 内容が同じセクタは書かない
                     if(XferPrim.RData == 0) begin
+                        pac_dirty[pac_page] <= 0;
+                    end
+
+                    if(!pac_page && pac_dirty[1]) begin
+                        // 次のセクタを比較する
+                        pac_page <= 1;
+                        state <= STATE_WRITE_PAC_VERIFY;
+                    end
+                    else begin
+                        state <= STATE_WRITE_PAC_PREPARE;
+                    end
+                end
+                STATE_WRITE_PAC_PREPARE: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    // 変更の無いセクタは現在のスロットを引き継ぐ
+                    pac_new_slot[0] <= pac_slot[0];
+                    pac_new_slot[1] <= pac_slot[1];
+                    pac_new_crc[0] <= pac_page_crc[0];
+                    pac_new_crc[1] <= pac_page_crc[1];
+
+                    if(pac_dirty == 0) begin
                         // RAM と FLASH の内容が全く同じ場合は何もしない
+                        pac_retry <= 0;
                         PAC.Busy <= 0;
                         state <= STATE_COMPLETE;
                     end
+                    else if((pac_dirty[0] + pac_dirty[1]) > (pac_free_ready[0] + pac_free_ready[1])) begin
+                        // 消去済スロットが足りないので、ここで用意する
+                        Led.State <= Led.LED_STATE_ON;
+                        pac_bg <= 0;
+                        pac_free_idx <= pac_free_ready[0];
+                        state <= STATE_PAC_PICK;
+                    end
                     else begin
                         // LED 点灯
                         Led.State <= Led.LED_STATE_ON;
-
-                        // SEARCH_FREE へ遷移
-                        state <= STATE_WRITE_PAC_SEARCH_FREE;
+                        pac_page <= !pac_dirty[0];
+                        state <= STATE_WRITE_PAC_CALC_CRC;
                     end
                 end
-                STATE_WRITE_PAC_SEARCH_FREE: if(CONFIG::ENABLE_PAC_WRITE)
+                STATE_WRITE_PAC_CALC_CRC: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
-                    if(PAC.FlashBankNumber == PAC.FlashBankCount - 1'd1) begin
-                        // 最終バンクまで使用済の場合は erase
-                        XferPrim.FlashAddress <= PAC_FLASH_ADDR;
-                        XferPrim.Mode <= XFER::XFER_MODE_ERASE;
-                        XferPrim.Start <= 1;
+                    // CRC 計算
+                    XferPrim.RamAddress <= pac_page_ram_addr;
+                    XferPrim.Size <= pac_page_size;
+                    XferPrim.Mode <= XFER::XFER_MODE_CRC;
+                    XferPrim.Start <= 1;
+
+                    // CRC 計算が終わったら WRITE へ遷移
+                    state <= STATE_WRITE_PAC_WRITE;
+                end
+                STATE_WRITE_PAC_WRITE: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    // 消去済スロットを割り当てる
+                    pac_new_crc[pac_page] <= XferPrim.RData;
+                    pac_new_slot[pac_page] <= pac_free[!pac_free_ready[0]];
+                    pac_free_ready[!pac_free_ready[0]] <= 0;
+
+                    // フラッシュへ書く
+                    XferPrim.RamAddress <= pac_page_ram_addr;
+                    XferPrim.FlashAddress <= pac_sector_addr(pac_free[!pac_free_ready[0]]);
+                    XferPrim.Size <= PAC_SECTOR_SIZE;
+                    XferPrim.Mode <= XFER::XFER_MODE_RAM_TO_FLASH;
+                    XferPrim.Start <= 1;
 
-                        // 先頭バンクに書き込む
-                        PAC.FlashBankNumber <= 0;
+                    state <= STATE_WRITE_PAC_WRITE_VERIFY;
+                end
+                STATE_WRITE_PAC_WRITE_VERIFY: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    // 書いた内容を確認
+                    XferPrim.RamAddress <= pac_page_ram_addr;
+                    XferPrim.FlashAddress <= pac_sector_addr(pac_new_slot[pac_page]);
+                    XferPrim.Size <= pac_page_size;
+                    XferPrim.Mode <= XFER::XFER_MODE_VERIFY;
+                    XferPrim.Start <= 1;
 
-                        // ERASE 完了したら CALC_CRC へ遷移する
+                    state <= STATE_WRITE_PAC_WRITE_CHECK;
+                end
+                STATE_WRITE_PAC_WRITE_CHECK: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    if(XferPrim.RData != 0) begin
+                        // 書き込み中に変更された、または書き込みに失敗した
+                        // ログを書かないので、現在のデータがそのまま有効
+                        // Dirty はクリア済なので、次の保存で書き直す
+                        pac_retry <= pac_retry | pac_dirty;
+                        PAC.Busy <= 0;
+                        state <= STATE_COMPLETE;
+                    end
+                    else if(!pac_page && pac_dirty[1]) begin
+                        // 次のセクタを書く
+                        pac_page <= 1;
                         state <= STATE_WRITE_PAC_CALC_CRC;
                     end
                     else begin
-                        // 次のバンクを FFh チェック
-                        PAC.FlashBankNumber <= PAC.FlashBankNumber + 1'd1;
-
-                        // SEARCH_FREE_READ へ遷移
-                        state <= STATE_WRITE_PAC_SEARCH_FREE_READ;
+                        state <= STATE_WRITE_PAC_LOG;
                     end
                 end
-                STATE_WRITE_PAC_SEARCH_FREE_READ: if(CONFIG::ENABLE_PAC_WRITE)
+                STATE_WRITE_PAC_LOG: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
-                    // FFh チェック
-                    XferPrim.RamAddress <= PAC_RAM_ADDR;
-                    XferPrim.FlashAddress <= pac_addr;
-                    XferPrim.Size <= PAC_BANK_SIZE;
-                    XferPrim.Mode <= XFER::XFER_MODE_FF;
-                    XferPrim.Start <= 1;
-
-                    // FFh チェックが終わったら SEARCH_FREE_CHECK へ遷移
-                    state <= STATE_WRITE_PAC_SEARCH_FREE_CHECK;
+                    if(pac_log_pos != PAC_LOG_ENTRIES) begin
+                        // 追記位置が未使用か確認
+                        XferPrim.RamAddress <= PAC_WORK_ADDR;
+                        XferPrim.FlashAddress <= pac_log_addr;
+                        XferPrim.Size <= PAC_LOG_ENTRY_SIZE;
+                        XferPrim.Mode <= XFER::XFER_MODE_FF;
+                        XferPrim.Start <= 1;
+                        state <= STATE_WRITE_PAC_LOG_FF;
+                    end
+                    else if(pac_log_ready) begin
+                        // ログセクタを切り替える(古いログは次のログが満杯になる前に消去する)
+                        pac_log <= !pac_log;
+                        pac_log_pos <= 0;
+                        pac_log_ready <= 0;
+                    end
+                    else begin
+                        // 次のログセクタを消去
+                        XferPrim.FlashAddress <= pac_sector_addr(pac_log_sector(!pac_log));
+                        XferPrim.Mode <= XFER::XFER_MODE_ERASE_4K;
+                        XferPrim.Start <= 1;
+                        pac_log_ready <= 1;
+                    end
                 end
-                STATE_WRITE_PAC_SEARCH_FREE_CHECK: if(CONFIG::ENABLE_PAC_WRITE)
+                STATE_WRITE_PAC_LOG_FF: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
-                    if(XferPrim.RData == 8'hFF)
-                    begin
-                        // 未使用バンクが見つかったら CRC 計算へ遷移
-                        state <= STATE_WRITE_PAC_CALC_CRC;
+                    if(XferPrim.RData != 8'hFF) begin
+                        // 電源断で書きかけになったエントリは飛ばす
+                        pac_log_pos <= pac_log_pos + 1'd1;
+                        state <= STATE_WRITE_PAC_LOG;
                     end
                     else begin
-                        // 使用済なので次バンクの FFh をチェック
-                        state <= STATE_WRITE_PAC_SEARCH_FREE;
+                        pac_ent_idx <= 0;
+                        state <= STATE_WRITE_PAC_LOG_ENTRY;
                     end
                 end
-                STATE_WRITE_PAC_CALC_CRC: if(CONFIG::ENABLE_PAC_WRITE)
+                STATE_WRITE_PAC_LOG_ENTRY: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    // エントリを作業領域に作る
+                    XferPrim.RamAddress <= PAC_WORK_ADDR + pac_ent_idx;
+                    XferPrim.WData <= pac_ent_value;
+                    XferPrim.Size <= 1;
+                    XferPrim.Mode <= XFER::XFER_MODE_FILL;
+                    XferPrim.Start <= 1;
+
+                    if(pac_ent_idx == 5) begin
+                        state <= STATE_WRITE_PAC_LOG_CRC;
+                    end
+                    else begin
+                        pac_ent_idx <= pac_ent_idx + 1'd1;
+                    end
+                end
+                STATE_WRITE_PAC_LOG_CRC: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
                     // CRC 計算
-                    XferPrim.RamAddress <= PAC_RAM_ADDR;
-                    XferPrim.Size <= PAC_BANK_SIZE - 2;
+                    XferPrim.RamAddress <= PAC_WORK_ADDR;
+                    XferPrim.Size <= 6;
                     XferPrim.Mode <= XFER::XFER_MODE_CRC;
                     XferPrim.Start <= 1;
-
-                    // CRC 計算が終わったら SET_CRC1 へ遷移
                     state <= STATE_WRITE_PAC_SET_CRC1;
                 end
                 STATE_WRITE_PAC_SET_CRC1: if(CONFIG::ENABLE_PAC_WRITE)
@@ -493,7 +1167,7 @@ module BOOTLOADER #(
                     pac_crc <= XferPrim.RData;
 
                     // CRC1 を RAM へ書く
-                    XferPrim.RamAddress <= PAC_RAM_ADDR + PAC_BANK_SIZE - 2;
+                    XferPrim.RamAddress <= PAC_WORK_ADDR + 6;
                     XferPrim.WData <= XferPrim.RData;
                     XferPrim.Size <= 1;
                     XferPrim.Mode <= XFER::XFER_MODE_FILL;
@@ -505,35 +1179,89 @@ module BOOTLOADER #(
                 STATE_WRITE_PAC_SET_CRC2: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
                     // CRC2 を RAM へ書く
-                    XferPrim.RamAddress <= PAC_RAM_ADDR + PAC_BANK_SIZE - 1;
+                    XferPrim.RamAddress <= PAC_WORK_ADDR + 7;
                     XferPrim.WData <= ~pac_crc;
                     XferPrim.Size <= 1;
                     XferPrim.Mode <= XFER::XFER_MODE_FILL;
                     XferPrim.Start <= 1;
 
-                    // CRC2 を書いたら WRITE へ遷移
-                    state <= STATE_WRITE_PAC_WRITE;
+                    // CRC2 を書いたら LOG_WRITE へ遷移
+                    state <= STATE_WRITE_PAC_LOG_WRITE;
                 end
-                STATE_WRITE_PAC_WRITE: if(CONFIG::ENABLE_PAC_WRITE)
+                STATE_WRITE_PAC_LOG_WRITE: if(CONFIG::ENABLE_PAC_WRITE)
                 begin
-                    // フラッシュへ書く
-                    XferPrim.RamAddress <= PAC_RAM_ADDR;
-                    XferPrim.FlashAddress <= pac_addr;
-                    XferPrim.Size <= PAC_BANK_SIZE;
+                    // エントリをフラッシュへ追記(ここで書き込みが確定する)
+                    XferPrim.RamAddress <= PAC_WORK_ADDR;
+                    XferPrim.FlashAddress <= pac_log_addr;
+                    XferPrim.Size <= PAC_LOG_ENTRY_SIZE;
                     XferPrim.Mode <= XFER::XFER_MODE_RAM_TO_FLASH;
                     XferPrim.Start <= 1;
+                    state <= STATE_WRITE_PAC_COMMIT;
+                end
+                STATE_WRITE_PAC_COMMIT: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    pac_journal <= 1;
+                    pac_seq <= pac_next_seq;
+                    pac_slot[0] <= pac_new_slot[0];
+                    pac_slot[1] <= pac_new_slot[1];
+                    pac_page_crc[0] <= pac_new_crc[0];
+                    pac_page_crc[1] <= pac_new_crc[1];
+                    pac_log_pos <= pac_log_pos + 1'd1;
+                    pac_retry <= 0;
 
                     // 書いたら PAC 処理終了
                     PAC.Busy <= 0;
                     state <= STATE_COMPLETE;
                 end
 
+                //------------------------------
+                // 消去済スロットの準備
+                //------------------------------
+                STATE_PAC_PICK: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    // 使用中のスロットを飛ばして順番に選ぶ
+                    pac_rr <= (pac_rr == PAC_SLOT_LAST) ? PAC_SLOT_FIRST : pac_rr + 1'd1;
+                    if(!pac_rr_used) begin
+                        pac_free[pac_free_idx] <= pac_rr;
+
+                        // 消去済か確認
+                        XferPrim.RamAddress <= PAC_WORK_ADDR;
+                        XferPrim.FlashAddress <= pac_sector_addr(pac_rr);
+                        XferPrim.Size <= PAC_SECTOR_SIZE;
+                        XferPrim.Mode <= XFER::XFER_MODE_FF;
+                        XferPrim.Start <= 1;
+                        state <= STATE_PAC_PICK_CHECK;
+                    end
+                end
+                STATE_PAC_PICK_CHECK: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    if(XferPrim.RData != 8'hFF) begin
+                        // 4KB セクタ消去
+                        XferPrim.FlashAddress <= pac_sector_addr(pac_free[pac_free_idx]);
+                        XferPrim.Mode <= XFER::XFER_MODE_ERASE_4K;
+                        XferPrim.Start <= 1;
+                    end
+                    pac_free_ready[pac_free_idx] <= 1;
+                    state <= pac_bg ? STATE_COMPLETE : STATE_WRITE_PAC_PREPARE;
+                end
+                STATE_PAC_LOG_CHECK: if(CONFIG::ENABLE_PAC_WRITE)
+                begin
+                    if(XferPrim.RData != 8'hFF) begin
+                        // 4KB セクタ消去
+                        XferPrim.Mode <= XFER::XFER_MODE_ERASE_4K;
+                        XferPrim.Start <= 1;
+                    end
+                    pac_log_ready <= 1;
+                    state <= STATE_COMPLETE;
+                end
+
                 //------------------------------
                 // MSX からのフラッシュ制御
                 //------------------------------
                 STATE_SECONDARY:
                 begin
                     Xfer.RData <= XferPrim.RData;
+                    Xfer.Crc   <= XferPrim.Crc;
 
                     // 転送開始された?
                     if(XferPrim.Busy && XferPrim.Start) begin
@@ -564,9 +1292,24 @@ module BOOTLOADER #(
                         Cooperate <= 1;
                         READY <= 1;
 
-                        if(pac_detect && CONFIG::ENABLE_PAC_WRITE) begin
+                        if((pac_detect || sram_detect) && pac_target != !pac_detect && CONFIG::ENABLE_PAC_WRITE) begin
+                            // 保存する方のジャーナルに切り替える(PAC を優先)
+                            state <= STATE_PAC_SWAP;
+                        end
+                        else if((pac_detect || sram_detect) && CONFIG::ENABLE_PAC_WRITE) begin
                             // PAC 書き込み処理開始
                             PAC.Busy <= 1;
+
+                            // 書き込みのあったセクタを保存してクリア
+                            // 前回保存できなかったセクタも含める
+                            if(pac_target) begin
+                                pac_dirty <= SRAM.Dirty | pac_retry;
+                                SRAM.DirtyClear <= 1;
+                            end
+                            else begin
+                                pac_dirty <= PAC.Dirty | pac_retry;
+                                PAC.DirtyClear <= 1;
+                            end
                             state <= STATE_WRITE_PAC;
                             Led.State <= Led.LED_STATE_OFF;
                         end
@@ -584,6 +1327,23 @@ module BOOTLOADER #(
                                 state <= STATE_SECONDARY;
                                 Led.State <= Led.LED_STATE_ON;
                             end
+                            else if(CONFIG::ENABLE_PAC_WRITE && pac_free_ready != 2'b11) begin
+                                // 次の書き込み用にスロットを消去しておく
+                                pac_bg <= 1;
+                                pac_free_idx <= pac_free_ready[0];
+                                state <= STATE_PAC_PICK;
+                                Led.State <= Led.LED_STATE_OFF;
+                            end
+                            else if(CONFIG::ENABLE_PAC_WRITE && pac_log_pos >= PAC_LOG_ENTRIES / 2 && !pac_log_ready) begin
+                                // ログが半分を超えたら次のログを消去しておく
+                                XferPrim.RamAddress <= PAC_WORK_ADDR;
+                                XferPrim.FlashAddress <= pac_sector_addr(pac_log_sector(!pac_log));
+                                XferPrim.Size <= PAC_SECTOR_SIZE;
+                                XferPrim.Mode <= XFER::XFER_MODE_FF;
+                                XferPrim.Start <= 1;
+                                state <= STATE_PAC_LOG_CHECK;
+                                Led.State <= Led.LED_STATE_OFF;
+                            end
                             else begin
                                 // 何もしない
                                 Led.State <= Led.LED_STATE_OFF;
@@ -633,6 +1393,16 @@ module XFER_MEMORY (
         .OUT        (crc_out)
     );
 
+    // MSX から転送したデータの確認用(CRC7 と同時に計算する)
+    CRC32 u_crc32 (
+        .CLK        (CLK),
+        .RESET_n    (RESET_n),
+        .CLEAR      (crc_clear),
+        .ENABLE     (crc_ena),
+        .IN         (rw_data),
+        .OUT        (Xfer.Crc)
+    );
+
     /***************************************************************
      * state
      ***************************************************************/
@@ -1079,7 +1849,7 @@ module XFER_MEMORY (
                         Flash.Address <= Xfer.FlashAddress;
                         Flash.Enable_n <= 0;
                         Flash.Mode <= FLASH::FLASH_MODE_ERASE;
-                        Flash.WData <= 8'hD8;
+                        Flash.WData <= (Xfer.Mode == XFER::XFER_MODE_ERASE_4K) ? XFER::ERASE_SECTOR_4K : XFER::ERASE_BLOCK_64K;
                         sub_state <= SUB_STATE_ERASE_WAIT_ACK;
                     end
 
@@ -1128,6 +1898,7 @@ module XFER_MEMORY (
                             XFER::XFER_MODE_FLASH_TO_RAM:   state <= STATE_F2R_ENABLE_FLASH;
                             XFER::XFER_MODE_RAM_TO_FLASH:   state <= STATE_R2F_ENABLE_FLASH;
                             XFER::XFER_MODE_ERASE:          state <= STATE_ERASE;
+                            XFER::XFER_MODE_ERASE_4K:       state <= STATE_ERASE;
                             XFER::XFER_MODE_VERIFY:         state <= STATE_VERIFY;
                             XFER::XFER_MODE_FF:             state <= STATE_FF;
                             XFER::XFER_MODE_CRC:            state <= STATE_CRC;
@@ -1449,4 +2220,40 @@ module CRC7 #(
     end
 endmodule
 
+/***************************************************************
+ * CRC32 (ZIP 等と同じ多項式 EDB88320h, LSB ファースト)
+ *  OUT は反転済みなので CLEAR から ENABLE したバイト列の CRC32 になる
+ ***************************************************************/
+module CRC32 (
+    input wire          CLK,
+    input wire          RESET_n,
+    input wire          CLEAR,
+    input wire          ENABLE,
+    input wire  [7:0]   IN,
+    output wire [31:0]  OUT
+);
+    logic [31:0] ff;
+
+    assign OUT = ~ff;
+
+    function automatic [31:0] update(input [31:0] crc, input [7:0] data);
+        update = crc ^ 32'(data);
+        for(int i = 0; i < 8; i++) begin
+            update = update[0] ? ((update >> 1) ^ 32'hEDB88320) : (update >> 1);
+        end
+    endfunction
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            ff <= 32'hFFFFFFFF;
+        end
+        else if(CLEAR) begin
+            ff <= 32'hFFFFFFFF;
+        end
+        else if(ENABLE) begin
+            ff <= update(ff, IN);
+        end
+    end
+endmodule
+
 `default_nettype wire
@@ -0,0 +1,370 @@
+//
+// cartridge_dma.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+`default_nettype none
+
+/***************************************************************
+ * メモリマッパー DMA カートリッジ
+ *  I/O ポート
+ *   +0 W : レジスタ番号
+ *   +0 R : ステータス(読み終わると、読んだ完了フラグとエラーフラグをクリア)
+ *          bit7 = 転送中, bit1 = エラー, bit0 = 完了
+ *   +1 RW: レジスタ(アクセス毎にレジスタ番号 +1)
+ *  レジスタ
+ *   00h~02h : 転送元アドレス(マッパー RAM 先頭からのバイト位置 = セグメント番号 * 16K + オフセット)
+ *   03h~05h : 転送先アドレス(マッパー RAM または VRAM 先頭からのバイト位置)
+ *   06h~08h : 転送サイズ(バイト)
+ *   09h     : FILL データ
+ *   0Ah     : bit0 = 完了割り込み有効
+ *   0Bh     : コマンド(書き込むと転送開始)
+ *             bit0 = FILL(1)/COPY(0), bit1 = 転送先 VRAM(1)/マッパー RAM(0)
+ *  転送元, 転送先, サイズが全て 4 の倍数の時は 32bit 単位で転送する
+ *  マッパー RAM の範囲(RAM_SIZE)を超える転送は行わず、エラーと完了をセットする
+ *  Z80 のリフレッシュサイクルに合わせて WAIT をかけてメモリにアクセスする
+ ***************************************************************/
+module CARTRIDGE_DMA #(
+    parameter [7:0]         IO_BASE_ADDR = 8'h2C,
+    parameter [23:0]        RAM_ADDR = 0,
+    parameter [23:0]        RAM_SIZE = 24'h40_0000,
+    parameter [23:0]        VRAM_ADDR = 0,
+    parameter [23:0]        VRAM_SIZE = 24'h08_0000
+) (
+    input   wire            RESET_n,
+    input   wire            CLK,
+    BUS_IF.CARTRIDGE        Bus,
+    RAM_IF.HOST             Ram
+);
+    localparam [3:0] REG_SRC_L   = 4'h0;
+    localparam [3:0] REG_SRC_M   = 4'h1;
+    localparam [3:0] REG_SRC_H   = 4'h2;
+    localparam [3:0] REG_DST_L   = 4'h3;
+    localparam [3:0] REG_DST_M   = 4'h4;
+    localparam [3:0] REG_DST_H   = 4'h5;
+    localparam [3:0] REG_LEN_L   = 4'h6;
+    localparam [3:0] REG_LEN_M   = 4'h7;
+    localparam [3:0] REG_LEN_H   = 4'h8;
+    localparam [3:0] REG_FILL    = 4'h9;
+    localparam [3:0] REG_CONTROL = 4'hA;
+    localparam [3:0] REG_COMMAND = 4'hB;
+
+    localparam BIT_COMMAND_FILL = 0;
+    localparam BIT_COMMAND_VRAM = 1;
+    localparam BIT_CONTROL_INT  = 0;
+
+    /***************************************************************
+     * アドレスデコーダ
+     ***************************************************************/
+    wire cs_n     = Bus.IORQ_n || (Bus.ADDR[7:1] != IO_BASE_ADDR[7:1]);
+    wire io_wr_n  = cs_n || Bus.WR_n;
+    wire io_rd_n  = cs_n || Bus.RD_n;
+
+    /***************************************************************
+     * I/O リード/ライト検出
+     ***************************************************************/
+    logic prev_io_wr_n;
+    logic prev_io_rd_n;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_io_wr_n <= 1;
+        else if(!Bus.RESET_n) prev_io_wr_n <= 1;
+        else                  prev_io_wr_n <= io_wr_n;
+    end
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_io_rd_n <= 1;
+        else if(!Bus.RESET_n) prev_io_rd_n <= 1;
+        else                  prev_io_rd_n <= io_rd_n;
+    end
+    wire det_io_wr = prev_io_wr_n && !io_wr_n;
+    wire det_io_rd = prev_io_rd_n && !io_rd_n;
+    wire det_io_rd_end = !prev_io_rd_n && io_rd_n;
+
+    /***************************************************************
+     * 読み出しデータ
+     *  Z80 がデータを取り込むのはサイクルの終わりなので、読み出しの開始時に
+     *  値を保持し、レジスタ番号の更新とフラグのクリアは読み出しの終わりに行う
+     ***************************************************************/
+    logic [7:0] dout;
+    logic       rd_port;        // 読み出し中のポート(ADDR[0])
+
+    /***************************************************************
+     * レジスタ
+     ***************************************************************/
+    logic [3:0]  index;
+    logic [7:0]  regs[0:REG_COMMAND];
+    logic        start;
+    logic        busy;
+    logic        done;
+    logic        error;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n || !Bus.RESET_n) begin
+            index <= 0;
+            for(int i = 0; i <= REG_COMMAND; i++) regs[i] <= 0;
+            start <= 0;
+        end
+        else if(det_io_wr && Bus.ADDR[0] == 0) begin
+            index <= Bus.DIN[3:0];
+        end
+        else if(det_io_wr && Bus.ADDR[0] == 1) begin
+            if(index <= REG_COMMAND) regs[index] <= Bus.DIN;
+            if(index == REG_COMMAND && !busy) start <= 1;
+            index <= index + 1'd1;
+        end
+        else if(det_io_rd_end && rd_port == 1) begin
+            index <= index + 1'd1;
+        end
+        else if(busy) begin
+            start <= 0;
+        end
+    end
+
+    /***************************************************************
+     * レジスタ読み込み
+     ***************************************************************/
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            dout <= 8'hFF;
+            rd_port <= 0;
+        end
+        else if(det_io_rd) begin
+            dout <= (Bus.ADDR[0] == 0)     ? {busy, 5'd0, error, done} :
+                    (index <= REG_COMMAND) ? regs[index] : 8'hFF;
+            rd_port <= Bus.ADDR[0];
+        end
+    end
+
+    assign Bus.BUSDIR_n = io_rd_n;
+    assign Bus.DOUT = io_rd_n ? 8'h00 : dout;
+
+    /***************************************************************
+     * 割り込み
+     ***************************************************************/
+    assign Bus.INT_n = !(done && regs[REG_CONTROL][BIT_CONTROL_INT]);
+
+    /***************************************************************
+     * 転送
+     ***************************************************************/
+    wire [23:0] reg_src  = { regs[REG_SRC_H], regs[REG_SRC_M], regs[REG_SRC_L] };
+    wire [23:0] reg_dst  = { regs[REG_DST_H], regs[REG_DST_M], regs[REG_DST_L] };
+    wire [23:0] reg_len  = { regs[REG_LEN_H], regs[REG_LEN_M], regs[REG_LEN_L] };
+    wire        cmd_fill = regs[REG_COMMAND][BIT_COMMAND_FILL];
+    wire        cmd_vram = regs[REG_COMMAND][BIT_COMMAND_VRAM];
+
+    logic [23:0] src;           // 転送元(マッパー RAM 内の位置)
+    logic [23:0] dst;           // 転送先(マッパー RAM または VRAM 内の位置)
+    logic [23:0] remain;
+    logic        wide;          // 32bit 単位で転送
+    logic        fill;
+    logic        vram;
+    logic [31:0] data;
+
+    // 転送範囲がマッパー RAM に収まっているか(RAM_SIZE は 2 の累乗とは限らない)
+    wire [24:0] src_end  = reg_src + reg_len;
+    wire [24:0] dst_end  = reg_dst + reg_len;
+    wire        range_ok = (cmd_fill || src_end <= RAM_SIZE) && (cmd_vram || dst_end <= RAM_SIZE);
+
+    wire [23:0] src_addr = RAM_ADDR + src;
+    wire [23:0] dst_addr = vram ? (VRAM_ADDR + (dst & (VRAM_SIZE - 1'd1))) : (RAM_ADDR + dst);
+    wire [2:0]  step = wide ? 3'd4 : 3'd1;
+
+    enum logic [3:0] {
+        STATE_IDLE,
+        STATE_NEXT,
+        STATE_WAIT_Z80,
+        STATE_WAIT_RFSH,
+        STATE_RFSH_REQ,
+        STATE_RFSH_WAIT_ACK,
+        STATE_RFSH_WAIT_BUSY,
+        STATE_ACCESS_REQ,
+        STATE_ACCESS_WAIT_ACK,
+        STATE_ACCESS_WAIT_BUSY
+    } state;
+    logic write;                // 今回のアクセスが書き込みか
+
+    assign busy = state != STATE_IDLE;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            state <= STATE_IDLE;
+            done <= 0;
+            error <= 0;
+            write <= 0;
+            src <= 0;
+            dst <= 0;
+            remain <= 0;
+            wide <= 0;
+            fill <= 0;
+            vram <= 0;
+            data <= 0;
+            Bus.WAIT_n <= 1;
+            Ram.ADDR <= 0;
+            Ram.DIN <= 0;
+            Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+            Ram.OE_n <= 1;
+            Ram.WE_n <= 1;
+            Ram.RFSH_n <= 1;
+        end
+        else if(!Bus.RESET_n) begin
+            state <= STATE_IDLE;
+            done <= 0;
+            error <= 0;
+            Bus.WAIT_n <= 1;
+            Ram.ADDR <= 0;
+            Ram.DIN <= 0;
+            Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+            Ram.OE_n <= 1;
+            Ram.WE_n <= 1;
+            Ram.RFSH_n <= 1;
+        end
+        else begin
+            // ステータスを読み終えたら、読んだ完了フラグとエラーフラグをクリア
+            // (読み出し中にセットされたフラグは次の読み出しまで残す)
+            if(det_io_rd_end && rd_port == 0) begin
+                if(dout[0]) done <= 0;
+                if(dout[1]) error <= 0;
+            end
+
+            case (state)
+                STATE_IDLE:
+                begin
+                    if(start) begin
+                        src <= reg_src;
+                        dst <= reg_dst;
+                        // 範囲外なら何もせずに完了する
+                        remain <= range_ok ? reg_len : 24'd0;
+                        error <= !range_ok;
+                        wide <= (reg_src[1:0] == 0) && (reg_dst[1:0] == 0) && (reg_len[1:0] == 0);
+                        fill <= cmd_fill;
+                        vram <= cmd_vram;
+                        data <= {4{regs[REG_FILL]}};
+                        done <= 0;
+                        write <= cmd_fill;
+                        state <= STATE_NEXT;
+                    end
+                end
+
+                // 次のアクセス
+                STATE_NEXT:
+                begin
+                    if(remain == 0) begin
+                        done <= 1;
+                        state <= STATE_IDLE;
+                    end
+                    else begin
+                        state <= STATE_WAIT_Z80;
+                    end
+                end
+
+                // Z80 のリフレッシュサイクル開始を待つ
+                STATE_WAIT_Z80:
+                begin
+                    if(Bus.RFSH_n) state <= STATE_WAIT_RFSH;
+                end
+                STATE_WAIT_RFSH:
+                begin
+                    if(Bus.RD_n && Bus.WR_n && !Bus.RFSH_n) begin
+                        Bus.WAIT_n <= 0;
+                        state <= STATE_RFSH_REQ;
+                    end
+                end
+
+                // SDRAM のリフレッシュを先に済ませる
+                STATE_RFSH_REQ:
+                begin
+                    Ram.RFSH_n <= 0;
+                    state <= STATE_RFSH_WAIT_ACK;
+                end
+                STATE_RFSH_WAIT_ACK:
+                begin
+                    if(Ram.ACK_n == 0) begin
+                        Ram.RFSH_n <= 1;
+                        state <= STATE_RFSH_WAIT_BUSY;
+                    end
+                end
+                STATE_RFSH_WAIT_BUSY:
+                begin
+                    if(Ram.ACK_n == 1) state <= STATE_ACCESS_REQ;
+                end
+
+                // 読み込みまたは書き込み
+                STATE_ACCESS_REQ:
+                begin
+                    Ram.ADDR <= write ? dst_addr : src_addr;
+                    Ram.DIN <= write ? data : 0;
+                    Ram.DIN_SIZE <= wide ? RAM::DIN_SIZE_32 : RAM::DIN_SIZE_8;
+                    Ram.OE_n <= write;
+                    Ram.WE_n <= !write;
+                    state <= STATE_ACCESS_WAIT_ACK;
+                end
+                STATE_ACCESS_WAIT_ACK:
+                begin
+                    if(Ram.ACK_n == 0) begin
+                        Ram.ADDR <= 0;
+                        Ram.DIN <= 0;
+                        Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+                        Ram.OE_n <= 1;
+                        Ram.WE_n <= 1;
+                        state <= STATE_ACCESS_WAIT_BUSY;
+                    end
+                end
+                STATE_ACCESS_WAIT_BUSY:
+                begin
+                    if(Ram.ACK_n == 1) begin
+                        Bus.WAIT_n <= 1;
+                        if(write) begin
+                            // 書いたら次の位置へ
+                            dst <= dst + step;
+                            remain <= remain - step;
+                            write <= fill;
+                            state <= STATE_NEXT;
+                        end
+                        else begin
+                            // 読んだら書き込み
+                            data <= wide ? Ram.DOUT : {24'd0, Ram.DOUT[7:0]};
+                            src <= src + step;
+                            write <= 1;
+                            state <= STATE_WAIT_Z80;
+                        end
+                    end
+                end
+
+                default:
+                begin
+                    state <= STATE_IDLE;
+                end
+            endcase
+        end
+    end
+
+endmodule
+
+`default_nettype wire
@@ -47,6 +47,8 @@ module CARTRIDGE_FM #(
     RAM_IF.HOST             Ram,
     PAC_IF.HOST             PAC,
     SOUND_IF.OUT            Sound,
+    SOUND_IF.OUT            SoundCh[0:1],   // メロディ/リズム毎の出力(ステレオ出力用)
+    SOUND_REG_IF.OUT        Reg,            // レジスタ書き込み通知(VGM ロガー用)
     output  wire            Output_En
 );
     localparam [7:0]    IO_BASE_ADDR = 8'h7C;
@@ -67,14 +69,15 @@ module CARTRIDGE_FM #(
         .Bus,
         .Ram,
         .ExtBus,
-        .SramEnable(PAC.SramEnable)
+        .SramEnable(PAC.SramEnable),
+        .Dirty(PAC.Dirty),
+        .DirtyClear(PAC.DirtyClear)
     );
 
     /***************************************************************
      * 未使用の出力信号の処理
      ***************************************************************/
     assign ExtBus[0].INT_n = 1;
-    assign ExtBus[0].WAIT_n = 1;
 
     /***************************************************************
      * メモリリード/ライト
@@ -123,6 +126,7 @@ module CARTRIDGE_FM #(
     /***************************************************************
      * リード
      ***************************************************************/
+    wire opll_nowait;   // 書き込みウェイト不要
     always_ff @(posedge CLK or negedge RESET_n) begin
         if(!RESET_n || !ExtBus[0].RESET_n) begin
             ExtBus[0].BUSDIR_n <= 1;
@@ -133,10 +137,10 @@ module CARTRIDGE_FM #(
             ExtBus[0].BUSDIR_n <= 1;
             ExtBus[0].DOUT <= 0;
         end
-        // IO SWITCH(7FF6h)
+        // IO SWITCH(7FF6h, bit7 はウェイト不要フラグ)
         else if(!cs_mem_iosw_n) begin
             ExtBus[0].BUSDIR_n <= 0;
-            ExtBus[0].DOUT <= iosw_reg;
+            ExtBus[0].DOUT <= { opll_nowait, iosw_reg[6:0] };
         end
         // NO DATA AREA
         else begin
@@ -145,13 +149,145 @@ module CARTRIDGE_FM #(
         end
     end
 
-if(CONFIG::ENABLE_FM == CONFIG::ENABLE_IKAOPLL) begin
     /***************************************************************
-     * IKA OPLL
+     * OPLL アドレスデコード
      ***************************************************************/
     wire cs_io_n = ((ExtBus[0].ADDR[7:1] != IO_BASE_ADDR[7:1]) || ExtBus[0].IORQ_n) || !ena_io;                // 7Ch~7Dh
     wire cs_mem_opll_n = (ExtBus[0].ADDR[15:1] != MIO_BASE_ADDR[15:1]) || ExtBus[0].MERQ_n || ExtBus[0].SLTSL_n;    // 7FF4h~7FF5h
 
+    /***************************************************************
+     * レジスタ書き込み通知
+     *  7Ch(7FF4h) で選択したレジスタ番号と 7Dh(7FF5h) の書き込みデータを
+     *  書き込みサイクルの終わりで通知する
+     ***************************************************************/
+    wire wr_opll = !(cs_io_n && cs_mem_opll_n) && !ExtBus[0].WR_n;
+    logic prev_wr_data;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n || !ExtBus[0].RESET_n) begin
+            prev_wr_data <= 0;
+            Reg.WR <= 0;
+            Reg.ADDR <= 0;
+            Reg.DATA <= 0;
+        end
+        else begin
+            prev_wr_data <= wr_opll && ExtBus[0].ADDR[0];
+            Reg.WR <= prev_wr_data && !(wr_opll && ExtBus[0].ADDR[0]);
+            if(wr_opll && !ExtBus[0].ADDR[0]) Reg.ADDR <= ExtBus[0].DIN;
+            if(wr_opll &&  ExtBus[0].ADDR[0]) Reg.DATA <= ExtBus[0].DIN;
+        end
+    end
+    assign Reg.PORT = 0;
+
+    /***************************************************************
+     * OPLL へのバス信号
+     ***************************************************************/
+    wire        opll_cs_n;
+    wire        opll_wr_n;
+    wire        opll_a0;
+    wire [7:0]  opll_din;
+
+if(CONFIG::ENABLE_FM_NOWAIT) begin
+    /***************************************************************
+     * 書き込み FIFO
+     *  CPU からの書き込みを FIFO に溜めて、OPLL が受け付けられる間隔
+     *  (アドレス書き込み後 12 クロック、データ書き込み後 84 クロック)で書き込む
+     *  CPU 側のウェイトは不要で、FIFO が一杯の時だけ WAIT を入れる
+     ***************************************************************/
+    localparam FIFO_DEPTH = 32;
+    localparam WR_PULSE = 2;
+    localparam WAIT_ADDR = 12;
+    localparam WAIT_DATA = 84;
+
+    assign opll_nowait = 1;
+
+    // 書き込みサイクルの終わりで FIFO に格納
+    logic       prev_wr_opll;
+    logic       wr_a0;
+    logic [7:0] wr_data;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n || !ExtBus[0].RESET_n) begin
+            prev_wr_opll <= 0;
+            wr_a0 <= 0;
+            wr_data <= 0;
+        end
+        else begin
+            prev_wr_opll <= wr_opll;
+            if(wr_opll) begin
+                wr_a0 <= ExtBus[0].ADDR[0];
+                wr_data <= ExtBus[0].DIN;
+            end
+        end
+    end
+
+    logic [8:0] fifo[0:FIFO_DEPTH-1];
+    logic [$clog2(FIFO_DEPTH):0] fifo_wp;
+    logic [$clog2(FIFO_DEPTH):0] fifo_rp;
+    wire fifo_empty = fifo_wp == fifo_rp;
+    wire fifo_full  = (fifo_wp - fifo_rp) == FIFO_DEPTH;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n || !ExtBus[0].RESET_n) begin
+            fifo_wp <= 0;
+        end
+        else if(prev_wr_opll && !wr_opll) begin
+            fifo[fifo_wp[$clog2(FIFO_DEPTH)-1:0]] <= { wr_a0, wr_data };
+            fifo_wp <= fifo_wp + 1'd1;
+        end
+    end
+
+    // FIFO が一杯の時は空くまで待たせる
+    assign ExtBus[0].WAIT_n = !(!(cs_io_n && cs_mem_opll_n) && fifo_full);
+
+    // OPLL へ書き込み
+    logic       out_wr_n;
+    logic       out_a0;
+    logic [7:0] out_data;
+    logic       busy;
+    logic [6:0] phase;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n || !ExtBus[0].RESET_n) begin
+            fifo_rp <= 0;
+            out_wr_n <= 1;
+            out_a0 <= 0;
+            out_data <= 0;
+            busy <= 0;
+            phase <= 0;
+        end
+        else if(!busy) begin
+            if(!fifo_empty) begin
+                { out_a0, out_data } <= fifo[fifo_rp[$clog2(FIFO_DEPTH)-1:0]];
+                fifo_rp <= fifo_rp + 1'd1;
+                busy <= 1;
+                phase <= 0;
+            end
+        end
+        else if(ExtBus[0].CLK_EN) begin
+            // アドレス/データを出した次のクロックから WR_PULSE クロックの間 WR_n を出す
+            phase <= phase + 1'd1;
+            out_wr_n <= !(phase < WR_PULSE);
+            if(phase == (out_a0 ? WAIT_DATA : WAIT_ADDR)) busy <= 0;
+        end
+    end
+
+    assign opll_cs_n = out_wr_n;
+    assign opll_wr_n = out_wr_n;
+    assign opll_a0   = out_a0;
+    assign opll_din  = out_data;
+end
+else begin
+    assign opll_nowait = 0;
+    assign ExtBus[0].WAIT_n = 1;
+    assign opll_cs_n = cs_io_n && cs_mem_opll_n;
+    assign opll_wr_n = ExtBus[0].WR_n;
+    assign opll_a0   = ExtBus[0].ADDR[0];
+    assign opll_din  = ExtBus[0].DIN;
+end
+
+if(CONFIG::ENABLE_FM == CONFIG::ENABLE_IKAOPLL) begin
+    /***************************************************************
+     * IKA OPLL
+     ***************************************************************/
+
     wire dac_stb;
     wire [15:0] dac_sig;
 
@@ -169,11 +305,11 @@ if(CONFIG::ENABLE_FM == CONFIG::ENABLE_IKAOPLL) begin
         .i_IC_n                     (ExtBus[0].RESET_n          ),
         .i_ALTPATCH_EN              (1'b0                       ),
 
-        .i_CS_n                     (cs_io_n && cs_mem_opll_n   ),
-        .i_WR_n                     (ExtBus[0].WR_n             ),
-        .i_A0                       (ExtBus[0].ADDR[0]          ),
+        .i_CS_n                     (opll_cs_n                  ),
+        .i_WR_n                     (opll_wr_n                  ),
+        .i_A0                       (opll_a0                    ),
 
-        .i_D                        (ExtBus[0].DIN              ),
+        .i_D                        (opll_din                   ),
         .o_D                        (                           ),
         .o_D_OE                     (                           ),
 
@@ -215,6 +351,18 @@ if(CONFIG::ENABLE_FM == CONFIG::ENABLE_IKAOPLL) begin
         end
     end
 
+    // メロディとリズムは分離できないので全てメロディに出力
+    wire [23:0] dac_sig_ch = {dac_sig[12:0], 11'd0};
+    always_ff @(posedge Bus.CLK_21M or negedge RESET_n) begin
+        if(!RESET_n) begin
+            SoundCh[0].Signal <= 0;
+        end
+        else if(!dac_stb_delay && dac_stb) begin
+            SoundCh[0].Signal <= dac_sig_ch[23:24-$bits(SoundCh[0].Signal)];
+        end
+    end
+    assign SoundCh[1].Signal = 0;
+
 end
 else if(CONFIG::ENABLE_FM == CONFIG::ENABLE_VM2413) begin
     /***************************************************************
@@ -222,15 +370,13 @@ else if(CONFIG::ENABLE_FM == CONFIG::ENABLE_VM2413) begin
      ***************************************************************/
     wire unsigned [9:0]           ro;
     wire unsigned [$bits(ro)-1:0] mo;
-    wire cs_io_n = ((ExtBus[0].ADDR[7:1] != IO_BASE_ADDR[7:1]) || ExtBus[0].IORQ_n) || !ena_io;                // 7Ch~7Dh
-    wire cs_mem_opll_n = (ExtBus[0].ADDR[15:1] != MIO_BASE_ADDR[15:1]) || ExtBus[0].MERQ_n || ExtBus[0].SLTSL_n;    // 7FF4h~7FF5h
     opll u_vm2413 (
         .xin        (ExtBus[0].CLK_21M),
         .xena       (ExtBus[0].CLK_EN_21M),
-        .d          (ExtBus[0].DIN),
-        .a          (ExtBus[0].ADDR[0]),
-        .cs_n       (cs_io_n && cs_mem_opll_n),
-        .we_n       (ExtBus[0].WR_n),
+        .d          (opll_din),
+        .a          (opll_a0),
+        .cs_n       (opll_cs_n),
+        .we_n       (opll_wr_n),
         .ic_n       (ExtBus[0].RESET_n),
         .mo         (mo),
         .ro         (ro)
@@ -286,6 +432,20 @@ else if(CONFIG::ENABLE_FM == CONFIG::ENABLE_VM2413) begin
             out_ff <= out0;
         end
     end
+
+    // メロディとリズムを別々に出力
+    wire [23:0] mo_ch = {lpf_mo, 14'd0};
+    wire [23:0] ro_ch = {lpf_ro, 14'd0};
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            SoundCh[0].Signal <= 0;
+            SoundCh[1].Signal <= 0;
+        end
+        else begin
+            SoundCh[0].Signal <= mo_ch[23:24-$bits(SoundCh[0].Signal)];
+            SoundCh[1].Signal <= ro_ch[23:24-$bits(SoundCh[1].Signal)];
+        end
+    end
 end
 
 endmodule
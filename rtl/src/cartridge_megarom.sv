@@ -49,6 +49,9 @@ module CARTRIDGE_MEGAROM #(
     parameter [23:0]    FLASH_PAC_SIZE              = 0,
     parameter [23:0]    RAM_ADDR                    = 0,
     parameter [23:0]    RAM_SIZE                    = 0,
+    parameter [23:0]    FLASH_MIXER_ADDR            = 0,
+    parameter [23:0]    RAM_MIXER_ADDR              = 0,
+    parameter [23:0]    RAM_SRAM_ADDR               = 0,
     parameter [7:0]     DEFAULT_BANK_REG_INIT_0     = 0,
     parameter [7:0]     DEFAULT_BANK_REG_INIT_1     = 0,
     parameter [7:0]     DEFAULT_BANK_REG_INIT_2     = 0,
@@ -66,14 +69,25 @@ module CARTRIDGE_MEGAROM #(
     parameter [0:0]     DEFAULT_SCC_ENA             = 1'b0,
     parameter [0:0]     DEFAULT_SCC_I_ENA           = 1'b0,
     parameter [0:0]     DEFAULT_ENABLE_CONTINUOUS   = 1'b0,
-    parameter [0:0]     DEFAULT_ENABLE              = 1'b0
+    parameter [0:0]     DEFAULT_ENABLE              = 1'b0,
+    parameter           DEFAULT_MIX_GAIN            = 0,
+    parameter           ENABLE_PAN                  = 0,
+    parameter           DEFAULT_PAN_GAIN            = 0,
+    parameter [7:0]     BOARD_ID                    = 0,
+    parameter [7:0]     FIRMWARE_VERSION            = 0,
+    parameter [15:0]    FEATURES                    = 0
 ) (
     input   wire            RESET_n,
     input   wire            CLK,
     BUS_IF.CARTRIDGE        Bus,
     RAM_IF.HOST             Ram,
     XFER_IF.HOST            Xfer,
-    SOUND_IF.OUT            Sound
+    PAC_IF.HOST             Sram,           // SRAM の保存(PAC と同じ経路でフラッシュへ保存する)
+    MIXER_IF.DEVICE         Mixer,
+    MIXER_IF.DEVICE         Pan,
+    SOUND_IF.OUT            Sound,
+    SOUND_IF.OUT            SoundCh[0:4],   // チャンネル毎の出力(ステレオ出力用)
+    SOUND_REG_IF.OUT        SccReg          // SCC レジスタ書き込み通知(VGM ロガー用)
 );
 
     /***************************************************************
@@ -95,6 +109,8 @@ module CARTRIDGE_MEGAROM #(
         .FLASH_PAC_SIZE         (FLASH_PAC_SIZE),
         .RAM_ADDR               (RAM_ADDR),
         .RAM_SIZE               (RAM_SIZE),
+        .FLASH_MIXER_ADDR       (FLASH_MIXER_ADDR),
+        .RAM_MIXER_ADDR         (RAM_MIXER_ADDR),
         .DEFAULT_BANK_REG_INIT_0(DEFAULT_BANK_REG_INIT_0),
         .DEFAULT_BANK_REG_INIT_1(DEFAULT_BANK_REG_INIT_1),
         .DEFAULT_BANK_REG_INIT_2(DEFAULT_BANK_REG_INIT_2),
@@ -112,13 +128,21 @@ module CARTRIDGE_MEGAROM #(
         .DEFAULT_SCC_ENA(DEFAULT_SCC_ENA),
         .DEFAULT_SCC_I_ENA(DEFAULT_SCC_I_ENA),
         .DEFAULT_ENABLE_CONTINUOUS(DEFAULT_ENABLE_CONTINUOUS),
-        .DEFAULT_ENABLE(DEFAULT_ENABLE)
+        .DEFAULT_ENABLE(DEFAULT_ENABLE),
+        .DEFAULT_MIX_GAIN(DEFAULT_MIX_GAIN),
+        .ENABLE_PAN(ENABLE_PAN),
+        .DEFAULT_PAN_GAIN(DEFAULT_PAN_GAIN),
+        .BOARD_ID(BOARD_ID),
+        .FIRMWARE_VERSION(FIRMWARE_VERSION),
+        .FEATURES(FEATURES)
     ) u_conf (
         .RESET_n,
         .CLK,
         .Bus(ExtBus[BUS_CONFIG]),
         .Xfer(Xfer),
         .Megarom,
+        .Mixer,
+        .Pan,
         .SCC_ENA,
         .SCC_I_ENA
     );
@@ -146,6 +170,8 @@ module CARTRIDGE_MEGAROM #(
     assign BankEnable[3] = BankEnable_SCC[3];
 
     MEGAROM_CONTROLLER #(
+        .RAM_ADDR_SRAM(RAM_SRAM_ADDR),
+        .RAM_SIZE(RAM_SIZE),
         .COUNT(BUS_COUNT),
         .USE_FF(1)
     ) u_rom (
@@ -156,7 +182,10 @@ module CARTRIDGE_MEGAROM #(
         .WriteProtect,
         .Bus,
         .Ram,
-        .ExtBus
+        .ExtBus,
+        .SramEnable(Sram.SramEnable),
+        .Dirty(Sram.Dirty),
+        .DirtyClear(Sram.DirtyClear)
     );
 
     /***************************************************************
@@ -227,10 +256,87 @@ module CARTRIDGE_MEGAROM #(
             else                              scc_cs_n <= ExtBus[BUS_SCC].ADDR[15:8] != 8'h98;
         end
 
+        // SCC レジスタ領域の選択
+        wire scc_reg_cs_n = scc_cs_n || ExtBus[BUS_SCC].SLTSL_n || ExtBus[BUS_SCC].MERQ_n || !SCC_ENA || scc_bank_n;
+
+        /***************************************************************
+         * レジスタ書き込み通知
+         *  書き込みサイクルの終わりで VGM の D2 コマンドのポート番号に変換して通知する
+         *   SCC   : 00h~7Fh 波形(0), 80h~89h 周波数(1), 8Ah~8Eh 音量(2), 8Fh ON/OFF(3), E0h~FFh TEST(5)
+         *   SCC-I : 00h~9Fh 波形(4), A0h~A9h 周波数(1), AAh~AEh 音量(2), AFh ON/OFF(3), C0h~DFh TEST(5)
+         ***************************************************************/
+        wire scc_wr = !scc_reg_cs_n && !ExtBus[BUS_SCC].WR_n;
+        logic prev_scc_wr;
+        logic [7:0] scc_wr_addr;
+        logic [7:0] scc_wr_data;
+        always_ff @(posedge CLK or negedge RESET_n) begin
+            if(!RESET_n || !ExtBus[BUS_SCC].RESET_n) begin
+                prev_scc_wr <= 0;
+                scc_wr_addr <= 0;
+                scc_wr_data <= 0;
+            end
+            else begin
+                prev_scc_wr <= scc_wr;
+                if(scc_wr) begin
+                    scc_wr_addr <= ExtBus[BUS_SCC].ADDR[7:0];
+                    scc_wr_data <= ExtBus[BUS_SCC].DIN;
+                end
+            end
+        end
+        wire scc_wr_end = prev_scc_wr && !scc_wr;
+
+        wire [3:0] scc_reg_row = scc_mode_scci ? (scc_wr_addr[7:4] - 4'h2) : scc_wr_addr[7:4];  // 周波数/音量を 8xh に揃える
+        always_ff @(posedge CLK or negedge RESET_n) begin
+            if(!RESET_n || !ExtBus[BUS_SCC].RESET_n) begin
+                SccReg.WR <= 0;
+                SccReg.PORT <= 0;
+                SccReg.ADDR <= 0;
+                SccReg.DATA <= 0;
+            end
+            else begin
+                SccReg.WR <= 0;
+                SccReg.DATA <= scc_wr_data;
+                if(scc_wr_end) begin
+                    SccReg.WR <= 1;
+                    if(scc_mode_scci ? (scc_wr_addr < 8'hA0) : !scc_wr_addr[7]) begin
+                        // 波形
+                        SccReg.PORT <= scc_mode_scci ? 8'd4 : 8'd0;
+                        SccReg.ADDR <= scc_wr_addr;
+                    end
+                    else if(scc_reg_row == 4'h8 && scc_wr_addr[3:0] < 4'd10) begin
+                        // 周波数
+                        SccReg.PORT <= 8'd1;
+                        SccReg.ADDR <= { 4'd0, scc_wr_addr[3:0] };
+                    end
+                    else if(scc_reg_row == 4'h8 && scc_wr_addr[3:0] < 4'd15) begin
+                        // 音量
+                        SccReg.PORT <= 8'd2;
+                        SccReg.ADDR <= { 4'd0, scc_wr_addr[3:0] - 4'd10 };
+                    end
+                    else if(scc_reg_row == 4'h8) begin
+                        // ON/OFF
+                        SccReg.PORT <= 8'd3;
+                        SccReg.ADDR <= 0;
+                    end
+                    else if(scc_wr_addr[7:5] == (scc_mode_scci ? 3'b110 : 3'b111)) begin
+                        // TEST
+                        SccReg.PORT <= 8'd5;
+                        SccReg.ADDR <= 0;
+                    end
+                    else begin
+                        // レジスタなし
+                        SccReg.WR <= 0;
+                    end
+                end
+            end
+        end
+
         // sound module
         logic busdir_n;
         logic [7:0] dout;
         wire  [10:0] sound;
+        wire         sound_update;
+        wire  [10:0] ch_sound[0:4];
         if(CONFIG::ENABLE_SCC == CONFIG::ENABLE_IKASCC) begin
             /***************************************************************
              * IKASCC
@@ -270,6 +376,21 @@ module CARTRIDGE_MEGAROM #(
                 dout <= db_oe ? db_o : 8'd0;
             end
 
+            // 補間フィルタ用の出力更新タイミング(CLK_EN の 1/16)
+            logic [3:0] update_cnt;
+            always_ff @(posedge CLK or negedge RESET_n) begin
+                if(!RESET_n)                    update_cnt <= 0;
+                else if(ExtBus[BUS_SCC].CLK_EN) update_cnt <= update_cnt + 1'd1;
+            end
+            assign sound_update = ExtBus[BUS_SCC].CLK_EN && update_cnt == 0;
+
+            // チャンネル毎の出力は無いので全て 0ch に出力
+            assign ch_sound[0] = sound;
+            assign ch_sound[1] = 0;
+            assign ch_sound[2] = 0;
+            assign ch_sound[3] = 0;
+            assign ch_sound[4] = 0;
+
             IKASCC #(
                 .IMPL_TYPE      (0),
                 .RAM_BLOCK      (1)
@@ -300,25 +421,62 @@ module CARTRIDGE_MEGAROM #(
             /***************************************************************
              * default SCC
              ***************************************************************/
+            wire [7:0] ch_out[0:4];
             SCC u_scc (
                 .RESET_n    (RESET_n && ExtBus[BUS_SCC].RESET_n),
                 .CLK        (CLK),
                 .CLK_EN     (ExtBus[BUS_SCC].CLK_EN),
                 .MODE_SCC_I (scc_mode_scci),
                 .ADDR       (ExtBus[BUS_SCC].ADDR[7:0]),
-                .CS_n       (scc_cs_n || ExtBus[BUS_SCC].SLTSL_n || ExtBus[BUS_SCC].MERQ_n || !SCC_ENA || scc_bank_n),
+                .CS_n       (scc_reg_cs_n),
                 .RD_n       (ExtBus[BUS_SCC].RD_n),
                 .WR_n       (ExtBus[BUS_SCC].WR_n),
                 .DIN        (ExtBus[BUS_SCC].DIN),
                 .DOUT       (dout),
                 .BUSDIR_n   (busdir_n),
-                .OUT        (sound)
+                .OUT        (sound),
+                .OUT_UPDATE (sound_update),
+                .CH_OUT     (ch_out)
             );
+
+            genvar ch;
+            for(ch = 0; ch < 5; ch = ch + 1) begin: ch_loop
+                assign ch_sound[ch] = ch_out[ch][7] ? {3'b111, ch_out[ch]} : {3'b000, ch_out[ch]};
+            end
         end
 
-        wire [15:0] sound_ext = { sound, 5'd0 };
+        wire [15:0] sound_ext;
+        if(CONFIG::ENABLE_SCC_FILTER) begin
+            /***************************************************************
+             * 補間フィルタ
+             *  SCC の出力(CLK_EN の 1/16 毎に更新)を CLK_EN 毎に補間する
+             ***************************************************************/
+            SOUND_INTERPOLATOR #(
+                .IN_WIDTH($bits(sound)),
+                .OUT_WIDTH($bits(sound_ext)),
+                .RATIO(16),
+                .ORDER(4)
+            ) u_interpolator (
+                .CLK,
+                .RESET_n,
+                .CLK_EN(ExtBus[BUS_SCC].CLK_EN),
+                .IN_EN(sound_update),
+                .IN(sound),
+                .OUT(sound_ext)
+            );
+        end
+        else begin
+            assign sound_ext = { sound, 5'd0 };
+        end
         assign Sound.Signal = sound_ext[15:16-$bits(Sound.Signal)];
 
+        // チャンネル毎の出力(Sound と同じ音量になるように上位ビットを揃える)
+        genvar sound_ch;
+        for(sound_ch = 0; sound_ch < 5; sound_ch = sound_ch + 1) begin: sound_ch_loop
+            wire [23:0] ch_ext = { ch_sound[sound_ch], 13'd0 };
+            assign SoundCh[sound_ch].Signal = ch_ext[23:24-$bits(SoundCh[sound_ch].Signal)];
+        end
+
         assign ExtBus[BUS_SCC].BUSDIR_n = busdir_n;
         assign ExtBus[BUS_SCC].DOUT = dout;
     end
@@ -326,6 +484,11 @@ module CARTRIDGE_MEGAROM #(
         assign ExtBus[BUS_SCC].BUSDIR_n = 1;
         assign ExtBus[BUS_SCC].DOUT = 0;
         assign Sound.Signal = 0;
+        always_comb SccReg.connect_dummy();
+        genvar sound_ch;
+        for(sound_ch = 0; sound_ch < 5; sound_ch = sound_ch + 1) begin: sound_ch_loop
+            assign SoundCh[sound_ch].Signal = 0;
+        end
         assign BankEnable_SCC[0] = 1'b1;
         assign BankEnable_SCC[1] = 1'b1;
         assign BankEnable_SCC[2] = 1'b1;
@@ -57,15 +57,20 @@ module CARTRIDGE_NEXTOR #(
     assign Megarom.BankRegAddr[1]    = 16'h6800;             // バンク#1 レジスタアドレス
 //  assign Megarom.BankRegAddr[2]    = 16'h7000;             // バンク#2 レジスタアドレス
 //  assign Megarom.BankRegAddr[3]    = 16'h7800;             // バンク#3 レジスタアドレス
-    assign Megarom.BankRegMask       = 8'hFF;                // バンクレジスタマスク
-    assign Megarom.BankRegInit[0]    = 8'h00;                // バンク#0 初期値
-    assign Megarom.BankRegInit[1]    = 8'h00;                // バンク#1 初期値
-//  assign Megarom.BankRegInit[2]    = 8'h00;                // バンク#2 初期値
-//  assign Megarom.BankRegInit[3]    = 8'h00;                // バンク#3 初期値
+    assign Megarom.BankRegHighAddr   = 16'h0000;             // 上位バンクレジスタアドレス(未使用)
+    assign Megarom.BankRegMask       = 12'h0FF;              // バンクレジスタマスク
+    assign Megarom.BankRegInit[0]    = 12'h000;              // バンク#0 初期値
+    assign Megarom.BankRegInit[1]    = 12'h000;              // バンク#1 初期値
+//  assign Megarom.BankRegInit[2]    = 12'h000;              // バンク#2 初期値
+//  assign Megarom.BankRegInit[3]    = 12'h000;              // バンク#3 初期値
     assign Megarom.WriteProtect      = 1;                    // 書き込み禁止
     assign Megarom.is_16k_bank       = 0;                    // バンクサイズ 8KB
     assign Megarom.CS1_Mask          = 0;                    // 4000h~7FFFh 有効
     assign Megarom.CS2_Mask          = 1;                    // 8000h=BFFFh 無効
+    assign Megarom.SramMask          = 0;                    // SRAM なし
+    assign Megarom.SramWriteEnable   = 0;                    // SRAM 書き込み禁止
+    assign Megarom.SramPage4K        = 0;                    // 未使用
+    assign Megarom.SramAddrMask      = 0;                    // 未使用
 
     /***************************************************************
      * メガロムコントローラ
@@ -82,7 +87,10 @@ module CARTRIDGE_NEXTOR #(
         .WriteProtect(4'b1111),
         .Bus,
         .Ram,
-        .ExtBus
+        .ExtBus,
+        .SramEnable(),
+        .Dirty(),
+        .DirtyClear(1'b0)
     );
 
     /***************************************************************
@@ -92,7 +100,7 @@ module CARTRIDGE_NEXTOR #(
         .RESET_n,
         .CLK,
         .Bus(ExtBus[0]),
-        .ENA_n(Megarom.BankReg[0] != 8'h40),
+        .ENA_n(Megarom.BankReg[0] != 12'h040),
         .TF,
         .Led
     );
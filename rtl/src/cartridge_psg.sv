@@ -43,7 +43,9 @@ module CARTRIDGE_PSG #(
     input   wire            RESET_n,
     input   wire            CLK,
     BUS_IF.CARTRIDGE        Bus,
-    SOUND_IF.OUT            Sound
+    SOUND_IF.OUT            Sound,
+    SOUND_IF.OUT            SoundCh[0:2],   // チャンネル毎の出力(ステレオ出力用)
+    SOUND_REG_IF.OUT        Reg             // レジスタ書き込み通知(VGM ロガー用)
 );
 
     /***************************************************************
@@ -71,6 +73,7 @@ module CARTRIDGE_PSG #(
     /***************************************************************
      * ym2149_audio
      ***************************************************************/
+    logic [11:0] ch_out[0:2];
     ym2149_audio u_ym2149_audio (
         .clk_i          (CLK),
         .en_clk_psg_i   (Bus.CLK_EN),
@@ -80,13 +83,37 @@ module CARTRIDGE_PSG #(
         .bdir_i         ((cs_addr || cs_write) && cs_psg),
         .data_i         (Bus.DIN),
         .data_r_o       (dout),
-        .ch_a_o         (),
-        .ch_b_o         (),
-        .ch_c_o         (),
+        .ch_a_o         (ch_out[0]),
+        .ch_b_o         (ch_out[1]),
+        .ch_c_o         (ch_out[2]),
         .mix_audio_o    (out),
         .pcm14s_o       ()
     );
 
+    /***************************************************************
+     * レジスタ書き込み通知
+     *  A0h で選択したレジスタ番号と A1h の書き込みデータを
+     *  書き込みサイクルの終わりで通知する
+     ***************************************************************/
+    wire wr_addr = cs_addr && cs_psg;
+    wire wr_data = cs_write && cs_psg;
+    logic prev_wr_data;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n || !Bus.RESET_n) begin
+            prev_wr_data <= 0;
+            Reg.WR <= 0;
+            Reg.ADDR <= 0;
+            Reg.DATA <= 0;
+        end
+        else begin
+            prev_wr_data <= wr_data;
+            Reg.WR <= prev_wr_data && !wr_data;
+            if(wr_addr) Reg.ADDR <= { 4'd0, Bus.DIN[3:0] };
+            if(wr_data) Reg.DATA <= Bus.DIN;
+        end
+    end
+    assign Reg.PORT = 0;
+
     /***************************************************************
      * 出力変換
      ***************************************************************/
@@ -100,6 +127,24 @@ module CARTRIDGE_PSG #(
         end
     end
 
+    /***************************************************************
+     * チャンネル毎の出力(Sound と同じ音量になるように上位ビットを揃える)
+     ***************************************************************/
+    generate
+        genvar ch;
+        for(ch = 0; ch < 3; ch = ch + 1) begin: ch_loop
+            wire [23:0] ch_ext = { 3'b000, ch_out[ch], 9'd0 };
+            always_ff @(posedge CLK or negedge RESET_n) begin
+                if(!RESET_n || !Bus.RESET_n) begin
+                    SoundCh[ch].Signal <= 0;
+                end
+                else begin
+                    SoundCh[ch].Signal <= ch_ext[23:24-$bits(SoundCh[ch].Signal)];
+                end
+            end
+        end
+    endgenerate
+
 endmodule
 
 `default_nettype wire
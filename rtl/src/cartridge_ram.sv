@@ -35,9 +35,19 @@
 
 /***************************************************************
  * RAM カードリッジ
+ *  FCh~FFh     : セグメントレジスタ(ページ 0~3)
+ *                READABLE=1 の時は読み出し可能(未使用の上位ビットは 1 を返す)
+ *  IO_EXT_ADDR : セグメント番号が 8bit を超える時の上位ビット
+ *                W: 次に FCh~FFh へ書き込む時のセグメント番号上位 2bit
+ *                   (その 1 回の書き込みで 0 に戻るので、続けて書き込む間は割り込みを禁止する)
+ *                R: bit1-0=ページ0, bit3-2=ページ1, bit5-4=ページ2, bit7-6=ページ3 の上位 2bit
+ *                (RAM_SIZE が 4MB 以下の時は無し)
  ***************************************************************/
 module CARTRIDGE_RAM #(
-    parameter [23:0]        RAM_ADDR = 0
+    parameter [23:0]        RAM_ADDR = 0,
+    parameter [23:0]        RAM_SIZE = 24'h40_0000,
+    parameter               READABLE = 0,
+    parameter [7:0]         IO_EXT_ADDR = 8'h2E
 ) (
     input   wire            RESET_n,
     input   wire            CLK,
@@ -45,9 +55,13 @@ module CARTRIDGE_RAM #(
     RAM_IF.HOST             Ram
 );
     localparam [7:0] IO_BASE_ADDR = 8'hFC;
+    localparam int   SEG_COUNT = RAM_SIZE / 24'h00_4000;
+    localparam int   SEG_BITS = ($clog2(SEG_COUNT) < 8) ? 8 : $clog2(SEG_COUNT);
+    localparam [9:0] SEG_MASK = (10'd1 << $clog2(SEG_COUNT)) - 1'd1;
+    localparam       USE_EXT = SEG_BITS > 8;
 
     /***************************************************************
-     * I/O ライト検出
+     * I/O リード/ライト検出
      ***************************************************************/
     wire io_wr_n = Bus.IORQ_n || Bus.WR_n;
     logic prev_io_wr_n;
@@ -58,22 +72,40 @@ module CARTRIDGE_RAM #(
     end
     wire det_io_wr = prev_io_wr_n && !io_wr_n;
 
+    wire io_bank_rd_n = !READABLE || Bus.IORQ_n || Bus.RD_n || (Bus.ADDR[7:2] != IO_BASE_ADDR[7:2]);
+    wire io_ext_rd_n  = !USE_EXT  || Bus.IORQ_n || Bus.RD_n || (Bus.ADDR[7:0] != IO_EXT_ADDR);
+    wire io_rd_n = io_bank_rd_n && io_ext_rd_n;
+
     /***************************************************************
      * バンクレジスタ
      ***************************************************************/
-    logic [7:0] bank[0:3];
+    logic [SEG_BITS-1:0] bank[0:3];
+    logic [1:0] ext;
     always_ff @(posedge CLK or negedge RESET_n) begin
         if(!RESET_n || !Bus.RESET_n) begin
             bank[0] <= 3;
             bank[1] <= 2;
             bank[2] <= 1;
             bank[3] <= 0;
+            ext <= 0;
         end
         else if(det_io_wr && Bus.ADDR[7:2] == IO_BASE_ADDR[7:2]) begin
-            bank[Bus.ADDR[1:0]] <= Bus.DIN;
+            // 上位ビットは次の 1 回だけ(上位ビットを知らない 8bit の書き込みは 0~255 になる)
+            bank[Bus.ADDR[1:0]] <= USE_EXT ? SEG_BITS'({ext, Bus.DIN}) : SEG_BITS'(Bus.DIN);
+            ext <= 0;
+        end
+        else if(USE_EXT && det_io_wr && Bus.ADDR[7:0] == IO_EXT_ADDR) begin
+            ext <= Bus.DIN[1:0];
         end
     end
 
+    /***************************************************************
+     * バンクレジスタ読み出しデータ
+     ***************************************************************/
+    wire [9:0] bank_rd = 10'(bank[Bus.ADDR[1:0]]);
+    wire [7:0] io_dout = !io_bank_rd_n ? (bank_rd[7:0] | ~SEG_MASK[7:0])
+                                       : { 2'(bank[3] >> 8), 2'(bank[2] >> 8), 2'(bank[1] >> 8), 2'(bank[0] >> 8) };
+
     /***************************************************************
      * メモリ R/W 検出
      ***************************************************************/
@@ -105,6 +137,13 @@ module CARTRIDGE_RAM #(
     end
     wire [$bits(Bus.ADDR)-1:0] addr = (!mem_rd_n || det_mem_wr) ? Bus.ADDR : save_addr;
 
+    /***************************************************************
+     * RAM 内の位置(RAM_SIZE を超えたセグメントは先頭から折り返す)
+     ***************************************************************/
+    wire [23:0] seg_addr = { 10'(bank[addr[15:14]]), addr[13:0] };
+    wire [23:0] ram_offset = ((RAM_SIZE & (RAM_SIZE - 1'd1)) == 0) ? (seg_addr & (RAM_SIZE - 1'd1)) :
+                             (seg_addr < RAM_SIZE)                 ? seg_addr : (seg_addr - RAM_SIZE);
+
     /***************************************************************
      * メモリ R/W
      ***************************************************************/
@@ -132,10 +171,10 @@ module CARTRIDGE_RAM #(
             Ram.RFSH_n <= Bus.RFSH_n;
         end
         else begin
-            Bus.DOUT <= mem_rd_n ? 0 : Ram.DOUT[7:0];
-            Bus.BUSDIR_n <= mem_rd_n;
+            Bus.DOUT <= !io_rd_n ? io_dout : mem_rd_n ? 0 : Ram.DOUT[7:0];
+            Bus.BUSDIR_n <= mem_rd_n && io_rd_n;
 
-            Ram.ADDR <= (mem_wr_n & mem_rd_n) ? 0 : (RAM_ADDR + {2'b00, bank[addr[15:14]], addr[13:0]});
+            Ram.ADDR <= (mem_wr_n & mem_rd_n) ? 0 : (RAM_ADDR + ram_offset);
 //            Ram.ADDR <= (mem_wr_n & mem_rd_n) ? 0 : (RAM_ADDR + {8'h00, addr[15:0]});
             Ram.DIN <= mem_wr_n ? 0 : Bus.DIN;
             Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
@@ -0,0 +1,523 @@
+//
+// cartridge_tracer.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+`default_nettype none
+
+/***************************************************************
+ * Z80 バストレーサー
+ *  カートリッジバスのメモリ/I/O アクセスを SD-RAM のリングバッファに記録する
+ *  I/O ポート
+ *   +0 W : レジスタ番号
+ *   +0 R : ステータス
+ *          bit7 = SD-RAM 書き込み中, bit3 = 記録漏れあり, bit2 = バッファ一周,
+ *          bit1 = トリガー検出, bit0 = 記録中
+ *   +1 RW: レジスタ(アクセス毎にレジスタ番号 +1, 13h の読み出し時は +1 しない)
+ *  レジスタ
+ *   00h     : bit0 = 記録開始(1)/停止(0), bit1 = トリガー有効, bit7 = 記録位置とフラグのクリア(W)
+ *   01h     : フィルタ bit0 = メモリリード, bit1 = メモリライト, bit2 = I/O リード, bit3 = I/O ライト
+ *                      bit4 = メモリアクセスは自スロットのみ, bit5 = M1 サイクルを除外
+ *   02h~03h : 比較アドレス
+ *   04h~05h : 比較アドレスマスク(1 のビットを比較)
+ *   06h~07h : トリガーアドレス
+ *   08h     : トリガー種別(01h の bit3-0 と同じ)
+ *   09h~0Ah : トリガー後に記録する件数
+ *   0Bh~0Dh : 次の記録位置(件数, R)
+ *   0Eh     : 記録漏れ件数(R, FFh で飽和)
+ *   0Fh     : バッファサイズ(64KB 単位, R)
+ *   10h~12h : 読み出し位置(バッファ先頭からのバイト位置)
+ *   13h     : 読み出しデータ(読むと読み出し位置 +1)
+ *  記録形式(1件 8バイト, リトルエンディアン)
+ *   +0~+1 : アドレス
+ *   +2    : データ
+ *   +3    : bit0 = ライト, bit1 = I/O, bit2 = M1, bit3 = 自スロット
+ *   +4~+7 : タイムスタンプ(3.58MHz のクロック数)
+ ***************************************************************/
+module CARTRIDGE_TRACER #(
+    parameter [7:0]         IO_BASE_ADDR = 8'h2A,
+    parameter [23:0]        RAM_ADDR = 0,
+    parameter [23:0]        RAM_SIZE = 24'h04_0000
+) (
+    input   wire            RESET_n,
+    input   wire            CLK,
+    BUS_IF.CARTRIDGE        Bus,
+    RAM_IF.HOST             Ram
+);
+    localparam [4:0] REG_CONTROL    = 5'h00;
+    localparam [4:0] REG_FILTER     = 5'h01;
+    localparam [4:0] REG_MATCH_L    = 5'h02;
+    localparam [4:0] REG_MATCH_H    = 5'h03;
+    localparam [4:0] REG_MASK_L     = 5'h04;
+    localparam [4:0] REG_MASK_H     = 5'h05;
+    localparam [4:0] REG_TRIG_L     = 5'h06;
+    localparam [4:0] REG_TRIG_H     = 5'h07;
+    localparam [4:0] REG_TRIG_TYPE  = 5'h08;
+    localparam [4:0] REG_POST_L     = 5'h09;
+    localparam [4:0] REG_POST_H     = 5'h0A;
+    localparam [4:0] REG_WPTR_L     = 5'h0B;
+    localparam [4:0] REG_WPTR_M     = 5'h0C;
+    localparam [4:0] REG_WPTR_H     = 5'h0D;
+    localparam [4:0] REG_DROP       = 5'h0E;
+    localparam [4:0] REG_SIZE       = 5'h0F;
+    localparam [4:0] REG_RPTR_L     = 5'h10;
+    localparam [4:0] REG_RPTR_M     = 5'h11;
+    localparam [4:0] REG_RPTR_H     = 5'h12;
+    localparam [4:0] REG_READ_DATA  = 5'h13;
+
+    localparam BIT_TYPE_WRITE = 0;
+    localparam BIT_TYPE_IO    = 1;
+    localparam BIT_TYPE_M1    = 2;
+    localparam BIT_TYPE_SLOT  = 3;
+
+    localparam BIT_FILTER_SLOT  = 4;
+    localparam BIT_FILTER_NO_M1 = 5;
+
+    localparam ENTRY_COUNT = RAM_SIZE / 8;
+    localparam ENTRY_BITS  = $clog2(ENTRY_COUNT);
+    localparam FIFO_DEPTH  = 8;
+
+    /***************************************************************
+     * アドレスデコーダ
+     ***************************************************************/
+    wire cs_n     = Bus.IORQ_n || (Bus.ADDR[7:1] != IO_BASE_ADDR[7:1]);
+    wire io_wr_n  = cs_n || Bus.WR_n;
+    wire io_rd_n  = cs_n || Bus.RD_n;
+
+    /***************************************************************
+     * I/O リード/ライト検出
+     ***************************************************************/
+    logic prev_io_wr_n;
+    logic prev_io_rd_n;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_io_wr_n <= 1;
+        else if(!Bus.RESET_n) prev_io_wr_n <= 1;
+        else                  prev_io_wr_n <= io_wr_n;
+    end
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_io_rd_n <= 1;
+        else if(!Bus.RESET_n) prev_io_rd_n <= 1;
+        else                  prev_io_rd_n <= io_rd_n;
+    end
+    wire det_io_wr = prev_io_wr_n && !io_wr_n;
+    wire det_io_rd = prev_io_rd_n && !io_rd_n;
+    wire det_reg_wr = det_io_wr && Bus.ADDR[0] == 1;
+    wire det_reg_rd = det_io_rd && Bus.ADDR[0] == 1;
+
+    /***************************************************************
+     * 設定レジスタ
+     *  (記録状態のレジスタは下の記録処理で更新する)
+     ***************************************************************/
+    logic [4:0]  index;
+    logic        run_req;
+    logic        run_stop;
+    logic        clear;
+    logic        trig_en;
+    logic [7:0]  filter;
+    logic [15:0] match;
+    logic [15:0] mask;
+    logic [15:0] trig_addr;
+    logic [3:0]  trig_type;
+    logic [15:0] post_count;
+    logic [23:0] rptr;
+    logic        fetch_req;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            index <= 0;
+            run_req <= 0;
+            clear <= 0;
+            trig_en <= 0;
+            filter <= 8'h0F;
+            match <= 0;
+            mask <= 0;
+            trig_addr <= 0;
+            trig_type <= 0;
+            post_count <= 0;
+            rptr <= 0;
+            fetch_req <= 0;
+        end
+        else begin
+            clear <= 0;
+            fetch_req <= 0;
+            if(run_stop) run_req <= 0;
+
+            if(det_io_wr && Bus.ADDR[0] == 0) begin
+                index <= Bus.DIN[4:0];
+            end
+            else if(det_reg_wr) begin
+                case (index)
+                    REG_CONTROL:    begin
+                                        run_req <= Bus.DIN[0];
+                                        trig_en <= Bus.DIN[1];
+                                        clear <= Bus.DIN[7];
+                                    end
+                    REG_FILTER:     filter <= Bus.DIN;
+                    REG_MATCH_L:    match[7:0] <= Bus.DIN;
+                    REG_MATCH_H:    match[15:8] <= Bus.DIN;
+                    REG_MASK_L:     mask[7:0] <= Bus.DIN;
+                    REG_MASK_H:     mask[15:8] <= Bus.DIN;
+                    REG_TRIG_L:     trig_addr[7:0] <= Bus.DIN;
+                    REG_TRIG_H:     trig_addr[15:8] <= Bus.DIN;
+                    REG_TRIG_TYPE:  trig_type <= Bus.DIN[3:0];
+                    REG_POST_L:     post_count[7:0] <= Bus.DIN;
+                    REG_POST_H:     post_count[15:8] <= Bus.DIN;
+                    REG_RPTR_L:     begin rptr[7:0] <= Bus.DIN;   fetch_req <= 1; end
+                    REG_RPTR_M:     begin rptr[15:8] <= Bus.DIN;  fetch_req <= 1; end
+                    REG_RPTR_H:     begin rptr[23:16] <= Bus.DIN; fetch_req <= 1; end
+                    default:        ;
+                endcase
+                index <= index + 1'd1;
+            end
+            else if(det_reg_rd) begin
+                if(index == REG_READ_DATA) begin
+                    // 読み出し位置を進めて、次の 32bit 境界で先読み
+                    rptr <= rptr + 1'd1;
+                    if(rptr[1:0] == 2'd3) fetch_req <= 1;
+                end
+                else begin
+                    index <= index + 1'd1;
+                end
+            end
+        end
+    end
+
+    /***************************************************************
+     * バスサイクル検出
+     ***************************************************************/
+    wire mem_rd = !Bus.MERQ_n && !Bus.RD_n && Bus.RFSH_n;
+    wire mem_wr = !Bus.MERQ_n && !Bus.WR_n;
+    wire io_rd  = !Bus.IORQ_n && !Bus.RD_n && Bus.M1_n;     // 割り込み応答サイクルは除外
+    wire io_wr  = !Bus.IORQ_n && !Bus.WR_n;
+    wire [3:0] cycle = { io_wr, io_rd, mem_wr, mem_rd };
+    wire cycle_active = cycle != 0;
+
+    logic        prev_cycle_active;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_cycle_active <= 0;
+        else if(!Bus.RESET_n) prev_cycle_active <= 0;
+        else                  prev_cycle_active <= cycle_active;
+    end
+    wire det_cycle_start = !prev_cycle_active && cycle_active;
+    wire det_cycle_end   = prev_cycle_active && !cycle_active;
+
+    /***************************************************************
+     * タイムスタンプ
+     ***************************************************************/
+    logic [31:0] timestamp;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)        timestamp <= 0;
+        else if(clear)      timestamp <= 0;
+        else if(Bus.CLK_EN) timestamp <= timestamp + 1'd1;
+    end
+
+    /***************************************************************
+     * サイクル情報の保持
+     *  アドレスと種別は開始時, データは終了直前の値を使う
+     ***************************************************************/
+    logic [15:0] cap_addr;
+    logic [7:0]  cap_data;
+    logic [3:0]  cap_cycle;
+    logic        cap_m1;
+    logic        cap_slot;
+    logic [31:0] cap_time;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            cap_addr <= 0;
+            cap_data <= 0;
+            cap_cycle <= 0;
+            cap_m1 <= 0;
+            cap_slot <= 0;
+            cap_time <= 0;
+        end
+        else if(det_cycle_start) begin
+            cap_addr <= Bus.ADDR;
+            cap_data <= Bus.DIN;
+            cap_cycle <= cycle;
+            cap_m1 <= !Bus.M1_n;
+            cap_slot <= !Bus.SLTSL_n;
+            cap_time <= timestamp;
+        end
+        else if(cycle_active) begin
+            cap_data <= Bus.DIN;
+        end
+    end
+
+    wire cap_write = cap_cycle[1] || cap_cycle[3];
+    wire cap_io    = cap_cycle[2] || cap_cycle[3];
+    wire [7:0] cap_type = { 4'h0, !cap_io && cap_slot, cap_m1, cap_io, cap_write };
+
+    wire pass_filter = ((cap_cycle & filter[3:0]) != 0) &&
+                       (((cap_addr ^ match) & mask) == 0) &&
+                       !(filter[BIT_FILTER_SLOT] && !cap_io && !cap_slot) &&
+                       !(filter[BIT_FILTER_NO_M1] && cap_m1);
+    wire hit_trigger = ((cap_cycle & trig_type) != 0) && (cap_addr == trig_addr);
+
+    /***************************************************************
+     * 記録 FIFO
+     ***************************************************************/
+    logic [63:0] fifo[0:FIFO_DEPTH-1];
+    logic [$clog2(FIFO_DEPTH):0] fifo_wp;
+    logic [$clog2(FIFO_DEPTH):0] fifo_rp;
+    wire fifo_empty = fifo_wp == fifo_rp;
+    wire fifo_full  = (fifo_wp - fifo_rp) == FIFO_DEPTH;
+    logic fifo_pop;
+
+    logic        running;
+    logic        triggered;
+    logic [15:0] post_remain;
+    logic [7:0]  drop;
+
+    assign run_stop = running && triggered && trig_en && post_remain == 0;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            fifo_wp <= 0;
+            running <= 0;
+            triggered <= 0;
+            post_remain <= 0;
+            drop <= 0;
+        end
+        else if(clear) begin
+            fifo_wp <= fifo_rp;
+            running <= 0;
+            triggered <= 0;
+            post_remain <= 0;
+            drop <= 0;
+        end
+        else begin
+            running <= run_req && !run_stop;
+
+            if(running && !run_stop && det_cycle_end) begin
+                if(pass_filter) begin
+                    if(fifo_full) begin
+                        if(drop != 8'hFF) drop <= drop + 1'd1;
+                    end
+                    else begin
+                        fifo[fifo_wp[$clog2(FIFO_DEPTH)-1:0]] <= { cap_time, cap_type, cap_data, cap_addr };
+                        fifo_wp <= fifo_wp + 1'd1;
+                    end
+                    if(triggered && post_remain != 0) post_remain <= post_remain - 1'd1;
+                end
+                if(trig_en && !triggered && hit_trigger) begin
+                    triggered <= 1;
+                    post_remain <= post_count;
+                end
+            end
+        end
+    end
+
+    /***************************************************************
+     * SD-RAM アクセス
+     *  FIFO の内容を 32bit x2 で書き込む
+     *  読み出し位置が変わったら 32bit 先読みする
+     ***************************************************************/
+    logic [ENTRY_BITS-1:0] wptr;
+    logic        wrapped;
+    logic [31:0] rdata;
+    logic        fetch_pending;
+    logic        half;              // 0 = 前半 32bit, 1 = 後半 32bit
+    logic        discard;           // 書き込み中にクリアされたら書き込んだ記録を捨てる
+
+    enum logic [2:0] {
+        STATE_IDLE,
+        STATE_WRITE_REQ,
+        STATE_WRITE_WAIT_ACK,
+        STATE_WRITE_WAIT_BUSY,
+        STATE_READ_REQ,
+        STATE_READ_WAIT_ACK,
+        STATE_READ_WAIT_BUSY
+    } state;
+
+    wire [63:0] fifo_top = fifo[fifo_rp[$clog2(FIFO_DEPTH)-1:0]];
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            state <= STATE_IDLE;
+            fifo_rp <= 0;
+            wptr <= 0;
+            wrapped <= 0;
+            rdata <= 0;
+            fetch_pending <= 0;
+            half <= 0;
+            discard <= 0;
+            Ram.ADDR <= 0;
+            Ram.DIN <= 0;
+            Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+            Ram.OE_n <= 1;
+            Ram.WE_n <= 1;
+            Ram.RFSH_n <= 1;
+        end
+        else begin
+            if(fetch_req) fetch_pending <= 1;
+            if(clear) begin
+                wptr <= 0;
+                wrapped <= 0;
+                if(state != STATE_IDLE) discard <= 1;
+            end
+
+            case (state)
+                STATE_IDLE:
+                begin
+                    if(fetch_pending || fetch_req) begin
+                        fetch_pending <= 0;
+                        state <= STATE_READ_REQ;
+                    end
+                    else if(!fifo_empty && !clear) begin
+                        half <= 0;
+                        state <= STATE_WRITE_REQ;
+                    end
+                end
+
+                // 記録の書き込み
+                STATE_WRITE_REQ:
+                begin
+                    Ram.ADDR <= RAM_ADDR + { wptr, half, 2'b00 };
+                    Ram.DIN <= half ? fifo_top[63:32] : fifo_top[31:0];
+                    Ram.DIN_SIZE <= RAM::DIN_SIZE_32;
+                    Ram.WE_n <= 0;
+                    state <= STATE_WRITE_WAIT_ACK;
+                end
+                STATE_WRITE_WAIT_ACK:
+                begin
+                    if(Ram.ACK_n == 0) begin
+                        Ram.ADDR <= 0;
+                        Ram.DIN <= 0;
+                        Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+                        Ram.WE_n <= 1;
+                        state <= STATE_WRITE_WAIT_BUSY;
+                    end
+                end
+                STATE_WRITE_WAIT_BUSY:
+                begin
+                    if(Ram.ACK_n == 1) begin
+                        if(!half) begin
+                            half <= 1;
+                            state <= STATE_WRITE_REQ;
+                        end
+                        else begin
+                            if(!discard && !clear) begin
+                                fifo_rp <= fifo_rp + 1'd1;
+                                wptr <= wptr + 1'd1;
+                                if(wptr == ENTRY_BITS'(ENTRY_COUNT - 1)) wrapped <= 1;
+                            end
+                            discard <= 0;
+                            state <= STATE_IDLE;
+                        end
+                    end
+                end
+
+                // 読み出しデータの先読み
+                STATE_READ_REQ:
+                begin
+                    Ram.ADDR <= RAM_ADDR + { rptr[ENTRY_BITS+2:2], 2'b00 };
+                    Ram.DIN_SIZE <= RAM::DIN_SIZE_32;
+                    Ram.OE_n <= 0;
+                    state <= STATE_READ_WAIT_ACK;
+                end
+                STATE_READ_WAIT_ACK:
+                begin
+                    if(Ram.ACK_n == 0) begin
+                        Ram.ADDR <= 0;
+                        Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+                        Ram.OE_n <= 1;
+                        state <= STATE_READ_WAIT_BUSY;
+                    end
+                end
+                STATE_READ_WAIT_BUSY:
+                begin
+                    if(Ram.ACK_n == 1) begin
+                        rdata <= Ram.DOUT;
+                        discard <= 0;
+                        state <= STATE_IDLE;
+                    end
+                end
+
+                default:
+                begin
+                    state <= STATE_IDLE;
+                end
+            endcase
+        end
+    end
+
+    /***************************************************************
+     * レジスタ読み込み
+     *  Z80 がデータを取り込むのはサイクルの終わりなので、読み出しの開始時に
+     *  値を保持する(index と rptr は同じクロックで次に進む)
+     ***************************************************************/
+    wire [23:0] wptr_out = 24'(wptr);
+    wire [7:0]  status = { state != STATE_IDLE || !fifo_empty, 3'd0, drop != 0, wrapped, triggered, running };
+    logic [7:0] reg_dout;
+    always_comb begin
+        case (index)
+            REG_CONTROL:    reg_dout = { 6'd0, trig_en, run_req };
+            REG_FILTER:     reg_dout = filter;
+            REG_MATCH_L:    reg_dout = match[7:0];
+            REG_MATCH_H:    reg_dout = match[15:8];
+            REG_MASK_L:     reg_dout = mask[7:0];
+            REG_MASK_H:     reg_dout = mask[15:8];
+            REG_TRIG_L:     reg_dout = trig_addr[7:0];
+            REG_TRIG_H:     reg_dout = trig_addr[15:8];
+            REG_TRIG_TYPE:  reg_dout = { 4'd0, trig_type };
+            REG_POST_L:     reg_dout = post_count[7:0];
+            REG_POST_H:     reg_dout = post_count[15:8];
+            REG_WPTR_L:     reg_dout = wptr_out[7:0];
+            REG_WPTR_M:     reg_dout = wptr_out[15:8];
+            REG_WPTR_H:     reg_dout = wptr_out[23:16];
+            REG_DROP:       reg_dout = drop;
+            REG_SIZE:       reg_dout = RAM_SIZE[23:16];
+            REG_RPTR_L:     reg_dout = rptr[7:0];
+            REG_RPTR_M:     reg_dout = rptr[15:8];
+            REG_RPTR_H:     reg_dout = rptr[23:16];
+            REG_READ_DATA:  reg_dout = rdata[rptr[1:0]*8 +: 8];
+            default:        reg_dout = 8'hFF;
+        endcase
+    end
+
+    logic [7:0] dout;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)        dout <= 8'hFF;
+        else if(det_io_rd)  dout <= (Bus.ADDR[0] == 0) ? status : reg_dout;
+    end
+
+    assign Bus.BUSDIR_n = io_rd_n;
+    assign Bus.DOUT = io_rd_n ? 8'h00 : dout;
+
+    /***************************************************************
+     * 未使用信号
+     ***************************************************************/
+    assign Bus.INT_n = 1;
+    assign Bus.WAIT_n = 1;
+
+endmodule
+
+`default_nettype wire
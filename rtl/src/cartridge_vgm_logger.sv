@@ -0,0 +1,513 @@
+//
+// cartridge_vgm_logger.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+`default_nettype none
+
+/***************************************************************
+ * 音源レジスタ書き込みロガー(VGM 形式)
+ *  PSG/OPLL/SCC のレジスタ書き込みを VGM のコマンド形式で
+ *  SD-RAM のリングバッファに記録する
+ *  I/O ポート
+ *   +0 W : レジスタ番号
+ *   +0 R : ステータス
+ *          bit7 = SD-RAM 書き込み中, bit3 = 記録漏れあり, bit2 = バッファ一周, bit0 = 記録中
+ *   +1 RW: レジスタ(アクセス毎にレジスタ番号 +1, 0Bh の読み出し時は +1 しない)
+ *  レジスタ
+ *   00h     : bit0 = 記録開始(1)/停止(0), bit7 = 記録位置とフラグのクリア(W)
+ *   01h     : 記録する音源 bit0 = PSG, bit1 = OPLL, bit2 = SCC
+ *   02h~04h : 次の記録位置(バッファ先頭からのバイト位置, R)
+ *   05h     : 記録漏れ件数(R, FFh で飽和)
+ *   06h~07h : バッファサイズ(256バイト単位, R)
+ *   08h~0Ah : 読み出し位置(バッファ先頭からのバイト位置)
+ *   0Bh     : 読み出しデータ(読むと読み出し位置 +1)
+ *  記録形式
+ *   61 nn nn    : 待ち(44.1kHz のサンプル数)
+ *   A0 aa dd    : PSG(AY8910)
+ *   51 aa dd    : OPLL(YM2413)
+ *   D2 pp aa dd : SCC(K051649, SCC-I の波形はポート 4)
+ *   67 66 3F ss ss ss ss ... : 256 バイト境界までの詰め物(データブロック)
+ *   コマンドは 256 バイト境界をまたがないので、バッファが一周した後も
+ *   次の記録位置の次の 256 バイト境界から読めばコマンドの先頭になる
+ ***************************************************************/
+module CARTRIDGE_VGM_LOGGER #(
+    parameter [7:0]         IO_BASE_ADDR = 8'h28,
+    parameter [23:0]        RAM_ADDR = 0,
+    parameter [23:0]        RAM_SIZE = 24'h01_8000
+) (
+    input   wire            RESET_n,
+    input   wire            CLK,
+    BUS_IF.CARTRIDGE        Bus,
+    RAM_IF.HOST             Ram,
+    SOUND_REG_IF.IN         Psg,
+    SOUND_REG_IF.IN         Fm,
+    SOUND_REG_IF.IN         Scc
+);
+    localparam [3:0] REG_CONTROL    = 4'h0;
+    localparam [3:0] REG_FILTER     = 4'h1;
+    localparam [3:0] REG_WPTR_L     = 4'h2;
+    localparam [3:0] REG_WPTR_M     = 4'h3;
+    localparam [3:0] REG_WPTR_H     = 4'h4;
+    localparam [3:0] REG_DROP       = 4'h5;
+    localparam [3:0] REG_SIZE_L     = 4'h6;
+    localparam [3:0] REG_SIZE_H     = 4'h7;
+    localparam [3:0] REG_RPTR_L     = 4'h8;
+    localparam [3:0] REG_RPTR_M     = 4'h9;
+    localparam [3:0] REG_RPTR_H     = 4'hA;
+    localparam [3:0] REG_READ_DATA  = 4'hB;
+
+    localparam [1:0] CHIP_NONE      = 2'd0;     // 待ちのみ
+    localparam [1:0] CHIP_PSG       = 2'd1;
+    localparam [1:0] CHIP_OPLL      = 2'd2;
+    localparam [1:0] CHIP_SCC       = 2'd3;
+
+    localparam [8:0] BLOCK_SIZE     = 9'd256;
+    localparam [8:0] PAD_HEADER_LEN = 9'd7;     // 67 66 tt ss ss ss ss
+    localparam [7:0] PAD_TYPE       = 8'h3F;    // 使われないチップ種別の PCM データ
+    localparam       FIFO_DEPTH     = 8;
+
+    // 44.1kHz = 3.579545MHz * 441 / 35795
+    localparam [15:0] SAMPLE_MUL    = 16'd441;
+    localparam [15:0] SAMPLE_DIV    = 16'd35795;
+
+    /***************************************************************
+     * アドレスデコーダ
+     ***************************************************************/
+    wire cs_n     = Bus.IORQ_n || (Bus.ADDR[7:1] != IO_BASE_ADDR[7:1]);
+    wire io_wr_n  = cs_n || Bus.WR_n;
+    wire io_rd_n  = cs_n || Bus.RD_n;
+
+    /***************************************************************
+     * I/O リード/ライト検出
+     ***************************************************************/
+    logic prev_io_wr_n;
+    logic prev_io_rd_n;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_io_wr_n <= 1;
+        else if(!Bus.RESET_n) prev_io_wr_n <= 1;
+        else                  prev_io_wr_n <= io_wr_n;
+    end
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          prev_io_rd_n <= 1;
+        else if(!Bus.RESET_n) prev_io_rd_n <= 1;
+        else                  prev_io_rd_n <= io_rd_n;
+    end
+    wire det_io_wr = prev_io_wr_n && !io_wr_n;
+    wire det_io_rd = prev_io_rd_n && !io_rd_n;
+    wire det_reg_wr = det_io_wr && Bus.ADDR[0] == 1;
+    wire det_reg_rd = det_io_rd && Bus.ADDR[0] == 1;
+
+    /***************************************************************
+     * 設定レジスタ
+     ***************************************************************/
+    logic [3:0]  index;
+    logic        run_req;
+    logic        clear;
+    logic [2:0]  filter;
+    logic [23:0] rptr;
+    logic        fetch_req;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            index <= 0;
+            run_req <= 0;
+            clear <= 0;
+            filter <= 3'b111;
+            rptr <= 0;
+            fetch_req <= 0;
+        end
+        else begin
+            clear <= 0;
+            fetch_req <= 0;
+
+            if(det_io_wr && Bus.ADDR[0] == 0) begin
+                index <= Bus.DIN[3:0];
+            end
+            else if(det_reg_wr) begin
+                case (index)
+                    REG_CONTROL:    begin
+                                        run_req <= Bus.DIN[0];
+                                        clear <= Bus.DIN[7];
+                                    end
+                    REG_FILTER:     filter <= Bus.DIN[2:0];
+                    REG_RPTR_L:     begin rptr[7:0] <= Bus.DIN;   fetch_req <= 1; end
+                    REG_RPTR_M:     begin rptr[15:8] <= Bus.DIN;  fetch_req <= 1; end
+                    REG_RPTR_H:     begin rptr[23:16] <= Bus.DIN; fetch_req <= 1; end
+                    default:        ;
+                endcase
+                index <= index + 1'd1;
+            end
+            else if(det_reg_rd) begin
+                if(index == REG_READ_DATA) begin
+                    // 読み出し位置を進めて、次の 32bit 境界で先読み
+                    rptr <= rptr + 1'd1;
+                    if(rptr[1:0] == 2'd3) fetch_req <= 1;
+                end
+                else begin
+                    index <= index + 1'd1;
+                end
+            end
+        end
+    end
+
+    /***************************************************************
+     * 記録中フラグ
+     ***************************************************************/
+    logic running;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)   running <= 0;
+        else if(clear) running <= 0;
+        else           running <= run_req;
+    end
+
+    /***************************************************************
+     * サンプルカウンタ(44.1kHz, 記録中のみ進める)
+     ***************************************************************/
+    logic [15:0] sample_frac;
+    logic [31:0] sample;
+    wire  [15:0] sample_frac_next = sample_frac + SAMPLE_MUL;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            sample_frac <= 0;
+            sample <= 0;
+        end
+        else if(clear) begin
+            sample_frac <= 0;
+            sample <= 0;
+        end
+        else if(running && Bus.CLK_EN) begin
+            if(sample_frac_next >= SAMPLE_DIV) begin
+                sample_frac <= sample_frac_next - SAMPLE_DIV;
+                sample <= sample + 1'd1;
+            end
+            else begin
+                sample_frac <= sample_frac_next;
+            end
+        end
+    end
+
+    /***************************************************************
+     * 書き込みの取り込み
+     *  各音源の通知は別々のバスサイクルの終わりなので同時には来ない
+     *  停止時は末尾の待ち時間を記録するため待ちのみの記録を入れる
+     ***************************************************************/
+    wire cap_psg  = Psg.WR && filter[0];
+    wire cap_fm   = Fm.WR  && filter[1];
+    wire cap_scc  = Scc.WR && filter[2];
+    wire cap_stop = !run_req;
+
+    wire [1:0] cap_chip = cap_psg ? CHIP_PSG :
+                          cap_fm  ? CHIP_OPLL :
+                          cap_scc ? CHIP_SCC : CHIP_NONE;
+    wire [7:0] cap_port = cap_scc ? Scc.PORT : 8'd0;
+    wire [7:0] cap_addr = cap_psg ? Psg.ADDR : cap_fm ? Fm.ADDR : Scc.ADDR;
+    wire [7:0] cap_data = cap_psg ? Psg.DATA : cap_fm ? Fm.DATA : Scc.DATA;
+    wire       cap_req  = running && (cap_psg || cap_fm || cap_scc || cap_stop);
+
+    /***************************************************************
+     * 記録 FIFO
+     *  { サンプル位置(32), 音源(2), ポート(8), レジスタ(8), データ(8) }
+     ***************************************************************/
+    logic [57:0] fifo[0:FIFO_DEPTH-1];
+    logic [$clog2(FIFO_DEPTH):0] fifo_wp;
+    logic [$clog2(FIFO_DEPTH):0] fifo_rp;
+    wire fifo_empty = fifo_wp == fifo_rp;
+    wire fifo_full  = (fifo_wp - fifo_rp) == FIFO_DEPTH;
+
+    logic [7:0]  drop;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            fifo_wp <= 0;
+            drop <= 0;
+        end
+        else if(clear) begin
+            fifo_wp <= fifo_rp;
+            drop <= 0;
+        end
+        else if(cap_req) begin
+            if(fifo_full) begin
+                if(drop != 8'hFF) drop <= drop + 1'd1;
+            end
+            else begin
+                fifo[fifo_wp[$clog2(FIFO_DEPTH)-1:0]] <= { sample, cap_chip, cap_port, cap_addr, cap_data };
+                fifo_wp <= fifo_wp + 1'd1;
+            end
+        end
+    end
+
+    /***************************************************************
+     * VGM コマンドの組み立て
+     *  待ち時間は前回の記録からのサンプル数
+     *  (65535 を超える分は待ちだけのコマンドに分ける)
+     ***************************************************************/
+    logic [23:0] wptr;
+    logic [31:0] emitted;           // 書き込み済みの待ち時間の合計
+
+    wire [57:0] fifo_top = fifo[fifo_rp[$clog2(FIFO_DEPTH)-1:0]];
+    wire [31:0] top_sample = fifo_top[57:26];
+    wire [1:0]  top_chip   = fifo_top[25:24];
+    wire [7:0]  top_port   = fifo_top[23:16];
+    wire [7:0]  top_addr   = fifo_top[15:8];
+    wire [7:0]  top_data   = fifo_top[7:0];
+
+    wire [31:0] wait_all   = top_sample - emitted;
+    wire        wait_split = wait_all[31:16] != 0;
+    wire [15:0] wait_cnt   = wait_split ? 16'hFFFF : wait_all[15:0];
+    wire [3:0]  wait_len   = (wait_cnt != 0) ? 4'd3 : 4'd0;
+    wire [3:0]  cmd_len    = (wait_split || top_chip == CHIP_NONE) ? 4'd0 :
+                             (top_chip == CHIP_SCC)                ? 4'd4 : 4'd3;
+    wire [31:0] cmd        = (top_chip == CHIP_SCC)  ? { top_data, top_addr, top_port, 8'hD2 } :
+                             (top_chip == CHIP_PSG)  ? { 8'h00, top_data, top_addr, 8'hA0 } :
+                                                       { 8'h00, top_data, top_addr, 8'h51 };
+    wire [55:0] cmd_bytes  = (wait_len != 0) ? { cmd, wait_cnt, 8'h61 } : { 24'd0, cmd };   // 先頭が下位バイト
+    wire [8:0]  cmd_total  = { 5'd0, wait_len } + { 5'd0, cmd_len };
+
+    // 256 バイト境界までの残りは 0 か 7 バイト以上にしておく(7 バイト以上なら詰め物を置ける)
+    wire [8:0]  block_remain = BLOCK_SIZE - { 1'b0, wptr[7:0] };
+    wire        need_pad = !(block_remain == cmd_total || block_remain >= cmd_total + PAD_HEADER_LEN);
+
+    /***************************************************************
+     * SD-RAM アクセス
+     *  コマンドを 1 バイトずつ書き込む
+     *  読み出し位置が変わったら 32bit 先読みする
+     ***************************************************************/
+    logic        wrapped;
+    logic [31:0] rdata;
+    logic        fetch_pending;
+    logic        discard;           // 書き込み中にクリアされたら書き込んだ記録を捨てる
+
+    logic [55:0] wr_bytes;
+    logic [8:0]  wr_len;
+    logic [8:0]  wr_pos;
+    logic        wr_pad;
+    logic        wr_pop;
+    logic [15:0] wr_wait;
+
+    wire  [7:0]  pad_byte = (wr_pos == 0) ? 8'h67 :
+                            (wr_pos == 1) ? 8'h66 :
+                            (wr_pos == 2) ? PAD_TYPE :
+                            (wr_pos == 3) ? 8'(wr_len - PAD_HEADER_LEN) : 8'h00;
+    wire  [7:0]  wr_byte  = wr_pad ? pad_byte : wr_bytes[wr_pos[2:0]*8 +: 8];
+
+    enum logic [2:0] {
+        STATE_IDLE,
+        STATE_WRITE_REQ,
+        STATE_WRITE_WAIT_ACK,
+        STATE_WRITE_WAIT_BUSY,
+        STATE_READ_REQ,
+        STATE_READ_WAIT_ACK,
+        STATE_READ_WAIT_BUSY
+    } state;
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            state <= STATE_IDLE;
+            fifo_rp <= 0;
+            wptr <= 0;
+            emitted <= 0;
+            wrapped <= 0;
+            rdata <= 0;
+            fetch_pending <= 0;
+            discard <= 0;
+            wr_bytes <= 0;
+            wr_len <= 0;
+            wr_pos <= 0;
+            wr_pad <= 0;
+            wr_pop <= 0;
+            wr_wait <= 0;
+            Ram.ADDR <= 0;
+            Ram.DIN <= 0;
+            Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+            Ram.OE_n <= 1;
+            Ram.WE_n <= 1;
+            Ram.RFSH_n <= 1;
+        end
+        else begin
+            if(fetch_req) fetch_pending <= 1;
+            if(clear) begin
+                wptr <= 0;
+                emitted <= 0;
+                wrapped <= 0;
+                if(state != STATE_IDLE) discard <= 1;
+            end
+
+            case (state)
+                STATE_IDLE:
+                begin
+                    if(fetch_pending || fetch_req) begin
+                        fetch_pending <= 0;
+                        state <= STATE_READ_REQ;
+                    end
+                    else if(!fifo_empty && !clear) begin
+                        wr_bytes <= cmd_bytes;
+                        wr_pos <= 0;
+                        wr_pad <= need_pad;
+                        wr_len <= need_pad ? block_remain : cmd_total;
+                        wr_pop <= !need_pad && !wait_split;
+                        wr_wait <= need_pad ? 16'd0 : wait_cnt;
+                        if(!need_pad && cmd_total == 0) begin
+                            // 書き込むものが無い(待ち時間 0 の停止)
+                            fifo_rp <= fifo_rp + 1'd1;
+                        end
+                        else begin
+                            state <= STATE_WRITE_REQ;
+                        end
+                    end
+                end
+
+                // 記録の書き込み
+                STATE_WRITE_REQ:
+                begin
+                    Ram.ADDR <= RAM_ADDR + wptr;
+                    Ram.DIN <= { 24'd0, wr_byte };
+                    Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+                    Ram.WE_n <= 0;
+                    state <= STATE_WRITE_WAIT_ACK;
+                end
+                STATE_WRITE_WAIT_ACK:
+                begin
+                    if(Ram.ACK_n == 0) begin
+                        Ram.ADDR <= 0;
+                        Ram.DIN <= 0;
+                        Ram.WE_n <= 1;
+                        state <= STATE_WRITE_WAIT_BUSY;
+                    end
+                end
+                STATE_WRITE_WAIT_BUSY:
+                begin
+                    if(Ram.ACK_n == 1) begin
+                        if(discard || clear) begin
+                            discard <= 0;
+                            state <= STATE_IDLE;
+                        end
+                        else begin
+                            if(wptr == RAM_SIZE - 1'd1) begin
+                                wptr <= 0;
+                                wrapped <= 1;
+                            end
+                            else begin
+                                wptr <= wptr + 1'd1;
+                            end
+
+                            if(wr_pos == wr_len - 1'd1) begin
+                                emitted <= emitted + wr_wait;
+                                if(wr_pop) fifo_rp <= fifo_rp + 1'd1;
+                                state <= STATE_IDLE;
+                            end
+                            else begin
+                                wr_pos <= wr_pos + 1'd1;
+                                state <= STATE_WRITE_REQ;
+                            end
+                        end
+                    end
+                end
+
+                // 読み出しデータの先読み
+                STATE_READ_REQ:
+                begin
+                    Ram.ADDR <= RAM_ADDR + { rptr[23:2], 2'b00 };
+                    Ram.DIN_SIZE <= RAM::DIN_SIZE_32;
+                    Ram.OE_n <= 0;
+                    state <= STATE_READ_WAIT_ACK;
+                end
+                STATE_READ_WAIT_ACK:
+                begin
+                    if(Ram.ACK_n == 0) begin
+                        Ram.ADDR <= 0;
+                        Ram.DIN_SIZE <= RAM::DIN_SIZE_8;
+                        Ram.OE_n <= 1;
+                        state <= STATE_READ_WAIT_BUSY;
+                    end
+                end
+                STATE_READ_WAIT_BUSY:
+                begin
+                    if(Ram.ACK_n == 1) begin
+                        rdata <= Ram.DOUT;
+                        discard <= 0;
+                        state <= STATE_IDLE;
+                    end
+                end
+
+                default:
+                begin
+                    state <= STATE_IDLE;
+                end
+            endcase
+        end
+    end
+
+    /***************************************************************
+     * レジスタ読み込み
+     *  Z80 がデータを取り込むのはサイクルの終わりなので、読み出しの開始時に
+     *  値を保持する(index と rptr は同じクロックで次に進む)
+     ***************************************************************/
+    wire [15:0] size_out = 16'(RAM_SIZE / BLOCK_SIZE);
+    wire [7:0]  status = { state != STATE_IDLE || !fifo_empty, 3'd0, drop != 0, wrapped, 1'b0, running };
+    logic [7:0] reg_dout;
+    always_comb begin
+        case (index)
+            REG_CONTROL:    reg_dout = { 7'd0, run_req };
+            REG_FILTER:     reg_dout = { 5'd0, filter };
+            REG_WPTR_L:     reg_dout = wptr[7:0];
+            REG_WPTR_M:     reg_dout = wptr[15:8];
+            REG_WPTR_H:     reg_dout = wptr[23:16];
+            REG_DROP:       reg_dout = drop;
+            REG_SIZE_L:     reg_dout = size_out[7:0];
+            REG_SIZE_H:     reg_dout = size_out[15:8];
+            REG_RPTR_L:     reg_dout = rptr[7:0];
+            REG_RPTR_M:     reg_dout = rptr[15:8];
+            REG_RPTR_H:     reg_dout = rptr[23:16];
+            REG_READ_DATA:  reg_dout = rdata[rptr[1:0]*8 +: 8];
+            default:        reg_dout = 8'hFF;
+        endcase
+    end
+
+    logic [7:0] dout;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)        dout <= 8'hFF;
+        else if(det_io_rd)  dout <= (Bus.ADDR[0] == 0) ? status : reg_dout;
+    end
+
+    assign Bus.BUSDIR_n = io_rd_n;
+    assign Bus.DOUT = io_rd_n ? 8'h00 : dout;
+
+    /***************************************************************
+     * 未使用信号
+     ***************************************************************/
+    assign Bus.INT_n = 1;
+    assign Bus.WAIT_n = 1;
+
+endmodule
+
+`default_nettype wire
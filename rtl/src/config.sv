@@ -47,6 +47,7 @@ package CONFIG;
     localparam ENABLE_IKASCC    = 2;            // 機能の有効(IKASCC)
     localparam ENABLE_MEGA_SCC  = 2;            // 機能の有効(電源ON で SCC を有効)
     localparam ENABLE_MEGA_SCC_I= 3;            // 機能の有効(電源ON で SCC-I を有効)
+    localparam ENABLE_RAM_LARGE = 2;            // 機能の有効(空き SD-RAM を全てマッパーにしてセグメントレジスタを読み出し可能にする)
 
     /***************************************************************
      * フラッシュメモリマップ
@@ -57,9 +58,15 @@ package CONFIG;
      *  12_0000 +-------------------+
      *          | FM-BIOS(16KB)     |
      *  12_4000 +-------------------+
-     *          | (816KB)           |
+     *          | (688KB)           |
+     *  1D_0000 +-------------------+
+     *          | SRAM(64KB)        | (メガロム SRAM, 4KB x16 のジャーナル)
+     *  1E_0000 +-------------------+
+     *          | (60KB)            |
+     *  1E_F000 +-------------------+
+     *          | MIXER(4KB)        | (ミキサー音量の保存)
      *  1F_0000 +-------------------+
-     *          | PAC(64KB)         | (予定)
+     *          | PAC(64KB)         | (4KB x16 のジャーナル)
      *  20_0000 +-------------------+
      *          | MEGA ROM (2MB)    | (FLASHからMEGAROMをブートするときに使う予定)
      *  40_0000 +-------------------+
@@ -72,19 +79,31 @@ package CONFIG;
     localparam [23:0]   FLASH_SIZE_BIOS_FM      = 24'h00_4000;
     localparam [23:0]   FLASH_ADDR_PAC          = 24'h1F_0000;
     localparam [23:0]   FLASH_SIZE_PAC          = 24'h01_0000;
+    localparam [23:0]   FLASH_ADDR_SRAM         = 24'h1D_0000;
+    localparam [23:0]   FLASH_SIZE_SRAM         = 24'h01_0000;
+    localparam [23:0]   FLASH_ADDR_MIXER        = 24'h1E_F000;
+    localparam [23:0]   FLASH_SIZE_MIXER        = 24'h00_1000;
 
     /***************************************************************
      * SD-RAM メモリマップ
      *  00_0000 +-------------------+
      *          | MEM MAPPER(4MB)   |
      *  40_0000 +-------------------+
-     *          | MEGA ROM(3MB)     |
+     *          | MEGA ROM(3MB)     | (ENABLE_RAM=ENABLE_RAM_LARGE で MEGAROM 無効の時はマッパー(計7MB))
      *  70_0000 +-------------------+
      *          | NEXTOR(128KB)     |
      *  72_0000 +-------------------+
      *          | FM-BIOS(16KB)     |
      *  72_4000 +-------------------+
-     *          | (360KB)           |
+     *          | TRACE(256KB)      |
+     *  76_4000 +-------------------+
+     *          | VGM LOG(88KB)     | (音源レジスタ書き込みの記録)
+     *  77_A000 +-------------------+
+     *          | SRAM(8KB)         | (メガロム SRAM)
+     *  77_C000 +-------------------+
+     *          | MIXER(4KB)        | (ミキサー音量の保存用作業領域)
+     *  77_D000 +-------------------+
+     *          | PAC 作業領域(4KB) |
      *  77_E000 +-------------------+
      *          | PAC(8KB)          |
      *  78_0000 +-------------------+
@@ -92,12 +111,18 @@ package CONFIG;
      *  80_0000 +-------------------+
      ***************************************************************/
     localparam [23:0]   RAM_ADDR_RAM            = 24'h00_0000;
-    localparam [23:0]   RAM_SIZE_RAM            = 24'h40_0000;
     localparam [23:0]   RAM_ADDR_MEGAROM        = 24'h40_0000;
     localparam [23:0]   RAM_SIZE_MEGAROM        = 24'h30_0000;
     localparam [23:0]   RAM_ADDR_BIOS           = 24'h70_0000;
     localparam [23:0]   RAM_ADDR_BIOS_NEXTOR    = RAM_ADDR_BIOS;
     localparam [23:0]   RAM_ADDR_BIOS_FM        = (RAM_ADDR_BIOS_NEXTOR + FLASH_SIZE_BIOS_NEXTOR);
+    localparam [23:0]   RAM_ADDR_TRACE          = 24'h72_4000;
+    localparam [23:0]   RAM_SIZE_TRACE          = 24'h04_0000;
+    localparam [23:0]   RAM_ADDR_VGM_LOG        = 24'h76_4000;
+    localparam [23:0]   RAM_SIZE_VGM_LOG        = 24'h01_6000;
+    localparam [23:0]   RAM_ADDR_SRAM           = 24'h77_A000;
+    localparam [23:0]   RAM_ADDR_MIXER_WORK     = 24'h77_C000;
+    localparam [23:0]   RAM_ADDR_PAC_WORK       = 24'h77_D000;
     localparam [23:0]   RAM_ADDR_PAC            = 24'h77_E000;
     localparam [23:0]   RAM_ADDR_VRAM           = 24'h78_0000;
 
@@ -123,17 +148,35 @@ package CONFIG;
      ***************************************************************/
     localparam          ENABLE_MEGAROM          = ENABLE;           // メガロムカートリッジを有効にするか(DISABLE/ENABLE/ENABLE_MEGA_SCC/ENABLE_MEGA_SCC_I)
     localparam          ENABLE_FM               = ENABLE_IKAOPLL;   // FM 音源カートリッジを有効にするか(DISABLE/ENABLE_VM2413/ENABLE_IKAOPLL)
+    localparam          ENABLE_FM_NOWAIT        = DISABLE;          // FM 音源の書き込みを FIFO に溜めて CPU 側のウェイトを不要にするか(DISABLE/ENABLE)
     localparam          ENABLE_NEXTOR           = ENABLE;           // NEXTOR カートリッジを有効にするか(DISABLE/ENABLE)
-    localparam          ENABLE_RAM              = ENABLE;           // 拡張 RAM カートリッジを有効にするか(DISABLE/ENABLE)
+    localparam          ENABLE_RAM              = ENABLE;           // 拡張 RAM カートリッジを有効にするか(DISABLE/ENABLE/ENABLE_RAM_LARGE)
+    localparam          ENABLE_RAM_DMA          = DISABLE;          // 拡張 RAM の DMA を有効にするか(DISABLE/ENABLE, 実機未確認)
     localparam          ENABLE_PSG              = ENABLE;           // PSG を有効にするか(DISABLE/ENABLE)
     localparam          ENABLE_SCC              = ENABLE;           // SCC を有効にするか(DISABLE/ENABLE/ENABLE_IKASCC)
+    localparam          ENABLE_SCC_FILTER       = DISABLE;          // SCC の出力を補間フィルタで滑らかにするか(DISABLE/ENABLE)
     localparam          ENABLE_V9990            = ENABLE;           // V9990 を有効にするか(DISABLE/ENABLE)
     localparam          ENABLE_V9990_CMD        = ENABLE;           // V9990 の VDP コマンドを有効(V9990のVDPコマンドを有効にすると回路の規模が大きくなるので、他の大きな機能と同時使用はできない)
     localparam          ENABLE_PAC_WRITE        = ENABLE;           // PAC データを FLASH に保存するか(DISABLE/ENABLE)
     localparam          ENABLE_SCANLINE         = DISABLE;          // 200ラインモード時に走査線の隙間を空ける
+    localparam          ENABLE_TRACER           = DISABLE;          // バストレーサーを有効にするか(DISABLE/ENABLE)
+    localparam          ENABLE_VGM_LOGGER       = DISABLE;          // 音源レジスタ書き込みの VGM 記録を有効にするか(DISABLE/ENABLE)
 
     localparam          ENABLE_DAC_I2S          = DISABLE;          // I2S DAC を使用するか(DISABLE/ENABLE)
     localparam          ENABLE_DAC_STEREO       = DISABLE;          // ステレオ出力を有効にするか(DISABLE/ENABLE)
+    localparam          DAC_I2S_BIT_WIDTH       = 16;               // I2S の 1ch あたりのビット数(16/32, 32 の時は 24bit DAC も使用可能)
+    localparam          ENABLE_MIXER_MATRIX     = DISABLE;          // 1個の乗算器で音量を計算するミキサーを使うか(DISABLE/ENABLE, 有効時のみ音量をレジスタから変更可能, 未合成)
+
+    /***************************************************************
+     * 機能で決まる RAM 配置(参照する機能とアドレスより後で定義する)
+     ***************************************************************/
+    // ENABLE_RAM_LARGE でメガロムが無効の時はメガロム領域までマッパーにする
+    localparam [23:0]   RAM_SIZE_RAM            = (ENABLE_RAM == ENABLE_RAM_LARGE && ENABLE_MEGAROM == DISABLE) ? (RAM_ADDR_MEGAROM + RAM_SIZE_MEGAROM - RAM_ADDR_RAM) : 24'h40_0000;
+
+    /***************************************************************
+     * ファームウェアバージョン(メガロム設定レジスタ 007Ch で読み出す)
+     ***************************************************************/
+    localparam [7:0]    FIRMWARE_VERSION        = 8'h01;            // 上位4bit=メジャー, 下位4bit=マイナー
 
     /***************************************************************
      * other(ここを変更すると動作しなくなる可能性があります)
@@ -141,6 +184,7 @@ package CONFIG;
     localparam          RAM_IF_EXPANSION_USES_FF= 0;                // RAM I/F 拡張動作に FF を使用(0=使用しない/1=使用する)
     localparam          SLOT_EXPANSION_USES_FF  = 1;                // SLOT 拡張に FF を使用(0=使用しない/1=使用する)
     localparam          SOUND_BIT_WIDTH         = 10;               // サウンド生成の量子化幅(bits)
+    localparam          SOUND_STEREO_BIT_WIDTH  = 16;               // ステレオ出力の量子化幅(bits, 18 以下)
 endpackage
 
 `default_nettype wire
@@ -41,6 +41,8 @@ module MAIN #(
     BUS_IF.CARTRIDGE        Bus,                // BUS I/F
     RAM_IF.HOST             Ram,                // RAM I/F
     RAM_IF                  VideoRam,           // VRAM I/F
+    RAM_IF.HOST             TraceRam,           // バストレーサー用 RAM I/F
+    RAM_IF.HOST             VgmLogRam,          // VGM ロガー用 RAM I/F
     UMA_IF.CLK              UmaClock,           // UMA クロック
     SPI_IF                  TF,                 // TF カード I/F
     LED_IF                  LedNextor,          // Nextor 用 LED
@@ -60,6 +62,91 @@ module MAIN #(
     localparam SOUND_COUNT   = 4;
     SOUND_IF #(.BIT_WIDTH(CONFIG::SOUND_BIT_WIDTH)) Sound[0:SOUND_COUNT-1]();
 
+    /***************************************************************
+     * ミキサー音量
+     *  CONFIG の ATT_* は電源投入時の値で、MEGAROM_CONFIGURE の
+     *  レジスタから変更できる(MEGAROM 無効時と ENABLE_MIXER_MATRIX 無効時は固定)
+     ***************************************************************/
+    localparam MIX_OUT_EXT     = 0;
+    localparam MIX_OUT_INT     = 1;
+    localparam MIX_OUT_COUNT   = 2;
+    localparam MIX_GAIN_WIDTH  = 12;
+    localparam MIX_GAIN_SHIFT  = 10;
+
+    // CONFIG の MUL/DIV から音量を計算(機能が無効な時は 0)
+    function automatic [MIX_GAIN_WIDTH-1:0] mix_gain(input int enable, input int mul, input int div);
+        mix_gain = (enable == 0 || mul == 0 || div == 0) ? 0 : MIX_GAIN_WIDTH'((2 ** MIX_GAIN_SHIFT) * mul / div);
+    endfunction
+
+    localparam [MIX_OUT_COUNT*SOUND_COUNT*MIX_GAIN_WIDTH-1:0] MIX_GAIN = {
+        // カートリッジ出力(MIX_OUT_INT)
+        mix_gain(0,                       0,                            0                           ),  // SOUND_PSG
+        mix_gain(0,                       0,                            0                           ),  // SOUND_FM_EXT
+        mix_gain(CONFIG::ENABLE_FM,       CONFIG::ATT_INT_FM_MUL,       CONFIG::ATT_INT_FM_DIV      ),  // SOUND_FM_INT
+        mix_gain(CONFIG::ENABLE_MEGAROM,  CONFIG::ATT_INT_MEGAROM_MUL,  CONFIG::ATT_INT_MEGAROM_DIV ),  // SOUND_MEGAROM
+        // 外部出力(MIX_OUT_EXT)
+        mix_gain(CONFIG::ENABLE_PSG,      CONFIG::ATT_EXT_PSG_MUL,      CONFIG::ATT_EXT_PSG_DIV     ),  // SOUND_PSG
+        mix_gain(CONFIG::ENABLE_FM,       CONFIG::ATT_EXT_FM_MUL,       CONFIG::ATT_EXT_FM_DIV      ),  // SOUND_FM_EXT
+        mix_gain(0,                       0,                            0                           ),  // SOUND_FM_INT
+        mix_gain(CONFIG::ENABLE_MEGAROM,  CONFIG::ATT_EXT_MEGAROM_MUL,  CONFIG::ATT_EXT_MEGAROM_DIV )   // SOUND_MEGAROM
+    };
+    MIXER_IF #(.COUNT(MIX_OUT_COUNT*SOUND_COUNT), .GAIN_WIDTH(MIX_GAIN_WIDTH)) Mixer();
+
+    /***************************************************************
+     * ステレオ出力
+     *  SCC, PSG, FM 音源のチャンネル毎の信号を左右の音量を付けて加算する
+     *  音量の初期値は外部出力(MIX_OUT_EXT)の音量と同じで、中央に定位する
+     ***************************************************************/
+    localparam STEREO_ENABLE   = (EXT_SOUND_CH_COUNT >= 2);
+    localparam STEREO_SCC      = 0;     // SCC 5ch
+    localparam STEREO_PSG      = 5;     // PSG 3ch
+    localparam STEREO_FM       = 8;     // FM 音源 メロディ/リズム
+    localparam STEREO_IN_COUNT = 10;
+    localparam STEREO_OUT_L    = 0;
+    localparam STEREO_OUT_R    = 1;
+    localparam STEREO_OUT_COUNT= 2;
+    localparam PAN_GAIN_WIDTH  = 8;
+    localparam PAN_GAIN_SHIFT  = 7;
+    SOUND_IF #(.BIT_WIDTH(CONFIG::SOUND_STEREO_BIT_WIDTH)) SoundCh[0:STEREO_IN_COUNT-1]();
+    SOUND_IF #(.BIT_WIDTH(CONFIG::SOUND_STEREO_BIT_WIDTH)) SoundChScc[0:STEREO_PSG-STEREO_SCC-1]();
+    SOUND_IF #(.BIT_WIDTH(CONFIG::SOUND_STEREO_BIT_WIDTH)) SoundChPsg[0:STEREO_FM-STEREO_PSG-1]();
+    SOUND_IF #(.BIT_WIDTH(CONFIG::SOUND_STEREO_BIT_WIDTH)) SoundChFm[0:STEREO_IN_COUNT-STEREO_FM-1]();
+    generate
+        genvar stereo_ch;
+        for(stereo_ch = 0; stereo_ch < STEREO_IN_COUNT; stereo_ch = stereo_ch + 1) begin: stereo_ch_loop
+            if(stereo_ch < STEREO_PSG)     assign SoundCh[stereo_ch].Signal = SoundChScc[stereo_ch - STEREO_SCC].Signal;
+            else if(stereo_ch < STEREO_FM) assign SoundCh[stereo_ch].Signal = SoundChPsg[stereo_ch - STEREO_PSG].Signal;
+            else                           assign SoundCh[stereo_ch].Signal = SoundChFm[stereo_ch - STEREO_FM].Signal;
+        end
+    endgenerate
+
+    // 入力 ch の音源
+    function automatic int stereo_source(input int ch);
+        stereo_source = (ch < STEREO_PSG) ? SOUND_MEGAROM : (ch < STEREO_FM) ? SOUND_PSG : SOUND_FM_EXT;
+    endfunction
+
+    // MIX_GAIN の外部出力の音量から左右の音量を計算
+    function automatic [STEREO_OUT_COUNT*STEREO_IN_COUNT*PAN_GAIN_WIDTH-1:0] pan_gain();
+        int gain;
+        for(int out_ch = 0; out_ch < STEREO_OUT_COUNT; out_ch++) begin
+            for(int in_ch = 0; in_ch < STEREO_IN_COUNT; in_ch++) begin
+                gain = MIX_GAIN[(MIX_OUT_EXT * SOUND_COUNT + stereo_source(in_ch)) * MIX_GAIN_WIDTH +: MIX_GAIN_WIDTH] >> (MIX_GAIN_SHIFT - PAN_GAIN_SHIFT);
+                pan_gain[(out_ch * STEREO_IN_COUNT + in_ch) * PAN_GAIN_WIDTH +: PAN_GAIN_WIDTH] = PAN_GAIN_WIDTH'((gain > 255) ? 255 : gain);
+            end
+        end
+    endfunction
+
+    localparam [STEREO_OUT_COUNT*STEREO_IN_COUNT*PAN_GAIN_WIDTH-1:0] PAN_GAIN = pan_gain();
+    MIXER_IF #(.COUNT(STEREO_OUT_COUNT*STEREO_IN_COUNT), .GAIN_WIDTH(PAN_GAIN_WIDTH)) Pan();
+    always_comb Pan.connect_dummy();
+
+    /***************************************************************
+     * 音源レジスタ書き込み通知(VGM ロガー用)
+     ***************************************************************/
+    SOUND_REG_IF SoundRegScc();
+    SOUND_REG_IF SoundRegPsg();
+    SOUND_REG_IF SoundRegFm();
+
     /***************************************************************
      * RAM I/F を複数に拡張
      ***************************************************************/
@@ -68,7 +155,8 @@ module MAIN #(
     localparam RAM_NEXTOR     = 2;
     localparam RAM_RAM        = 3;
     localparam RAM_BOOTLOADER = 4;
-    localparam RAM_COUNT      = 5;
+    localparam RAM_DMA        = 5;
+    localparam RAM_COUNT      = 6;
     RAM_IF ExpRam[0:RAM_COUNT-1]();
     EXPANSION_RAM #(
         .COUNT          (RAM_COUNT),
@@ -89,7 +177,10 @@ module MAIN #(
     localparam BUS_RAM     = 3;
     localparam BUS_PSG     = 4;     // SLTSL_n 信号なし(I/Oのみ)
     localparam BUS_V9990   = 5;     // SLTSL_n 信号なし(I/Oのみ)
-    localparam BUS_COUNT   = 6;
+    localparam BUS_DMA     = 6;     // SLTSL_n 信号なし(I/Oのみ)
+    localparam BUS_TRACER  = 7;     // SLTSL_n 信号なし(I/Oのみ)
+    localparam BUS_VGM_LOG = 8;     // SLTSL_n 信号なし(I/Oのみ)
+    localparam BUS_COUNT   = 9;
     BUS_IF  ExpBus[0:BUS_COUNT-1]();
     EXPANSION_SLOT #(
         .COUNT          (BUS_COUNT),
@@ -106,6 +197,7 @@ module MAIN #(
      * MEGAROM カートリッジ
      ***************************************************************/
     XFER_IF Xfer();
+    PAC_IF PacMegarom();
     if(CONFIG::ENABLE_MEGAROM) begin
         localparam [7:0]     DEFAULT_BANK_REG_INIT_0     = (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC_I) ? 0        : (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC) ? 0        : 0;
         localparam [7:0]     DEFAULT_BANK_REG_INIT_1     = (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC_I) ? 1        : (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC) ? 1        : 0;
@@ -125,6 +217,26 @@ module MAIN #(
         localparam [0:0]     DEFAULT_SCC_I_ENA           = (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC_I) ? 1'b1     : (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC) ? 1'b0     : 1'b0;
         localparam [0:0]     DEFAULT_ENABLE_CONTINUOUS   = (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC_I) ? 1'b1     : (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC) ? 1'b1     : 1'b0;
         localparam [0:0]     DEFAULT_ENABLE              = (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC_I) ? 1'b1     : (CONFIG::ENABLE_MEGAROM == CONFIG::ENABLE_MEGA_SCC) ? 1'b1     : 1'b0;
+
+        // 機能フラグ(メガロム設定レジスタ 007Dh~007Eh で読み出す)
+        localparam [15:0]    FEATURES = {
+            1'(CONFIG::ENABLE_RAM == CONFIG::ENABLE_RAM_LARGE),     // b15 拡張 RAM 7MB
+            1'(CONFIG::ENABLE_SCC == CONFIG::ENABLE),               // b14 SCC-I
+            1'b1,                                                   // b13 CRC32 計算("@CR\r")
+            1'(CONFIG::ENABLE_FM_NOWAIT    != CONFIG::DISABLE),     // b12 FM 書き込み FIFO
+            1'(CONFIG::ENABLE_DAC_STEREO   != CONFIG::DISABLE),     // b11 ステレオ出力
+            1'(CONFIG::ENABLE_VGM_LOGGER   != CONFIG::DISABLE),     // b10 VGM ロガー
+            1'(CONFIG::ENABLE_TRACER       != CONFIG::DISABLE),     // b9  バストレーサー
+            1'(CONFIG::ENABLE_PAC_WRITE    != CONFIG::DISABLE),     // b8  PAC 書き込み
+            1'(CONFIG::ENABLE_V9990        != CONFIG::DISABLE),     // b7  V9990
+            1'(CONFIG::ENABLE_PSG          != CONFIG::DISABLE),     // b6  PSG
+            1'(CONFIG::ENABLE_RAM_DMA      != CONFIG::DISABLE && CONFIG::ENABLE_RAM != CONFIG::DISABLE),   // b5  拡張 RAM DMA
+            1'(CONFIG::ENABLE_RAM          != CONFIG::DISABLE),     // b4  拡張 RAM
+            1'(CONFIG::ENABLE_NEXTOR       != CONFIG::DISABLE),     // b3  NEXTOR
+            1'(CONFIG::ENABLE_FM           != CONFIG::DISABLE),     // b2  FM 音源
+            1'(CONFIG::ENABLE_SCC          != CONFIG::DISABLE),     // b1  SCC
+            1'b1                                                    // b0  メガロム
+        };
         CARTRIDGE_MEGAROM #(
             .FLASH_FS_ADDR          (0),
             .FLASH_FS_SIZE          (24'h10_0000),
@@ -138,6 +250,9 @@ module MAIN #(
             .FLASH_PAC_SIZE         (CONFIG::FLASH_SIZE_PAC),
             .RAM_ADDR               (CONFIG::RAM_ADDR_MEGAROM),
             .RAM_SIZE               (CONFIG::RAM_SIZE_MEGAROM),
+            .FLASH_MIXER_ADDR       (CONFIG::FLASH_ADDR_MIXER),
+            .RAM_MIXER_ADDR         (CONFIG::RAM_ADDR_MIXER_WORK),
+            .RAM_SRAM_ADDR          (CONFIG::RAM_ADDR_SRAM),
             .DEFAULT_BANK_REG_INIT_0(DEFAULT_BANK_REG_INIT_0),
             .DEFAULT_BANK_REG_INIT_1(DEFAULT_BANK_REG_INIT_1),
             .DEFAULT_BANK_REG_INIT_2(DEFAULT_BANK_REG_INIT_2),
@@ -155,27 +270,46 @@ module MAIN #(
             .DEFAULT_SCC_ENA(DEFAULT_SCC_ENA),
             .DEFAULT_SCC_I_ENA(DEFAULT_SCC_I_ENA),
             .DEFAULT_ENABLE_CONTINUOUS(DEFAULT_ENABLE_CONTINUOUS),
-            .DEFAULT_ENABLE(DEFAULT_ENABLE)
+            .DEFAULT_ENABLE(DEFAULT_ENABLE),
+            .DEFAULT_MIX_GAIN(MIX_GAIN),
+            .ENABLE_PAN(STEREO_ENABLE),
+            .DEFAULT_PAN_GAIN(PAN_GAIN),
+            .BOARD_ID               (CONFIG_BOARD::BOARD_ID),
+            .FIRMWARE_VERSION       (CONFIG::FIRMWARE_VERSION),
+            .FEATURES               (FEATURES)
         ) u_megarom (
             .RESET_n        (SYS_RESET_n),
             .CLK,
             .Bus            (ExpBus[BUS_MEGAROM]),
             .Ram            (ExpRam[RAM_MEGAROM]),
             .Xfer           (Xfer),
-            .Sound          (Sound[SOUND_MEGAROM])
+            .Sram           (PacMegarom),
+            .Mixer          (Mixer),
+            .Pan            (Pan),
+            .Sound          (Sound[SOUND_MEGAROM]),
+            .SoundCh        (SoundChScc),
+            .SccReg         (SoundRegScc)
         );
         end
     else begin
         always_comb ExpBus[BUS_MEGAROM].connect_dummy();
         always_comb ExpRam[RAM_MEGAROM].connect_dummy();
         always_comb Sound[SOUND_MEGAROM].connect_dummy();
+        always_comb SoundRegScc.connect_dummy();
+        genvar ch;
+        for(ch = 0; ch < STEREO_PSG - STEREO_SCC; ch = ch + 1) begin: ch_dummy
+            always_comb SoundChScc[ch].connect_dummy();
+        end
         always_comb Xfer.connect_dummy();
+        always_comb PacMegarom.connect_dummy();
+        assign Mixer.Gain = MIX_GAIN;
+        assign Pan.Gain = PAN_GAIN;
     end
 
     /***************************************************************
      * FM 音源カートリッジ
      ***************************************************************/
-    PAC_IF PAC();
+    PAC_IF PacFm();
     if(CONFIG::ENABLE_FM) begin
         wire FM_Sound_Enable;
         CARTRIDGE_FM #(
@@ -187,18 +321,25 @@ module MAIN #(
             .CLK,
             .Bus            (ExpBus[BUS_FM]),
             .Ram            (ExpRam[RAM_FM]),
-            .PAC            (PAC),
+            .PAC            (PacFm),
             .Sound          (Sound[SOUND_FM_EXT]),
+            .SoundCh        (SoundChFm),
+            .Reg            (SoundRegFm),
             .Output_En      (FM_Sound_Enable)
         );
         assign Sound[SOUND_FM_INT].Signal = FM_Sound_Enable ? Sound[SOUND_FM_EXT].Signal : 0;
     end
     else begin
-        always_comb PAC.connect_dummy();
+        always_comb PacFm.connect_dummy();
         always_comb ExpBus[BUS_FM].connect_dummy();
         always_comb ExpRam[RAM_FM].connect_dummy();
         always_comb Sound[SOUND_FM_EXT].connect_dummy();
         always_comb Sound[SOUND_FM_INT].connect_dummy();
+        always_comb SoundRegFm.connect_dummy();
+        genvar ch;
+        for(ch = 0; ch < STEREO_IN_COUNT - STEREO_FM; ch = ch + 1) begin: ch_dummy
+            always_comb SoundChFm[ch].connect_dummy();
+        end
     end
 
     /***************************************************************
@@ -228,7 +369,9 @@ module MAIN #(
      ***************************************************************/
     if(CONFIG::ENABLE_RAM) begin
         CARTRIDGE_RAM #(
-            .RAM_ADDR       (CONFIG::RAM_ADDR_RAM)
+            .RAM_ADDR       (CONFIG::RAM_ADDR_RAM),
+            .RAM_SIZE       (CONFIG::RAM_SIZE_RAM),
+            .READABLE       (CONFIG::ENABLE_RAM == CONFIG::ENABLE_RAM_LARGE)
         ) u_ram (
             .RESET_n        (SYS_RESET_n),
             .CLK,
@@ -241,6 +384,67 @@ module MAIN #(
         always_comb ExpRam[RAM_RAM].connect_dummy();
     end
 
+    /***************************************************************
+     * メモリマッパー DMA
+     ***************************************************************/
+    if(CONFIG::ENABLE_RAM && CONFIG::ENABLE_RAM_DMA) begin
+        CARTRIDGE_DMA #(
+            .RAM_ADDR       (CONFIG::RAM_ADDR_RAM),
+            .RAM_SIZE       (CONFIG::RAM_SIZE_RAM),
+            .VRAM_ADDR      (CONFIG::RAM_ADDR_VRAM)
+        ) u_dma (
+            .RESET_n        (SYS_RESET_n),
+            .CLK,
+            .Bus            (ExpBus[BUS_DMA]),
+            .Ram            (ExpRam[RAM_DMA])
+        );
+    end
+    else begin
+        always_comb ExpBus[BUS_DMA].connect_dummy();
+        always_comb ExpRam[RAM_DMA].connect_dummy();
+    end
+
+    /***************************************************************
+     * バストレーサー
+     ***************************************************************/
+    if(CONFIG::ENABLE_TRACER) begin
+        CARTRIDGE_TRACER #(
+            .RAM_ADDR       (CONFIG::RAM_ADDR_TRACE),
+            .RAM_SIZE       (CONFIG::RAM_SIZE_TRACE)
+        ) u_tracer (
+            .RESET_n        (SYS_RESET_n),
+            .CLK,
+            .Bus            (ExpBus[BUS_TRACER]),
+            .Ram            (TraceRam)
+        );
+    end
+    else begin
+        always_comb ExpBus[BUS_TRACER].connect_dummy();
+        always_comb TraceRam.connect_dummy();
+    end
+
+    /***************************************************************
+     * VGM ロガー
+     ***************************************************************/
+    if(CONFIG::ENABLE_VGM_LOGGER) begin
+        CARTRIDGE_VGM_LOGGER #(
+            .RAM_ADDR       (CONFIG::RAM_ADDR_VGM_LOG),
+            .RAM_SIZE       (CONFIG::RAM_SIZE_VGM_LOG)
+        ) u_vgm_logger (
+            .RESET_n        (SYS_RESET_n),
+            .CLK,
+            .Bus            (ExpBus[BUS_VGM_LOG]),
+            .Ram            (VgmLogRam),
+            .Psg            (SoundRegPsg),
+            .Fm             (SoundRegFm),
+            .Scc            (SoundRegScc)
+        );
+    end
+    else begin
+        always_comb ExpBus[BUS_VGM_LOG].connect_dummy();
+        always_comb VgmLogRam.connect_dummy();
+    end
+
     /***************************************************************
      * PSG カートリッジ
      ***************************************************************/
@@ -249,12 +453,19 @@ module MAIN #(
             .RESET_n        (SYS_RESET_n),
             .CLK,
             .Bus            (ExpBus[BUS_PSG]),
-            .Sound          (Sound[SOUND_PSG])
+            .Sound          (Sound[SOUND_PSG]),
+            .SoundCh        (SoundChPsg),
+            .Reg            (SoundRegPsg)
         );
     end
     else begin
         always_comb ExpBus[BUS_PSG].connect_dummy();
         always_comb Sound[SOUND_PSG].connect_dummy();
+        always_comb SoundRegPsg.connect_dummy();
+        genvar ch;
+        for(ch = 0; ch < STEREO_FM - STEREO_PSG; ch = ch + 1) begin: ch_dummy
+            always_comb SoundChPsg[ch].connect_dummy();
+        end
     end
 
     /***************************************************************
@@ -297,7 +508,12 @@ module MAIN #(
         .RAM_CLEAR_ADDR (CONFIG::RAM_ADDR_RAM),
         .RAM_CLEAR_SIZE (65536),
         .PAC_RAM_ADDR   (CONFIG::RAM_ADDR_PAC),
-        .PAC_FLASH_ADDR (CONFIG::FLASH_ADDR_PAC)
+        .PAC_FLASH_ADDR (CONFIG::FLASH_ADDR_PAC),
+        .PAC_WORK_ADDR  (CONFIG::RAM_ADDR_PAC_WORK),
+        .SRAM_RAM_ADDR  (CONFIG::RAM_ADDR_SRAM),
+        .SRAM_FLASH_ADDR(CONFIG::ENABLE_MEGAROM ? CONFIG::FLASH_ADDR_SRAM : 24'd0),
+        .MIXER_FLASH_ADDR(CONFIG::FLASH_ADDR_MIXER),
+        .MIXER_WORK_ADDR(CONFIG::RAM_ADDR_MIXER_WORK)
     ) u_boot (
         .RESET_n,
         .CLK,
@@ -305,7 +521,9 @@ module MAIN #(
         .Ram            (ExpRam[RAM_BOOTLOADER]),
         .Led            (LedBoot),
         .Xfer           (Xfer),
-        .PAC            (PAC),
+        .PAC            (PacFm),
+        .SRAM           (PacMegarom),
+        .Mixer          (Mixer),
         .ClearMegarom   (1'b1),
         .BusReset_n     (Bus.RESET_n),
         .RD_n           (Bus.RD_n),
@@ -316,141 +534,194 @@ module MAIN #(
     );
 
     /***************************************************************
-     * 外部サウンド出力ミキサー
+     * サウンド出力ミキサー
      ***************************************************************/
-    localparam SOUND_EXT_MEGAROM = 0;
-    localparam SOUND_EXT_FM      = 1;
-    localparam SOUND_EXT_PSG     = 2;
-    localparam SOUND_EXT_COUNT   = 3;
-    SOUND_IF #(.BIT_WIDTH($bits(Sound[0].Signal))) AttOutExt[0:SOUND_EXT_COUNT-1]();
+    SOUND_IF #(.BIT_WIDTH($bits(Sound[0].Signal))) MixOut[0:MIX_OUT_COUNT-1]();
 
-    if(CONFIG::ENABLE_MEGAROM) begin
-        SOUND_ATTENUATOR #(
-            .MUL(CONFIG::ATT_EXT_MEGAROM_MUL),
-            .DIV(CONFIG::ATT_EXT_MEGAROM_DIV)
-        ) u_att_ext_megarom (
+    if(CONFIG::ENABLE_MIXER_MATRIX) begin
+        /***************************************************************
+         * マトリクスミキサー
+         *  外部出力とカートリッジ出力を 1個の乗算器で順番に計算する
+         *  (音量はレジスタから変更できる)
+         ***************************************************************/
+        SOUND_MIXER_MATRIX #(
+            .IN_COUNT       (SOUND_COUNT),
+            .OUT_COUNT      (MIX_OUT_COUNT),
+            .GAIN_WIDTH     (MIX_GAIN_WIDTH),
+            .GAIN_SHIFT     (MIX_GAIN_SHIFT)
+        ) u_mixer (
             .RESET_n,
             .CLK,
-            .IN(Sound[SOUND_MEGAROM]),
-            .OUT(AttOutExt[SOUND_EXT_MEGAROM])
+            .IN             (Sound),
+            .GAIN           (Mixer.Gain),
+            .OUT            (MixOut)
         );
     end
     else begin
-        always_comb AttOutExt[SOUND_EXT_MEGAROM].connect_dummy();
-    end
+        /***************************************************************
+         * 外部サウンド出力ミキサー
+         *  音量は CONFIG の ATT_* に固定
+         ***************************************************************/
+        localparam SOUND_EXT_MEGAROM = 0;
+        localparam SOUND_EXT_FM      = 1;
+        localparam SOUND_EXT_PSG     = 2;
+        localparam SOUND_EXT_COUNT   = 3;
+        SOUND_IF #(.BIT_WIDTH($bits(Sound[0].Signal))) AttOutExt[0:SOUND_EXT_COUNT-1]();
 
-    if(CONFIG::ENABLE_FM) begin
-        SOUND_ATTENUATOR #(
-            .MUL(CONFIG::ATT_EXT_FM_MUL),
-            .DIV(CONFIG::ATT_EXT_FM_DIV)
-        ) u_att_ext_fm (
-            .RESET_n,
-            .CLK,
-            .IN(Sound[SOUND_FM_EXT]),
-            .OUT(AttOutExt[SOUND_EXT_FM])
-        );
-    end
-    else begin
-        always_comb AttOutExt[SOUND_EXT_FM].connect_dummy();
-    end
+        if(CONFIG::ENABLE_MEGAROM) begin
+            SOUND_ATTENUATOR #(
+                .MUL(CONFIG::ATT_EXT_MEGAROM_MUL),
+                .DIV(CONFIG::ATT_EXT_MEGAROM_DIV)
+            ) u_att_ext_megarom (
+                .RESET_n,
+                .CLK,
+                .IN(Sound[SOUND_MEGAROM]),
+                .OUT(AttOutExt[SOUND_EXT_MEGAROM])
+            );
+        end
+        else begin
+            always_comb AttOutExt[SOUND_EXT_MEGAROM].connect_dummy();
+        end
 
-    if(CONFIG::ENABLE_PSG) begin
-        SOUND_ATTENUATOR #(
-            .MUL(CONFIG::ATT_EXT_PSG_MUL),
-            .DIV(CONFIG::ATT_EXT_PSG_DIV)
-        ) u_att_ext_psg (
+        if(CONFIG::ENABLE_FM) begin
+            SOUND_ATTENUATOR #(
+                .MUL(CONFIG::ATT_EXT_FM_MUL),
+                .DIV(CONFIG::ATT_EXT_FM_DIV)
+            ) u_att_ext_fm (
+                .RESET_n,
+                .CLK,
+                .IN(Sound[SOUND_FM_EXT]),
+                .OUT(AttOutExt[SOUND_EXT_FM])
+            );
+        end
+        else begin
+            always_comb AttOutExt[SOUND_EXT_FM].connect_dummy();
+        end
+
+        if(CONFIG::ENABLE_PSG) begin
+            SOUND_ATTENUATOR #(
+                .MUL(CONFIG::ATT_EXT_PSG_MUL),
+                .DIV(CONFIG::ATT_EXT_PSG_DIV)
+            ) u_att_ext_psg (
+                .RESET_n,
+                .CLK,
+                .IN(Sound[SOUND_PSG]),
+                .OUT(AttOutExt[SOUND_EXT_PSG])
+            );
+        end
+        else begin
+            always_comb AttOutExt[SOUND_EXT_PSG].connect_dummy();
+        end
+
+        SOUND_MIXER #(
+            .COUNT          (SOUND_EXT_COUNT)
+        ) u_mixer_ext (
             .RESET_n,
             .CLK,
-            .IN(Sound[SOUND_PSG]),
-            .OUT(AttOutExt[SOUND_EXT_PSG])
+            .IN             (AttOutExt),
+            .OUT            (MixOut[MIX_OUT_EXT])
         );
-    end
-    else begin
-        always_comb AttOutExt[SOUND_EXT_PSG].connect_dummy();
-    end
-
-    SOUND_IF #(.BIT_WIDTH($bits(AttOutExt[0].Signal))) mix_ext();
 
-    SOUND_MIXER #(
-        .COUNT          (SOUND_EXT_COUNT)
-    ) u_mixer_ext (
-        .RESET_n,
-        .CLK,
-        .IN             (AttOutExt),
-        .OUT            (mix_ext)
-    );
+        /***************************************************************
+         * カートリッジサウンド出力ミキサー
+         *  音量は CONFIG の ATT_* に固定
+         ***************************************************************/
+        localparam SOUND_INT_MEGAROM = 0;
+        localparam SOUND_INT_FM      = 1;
+        localparam SOUND_INT_COUNT   = 2;
+        SOUND_IF #(.BIT_WIDTH($bits(Sound[0].Signal))) AttOutInt[0:SOUND_INT_COUNT-1]();
 
-    if($bits(SoundExternal[0].Signal) == $bits(mix_ext.Signal)) begin
-        assign SoundExternal[0].Signal = mix_ext.Signal;
-    end
-    else begin
-        wire [$bits(mix_ext.Signal)+16-1:0] mix_ext_ex = { mix_ext.Signal, 16'd0 };
-        assign SoundExternal[0].Signal = mix_ext_ex[$bits(mix_ext_ex)-1:$bits(mix_ext_ex)-$bits(SoundExternal[0].Signal)];
-    end
-
-    generate
-        genvar ext_ch;
-        if(EXT_SOUND_CH_COUNT >= 2) begin
-            for(ext_ch = 1; ext_ch < EXT_SOUND_CH_COUNT; ext_ch = ext_ch + 1) begin: ch
-                assign SoundExternal[ext_ch].Signal = 0;
-            end
+        if(CONFIG::ENABLE_MEGAROM) begin
+            SOUND_ATTENUATOR #(
+                .MUL(CONFIG::ATT_INT_MEGAROM_MUL),
+                .DIV(CONFIG::ATT_INT_MEGAROM_DIV)
+            ) u_att_int_megarom (
+                .RESET_n,
+                .CLK,
+                .IN(Sound[SOUND_MEGAROM]),
+                .OUT(AttOutInt[SOUND_INT_MEGAROM])
+            );
+        end
+        else begin
+            always_comb AttOutInt[SOUND_INT_MEGAROM].connect_dummy();
         end
-    endgenerate
 
-    /***************************************************************
-     * カートリッジサウンド出力ミキサー
-     ***************************************************************/
-    localparam SOUND_INT_MEGAROM = 0;
-    localparam SOUND_INT_FM      = 1;
-    localparam SOUND_INT_COUNT   = 2;
-    SOUND_IF #(.BIT_WIDTH($bits(Sound[0].Signal))) AttOutInt[0:SOUND_INT_COUNT-1]();
+        if(CONFIG::ENABLE_FM) begin
+            SOUND_ATTENUATOR #(
+                .MUL(CONFIG::ATT_INT_FM_MUL),
+                .DIV(CONFIG::ATT_INT_FM_DIV)
+            ) u_att_int_fm (
+                .RESET_n,
+                .CLK,
+                .IN(Sound[SOUND_FM_INT]),
+                .OUT(AttOutInt[SOUND_INT_FM])
+            );
+        end
+        else begin
+            always_comb AttOutInt[SOUND_INT_FM].connect_dummy();
+        end
 
-    if(CONFIG::ENABLE_MEGAROM) begin
-        SOUND_ATTENUATOR #(
-            .MUL(CONFIG::ATT_INT_MEGAROM_MUL),
-            .DIV(CONFIG::ATT_INT_MEGAROM_DIV)
-        ) u_att_int_megarom (
+        SOUND_MIXER #(
+            .COUNT          (SOUND_INT_COUNT)
+        ) u_mixer_int (
             .RESET_n,
             .CLK,
-            .IN(Sound[SOUND_MEGAROM]),
-            .OUT(AttOutInt[SOUND_INT_MEGAROM])
+            .IN             (AttOutInt),
+            .OUT            (MixOut[MIX_OUT_INT])
         );
     end
-    else begin
-        always_comb AttOutInt[SOUND_INT_MEGAROM].connect_dummy();
-    end
 
-    if(CONFIG::ENABLE_FM) begin
-        SOUND_ATTENUATOR #(
-            .MUL(CONFIG::ATT_INT_FM_MUL),
-            .DIV(CONFIG::ATT_INT_FM_DIV)
-        ) u_att_int_fm (
+    /***************************************************************
+     * 外部サウンド出力
+     ***************************************************************/
+    if(STEREO_ENABLE) begin
+        /***************************************************************
+         * ステレオ
+         *  チャンネル毎の信号に左右の音量を付けて 1個の乗算器で順番に計算する
+         ***************************************************************/
+        SOUND_IF #(.BIT_WIDTH(CONFIG::SOUND_STEREO_BIT_WIDTH)) StereoOut[0:STEREO_OUT_COUNT-1]();
+
+        SOUND_MIXER_MATRIX #(
+            .IN_COUNT       (STEREO_IN_COUNT),
+            .OUT_COUNT      (STEREO_OUT_COUNT),
+            .GAIN_WIDTH     (PAN_GAIN_WIDTH),
+            .GAIN_SHIFT     (PAN_GAIN_SHIFT)
+        ) u_stereo_mixer (
             .RESET_n,
             .CLK,
-            .IN(Sound[SOUND_FM_INT]),
-            .OUT(AttOutInt[SOUND_INT_FM])
+            .IN             (SoundCh),
+            .GAIN           (Pan.Gain),
+            .OUT            (StereoOut)
         );
+
+        genvar ext_ch;
+        for(ext_ch = 0; ext_ch < EXT_SOUND_CH_COUNT; ext_ch = ext_ch + 1) begin: ch
+            localparam out_ch = (ext_ch == 0) ? STEREO_OUT_L : STEREO_OUT_R;
+            wire [$bits(StereoOut[0].Signal)+24-1:0] stereo_ex = { StereoOut[out_ch].Signal, 24'd0 };
+            assign SoundExternal[ext_ch].Signal = stereo_ex[$bits(stereo_ex)-1:$bits(stereo_ex)-$bits(SoundExternal[ext_ch].Signal)];
+        end
     end
     else begin
-        always_comb AttOutInt[SOUND_INT_FM].connect_dummy();
+        /***************************************************************
+         * モノラル
+         ***************************************************************/
+        if($bits(SoundExternal[0].Signal) == $bits(MixOut[MIX_OUT_EXT].Signal)) begin
+            assign SoundExternal[0].Signal = MixOut[MIX_OUT_EXT].Signal;
+        end
+        else begin
+            wire [$bits(MixOut[MIX_OUT_EXT].Signal)+16-1:0] mix_ext_ex = { MixOut[MIX_OUT_EXT].Signal, 16'd0 };
+            assign SoundExternal[0].Signal = mix_ext_ex[$bits(mix_ext_ex)-1:$bits(mix_ext_ex)-$bits(SoundExternal[0].Signal)];
+        end
     end
 
-    SOUND_IF #(.BIT_WIDTH($bits(AttOutInt[0].Signal))) mix_int();
-
-    SOUND_MIXER #(
-        .COUNT          (SOUND_INT_COUNT)
-    ) u_mixer_int (
-        .RESET_n,
-        .CLK,
-        .IN             (AttOutInt),
-        .OUT            (mix_int)
-    );
-
-    if($bits(SoundInternal.Signal) == $bits(mix_int.Signal)) begin
-        assign SoundInternal.Signal = mix_int.Signal;
+    /***************************************************************
+     * カートリッジサウンド出力
+     ***************************************************************/
+    if($bits(SoundInternal.Signal) == $bits(MixOut[MIX_OUT_INT].Signal)) begin
+        assign SoundInternal.Signal = MixOut[MIX_OUT_INT].Signal;
     end
     else begin
-        wire [$bits(mix_int.Signal)+16-1:0] mix_int_ex = { mix_int.Signal, 16'd0 };
+        wire [$bits(MixOut[MIX_OUT_INT].Signal)+16-1:0] mix_int_ex = { MixOut[MIX_OUT_INT].Signal, 16'd0 };
         assign SoundInternal.Signal = mix_int_ex[$bits(mix_int_ex)-1:$bits(mix_int_ex)-$bits(SoundInternal.Signal)];
     end
 
@@ -82,6 +82,7 @@ module FLASH_SPI (
     localparam [7:0] CMD_READ_STATUS    = 8'h05;
     localparam [7:0] CMD_PAGE_PROGRAM   = 8'h02;
     localparam [7:0] CMD_BLOCK_ERASE_64 = 8'hD8;
+    localparam [7:0] CMD_SECTOR_ERASE_4 = 8'h20;
 
     localparam cs_delay = 10;
     logic [$clog2(cs_delay+1)-1:0] delay_count; // 一定時間待機用
@@ -261,7 +262,8 @@ module FLASH_SPI (
                     end
                     SUB_STATE_ERASE_SEND:
                     begin
-                        SPI.MOSI[$bits(SPI.MOSI)-1:$bits(SPI.MOSI)-($bits(Flash.Address) + $bits(CMD_BLOCK_ERASE_64))] <= { CMD_BLOCK_ERASE_64, Flash.Address };
+                        // WData で指定されたイレーズコマンド(64KB ブロック / 4KB セクタ)
+                        SPI.MOSI[$bits(SPI.MOSI)-1:$bits(SPI.MOSI)-($bits(Flash.Address) + $bits(CMD_BLOCK_ERASE_64))] <= { Flash.WData, Flash.Address };
                         SPI.LEN <= $bits(Flash.Address) + $bits(CMD_BLOCK_ERASE_64);
                         SPI.REQ <= 1;
                         sub_state <= SUB_STATE_EXIT;
@@ -375,7 +377,7 @@ module FLASH_SPI (
                      *****************************************************************************/
                     STATE_ERASE:
                     begin
-                        if(Flash.Enable_n != 0 && Flash.WData == CMD_BLOCK_ERASE_64) begin
+                        if(Flash.Enable_n != 0 && (Flash.WData == CMD_BLOCK_ERASE_64 || Flash.WData == CMD_SECTOR_ERASE_4)) begin
                             sub_state <= SUB_STATE_WRITE_ENABLE;
                             state <= STATE_ERASE_SEND;
                         end
@@ -40,6 +40,14 @@
 //  0001h   キー1
 //  0002h   キー2
 //  0003h   キー3
+//  0004h   SRAM フラグ
+//              b0~b3   SRAM 書き込み許可(4000h/6000h/8000h/A000h の 8KB 領域毎, 1=許可)
+//              b4      SRAM 4KB ページ(1=バンクレジスタの bit5 で 4KB ページを選択, A12=1 の領域のみ書き込み可)
+//  0005h   SRAM アドレスマスク上位(A12~A8, 1Fh=8KB/07h=2KB)
+//  0008h   バンクレジスタデータマスク上位(上位バンクレジスタのマスク)
+//  0009h   SRAM 選択ビット(バンクレジスタのライト値とのANDが 0 以外なら SRAM, 0=SRAM なし)
+//  000Ah   上位バンクレジスタアドレス下位(バンクレジスタアドレスとの XOR)
+//  000Bh   上位バンクレジスタアドレス上位
 //  000Ch   フラグ
 //              b0  ライトプロテクト(1=書き込み禁止/0=書き込み許可)
 //              b1  バンクサイズ(0=8KB/1=16KB)
@@ -52,19 +60,47 @@
 //  0010h   BANK#0 レジスタアドレス下位
 //  0011h   BANK#0 レジスタアドレス上位
 //  0012h   BANK#0 初期値
-//  0013h   予約
+//  0013h   BANK#0 初期値上位
 //  0014h   BANK#1 レジスタアドレス下位
 //  0015h   BANK#1 レジスタアドレス上位
 //  0016h   BANK#1 初期値
-//  0017h   予約
+//  0017h   BANK#1 初期値上位
 //  0018h   BANK#2 レジスタアドレス下位
 //  0019h   BANK#2 レジスタアドレス上位
 //  001Ah   BANK#2 初期値
-//  001Bh   予約
+//  001Bh   BANK#2 初期値上位
 //  001Ch   BANK#3 レジスタアドレス下位
 //  001Dh   BANK#3 レジスタアドレス上位
 //  001Eh   BANK#3 初期値
-//  001Fh   予約
+//  001Fh   BANK#3 初期値上位
+//  0020h~003Fh フラッシュ転送
+//  002Ch~002Fh CRC32(R, "@CR\r" で RAM アドレスからサイズ分を計算, 下位から)
+//  003Fh       フラッシュ転送コマンド("@EB\r" で 64KB ブロック消去, "@ES\r" で 4KB セクタ消去)
+//  0040h   ミキサー音量#0 下位
+//  0041h   ミキサー音量#0 上位
+//   :
+//  004Eh   ミキサー音量#7 下位
+//  004Fh   ミキサー音量#7 上位
+//  0050h   音量保存用フラッシュアドレス中位(R)
+//  0051h   音量保存用フラッシュアドレス上位(R)
+//  0052h   音量保存用 RAM アドレス中位(R)
+//  0053h   音量保存用 RAM アドレス上位(R)
+//  0060h   ステレオ出力 左音量#0(128 で 0dB)
+//   :
+//  0069h   ステレオ出力 左音量#9
+//  006Ah   ステレオ出力 右音量#0
+//   :
+//  0073h   ステレオ出力 右音量#9
+//  0078h~007Ah 識別子 'T','N','C'(R, ロック中も読み出し可能)
+//  007Bh   ボード ID(R, board_id.sv)
+//  007Ch   ファームウェアバージョン(R, config.sv の FIRMWARE_VERSION)
+//  007Dh   機能フラグ下位(R)
+//              b0  メガロム        b1  SCC             b2  FM 音源         b3  NEXTOR
+//              b4  拡張 RAM        b5  拡張 RAM DMA    b6  PSG             b7  V9990
+//  007Eh   機能フラグ上位(R)
+//              b0  PAC 書き込み    b1  バストレーサー  b2  VGM ロガー      b3  ステレオ出力
+//              b4  FM 書き込み FIFO b5 CRC32 計算      b6  SCC-I           b7  拡張 RAM 7MB
+//  007Fh   予約(R, 00h)
 
 module MEGAROM_CONFIGURE #(
     parameter [23:0]    FLASH_FS_ADDR               = 0,
@@ -79,6 +115,8 @@ module MEGAROM_CONFIGURE #(
     parameter [23:0]    FLASH_PAC_SIZE              = 0,
     parameter [23:0]    RAM_ADDR                    = 0,
     parameter [23:0]    RAM_SIZE                    = 0,
+    parameter [23:0]    FLASH_MIXER_ADDR            = 0,
+    parameter [23:0]    RAM_MIXER_ADDR              = 0,
     parameter [15:0]    BASE_ADDR                   = 0,
     parameter [7:0]     DEFAULT_BANK_REG_INIT_0     = 0,
     parameter [7:0]     DEFAULT_BANK_REG_INIT_1     = 0,
@@ -97,13 +135,21 @@ module MEGAROM_CONFIGURE #(
     parameter [0:0]     DEFAULT_SCC_ENA             = 1'b0,
     parameter [0:0]     DEFAULT_SCC_I_ENA           = 1'b0,
     parameter [0:0]     DEFAULT_ENABLE_CONTINUOUS   = 1'b0,
-    parameter [0:0]     DEFAULT_ENABLE              = 1'b0
+    parameter [0:0]     DEFAULT_ENABLE              = 1'b0,
+    parameter           DEFAULT_MIX_GAIN            = 0,
+    parameter           ENABLE_PAN                  = 0,
+    parameter           DEFAULT_PAN_GAIN            = 0,
+    parameter [7:0]     BOARD_ID                    = 0,
+    parameter [7:0]     FIRMWARE_VERSION            = 0,
+    parameter [15:0]    FEATURES                    = 0
 ) (
     input wire          CLK,
     input wire          RESET_n,
     BUS_IF.CARTRIDGE    Bus,
     XFER_IF.HOST        Xfer,
     MEGAROM_IF.HOST     Megarom,
+    MIXER_IF.DEVICE     Mixer,
+    MIXER_IF.DEVICE     Pan,
     output reg          SCC_ENA,
     output reg          SCC_I_ENA
 );
@@ -116,6 +162,12 @@ module MEGAROM_CONFIGURE #(
     localparam [4:0]    ADDR_KEY_1                  = 5'h01;
     localparam [4:0]    ADDR_KEY_2                  = 5'h02;
     localparam [4:0]    ADDR_KEY_3                  = 5'h03;
+    localparam [4:0]    ADDR_SRAM_FLAGS             = 5'h04;
+    localparam [4:0]    ADDR_SRAM_ADDR_MASK         = 5'h05;
+    localparam [4:0]    ADDR_MASK_VAL_H             = 5'h08;
+    localparam [4:0]    ADDR_SRAM_MASK              = 5'h09;
+    localparam [4:0]    ADDR_HIGH_ADDR_L            = 5'h0A;
+    localparam [4:0]    ADDR_HIGH_ADDR_H            = 5'h0B;
     localparam [4:0]    ADDR_FLAGS                  = 5'h0C;
     localparam [4:0]    ADDR_MASK_VAL               = 5'h0D;
     localparam [4:0]    ADDR_MASK_ADDR_L            = 5'h0E;
@@ -123,19 +175,19 @@ module MEGAROM_CONFIGURE #(
     localparam [4:0]    ADDR_BANK0_ADDR_L           = 5'h10;
     localparam [4:0]    ADDR_BANK0_ADDR_H           = 5'h11;
     localparam [4:0]    ADDR_BANK0_INIT_VAL         = 5'h12;
-    localparam [4:0]    ADDR_BANK0_RESERVED         = 5'h13;
+    localparam [4:0]    ADDR_BANK0_INIT_VAL_H       = 5'h13;
     localparam [4:0]    ADDR_BANK1_ADDR_L           = 5'h14;
     localparam [4:0]    ADDR_BANK1_ADDR_H           = 5'h15;
     localparam [4:0]    ADDR_BANK1_INIT_VAL         = 5'h16;
-    localparam [4:0]    ADDR_BANK1_RESERVED         = 5'h17;
+    localparam [4:0]    ADDR_BANK1_INIT_VAL_H       = 5'h17;
     localparam [4:0]    ADDR_BANK2_ADDR_L           = 5'h18;
     localparam [4:0]    ADDR_BANK2_ADDR_H           = 5'h19;
     localparam [4:0]    ADDR_BANK2_INIT_VAL         = 5'h1A;
-    localparam [4:0]    ADDR_BANK2_RESERVED         = 5'h1B;
+    localparam [4:0]    ADDR_BANK2_INIT_VAL_H       = 5'h1B;
     localparam [4:0]    ADDR_BANK3_ADDR_L           = 5'h1C;
     localparam [4:0]    ADDR_BANK3_ADDR_H           = 5'h1D;
     localparam [4:0]    ADDR_BANK3_INIT_VAL         = 5'h1E;
-    localparam [4:0]    ADDR_BANK3_RESERVED         = 5'h1F;
+    localparam [4:0]    ADDR_BANK3_INIT_VAL_H       = 5'h1F;
 
     // 20h~2Fh
     localparam [4:0]    ADDR_FLASH_RAM_ADDR_L       = 5'h00;
@@ -149,6 +201,10 @@ module MEGAROM_CONFIGURE #(
     localparam [4:0]    ADDR_FLASH_SIZE_H           = 5'h08;
     localparam [4:0]    ADDR_FLASH_WDATA            = 5'h09;
     localparam [4:0]    ADDR_FLASH_RDATA            = 5'h0A;
+    localparam [4:0]    ADDR_FLASH_CRC_0            = 5'h0C;
+    localparam [4:0]    ADDR_FLASH_CRC_1            = 5'h0D;
+    localparam [4:0]    ADDR_FLASH_CRC_2            = 5'h0E;
+    localparam [4:0]    ADDR_FLASH_CRC_3            = 5'h0F;
 
     // 30h~3Fh
     localparam [4:0]    ADDR_FLASH_FS_ADDR_M        = 5'h10;
@@ -169,6 +225,21 @@ module MEGAROM_CONFIGURE #(
     localparam [4:0]    ADDR_FLASH_CONTROL          = 5'h1F;
     localparam [4:0]    ADDR_FLASH_STATUS           = 5'h1F;
 
+    // 50h~5Fh
+    localparam [4:0]    ADDR_FLASH_MIXER_ADDR_M     = 5'h10;
+    localparam [4:0]    ADDR_FLASH_MIXER_ADDR_H     = 5'h11;
+    localparam [4:0]    ADDR_RAM_MIXER_ADDR_M       = 5'h12;
+    localparam [4:0]    ADDR_RAM_MIXER_ADDR_H       = 5'h13;
+
+    // 78h~7Fh
+    localparam [2:0]    ADDR_ID_0                   = 3'h0;
+    localparam [2:0]    ADDR_ID_1                   = 3'h1;
+    localparam [2:0]    ADDR_ID_2                   = 3'h2;
+    localparam [2:0]    ADDR_ID_BOARD               = 3'h3;
+    localparam [2:0]    ADDR_ID_VERSION             = 3'h4;
+    localparam [2:0]    ADDR_ID_FEATURES_L          = 3'h5;
+    localparam [2:0]    ADDR_ID_FEATURES_H          = 3'h6;
+
     localparam [3:0]    BIT_FLAGS_WRITE_PROTECT     = 3'h0;
     localparam [3:0]    BIT_FLAGS_BANK_SIZE         = 3'h1;
     localparam [3:0]    BIT_FLAGS_CS1_MASK          = 3'h2;
@@ -192,6 +263,16 @@ module MEGAROM_CONFIGURE #(
     assign Xfer.Size         = {flash_reg[ADDR_FLASH_SIZE_H      ], flash_reg[ADDR_FLASH_SIZE_M      ], flash_reg[ADDR_FLASH_SIZE_L      ]};
     assign Xfer.WData        = flash_reg[ADDR_FLASH_WDATA];
 
+    /***************************************************************
+     * ミキサー音量レジスタ(Mixer.COUNT は 8 以下)
+     ***************************************************************/
+    logic [Mixer.GAIN_WIDTH-1:0] mix_reg[0:7];
+
+    /***************************************************************
+     * ステレオ出力音量レジスタ(Pan.COUNT は 20 以下、Pan.GAIN_WIDTH は 8)
+     ***************************************************************/
+    logic [7:0] pan_reg[0:19];
+
     /***************************************************************
      * 未使用信号の処理
      ***************************************************************/
@@ -224,8 +305,10 @@ module MEGAROM_CONFIGURE #(
     /***************************************************************
      * アドレスデコード
      ***************************************************************/
-    wire cs_reg_rd_n = reg_protect || (Bus.ADDR[15:6] != BASE_ADDR[15:6]);
-    wire cs_reg_wr_n = reg_protect ? (Bus.ADDR[15:2] != BASE_ADDR[15:2]) : (Bus.ADDR[15:6] != BASE_ADDR[15:6]);
+    // 識別レジスタ(78h~7Fh)はロック中も読み出せるので、書き込まずにカートリッジを探せる
+    wire cs_id_rd_n  = (Bus.ADDR[15:3] != {BASE_ADDR[15:7], 4'b1111});
+    wire cs_reg_rd_n = (reg_protect && cs_id_rd_n) || (Bus.ADDR[15:7] != BASE_ADDR[15:7]);
+    wire cs_reg_wr_n = reg_protect ? (Bus.ADDR[15:2] != BASE_ADDR[15:2]) : (Bus.ADDR[15:7] != BASE_ADDR[15:7]);
 
     /***************************************************************
      * レジスタリード
@@ -235,6 +318,42 @@ module MEGAROM_CONFIGURE #(
             Bus.BUSDIR_n <= 1;
             Bus.DOUT <= 0;
         end
+        else if(Bus.ADDR[6:3] == 4'b1111) begin
+            Bus.BUSDIR_n <= 0;
+            case (Bus.ADDR[2:0])
+                default:                Bus.DOUT <= 0;
+                ADDR_ID_0:              Bus.DOUT <= 8'h54;  // 'T'
+                ADDR_ID_1:              Bus.DOUT <= 8'h4E;  // 'N'
+                ADDR_ID_2:              Bus.DOUT <= 8'h43;  // 'C'
+                ADDR_ID_BOARD:          Bus.DOUT <= BOARD_ID;
+                ADDR_ID_VERSION:        Bus.DOUT <= FIRMWARE_VERSION;
+                ADDR_ID_FEATURES_L:     Bus.DOUT <= FEATURES[ 7:0];
+                ADDR_ID_FEATURES_H:     Bus.DOUT <= FEATURES[15:8];
+            endcase
+        end
+        else if(Bus.ADDR[6:5] == 2'b11) begin
+            if(ENABLE_PAN && Bus.ADDR[4:0] < Pan.COUNT) begin
+                Bus.BUSDIR_n <= 0;
+                Bus.DOUT <= pan_reg[Bus.ADDR[4:0]];
+            end
+            else begin
+                Bus.BUSDIR_n <= 1;
+                Bus.DOUT <= 0;
+            end
+        end
+        else if(Bus.ADDR[6] == 1) begin
+            if(Bus.ADDR[5:4] == 2'b00) begin
+                Bus.BUSDIR_n <= 0;
+                Bus.DOUT <= Bus.ADDR[0] ? 8'(mix_reg[Bus.ADDR[3:1]] >> 8) : mix_reg[Bus.ADDR[3:1]][7:0];
+            end
+            else case (Bus.ADDR[4:0])
+                default:                    begin   Bus.BUSDIR_n <= 1;  Bus.DOUT <= 0;                                  end
+                ADDR_FLASH_MIXER_ADDR_M:    begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= FLASH_MIXER_ADDR[15: 8];            end
+                ADDR_FLASH_MIXER_ADDR_H:    begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= FLASH_MIXER_ADDR[23:16];            end
+                ADDR_RAM_MIXER_ADDR_M:      begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= RAM_MIXER_ADDR[15: 8];              end
+                ADDR_RAM_MIXER_ADDR_H:      begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= RAM_MIXER_ADDR[23:16];              end
+            endcase
+        end
         else if(Bus.ADDR[5] == 0) begin
             Bus.BUSDIR_n <= 0;
             Bus.DOUT <= ctrl_reg[Bus.ADDR[4:0]];
@@ -243,13 +362,17 @@ module MEGAROM_CONFIGURE #(
             Bus.BUSDIR_n <= 0;
             Bus.DOUT <= Xfer.RData;
         end
+        else if(Bus.ADDR[4:2] == ADDR_FLASH_CRC_0[4:2]) begin
+            Bus.BUSDIR_n <= 0;
+            Bus.DOUT <= Xfer.Crc[Bus.ADDR[1:0]*8 +: 8];
+        end
         else if(Bus.ADDR[4] == 0) begin
             Bus.BUSDIR_n <= 0;
             Bus.DOUT <= flash_reg[Bus.ADDR[3:0]];
         end
         else case (Bus.ADDR[4:0])
             default:                    begin   Bus.BUSDIR_n <= 1;  Bus.DOUT <= 0;                                          end
-            ADDR_FLASH_STATUS:          begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= {7'b0000000, (Xfer.Busy ? 1'b1 : 1'b0)};    end
+            ADDR_FLASH_STATUS:          begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= {7'b0000000, (Xfer.Busy || Xfer.Start ? 1'b1 : 1'b0)};    end
             ADDR_FLASH_FS_ADDR_M:       begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= FLASH_FS_ADDR[15: 8];                       end
             ADDR_FLASH_FS_ADDR_H:       begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= FLASH_FS_ADDR[23:16];                       end
             ADDR_FLASH_FS_SIZE:         begin   Bus.BUSDIR_n <= 0;  Bus.DOUT <= FLASH_FS_SIZE[21:14];                       end
@@ -278,24 +401,30 @@ module MEGAROM_CONFIGURE #(
             ctrl_reg[ADDR_KEY_2         ] <= ~KEY_2;
             ctrl_reg[ADDR_KEY_3         ] <= ~KEY_3;
             ctrl_reg[ADDR_MASK_VAL      ] <= DEFAULT_BANK_REG_MASK;             // BankRegMask
+            ctrl_reg[ADDR_MASK_VAL_H    ] <= 0;                                 // BankRegMask[11:8]
+            ctrl_reg[ADDR_HIGH_ADDR_L   ] <= 0;                                 // BankRegHighAddr[7:0]
+            ctrl_reg[ADDR_HIGH_ADDR_H   ] <= 0;                                 // BankRegHighAddr[15:8]
+            ctrl_reg[ADDR_SRAM_MASK     ] <= 0;                                 // SramMask
+            ctrl_reg[ADDR_SRAM_FLAGS    ] <= 0;                                 // SramWriteEnable, SramPage4K
+            ctrl_reg[ADDR_SRAM_ADDR_MASK] <= 0;                                 // SramAddrMask[12:8]
             ctrl_reg[ADDR_MASK_ADDR_L   ] <= DEFAULT_BANK_REG_ADDR_MASK[7:0];   // BankRegAddrMask[7:0]
             ctrl_reg[ADDR_MASK_ADDR_H   ] <= DEFAULT_BANK_REG_ADDR_MASK[15:8];  // BankRegAddrMask[7:0]
             ctrl_reg[ADDR_BANK0_ADDR_L  ] <= DEFAULT_BANK_REG_ADDR_0[7:0];      // BankRegAddr[0][7:0]
             ctrl_reg[ADDR_BANK0_ADDR_H  ] <= DEFAULT_BANK_REG_ADDR_0[15:8];     // BankRegAddr[0][15:8]
             ctrl_reg[ADDR_BANK0_INIT_VAL] <= DEFAULT_BANK_REG_INIT_0;           // BankRegInit[0]
-            ctrl_reg[ADDR_BANK0_RESERVED] <= 0;
+            ctrl_reg[ADDR_BANK0_INIT_VAL_H] <= 0;                               // BankRegInit[0][11:8]
             ctrl_reg[ADDR_BANK1_ADDR_L  ] <= DEFAULT_BANK_REG_ADDR_1[7:0];      // BankRegAddr[1][7:0]
             ctrl_reg[ADDR_BANK1_ADDR_H  ] <= DEFAULT_BANK_REG_ADDR_1[15:8];     // BankRegAddr[1][15:8]
             ctrl_reg[ADDR_BANK1_INIT_VAL] <= DEFAULT_BANK_REG_INIT_1;           // BankRegInit[1]
-            ctrl_reg[ADDR_BANK1_RESERVED] <= 0;
+            ctrl_reg[ADDR_BANK1_INIT_VAL_H] <= 0;                               // BankRegInit[1][11:8]
             ctrl_reg[ADDR_BANK2_ADDR_L  ] <= DEFAULT_BANK_REG_ADDR_2[7:0];      // BankRegAddr[2][7:0]
             ctrl_reg[ADDR_BANK2_ADDR_H  ] <= DEFAULT_BANK_REG_ADDR_2[15:8];     // BankRegAddr[2][15:8]
             ctrl_reg[ADDR_BANK2_INIT_VAL] <= DEFAULT_BANK_REG_INIT_2;           // BankRegInit[2]
-            ctrl_reg[ADDR_BANK2_RESERVED] <= 0;
+            ctrl_reg[ADDR_BANK2_INIT_VAL_H] <= 0;                               // BankRegInit[2][11:8]
             ctrl_reg[ADDR_BANK3_ADDR_L  ] <= DEFAULT_BANK_REG_ADDR_3[7:0];      // BankRegAddr[3][7:0]
             ctrl_reg[ADDR_BANK3_ADDR_H  ] <= DEFAULT_BANK_REG_ADDR_3[15:8];     // BankRegAddr[3][15:8]
             ctrl_reg[ADDR_BANK3_INIT_VAL] <= DEFAULT_BANK_REG_INIT_3;           // BankRegInit[3]
-            ctrl_reg[ADDR_BANK3_RESERVED] <= 0;
+            ctrl_reg[ADDR_BANK3_INIT_VAL_H] <= 0;                               // BankRegInit[3][11:8]
             ctrl_reg[ADDR_FLAGS         ][BIT_FLAGS_WRITE_PROTECT    ] <= DEFAULT_WRITE_PROTECT;
             ctrl_reg[ADDR_FLAGS         ][BIT_FLAGS_BANK_SIZE        ] <= DEFAULT_IS_16K_BANK;
             ctrl_reg[ADDR_FLAGS         ][BIT_FLAGS_CS1_MASK         ] <= DEFAULT_CS1_MASK;
@@ -319,7 +448,7 @@ module MEGAROM_CONFIGURE #(
             ctrl_reg[ADDR_KEY_3         ] <= ~KEY_3;
         end
         else if(det_wr && !cs_reg_wr_n) begin
-            if(Bus.ADDR[5] == 0) begin
+            if(Bus.ADDR[6:5] == 2'b00) begin
                 ctrl_reg[Bus.ADDR[4:0]] <= Bus.DIN;
             end
         end
@@ -348,7 +477,7 @@ module MEGAROM_CONFIGURE #(
             flash_reg[15] <= 0;
         end
         else if(det_wr && !cs_reg_wr_n) begin
-            if(Bus.ADDR[5:4] == 2'b10) begin
+            if(Bus.ADDR[6:4] == 3'b010) begin
                 flash_reg[Bus.ADDR[3:0]] <= Bus.DIN;
             end
         end
@@ -387,25 +516,101 @@ module MEGAROM_CONFIGURE #(
             Xfer.Start <= 1;
             flash_cmd <= 0;
         end
-        else if(det_wr && !cs_reg_wr_n && Bus.ADDR[5] == 1'b1 && Bus.ADDR[4:0] == ADDR_FLASH_CONTROL) begin
+        else if(flash_cmd[31:0] == {8'h40, 8'h45, 8'h53, 8'h0D}) begin
+            Xfer.Mode <= XFER::XFER_MODE_ERASE_4K;
+            Xfer.Start <= 1;
+            flash_cmd <= 0;
+        end
+        else if(flash_cmd[31:0] == {8'h40, 8'h46, 8'h4C, 8'h0D}) begin
+            Xfer.Mode <= XFER::XFER_MODE_FILL;
+            Xfer.Start <= 1;
+            flash_cmd <= 0;
+        end
+        else if(flash_cmd[31:0] == {8'h40, 8'h43, 8'h52, 8'h0D}) begin
+            Xfer.Mode <= XFER::XFER_MODE_CRC;
+            Xfer.Start <= 1;
+            flash_cmd <= 0;
+        end
+        else if(det_wr && !cs_reg_wr_n && Bus.ADDR[6:5] == 2'b01 && Bus.ADDR[4:0] == ADDR_FLASH_CONTROL) begin
             flash_cmd <= {flash_cmd[23:0], Bus.DIN};
         end
     end
 
+    /***************************************************************
+     * ミキサー音量レジスタライト
+     *  1ch あたり 2バイト(下位,上位), 2**10 で 0dB
+     *  電源投入時は DEFAULT_MIX_GAIN、ブートローダーがフラッシュから
+     *  読み込んだ値があればその値になる(MSX のリセットでは変化しない)
+     ***************************************************************/
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            for(int i = 0; i < 8; i++) begin
+                mix_reg[i] <= (i < Mixer.COUNT) ? DEFAULT_MIX_GAIN[i*Mixer.GAIN_WIDTH +: Mixer.GAIN_WIDTH] : 0;
+            end
+        end
+        else if(Mixer.Load) begin
+            for(int i = 0; i < Mixer.COUNT; i++) begin
+                mix_reg[i] <= Mixer.GAIN_WIDTH'({Mixer.LoadData[i*2+1], Mixer.LoadData[i*2]});
+            end
+        end
+        else if(det_wr && !cs_reg_wr_n && Bus.ADDR[6:4] == 3'b100) begin
+            if(Bus.ADDR[0]) mix_reg[Bus.ADDR[3:1]] <= Mixer.GAIN_WIDTH'({Bus.DIN, mix_reg[Bus.ADDR[3:1]][7:0]});
+            else            mix_reg[Bus.ADDR[3:1]][7:0] <= Bus.DIN;
+        end
+    end
+
+    generate
+        genvar mix_ch;
+        for(mix_ch = 0; mix_ch < Mixer.COUNT; mix_ch = mix_ch + 1) begin: mix_loop
+            assign Mixer.Gain[mix_ch*Mixer.GAIN_WIDTH +: Mixer.GAIN_WIDTH] = mix_reg[mix_ch];
+        end
+    endgenerate
+
+    /***************************************************************
+     * ステレオ出力音量レジスタライト
+     *  入力 i の左音量は i 番、右音量は Pan.COUNT/2+i 番, 128 で 0dB
+     *  電源投入時は DEFAULT_PAN_GAIN(MSX のリセットでは変化しない)
+     ***************************************************************/
+    if(ENABLE_PAN) begin
+        always_ff @(posedge CLK or negedge RESET_n) begin
+            if(!RESET_n) begin
+                for(int i = 0; i < 20; i++) begin
+                    pan_reg[i] <= (i < Pan.COUNT) ? 8'(DEFAULT_PAN_GAIN[i*Pan.GAIN_WIDTH +: Pan.GAIN_WIDTH]) : 8'd0;
+                end
+            end
+            else if(det_wr && !cs_reg_wr_n && Bus.ADDR[6:5] == 2'b11 && Bus.ADDR[4:0] < Pan.COUNT) begin
+                pan_reg[Bus.ADDR[4:0]] <= Bus.DIN;
+            end
+        end
+
+        genvar pan_ch;
+        for(pan_ch = 0; pan_ch < Pan.COUNT; pan_ch = pan_ch + 1) begin: pan_loop
+            assign Pan.Gain[pan_ch*Pan.GAIN_WIDTH +: Pan.GAIN_WIDTH] = Pan.GAIN_WIDTH'(pan_reg[pan_ch]);
+        end
+    end
+    else begin
+        assign Pan.Gain = DEFAULT_PAN_GAIN;
+    end
+
     /***************************************************************
      * 設定を転送
      ***************************************************************/
     always_comb begin
-        Megarom.BankRegInit[0]  =   ctrl_reg[ADDR_BANK0_INIT_VAL];
-        Megarom.BankRegInit[1]  =   ctrl_reg[ADDR_BANK1_INIT_VAL];
-        Megarom.BankRegInit[2]  =   ctrl_reg[ADDR_BANK2_INIT_VAL];
-        Megarom.BankRegInit[3]  =   ctrl_reg[ADDR_BANK3_INIT_VAL];
+        Megarom.BankRegInit[0]  = Megarom.BANK_BIT_WIDTH'({ ctrl_reg[ADDR_BANK0_INIT_VAL_H], ctrl_reg[ADDR_BANK0_INIT_VAL] });
+        Megarom.BankRegInit[1]  = Megarom.BANK_BIT_WIDTH'({ ctrl_reg[ADDR_BANK1_INIT_VAL_H], ctrl_reg[ADDR_BANK1_INIT_VAL] });
+        Megarom.BankRegInit[2]  = Megarom.BANK_BIT_WIDTH'({ ctrl_reg[ADDR_BANK2_INIT_VAL_H], ctrl_reg[ADDR_BANK2_INIT_VAL] });
+        Megarom.BankRegInit[3]  = Megarom.BANK_BIT_WIDTH'({ ctrl_reg[ADDR_BANK3_INIT_VAL_H], ctrl_reg[ADDR_BANK3_INIT_VAL] });
         Megarom.BankRegAddr[0]  = { ctrl_reg[ADDR_BANK0_ADDR_H  ], ctrl_reg[ADDR_BANK0_ADDR_L] };
         Megarom.BankRegAddr[1]  = { ctrl_reg[ADDR_BANK1_ADDR_H  ], ctrl_reg[ADDR_BANK1_ADDR_L] };
         Megarom.BankRegAddr[2]  = { ctrl_reg[ADDR_BANK2_ADDR_H  ], ctrl_reg[ADDR_BANK2_ADDR_L] };
         Megarom.BankRegAddr[3]  = { ctrl_reg[ADDR_BANK3_ADDR_H  ], ctrl_reg[ADDR_BANK3_ADDR_L] };
         Megarom.BankRegAddrMask = { ctrl_reg[ADDR_MASK_ADDR_H   ], ctrl_reg[ADDR_MASK_ADDR_L] };
-        Megarom.BankRegMask     =   ctrl_reg[ADDR_MASK_VAL      ];
+        Megarom.BankRegMask     = Megarom.BANK_BIT_WIDTH'({ ctrl_reg[ADDR_MASK_VAL_H], ctrl_reg[ADDR_MASK_VAL] });
+        Megarom.BankRegHighAddr = { ctrl_reg[ADDR_HIGH_ADDR_H   ], ctrl_reg[ADDR_HIGH_ADDR_L] };
+        Megarom.SramMask        =   ctrl_reg[ADDR_SRAM_MASK     ];
+        Megarom.SramWriteEnable =   ctrl_reg[ADDR_SRAM_FLAGS    ][3:0];
+        Megarom.SramPage4K      =   ctrl_reg[ADDR_SRAM_FLAGS    ][4];
+        Megarom.SramAddrMask    = { ctrl_reg[ADDR_SRAM_ADDR_MASK][4:0], 8'hFF };
         Megarom.WriteProtect    =   ctrl_reg[ADDR_FLAGS         ][BIT_FLAGS_WRITE_PROTECT];
         Megarom.is_16k_bank     =   ctrl_reg[ADDR_FLAGS         ][BIT_FLAGS_BANK_SIZE    ];
         Megarom.CS1_Mask        =   ctrl_reg[ADDR_FLAGS         ][BIT_FLAGS_CS1_MASK     ] || !ctrl_reg[ADDR_FLAGS][BIT_FLAGS_ENABLE];
@@ -36,7 +36,7 @@
 /***********************************************************************
  * メガロムコントローラーインターフェース
  ***********************************************************************/
-interface MEGAROM_IF #(parameter ADDR_BIT_WIDTH=24, BANK_COUNT = 4);
+interface MEGAROM_IF #(parameter ADDR_BIT_WIDTH=24, BANK_COUNT = 4, BANK_BIT_WIDTH = 12);
     logic [ADDR_BIT_WIDTH-1:0]  MemoryTopAddr;                  // メモリ先頭アドレス
     logic                       WriteProtect;                   // 書き込み禁止
     logic                       is_16k_bank;                    // banksize 0:8KB / 1:16KB
@@ -45,25 +45,35 @@ interface MEGAROM_IF #(parameter ADDR_BIT_WIDTH=24, BANK_COUNT = 4);
 
     logic [15:0]                BankRegAddrMask;
     logic [15:0]                BankRegAddr[0:BANK_COUNT-1];
-    logic [7:0]                 BankRegMask;                    // バンクレジスタマスク
-    logic [7:0]                 BankRegInit[0:BANK_COUNT-1];    // バンクレジスタ初期値
-    logic [7:0]                 BankReg[0:BANK_COUNT-1];        // バンクレジスタ(マスク値)
-    logic [7:0]                 BankRegRaw[0:BANK_COUNT-1];     // バンクレジスタ(ライト値)
+    logic [15:0]                BankRegHighAddr;                // 上位バンクレジスタアドレス(BankRegAddr との XOR)
+    logic [BANK_BIT_WIDTH-1:0]  BankRegMask;                    // バンクレジスタマスク([BANK_BIT_WIDTH-1:8] は上位バンクレジスタ)
+    logic [BANK_BIT_WIDTH-1:0]  BankRegInit[0:BANK_COUNT-1];    // バンクレジスタ初期値
+    logic [BANK_BIT_WIDTH-1:0]  BankReg[0:BANK_COUNT-1];        // バンクレジスタ(マスク値)
+    logic [7:0]                 BankRegRaw[0:BANK_COUNT-1];     // バンクレジスタ(下位のライト値)
+
+    logic [7:0]                 SramMask;                       // SRAM 選択ビット(BankRegRaw & SramMask != 0 のバンクは SRAM, 0 なら SRAM なし)
+    logic [3:0]                 SramWriteEnable;                // 8KB 領域(4000h/6000h/8000h/A000h)毎の SRAM 書き込み許可
+    logic                       SramPage4K;                     // 1: 4KB ページ(A12 = BankRegRaw bit5, A12=1 の領域のみ書き込み可)
+    logic [12:0]                SramAddrMask;                   // SRAM アドレスマスク(1FFFh=8KB, 07FFh=2KB)
 
     // ホスト側ポート
     modport HOST(
                     output MemoryTopAddr, WriteProtect, is_16k_bank, CS1_Mask, CS2_Mask,
 
-                    output BankRegAddrMask, BankRegAddr, BankRegMask, BankRegInit,
-                    input  BankReg, BankRegRaw
+                    output BankRegAddrMask, BankRegAddr, BankRegHighAddr, BankRegMask, BankRegInit,
+                    input  BankReg, BankRegRaw,
+
+                    output SramMask, SramWriteEnable, SramPage4K, SramAddrMask
                 );
 
     // メガロムコントローラ側ポート
     modport DEVICE (
                     input  MemoryTopAddr, WriteProtect, is_16k_bank, CS1_Mask, CS2_Mask,
 
-                    input  BankRegAddrMask, BankRegAddr, BankRegMask, BankRegInit,
-                    inout  BankReg, BankRegRaw
+                    input  BankRegAddrMask, BankRegAddr, BankRegHighAddr, BankRegMask, BankRegInit,
+                    inout  BankReg, BankRegRaw,
+
+                    input  SramMask, SramWriteEnable, SramPage4K, SramAddrMask
                 );
 endinterface
 
@@ -71,6 +81,8 @@ endinterface
  * メガロムコントローラ
  ***************************************************************/
 module MEGAROM_CONTROLLER #(
+    parameter               RAM_ADDR_SRAM = 0,
+    parameter [23:0]        RAM_SIZE = 0,           // ROM 領域のサイズ(0 なら制限しない)
     parameter               COUNT = 1,
     parameter               USE_FF = 0
 ) (
@@ -81,7 +93,10 @@ module MEGAROM_CONTROLLER #(
     input wire [3:0]        WriteProtect,
     BUS_IF.CARTRIDGE        Bus,
     RAM_IF.HOST             Ram,
-    BUS_IF.MSX              ExtBus[0:COUNT-1]
+    BUS_IF.MSX              ExtBus[0:COUNT-1],
+    output wire             SramEnable,
+    output reg  [1:0]       Dirty,
+    input   wire            DirtyClear
 );
 
     /***************************************************************
@@ -215,8 +230,6 @@ module MEGAROM_CONTROLLER #(
      ***************************************************************/
     wire wr_n = Bus.SLTSL_n || Bus.MERQ_n || Bus.WR_n;
     wire rd_n = Bus.SLTSL_n || Bus.MERQ_n || Bus.RD_n;
-    wire wr_mem_n  = cs12_n || wr_n || Megarom.WriteProtect || bank_write_protect;
-    wire rd_mem_n  = cs12_n || rd_n;
 
     /***************************************************************
      * ライト検出
@@ -231,10 +244,23 @@ module MEGAROM_CONTROLLER #(
 
     /***************************************************************
      * bank register
+     *  BankRegAddr への書き込みで下位 8bit、BankRegAddr ^ BankRegHighAddr への書き込みで上位ビットを設定する
+     *  BankRegHighAddr = 0 の時は同じ書き込みで上位ビットも更新されるので、
+     *  8bit のバンクレジスタとして使う時は BankRegMask の上位ビットを 0 にする
      ***************************************************************/
+    localparam BANK_BIT_WIDTH = Megarom.BANK_BIT_WIDTH;
+    wire [BANK_BIT_WIDTH-1:0] bank_din_h = BANK_BIT_WIDTH'({ Bus.DIN, 8'h00 });
+
+    logic [Megarom.BANK_COUNT-1:0] sram_bank;
+
     generate
         genvar bank_num;
         for(bank_num = 0; bank_num < Megarom.BANK_COUNT; bank_num = bank_num + 1) begin: bank_reg
+            assign sram_bank[bank_num] = (Megarom.BankRegRaw[bank_num] & Megarom.SramMask) != 0;
+
+            wire bank_en = det_wr && BankEnable[bank_num];
+            wire cs_bank_l = (Bus.ADDR & Megarom.BankRegAddrMask) == Megarom.BankRegAddr[bank_num];
+            wire cs_bank_h = (Bus.ADDR & Megarom.BankRegAddrMask) == (Megarom.BankRegAddr[bank_num] ^ Megarom.BankRegHighAddr);
             always_ff @(posedge CLK or negedge RESET_n) begin
                 if(!RESET_n) begin
                     Megarom.BankReg[bank_num] <= 0;
@@ -242,11 +268,16 @@ module MEGAROM_CONTROLLER #(
                 end
                 else if(!Bus.RESET_n) begin
                     Megarom.BankReg[bank_num] <= Megarom.BankRegInit[bank_num];
-                    Megarom.BankRegRaw[bank_num] <= Megarom.BankRegInit[bank_num];
+                    Megarom.BankRegRaw[bank_num] <= Megarom.BankRegInit[bank_num][7:0];
                 end
-                else if(det_wr && ((Bus.ADDR & Megarom.BankRegAddrMask) == Megarom.BankRegAddr[bank_num]) && BankEnable[bank_num]) begin
-                    Megarom.BankReg[bank_num] <= Bus.DIN & Megarom.BankRegMask;
-                    Megarom.BankRegRaw[bank_num] <= Bus.DIN;
+                else if(bank_en && (cs_bank_l || cs_bank_h)) begin
+                    if(cs_bank_l) begin
+                        Megarom.BankReg[bank_num][7:0] <= Bus.DIN & Megarom.BankRegMask[7:0];
+                        Megarom.BankRegRaw[bank_num] <= Bus.DIN;
+                    end
+                    if(cs_bank_h) begin
+                        Megarom.BankReg[bank_num][BANK_BIT_WIDTH-1:8] <= bank_din_h[BANK_BIT_WIDTH-1:8] & Megarom.BankRegMask[BANK_BIT_WIDTH-1:8];
+                    end
                 end
             end
         end
@@ -255,31 +286,81 @@ module MEGAROM_CONTROLLER #(
     /***************************************************************
      * address
      ***************************************************************/
-    wire [ 7:0] bank_16;
-    wire [ 7:0] bank_8;
-    wire [23:0] addr_16 = Megarom.MemoryTopAddr + { 2'h0, bank_16, Bus.ADDR[13:0] };
-    wire [23:0] addr_8  = Megarom.MemoryTopAddr + { 3'h0, bank_8 , Bus.ADDR[12:0] };
-    wire [23:0] addr = Megarom.is_16k_bank ? addr_16 : addr_8;
+    wire [BANK_BIT_WIDTH-1:0] bank_16;
+    wire [BANK_BIT_WIDTH-1:0] bank_8;
+    wire [7:0] raw_16;
+    wire [7:0] raw_8;
+    wire [BANK_BIT_WIDTH+13:0] offset_16 = { bank_16, Bus.ADDR[13:0] };
+    wire [BANK_BIT_WIDTH+13:0] offset_8  = { 1'b0, bank_8, Bus.ADDR[12:0] };
+    wire [BANK_BIT_WIDTH+13:0] rom_offset = Megarom.is_16k_bank ? offset_16 : offset_8;
+    wire [23:0] addr_16 = Megarom.MemoryTopAddr + 24'(offset_16);
+    wire [23:0] addr_8  = Megarom.MemoryTopAddr + 24'(offset_8);
+
+    // RAM_SIZE を超えるバンクは何も無い領域として扱う(他の領域を読み書きしない)
+    wire rom_in_range = (RAM_SIZE == 0) || (rom_offset < RAM_SIZE);
 
     if(Megarom.BANK_COUNT >= 4) begin
         assign bank_16 = Megarom.BankReg[Bus.ADDR[15]];
         assign bank_8  = Megarom.BankReg[{Bus.ADDR[15],Bus.ADDR[13]}];
+        assign raw_16  = Megarom.BankRegRaw[Bus.ADDR[15]];
+        assign raw_8   = Megarom.BankRegRaw[{Bus.ADDR[15],Bus.ADDR[13]}];
     end
     else if(Megarom.BANK_COUNT >= 3) begin
         assign bank_16 = Megarom.BankReg[Bus.ADDR[15]];
-        assign bank_8  = {Bus.ADDR[15],Bus.ADDR[13]} == 2'b11 ? 8'h00 : Megarom.BankReg[{Bus.ADDR[15],Bus.ADDR[13]}];
+        assign bank_8  = {Bus.ADDR[15],Bus.ADDR[13]} == 2'b11 ? '0 : Megarom.BankReg[{Bus.ADDR[15],Bus.ADDR[13]}];
+        assign raw_16  = Megarom.BankRegRaw[Bus.ADDR[15]];
+        assign raw_8   = {Bus.ADDR[15],Bus.ADDR[13]} == 2'b11 ? '0 : Megarom.BankRegRaw[{Bus.ADDR[15],Bus.ADDR[13]}];
     end
     else if(Megarom.BANK_COUNT >= 2) begin
         assign bank_16 = Megarom.BankReg[Bus.ADDR[15]];
         assign bank_8  = Megarom.BankReg[Bus.ADDR[13]];
+        assign raw_16  = Megarom.BankRegRaw[Bus.ADDR[15]];
+        assign raw_8   = Megarom.BankRegRaw[Bus.ADDR[13]];
     end
     else if(Megarom.BANK_COUNT >= 1) begin
-        assign bank_16 = Bus.ADDR[15] ? 8'h00 : Megarom.BankReg[0];
-        assign bank_8  = Bus.ADDR[13] ? 8'h00 : Megarom.BankReg[0];
+        assign bank_16 = Bus.ADDR[15] ? '0 : Megarom.BankReg[0];
+        assign bank_8  = Bus.ADDR[13] ? '0 : Megarom.BankReg[0];
+        assign raw_16  = Bus.ADDR[15] ? '0 : Megarom.BankRegRaw[0];
+        assign raw_8   = Bus.ADDR[13] ? '0 : Megarom.BankRegRaw[0];
     end
     else begin
-        assign bank_16 = 8'h00;
-        assign bank_8  = 8'h00;
+        assign bank_16 = '0;
+        assign bank_8  = '0;
+        assign raw_16  = '0;
+        assign raw_8   = '0;
+    end
+
+    /***************************************************************
+     * SRAM
+     *  BankRegRaw & SramMask が 0 以外のバンクは ROM の代わりに RAM_ADDR_SRAM からの SRAM を割り当てる
+     *  SRAM の書き込みは WriteProtect ではなく SramWriteEnable に従う
+     *  SramPage4K = 1 の時は BankRegRaw の bit5 で 4KB ページを選び、A12=1 の領域にだけ書き込める
+     *  (A12=0 の領域はバンクレジスタと重なるため)
+     ***************************************************************/
+    wire [7:0]  bank_raw = Megarom.is_16k_bank ? raw_16 : raw_8;
+    wire        sram_sel = (bank_raw & Megarom.SramMask) != 0;
+    wire [12:0] sram_offset = (Megarom.SramPage4K ? { bank_raw[5], Bus.ADDR[11:0] } : Bus.ADDR[12:0]) & Megarom.SramAddrMask;
+    wire        sram_write_enable = Megarom.SramWriteEnable[{Bus.ADDR[15],Bus.ADDR[13]}] && (!Megarom.SramPage4K || Bus.ADDR[12]);
+
+    wire [23:0] addr_sram = { RAM_ADDR_SRAM[23:13], sram_offset };
+    wire [23:0] addr = sram_sel ? addr_sram : Megarom.is_16k_bank ? addr_16 : addr_8;
+
+    // SRAM 以外は WriteProtect に従う
+    wire rd_mem_n  = cs12_n || rd_n || (!sram_sel && !rom_in_range);
+    wire wr_mem_n  = cs12_n || wr_n || (sram_sel ? !sram_write_enable : (Megarom.WriteProtect || bank_write_protect || !rom_in_range));
+
+    // SRAM を割り当てているバンクがあるか(1->0 でブートローダーがフラッシュへ保存する)
+    assign SramEnable = |sram_bank;
+
+    /***************************************************************
+     * 書き込みのあった SRAM の 4KB セクタを記録
+     * 同時に発生した場合は DirtyClear より書き込みを優先
+     ***************************************************************/
+    wire [1:0] dirty_set = (det_wr && !wr_mem_n && sram_sel) ? (sram_offset[12] ? 2'b10 : 2'b01) : 2'b00;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)         Dirty <= 0;
+        else if(DirtyClear)  Dirty <= dirty_set;
+        else                 Dirty <= Dirty | dirty_set;
     end
 
 
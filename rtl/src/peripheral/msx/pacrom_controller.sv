@@ -47,7 +47,9 @@ module PACROM_CONTROLLER #(
     BUS_IF.CARTRIDGE        Bus,
     RAM_IF.HOST             Ram,
     BUS_IF.MSX              ExtBus[0:COUNT-1],
-    output wire             SramEnable
+    output wire             SramEnable,
+    output reg  [1:0]       Dirty,
+    input   wire            DirtyClear
 );
     localparam [15:0] BankAddr = 16'h5FFE;
     localparam [15:0] BankKey = 16'h694D;
@@ -216,6 +218,18 @@ module PACROM_CONTROLLER #(
     wire bank_pac = SramEnable && (Bus.ADDR[15:13] == 2'b010);
     wire [23:0] addr = bank_pac ? {RAM_ADDR_PAC[23:13], Bus.ADDR[12:0]} : {RAM_ADDR_BIOS[23:14], Bus.ADDR[13:0]};
 
+    /***************************************************************
+     * 書き込みのあった 4KB セクタを記録
+     * バンクレジスタ(5FFEh/5FFFh)への書き込みは除外
+     * 同時に発生した場合は DirtyClear より書き込みを優先
+     ***************************************************************/
+    wire [1:0] dirty_set = (det_wr && !wr_mem_n && (Bus.ADDR[15:1] != BankAddr[15:1])) ? (Bus.ADDR[12] ? 2'b10 : 2'b01) : 2'b00;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)         Dirty <= 0;
+        else if(DirtyClear)  Dirty <= dirty_set;
+        else                 Dirty <= Dirty | dirty_set;
+    end
+
     /***************************************************************
      * memory r/w
      ***************************************************************/
@@ -60,7 +60,8 @@ module UMA #(
     parameter COUNT         = 2,
     parameter DIV           = 30,       // 3.58MHz の分周値
     parameter DELAY         = 0,        // 3.58MHz クロックエッジからメモリアクセスまでのディレイ
-    parameter SYNC_CLK_EN   = 1         // CLK_EN で同期をとる
+    parameter SYNC_CLK_EN   = 1,        // CLK_EN で同期をとる
+    parameter SUB_GUARD     = DIV / 2   // MainRam の要求が途切れてから 3ch 目以降へ空きタイミングを渡すまでのクロック数
 ) (
     input   wire            RESET_n,
     input   wire            CLK,
@@ -226,6 +227,44 @@ end
     assign exec_timing[0] = exec_timing_buff[0][MRAM_EXEC_DELAY-1]; // MainRam は 1CLK 遅延
     assign exec_timing[1] = exec_timing_buff[1][VRAM_EXEC_DELAY-1]; // VideoRam は 2CLK 遅延
 
+    /***************************************************************
+     * 3ch 目以降は MainRam の空いているタイミングを使う
+     *  (MainRam 側に要求がある時は MainRam を優先)
+     *  Z80 のメモリアクセスは続けて来るので、MainRam の要求が途切れてから
+     *  SUB_GUARD クロックの間は MainRam 用に空けておく
+     ***************************************************************/
+    logic [$clog2(SUB_GUARD+2)-1:0]    main_idle_cnt;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)                          main_idle_cnt <= 0;
+        else if(req_any[0] || processing[0])  main_idle_cnt <= 0;
+        else if(main_idle_cnt != SUB_GUARD)   main_idle_cnt <= main_idle_cnt + 1'd1;
+    end
+    wire sub_enable = (main_idle_cnt == SUB_GUARD);
+
+    // 自分より前の 3ch 目以降に要求があるか
+    wire                               exec_grant_lower[0:COUNT];
+    assign exec_grant_lower[0] = 0;
+    assign exec_grant_lower[1] = 0;
+    assign exec_grant_lower[2] = 0;
+    generate
+        genvar lower_ch;
+        for(lower_ch = 3; lower_ch <= COUNT; lower_ch = lower_ch + 1) begin: lower
+            assign exec_grant_lower[lower_ch] = exec_grant_lower[lower_ch-1] || req_any[lower_ch-1];
+        end
+    endgenerate
+
+    generate
+        genvar sub_ch;
+        for(sub_ch = 2; sub_ch < COUNT; sub_ch = sub_ch + 1) begin: sub
+            assign exec_timing[sub_ch] = exec_timing[0] && !req_any[0] && sub_enable && !exec_grant_lower[sub_ch];
+            always_ff @(posedge CLK or negedge RESET_n) begin
+                if(!RESET_n) Secondary[sub_ch].TIMING <= 0;
+                else         Secondary[sub_ch].TIMING <= 0;
+            end
+        end
+    endgenerate
+
+
     generate
         genvar process_ch;
         for(process_ch = 0; process_ch < COUNT; process_ch = process_ch + 1) begin: process
@@ -377,6 +416,18 @@ end
             Primary.WE_n     <= !req_we[1];
             Primary.RFSH_n   <= !req_rfsh[1];
         end
+        else begin
+            for(int ch = 2; ch < COUNT; ch++) begin
+                if(exec_timing[ch] && req_any[ch]) begin
+                    Primary.ADDR     <= (req_oe[ch] || req_we[ch]) ? ((req_addr[ch] + Uma.ADDR[ch]) & 24'hFFFFFF) : 0;
+                    Primary.DIN      <= (req_oe[ch] || req_we[ch]) ? req_din[ch] : 0;
+                    Primary.DIN_SIZE <= (req_oe[ch] || req_we[ch]) ? req_din_size[ch] : 0;
+                    Primary.OE_n     <= !req_oe[ch];
+                    Primary.WE_n     <= !req_we[ch];
+                    Primary.RFSH_n   <= !req_rfsh[ch];
+                end
+            end
+        end
     end
 
 endmodule
@@ -33,10 +33,12 @@
 
 `default_nettype none
 
-`define SCC_USE_DPB
-
 /***************************************************************
  * SCC sound
+ *  波形メモリは 5ch 分(160byte)を 1 つのデュアルポート RAM にまとめ、
+ *  A ポートを発音側、B ポートを CPU 側で使う
+ *  分周カウンタと音量の処理は CLK_EN 後の 5 クロックで 1ch ずつ時分割で行うため、
+ *  CLK_EN の間隔は 6 クロック以上必要
  ***************************************************************/
 module SCC (
     input wire          RESET_n,
@@ -53,29 +55,42 @@ module SCC (
     input wire [7:0]    DIN,
     output wire [7:0]   DOUT,
 
-    output reg [10:0]   OUT
+    output reg [10:0]   OUT,
+    output wire         OUT_UPDATE,     // 1 の次のクロックで OUT が更新される
+    output wire [7:0]   CH_OUT[0:4]     // チャンネル毎の出力(ステレオ出力用)
 );
+    localparam CH_COUNT = 5;
+
     /***************************************************************
      * 読み書きタイミング
      ***************************************************************/
-    wire rd_n = CS_n || RD_n;
-    wire wr_n = CS_n || WR_n;
-    logic prev_wr_n;
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n)                 prev_wr_n <= 1;
-        else if(!wr_n && !cs_test_n) prev_wr_n <= wr_n;
-    end
-    wire det_wr = prev_wr_n && !wr_n;
-    wire det_rd = !rd_n;
+    wire det_wr = !CS_n && !WR_n;
+    wire det_rd = !CS_n && !RD_n;
 
     /***************************************************************
      * アドレスデコーダ
+     *  SCC   : 00~7F 波形(ch3,4 共通), A0~BF ch4 波形読み出し, 80~8F レジスタ, E0~FF TEST
+     *  SCC-I : 00~9F 波形, A0~AF レジスタ, C0~DF TEST
      ***************************************************************/
     wire cs_test_n = ADDR[7:5] != (MODE_SCC_I ? 3'b110 : 3'b111);
-    wire cs_enable_n = ADDR != (MODE_SCC_I ? 8'hAF : 8'h8F);
+    wire cs_reg_n  = ADDR[7:4] != (MODE_SCC_I ? 4'b1010 : 4'b1000);
+    wire cs_enable_n = cs_reg_n || ADDR[3:0] != 4'hF;
+    wire cs_freq_n = cs_reg_n || ADDR[3:0] >= 4'd10;
+    wire cs_vol_n  = cs_reg_n || ADDR[3:0] < 4'd10 || ADDR[3:0] == 4'hF;
+    wire cs_wave_wr_n = MODE_SCC_I ? (ADDR[7:5] > 3'd4) : ADDR[7];
+    wire cs_wave_rd_n = MODE_SCC_I ? (ADDR[7:5] > 3'd4) : (ADDR[7] && ADDR[7:5] != 3'd5);
+
+    wire [2:0] freq_ch = ADDR[3:1];
+    wire [2:0] vol_ch  = ADDR[2:0] - 3'd2;  // A~E → 0~4
+    wire [2:0] wave_ch = MODE_SCC_I ? ADDR[7:5] : (ADDR[7] ? 3'd4 : {1'b0, ADDR[6:5]});
+
+    // SCC モードの ch4 は ch3 の波形メモリを使う
+    function [2:0] wave_bank(input [2:0] ch, input scc_i);
+        wave_bank = (ch == 4 && !scc_i) ? 3'd3 : ch;
+    endfunction
 
     /***************************************************************
-     * TEST レジスタ
+     * TEST(変形)レジスタ
      ***************************************************************/
     logic [7:0] test_reg;
     always_ff @(posedge CLK or negedge RESET_n) begin
@@ -83,6 +98,26 @@ module SCC (
         else if(det_wr && !cs_test_n) test_reg <= DIN;
     end
 
+    wire test_cntm = test_reg[0];   // 分周カウンタの下位 4bit を使わない
+    wire test_cnth = test_reg[1];   // 分周カウンタの下位 8bit を使わない
+    wire test_addr = test_reg[5];   // 分周レジスタ書き込みで波形アドレスをリセット
+
+    // b7,b6 : 波形メモリの回転/書き込み禁止 (SCC-I モードでは b7 は無効)
+    //  00 : 通常
+    //  01 : 全ch 回転, 書き込み禁止
+    //  10 : ch3,4 回転, 書き込み禁止
+    //  11 : ch0~2 回転, 全ch 書き込み禁止
+    logic [CH_COUNT-1:0] rotate;
+    logic [CH_COUNT-1:0] protect;
+    always_comb begin
+        case({test_reg[7] && !MODE_SCC_I, test_reg[6]})
+            2'b00: begin rotate = 5'b00000; protect = 5'b00000; end
+            2'b01: begin rotate = 5'b11111; protect = 5'b11111; end
+            2'b10: begin rotate = 5'b11000; protect = 5'b11000; end
+            2'b11: begin rotate = 5'b00111; protect = 5'b11111; end
+        endcase
+    end
+
     /***************************************************************
      * ENABLE レジスタ
      ***************************************************************/
@@ -92,6 +127,29 @@ module SCC (
         else if(det_wr && !cs_enable_n) enable_reg <= DIN;
     end
 
+    /***************************************************************
+     * 分周レジスタ, 音量レジスタ
+     ***************************************************************/
+    logic [11:0] freq[0:CH_COUNT-1];
+    logic [3:0]  vol[0:CH_COUNT-1];
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            for(int i = 0; i < CH_COUNT; i = i + 1) begin
+                freq[i] <= 0;
+                vol[i] <= 0;
+            end
+        end
+        else if(det_wr && !cs_freq_n) begin
+            if(ADDR[0]) freq[freq_ch][11:8] <= DIN[3:0];
+            else        freq[freq_ch][7:0]  <= DIN;
+        end
+        else if(det_wr && !cs_vol_n) begin
+            vol[vol_ch] <= DIN[3:0];
+        end
+    end
+
+    wire rst_adr = det_wr && !cs_freq_n && test_addr;
+
     /***************************************************************
      * 出力更新カウンタ
      ***************************************************************/
@@ -101,52 +159,144 @@ module SCC (
         else if(CLK_EN) out_cnt <= out_cnt + 1'd1;
     end
     wire OUT_EN = out_cnt == 0;
+    assign OUT_UPDATE = CLK_EN && OUT_EN;
 
     /***************************************************************
-     * 各チャンネルの処理
+     * チャンネル処理のスロット
+     *  CLK_EN の次のクロックから slot = 0~4 で各チャンネルのカウンタを更新、
+     *  その 1 クロック後に読み出した波形データで音量の処理をする
      ***************************************************************/
-    logic busdir_n[0:4];
-    logic [7:0] dout[0:4];
-    logic [7:0] ch_out[0:4];
-
-    generate
-        genvar chnum;
-        for(chnum = 0; chnum < 5; chnum = chnum + 1) begin: ch
-            wire wr_freq_l = (ADDR[7:4] == (MODE_SCC_I ? 4'b1010 : 4'b1000)) && (ADDR[3:0] == chnum * 2 +  0);
-            wire wr_freq_h = (ADDR[7:4] == (MODE_SCC_I ? 4'b1010 : 4'b1000)) && (ADDR[3:0] == chnum * 2 +  1);
-            wire wr_vol    = (ADDR[7:4] == (MODE_SCC_I ? 4'b1010 : 4'b1000)) && (ADDR[3:0] == chnum     + 10);
-            wire wr_wave   = (ADDR[7:5] == (MODE_SCC_I ? chnum[2:0] : (chnum[2] ? 3'd3 : chnum[2:0])));
-            wire rd_wave   = (ADDR[7:5] == (MODE_SCC_I ? chnum[2:0] : (chnum[2] ? 3'd5 : chnum[2:0])));
-
-            SCC_SIGNAL_GENERATOR u_gen (
-                .RESET_n,
-                .CLK,
-                .CLK_EN,
-                .TEST_CNTM  (test_reg[0]),
-                .TEST_CNTH  (test_reg[1]),
-                .TEST_ADDR  (test_reg[5]),
-                .TEST_MEM   (chnum == 4 ? test_reg[7] : test_reg[6]),
-                .ADDR       (ADDR[4:0]),
-                .WR_FREQ_L_n(!det_wr || !wr_freq_l),
-                .WR_FREQ_H_n(!det_wr || !wr_freq_h),
-                .WR_VOL_n   (!det_wr || !wr_vol),
-                .WR_WAVE_n  (!det_wr || !wr_wave),
-                .RD_WAVE_n  (!det_rd || !rd_wave),
-                .BUSDIR_n   (busdir_n[chnum]),
-                .DIN,
-                .DOUT       (dout[chnum]),
-                .MUTE_n     (enable_reg[chnum]),
-                .OUT_EN,
-                .OUT        (ch_out[chnum])
-            );
+    logic [2:0] slot;
+    logic       slot_out_en;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            slot <= CH_COUNT;
+            slot_out_en <= 0;
+        end
+        else if(CLK_EN) begin
+            slot <= 0;
+            slot_out_en <= OUT_EN;
         end
-    endgenerate
+        else if(slot != CH_COUNT) begin
+            slot <= slot + 1'd1;
+        end
+    end
+    wire slot_active = slot != CH_COUNT;
+
+    /***************************************************************
+     * 分周カウンタと波形アドレス
+     ***************************************************************/
+    logic [11:0] cnt[0:CH_COUNT-1];
+    logic [4:0]  pos[0:CH_COUNT-1];
+
+    wire [11:0] cur_cnt = cnt[slot];
+    wire dec_cnt_m = (cur_cnt[3:0] == 0) || test_cntm;
+    wire dec_cnt_h = (dec_cnt_m && (cur_cnt[7:4] == 0)) || test_cnth;
+    wire inc_adr   = (dec_cnt_h && (cur_cnt[11:8] == 0));
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            for(int i = 0; i < CH_COUNT; i = i + 1) begin
+                cnt[i] <= 0;
+                pos[i] <= 0;
+            end
+        end
+        else begin
+            if(slot_active) begin
+                if(inc_adr) begin
+                    cnt[slot] <= freq[slot];
+                    pos[slot] <= pos[slot] + 1'd1;
+                end
+                else begin
+                    cnt[slot][3:0]  <= cur_cnt[3:0] - 1'd1;
+                    cnt[slot][7:4]  <= dec_cnt_m ? cur_cnt[7:4]  - 1'd1 : cur_cnt[7:4];
+                    cnt[slot][11:8] <= dec_cnt_h ? cur_cnt[11:8] - 1'd1 : cur_cnt[11:8];
+                end
+            end
+            if(rst_adr) begin
+                pos[freq_ch] <= 0;
+            end
+        end
+    end
+
+    /***************************************************************
+     * 波形メモリ
+     *  A ポート: 発音側(slot のチャンネルの現在位置を読む)
+     *  B ポート: CPU 側(回転モードでは現在位置からの相対アドレスになる)
+     ***************************************************************/
+    logic [7:0] wave_ram[0:CH_COUNT*32-1] /* synthesis syn_ramstyle="block_ram" */;
+
+    wire [7:0] play_addr = { wave_bank(slot, MODE_SCC_I), pos[slot] };
+    logic [7:0] play_data;
+    always_ff @(posedge CLK) begin
+        play_data <= wave_ram[play_addr];
+    end
+
+    wire [4:0] cpu_offset = rotate[wave_ch] ? pos[wave_ch] : 5'd0;
+    wire [7:0] cpu_addr = { wave_bank(wave_ch, MODE_SCC_I), ADDR[4:0] + cpu_offset };
+    wire cpu_we = det_wr && !cs_wave_wr_n && !protect[wave_ch];
+    logic [7:0] cpu_data;
+    always_ff @(posedge CLK) begin
+        if(cpu_we) wave_ram[cpu_addr] <= DIN;
+        cpu_data <= wave_ram[cpu_addr];
+    end
 
     /***************************************************************
      * 波形メモリのデータを CPU 側へ出力
      ***************************************************************/
-    assign BUSDIR_n = busdir_n[0] && busdir_n[1] && busdir_n[2] && busdir_n[3] && busdir_n[4];
-    assign DOUT = dout[0] | dout[1] | dout[2] | dout[3] | dout[4];
+    assign BUSDIR_n = !det_rd || cs_wave_rd_n;
+    assign DOUT = BUSDIR_n ? 8'd0 : cpu_data;
+
+    /***************************************************************
+     * 音量の分だけ加算する
+     ***************************************************************/
+    logic       amp_active;
+    logic [2:0] amp_ch;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            amp_active <= 0;
+            amp_ch <= 0;
+        end
+        else begin
+            amp_active <= slot_active;
+            amp_ch <= slot;
+        end
+    end
+
+    wire [11:0] data_12bit = play_data[7] ? {4'b1111,play_data} : {4'b0000,play_data};
+
+    logic [3:0]  amp_cnt[0:CH_COUNT-1];
+    logic [11:0] amp_sum[0:CH_COUNT-1];
+    logic [7:0]  ch_out[0:CH_COUNT-1];
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            for(int i = 0; i < CH_COUNT; i = i + 1) begin
+                amp_cnt[i] <= 0;
+                amp_sum[i] <= 0;
+                ch_out[i] <= 0;
+            end
+        end
+        else if(amp_active) begin
+            if(slot_out_en) begin
+                ch_out[amp_ch] <= enable_reg[amp_ch] ? amp_sum[amp_ch][11:4] : 8'd0;
+
+                if(vol[amp_ch] != 0) begin
+                    amp_cnt[amp_ch] <= vol[amp_ch] - 1'd1;
+                    amp_sum[amp_ch] <= data_12bit;
+                end
+                else begin
+                    amp_cnt[amp_ch] <= 0;
+                    amp_sum[amp_ch] <= 0;
+                end
+            end
+            else if(amp_cnt[amp_ch] != 0) begin
+                amp_cnt[amp_ch] <= amp_cnt[amp_ch] - 1'd1;
+                amp_sum[amp_ch] <= amp_sum[amp_ch] + data_12bit;
+            end
+        end
+    end
+
+    assign CH_OUT = ch_out;
 
     /***************************************************************
      * ミキサー
@@ -208,362 +358,4 @@ module SCC_MIXER (
 
 endmodule
 
-/***********************************************************************
- * SCC 1CH シグナルジェネレータ
- ***********************************************************************/
-module SCC_SIGNAL_GENERATOR (
-    input wire          RESET_n,
-    input wire          CLK,
-    input wire          CLK_EN,
-
-    input wire          TEST_CNTM,      // TEST.b0
-    input wire          TEST_CNTH,      // TEST.b1
-    input wire          TEST_ADDR,      // TEST.b5
-    input wire          TEST_MEM,       // TEST.b6(ch0~3), TEST.b7(ch4)
-
-    input wire [4:0]    ADDR,
-    input wire          WR_FREQ_L_n,
-    input wire          WR_FREQ_H_n,
-    input wire          WR_VOL_n,
-    input wire          WR_WAVE_n,
-    input wire          RD_WAVE_n,
-    output wire         BUSDIR_n,
-    input wire  [7:0]   DIN,
-    output wire  [7:0]  DOUT,
-
-    input wire          MUTE_n,
-    input wire          OUT_EN,
-    output reg [7:0]    OUT
-);
-
-    logic [4:0] WAVE_ADDR;
-    SCC_COUNTER u_cnt (
-        .RESET_n,
-        .CLK,
-        .CLK_EN,
-        .TEST_CNTM,
-        .TEST_CNTH,
-        .TEST_ADDR,
-        .WR_FREQ_L_n,
-        .WR_FREQ_H_n,
-        .DIN,
-        .WAVE_ADDR
-    );
-
-    wire [7:0] WAVE_DATA;
-    SCC_WAVE_MEMORY u_mem (
-        .RESET_n,
-        .CLK,
-        .TEST_MEM,
-        .ADDR(ADDR[4:0]),
-        .RD_WAVE_n,
-        .WR_WAVE_n,
-        .DIN,
-        .BUSDIR_n,
-        .DOUT,
-        .WAVE_ADDR,
-        .WAVE_DATA
-    );
-
-    SCC_AMP u_amp (
-        .RESET_n,
-        .CLK,
-        .CLK_EN,
-        .WR_VOL_n,
-        .DIN(DIN[3:0]),
-        .WAVE_DATA,
-        .MUTE_n,
-        .OUT_EN,
-        .OUT
-    );
-endmodule
-
-/***********************************************************************
- * SCC CH カウンター
- ***********************************************************************/
-module SCC_COUNTER (
-    input wire          RESET_n,
-    input wire          CLK,
-    input wire          CLK_EN,
-
-    input wire          TEST_CNTM,      // TEST.b0
-    input wire          TEST_CNTH,      // TEST.b1
-    input wire          TEST_ADDR,      // TEST.b5
-
-    input wire          WR_FREQ_L_n,
-    input wire          WR_FREQ_H_n,
-    input wire [7:0]    DIN,
-
-    output reg [4:0]    WAVE_ADDR
-);
-
-    /***************************************************************
-     * 分周レジスタライト
-     ***************************************************************/
-    logic [3:0] freq_l;
-    logic [3:0] freq_m;
-    logic [3:0] freq_h;
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n) begin
-            freq_l <= 0;
-            freq_m <= 0;
-            freq_h <= 0;
-        end
-        else if(!WR_FREQ_L_n) begin
-            freq_l <= DIN[3:0];
-            freq_m <= DIN[7:4];
-        end
-        else if(!WR_FREQ_H_n) begin
-            freq_h <= DIN[3:0];
-        end
-    end
-
-    /***************************************************************
-     * カウンタの動作条件
-     ***************************************************************/
-    wire dec_cnt_l = CLK_EN;
-    wire dec_cnt_m = (dec_cnt_l && (cnt_l == 0)) || TEST_CNTM;
-    wire dec_cnt_h = (dec_cnt_m && (cnt_m == 0)) || TEST_CNTH;
-    wire inc_adr   = (dec_cnt_h && (cnt_h == 0));
-    wire rst_cnt   = inc_adr;
-    wire rst_adr   = (TEST_ADDR && (!WR_FREQ_L_n || !WR_FREQ_H_n));
-
-    /***************************************************************
-     * 分周カウント
-     ***************************************************************/
-    logic [3:0] cnt_l;
-    logic [3:0] cnt_m;
-    logic [3:0] cnt_h;
-
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n)       cnt_l <= 0;
-        else if(rst_cnt)   cnt_l <= freq_l;
-        else if(dec_cnt_l) cnt_l <= cnt_l - 1'd1;
-    end
-
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n)       cnt_m <= 0;
-        else if(rst_cnt)   cnt_m <= freq_m;
-        else if(dec_cnt_m) cnt_m <= cnt_m - 1'd1;
-    end
-
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n)       cnt_h <= 0;
-        else if(rst_cnt)   cnt_h <= freq_h;
-        else if(dec_cnt_h) cnt_h <= cnt_h - 1'd1;
-    end
-
-    /***************************************************************
-     * アドレスカウント
-     ***************************************************************/
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n)       WAVE_ADDR <= 0;
-        else if(rst_adr)   WAVE_ADDR <= 0;
-        else if(inc_adr)   WAVE_ADDR <= WAVE_ADDR + 1'd1;
-    end
-
-endmodule
-
-`ifdef SCC_USE_DPB
-/***********************************************************************
- * SCC CH 波形メモリー(DPB)
- ***********************************************************************/
-module SCC_WAVE_MEMORY (
-    input wire          RESET_n,
-    input wire          CLK,
-
-    input wire          TEST_MEM,   // TEST.b6(ch0~3), TEST.b7(ch4)
-
-    input wire [4:0]    ADDR,
-    input wire          RD_WAVE_n,
-    input wire          WR_WAVE_n,
-    input wire  [7:0]   DIN,
-    output wire         BUSDIR_n,
-    output wire [7:0]   DOUT,
-
-    input wire [4:0]    WAVE_ADDR,
-    output wire  [7:0]  WAVE_DATA
-);
-
-    wire [7:0] dpb_read_a;  // DAC 側
-    wire [7:0] dpb_read_b;  // CPU 側
-
-    /***************************************************************
-     * 波形出力
-     ***************************************************************/
-    assign WAVE_DATA = dpb_read_a;
-
-    /***************************************************************
-     * メモリリード
-     ***************************************************************/
-    assign DOUT = RD_WAVE_n ? 0 : (TEST_MEM ? dpb_read_a : dpb_read_b); // TEST_MEM == 1 の時は波形出力データを返す
-    assign BUSDIR_n = RD_WAVE_n;
-
-    /***************************************************************
-     * メモリ
-     ***************************************************************/
-    wire [7:0] dpb_douta_w;
-    wire [7:0] dpb_doutb_w;
-
-    DPB u_dpb (
-        .DOA({dpb_douta_w[7:0],dpb_read_a[7:0]}),
-        .DOB({dpb_doutb_w[7:0],dpb_read_b[7:0]}),
-        .CLKA(CLK),
-        .OCEA(1'b1),
-        .CEA(1'b1),
-        .RESETA(!RESET_n),
-        .WREA(1'b0),
-        .CLKB(CLK),
-        .OCEB(1'b1),
-        .CEB(1'b1),
-        .RESETB(!RESET_n),
-        .WREB(!(WR_WAVE_n | TEST_MEM)),         // TEST_MEM == 1 の時はライト禁止
-        .BLKSELA(3'b000),
-        .BLKSELB(3'b000),
-        .ADA({6'b000000,WAVE_ADDR[4:0],3'b000}),
-        .DIA({8'b00000000,8'b00000000}),
-        .ADB({6'b000000,ADDR[4:0],3'b000}),
-        .DIB({8'b00000000,DIN[7:0]})
-    );
-
-    defparam u_dpb.READ_MODE0 = 1'b0;
-    defparam u_dpb.READ_MODE1 = 1'b0;
-    defparam u_dpb.WRITE_MODE0 = 2'b00;
-    defparam u_dpb.WRITE_MODE1 = 2'b00;
-    defparam u_dpb.BIT_WIDTH_0 = 8;
-    defparam u_dpb.BIT_WIDTH_1 = 8;
-    defparam u_dpb.BLK_SEL_0 = 3'b000;
-    defparam u_dpb.BLK_SEL_1 = 3'b000;
-    defparam u_dpb.RESET_MODE = "SYNC";
-endmodule
-
-`else
-
-/***********************************************************************
- * SCC CH 波形メモリー(register)
- ***********************************************************************/
-module SCC_WAVE_MEMORY (
-    input wire          RESET_n,
-    input wire          CLK,
-
-    input wire          TEST_MEM,   // TEST.b6(ch0~3), TEST.b7(ch4)
-
-    input wire [4:0]    ADDR,
-    input wire          RD_WAVE_n,
-    input wire          WR_WAVE_n,
-    input wire  [7:0]   DIN,
-    output reg          BUSDIR_n,
-    output reg [7:0]    DOUT,
-
-    input wire [4:0]    WAVE_ADDR,
-    output reg  [7:0]   WAVE_DATA
-);
-
-    reg [7:0] buffer[0:31];
-
-    /***************************************************************
-     * メモリ R/W
-     ***************************************************************/
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n) begin
-            BUSDIR_n <= 1;
-            DOUT <= 0;
-            WAVE_DATA <= 0;
-        end
-        else if(TEST_MEM) begin
-            BUSDIR_n <= 1;
-            DOUT <= 0;
-            WAVE_DATA <= buffer[WAVE_ADDR];
-        end
-        else if(!WR_WAVE_n) begin
-            BUSDIR_n <= 1;
-            DOUT <= 0;
-            WAVE_DATA <= DIN;
-            buffer[ADDR] <= DIN;
-        end
-        else if(!RD_WAVE_n) begin
-            BUSDIR_n <= 0;
-            DOUT <= buffer[ADDR];
-            WAVE_DATA <= buffer[ADDR];
-        end
-        else begin
-            BUSDIR_n <= 1;
-            DOUT <= 0;
-            WAVE_DATA <= buffer[WAVE_ADDR];
-        end
-    end
-endmodule
-
-`endif
-
-/***********************************************************************
- * SCC CH アンプ
- ***********************************************************************/
-module SCC_AMP (
-    input wire          RESET_n,
-    input wire          CLK,
-    input wire          CLK_EN,
-
-    input wire          WR_VOL_n,
-    input wire [3:0]    DIN,
-
-    input wire [7:0]    WAVE_DATA,
-
-    input wire          MUTE_n,
-    input wire          OUT_EN,
-    output reg [7:0]    OUT
-);
-    logic [3:0] vol;
-    logic [3:0] cnt;
-    logic [11:0] sum;
-
-    /***************************************************************
-     * 音量レジスタライト
-     ***************************************************************/
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n) begin
-            vol <= 0;
-        end
-        else if(!WR_VOL_n) begin
-            vol <= DIN;
-        end
-    end
-
-    /***************************************************************
-     * 波形データを12bitへ拡張
-     ***************************************************************/
-    wire [11:0] data_12bit = WAVE_DATA[7] ? {4'b1111,WAVE_DATA} : {4'b0000,WAVE_DATA};
-
-    /***************************************************************
-     * 音量の分だけ加算する
-     ***************************************************************/
-    always_ff @(posedge CLK or negedge RESET_n) begin
-        if(!RESET_n) begin
-            OUT <= 0;
-            cnt <= 0;
-            sum <= 0;
-        end
-        else if(CLK_EN) begin
-            if(OUT_EN) begin
-                OUT <= MUTE_n ? sum[11:4] : 0;
-
-                if(vol != 0) begin
-                    cnt <= vol - 1'd1;
-                    sum <= data_12bit;
-                end
-                else begin
-                    cnt <= 0;
-                    sum <= 0;
-                end
-            end
-            else begin
-                if(cnt != 0) begin
-                    cnt <= cnt - 1'd1;
-                    sum <= sum + data_12bit;
-                end
-            end
-        end
-    end
-endmodule
-
 `default_nettype wire
@@ -0,0 +1,155 @@
+//
+// scc_interp_tb.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/***********************************************************************
+ * SCC 補間フィルタのテストベンチ
+ *  SCC のチャンネル 0 から正弦波を出力し、CLK_EN 毎に
+ *  SCC の出力(補間なし)と SOUND_INTERPOLATOR の出力をファイルへ書き出す
+ *  結果は scc_thdn.c で THD+N を計算する
+ *
+ *  シミュレーションには Gowin のプリミティブモデル(prim_sim.v)が必要
+ *   iverilog -g2012 -o scc_interp_tb ../scc.sv ../../sound.sv scc_interp_tb.sv prim_sim.v
+ *   vvp scc_interp_tb +freq=01F +samples=65536 +out=scc_interp.txt
+ ***********************************************************************/
+`timescale 1ns/1ps
+`default_nettype none
+
+module scc_interp_tb;
+    localparam CLK_EN_DIV = 8;          // CLK_EN の間隔(ORDER+3 以上)
+
+    logic       CLK = 0;
+    logic       RESET_n = 0;
+    logic       CLK_EN;
+    logic       CS_n = 1;
+    logic       WR_n = 1;
+    logic [7:0] ADDR = 0;
+    logic [7:0] DIN = 0;
+
+    always #5 CLK = !CLK;
+
+    logic [$clog2(CLK_EN_DIV)-1:0] div_cnt = 0;
+    always_ff @(posedge CLK) div_cnt <= div_cnt + 1'd1;
+    assign CLK_EN = (div_cnt == 0);
+
+    /***************************************************************
+     * テスト対象
+     ***************************************************************/
+    wire [10:0] scc_out;
+    wire        scc_update;
+    SCC u_scc (
+        .RESET_n,
+        .CLK,
+        .CLK_EN,
+        .MODE_SCC_I (1'b0),
+        .CS_n,
+        .ADDR,
+        .WR_n,
+        .RD_n       (1'b1),
+        .BUSDIR_n   (),
+        .DIN,
+        .DOUT       (),
+        .OUT        (scc_out),
+        .OUT_UPDATE (scc_update)
+    );
+
+    wire [15:0] filter_out;
+    SOUND_INTERPOLATOR #(
+        .IN_WIDTH(11),
+        .OUT_WIDTH(16),
+        .RATIO(16),
+        .ORDER(4)
+    ) u_interpolator (
+        .CLK,
+        .RESET_n,
+        .CLK_EN,
+        .IN_EN(scc_update),
+        .IN(scc_out),
+        .OUT(filter_out)
+    );
+
+    /***************************************************************
+     * レジスタ書き込み
+     ***************************************************************/
+    task automatic scc_write(input [7:0] addr, input [7:0] data);
+        @(posedge CLK) begin
+            ADDR <= addr;
+            DIN <= data;
+            CS_n <= 0;
+        end
+        @(posedge CLK) WR_n <= 0;
+        repeat(4) @(posedge CLK);
+        @(posedge CLK) WR_n <= 1;
+        @(posedge CLK) CS_n <= 1;
+    endtask
+
+    /***************************************************************
+     * テスト
+     ***************************************************************/
+    int freq;
+    int samples;
+    string out_name;
+    int fd;
+
+    initial begin
+        if(!$value$plusargs("freq=%h", freq)) freq = 'h01F;
+        if(!$value$plusargs("samples=%d", samples)) samples = 65536;
+        if(!$value$plusargs("out=%s", out_name)) out_name = "scc_interp.txt";
+
+        repeat(4) @(posedge CLK);
+        RESET_n <= 1;
+
+        // 波形(scc_thdn.c の scc_wave() と同じ値)
+        for(int i = 0; i < 32; i++) begin
+            scc_write(8'(i), 8'($rtoi($floor(127.0 * $sin(2.0 * 3.14159265358979 * i / 32.0) + 0.5))));
+        end
+        scc_write(8'h80, 8'(freq));
+        scc_write(8'h81, 8'(freq >> 8));
+        scc_write(8'h8A, 8'h0F);
+        scc_write(8'h8F, 8'h01);
+
+        // 安定するまで 2周期待つ
+        repeat(2 * 32 * (freq + 1) * CLK_EN_DIV) @(posedge CLK);
+
+        fd = $fopen(out_name, "w");
+        for(int i = 0; i < samples; i++) begin
+            @(negedge CLK iff CLK_EN);
+            $fdisplay(fd, "%0d %0d", $signed(scc_out), $signed(filter_out));
+        end
+        $fclose(fd);
+        $finish;
+    end
+
+endmodule
+
+`default_nettype wire
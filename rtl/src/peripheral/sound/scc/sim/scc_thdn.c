@@ -0,0 +1,317 @@
+//
+// scc_thdn.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// SCC 補間フィルタの THD+N 計算
+//  ソフトウェアの SCC と SOUND_INTERPOLATOR のモデルで出力を作り、FFT で THD+N を計算する
+//  scc_interp_tb の出力ファイルを指定すると、モデルと一致するか確認してから RTL の出力で計算する
+//
+// cc -O2 -o scc_thdn scc_thdn.c -lm
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define CLK_EN_FREQ     (3579545.0)     // CLK_EN の周波数
+#define OUT_RATIO       (16)            // SCC の出力更新間隔(CLK_EN 数)
+#define FILTER_ORDER    (4)             // SOUND_INTERPOLATOR の ORDER
+#define IN_WIDTH        (11)
+#define OUT_WIDTH       (16)
+#define SUM_SHIFT       (4 * (FILTER_ORDER - 1) - (OUT_WIDTH - IN_WIDTH))
+#define AUDIO_BAND      (20000.0)       // 可聴帯域
+#define SEARCH_COUNT    (4096)          // RTL との位置合わせに使うサンプル数
+
+static int8_t wave[32];
+static int coef[OUT_RATIO * FILTER_ORDER];
+
+//
+// 波形(scc_interp_tb と同じ値)
+//
+static void scc_wave(void)
+{
+    for(int i = 0; i < 32; i++) wave[i] = (int8_t)floor(127.0 * sin(2.0 * 3.14159265358979 * i / 32.0) + 0.5);
+}
+
+//
+// 係数(SOUND_INTERPOLATOR と同じ計算)
+//
+static int binom(int n, int k)
+{
+    int r = (n < k || k < 0) ? 0 : 1;
+    for(int i = 1; i <= k; i++) r = r * (n - k + i) / i;
+    return r;
+}
+
+static void make_coef(void)
+{
+    for(int n = 0; n < OUT_RATIO * FILTER_ORDER; n++)
+    {
+        int c = 0;
+        for(int j = 0; j <= FILTER_ORDER; j++)
+        {
+            if(n - OUT_RATIO * j >= 0) c += ((j % 2) ? -1 : 1) * binom(FILTER_ORDER, j) * binom(n - OUT_RATIO * j + FILTER_ORDER - 1, FILTER_ORDER - 1);
+        }
+        coef[n] = c;
+    }
+}
+
+//
+// ソフトウェア SCC (1ch, SCC_AMP と同じ計算)
+//  tick    : CLK_EN の番号
+//  offset  : 波形アドレスのずれ(CLK_EN 数)
+//  frame   : 出力更新タイミングのずれ(CLK_EN 数)
+//
+static int scc_out(long tick, int freq, int vol, long offset, int frame)
+{
+    long start = (tick + OUT_RATIO - frame) / OUT_RATIO * OUT_RATIO + frame - OUT_RATIO;
+    int sum = 0;
+    for(int i = 0; i < vol; i++)
+    {
+        sum += wave[((start + i + offset) / (freq + 1)) % 32];
+    }
+    return sum >> 4;
+}
+
+//
+// SOUND_INTERPOLATOR のモデル
+//  zoh[] は SCC の出力、出力の更新は frame の位置
+//
+static void interpolate(const int *zoh, int *out, long count, int frame)
+{
+    int hist[FILTER_ORDER] = { 0 };
+    int phase = 0;
+    for(long t = 0; t < count; t++)
+    {
+        if((t - frame) % OUT_RATIO == 0)
+        {
+            for(int k = FILTER_ORDER - 1; k > 0; k--) hist[k] = hist[k - 1];
+            hist[0] = zoh[t];
+            phase = 0;
+        }
+        else
+        {
+            phase++;
+        }
+        long sum = 0;
+        for(int k = 0; k < FILTER_ORDER; k++) sum += (long)hist[k] * coef[k * OUT_RATIO + phase];
+        out[t] = (int)(sum >> SUM_SHIFT);
+    }
+}
+
+//
+// FFT (基数2)
+//
+static void fft(double *re, double *im, long n)
+{
+    for(long i = 1, j = 0; i < n; i++)
+    {
+        long bit = n >> 1;
+        for(; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if(i < j)
+        {
+            double t;
+            t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for(long len = 2; len <= n; len <<= 1)
+    {
+        double a = -2.0 * M_PI / len;
+        for(long i = 0; i < n; i += len)
+        {
+            for(long k = 0; k < len / 2; k++)
+            {
+                double wr = cos(a * k);
+                double wi = sin(a * k);
+                double xr = re[i + k + len / 2] * wr - im[i + k + len / 2] * wi;
+                double xi = re[i + k + len / 2] * wi + im[i + k + len / 2] * wr;
+                re[i + k + len / 2] = re[i + k] - xr;
+                im[i + k + len / 2] = im[i + k] - xi;
+                re[i + k] += xr;
+                im[i + k] += xi;
+            }
+        }
+    }
+}
+
+//
+// THD+N を計算して表示
+//  サンプル数は信号の周期の整数倍なので窓関数は使わない
+//
+static void print_thdn(const char *name, const int *data, long count, long signal_bin)
+{
+    double *re = calloc(count, sizeof(double));
+    double *im = calloc(count, sizeof(double));
+    if(re == NULL || im == NULL) { fprintf(stderr, "out of memory\n"); exit(1); }
+    for(long i = 0; i < count; i++) re[i] = data[i];
+    fft(re, im, count);
+
+    long band = (long)(AUDIO_BAND * count / CLK_EN_FREQ);
+    double signal = re[signal_bin] * re[signal_bin] + im[signal_bin] * im[signal_bin];
+    double noise_band = 0;
+    double noise_full = 0;
+    double spur = 0;
+    long spur_bin = 0;
+    for(long i = 1; i <= count / 2; i++)
+    {
+        if(i == signal_bin) continue;
+        double p = re[i] * re[i] + im[i] * im[i];
+        noise_full += p;
+        if(i <= band) noise_band += p;
+        else if(p > spur) { spur = p; spur_bin = i; }
+    }
+    printf("%-8s THD+N(20kHz) %7.2f dB  THD+N(full) %7.2f dB  max spur %7.2f dB @ %.1f kHz\n",
+        name,
+        10.0 * log10(noise_band / signal),
+        10.0 * log10(noise_full / signal),
+        10.0 * log10(spur / signal),
+        spur_bin * CLK_EN_FREQ / count / 1000.0);
+    free(re);
+    free(im);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: scc_thdn [-f freq] [-n samples] [file]\n"
+                    "  -f freq     SCC frequency register (hex, default 01F)\n"
+                    "  -n samples  number of samples (power of 2, default 65536)\n"
+                    "  file        output of scc_interp_tb (same -f and -n)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    int freq = 0x01F;
+    long count = 65536;
+    const int vol = 15;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-f") == 0 && i + 1 < argc) freq = (int)strtol(argv[++i], NULL, 16);
+        else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) count = atol(argv[++i]);
+        else if(argv[i][0] == '-') { usage(); return 1; }
+        else path = argv[i];
+    }
+
+    long period = 32L * (freq + 1);
+    if(count < SEARCH_COUNT || (count & (count - 1)) != 0 || count % period != 0)
+    {
+        fprintf(stderr, "samples must be a power of 2 and a multiple of the signal period (%ld)\n", period);
+        return 1;
+    }
+
+    scc_wave();
+    make_coef();
+
+    int *zoh = calloc(count, sizeof(int));
+    int *filtered = calloc(count, sizeof(int));
+    int *model = calloc(count + period, sizeof(int));
+    int *model_filtered = calloc(count + period, sizeof(int));
+    if(zoh == NULL || filtered == NULL || model == NULL || model_filtered == NULL) { fprintf(stderr, "out of memory\n"); return 1; }
+
+    long offset = 0;
+    int frame = 0;
+    if(path != NULL)
+    {
+        // RTL の出力を読み込む
+        FILE *fp = fopen(path, "r");
+        if(fp == NULL) { perror(path); return 1; }
+        long n = 0;
+        while(n < count && fscanf(fp, "%d %d", &zoh[n], &filtered[n]) == 2) n++;
+        fclose(fp);
+        if(n != count) { fprintf(stderr, "%s: %ld samples (expected %ld)\n", path, n, count); return 1; }
+
+        // ソフトウェア SCC と位置を合わせる
+        int found = 0;
+        for(frame = 0; frame < OUT_RATIO && !found; frame++)
+        {
+            for(offset = 0; offset < period && !found; offset++)
+            {
+                long t;
+                for(t = 0; t < SEARCH_COUNT; t++)
+                {
+                    if(scc_out(t, freq, vol, offset, frame) != zoh[t]) break;
+                }
+                found = (t == SEARCH_COUNT);
+            }
+        }
+        if(!found) { fprintf(stderr, "SCC output does not match the software model\n"); return 1; }
+        frame--;
+        offset--;
+        for(long t = 0; t < count; t++)
+        {
+            if(scc_out(t, freq, vol, offset, frame) != zoh[t]) { fprintf(stderr, "SCC output mismatch at %ld\n", t); return 1; }
+        }
+        printf("SCC output matches the software model (offset %ld, frame %d)\n", offset, frame);
+    }
+
+    // モデルの出力(最初の 1周期はフィルタの初期化に使う)
+    for(long t = 0; t < count + period; t++) model[t] = scc_out(t, freq, vol, offset, frame);
+    interpolate(model, model_filtered, count + period, frame);
+
+    if(path != NULL)
+    {
+        // RTL のフィルタ出力は出力レジスタの分だけ遅れる
+        int lag;
+        for(lag = 0; lag < OUT_RATIO; lag++)
+        {
+            long t;
+            for(t = 0; t < count; t++)
+            {
+                if(model_filtered[period + t - lag] != (int16_t)filtered[t]) break;
+            }
+            if(t == count) break;
+        }
+        if(lag == OUT_RATIO) { fprintf(stderr, "interpolator output does not match the model\n"); return 1; }
+        printf("interpolator output matches the model (latency %d)\n", lag);
+    }
+    else
+    {
+        memcpy(zoh, &model[period], count * sizeof(int));
+        memcpy(filtered, &model_filtered[period], count * sizeof(int));
+    }
+
+    printf("signal %.1f Hz, fs %.0f Hz, %ld samples\n", CLK_EN_FREQ / period, CLK_EN_FREQ, count);
+    for(long t = 0; t < count; t++) zoh[t] <<= (OUT_WIDTH - IN_WIDTH);
+    print_thdn("ZOH", zoh, count, count / period);
+    print_thdn("filtered", filtered, count, count / period);
+
+    free(zoh);
+    free(filtered);
+    free(model);
+    free(model_filtered);
+    return 0;
+}
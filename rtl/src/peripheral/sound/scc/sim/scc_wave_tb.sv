@@ -0,0 +1,193 @@
+//
+// scc_wave_tb.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+/***********************************************************************
+ * SCC 波形メモリのテストベンチ
+ *  SCC/SCC-I モードの波形メモリの読み書き、TEST レジスタの
+ *  書き込み禁止と回転モードを確認する
+ *
+ *   iverilog -g2012 -o scc_wave_tb ../scc.sv scc_wave_tb.sv
+ *   vvp scc_wave_tb
+ ***********************************************************************/
+`timescale 1ns/1ps
+`default_nettype none
+
+module scc_wave_tb;
+    localparam CLK_EN_DIV = 8;          // CLK_EN の間隔(6 以上)
+
+    logic       CLK = 0;
+    logic       RESET_n = 0;
+    logic       CLK_EN;
+    logic       MODE_SCC_I = 0;
+    logic       CS_n = 1;
+    logic       WR_n = 1;
+    logic       RD_n = 1;
+    logic [7:0] ADDR = 0;
+    logic [7:0] DIN = 0;
+
+    always #5 CLK = !CLK;
+
+    logic [$clog2(CLK_EN_DIV)-1:0] div_cnt = 0;
+    always_ff @(posedge CLK) div_cnt <= div_cnt + 1'd1;
+    assign CLK_EN = (div_cnt == 0);
+
+    /***************************************************************
+     * テスト対象
+     ***************************************************************/
+    wire        BUSDIR_n;
+    wire [7:0]  DOUT;
+    wire [10:0] scc_out;
+    wire [7:0]  ch_out[0:4];
+    SCC u_scc (
+        .RESET_n,
+        .CLK,
+        .CLK_EN,
+        .MODE_SCC_I,
+        .CS_n,
+        .ADDR,
+        .WR_n,
+        .RD_n,
+        .BUSDIR_n,
+        .DIN,
+        .DOUT,
+        .OUT        (scc_out),
+        .OUT_UPDATE (),
+        .CH_OUT     (ch_out)
+    );
+
+    /***************************************************************
+     * レジスタ読み書き
+     ***************************************************************/
+    task automatic scc_write(input [7:0] addr, input [7:0] data);
+        @(posedge CLK) begin
+            ADDR <= addr;
+            DIN <= data;
+            CS_n <= 0;
+        end
+        @(posedge CLK) WR_n <= 0;
+        repeat(4) @(posedge CLK);
+        @(posedge CLK) WR_n <= 1;
+        @(posedge CLK) CS_n <= 1;
+    endtask
+
+    // RD_n を下げてから 2 クロック後の DOUT を返す
+    task automatic scc_read(input [7:0] addr, output [7:0] data, output busdir_n);
+        @(posedge CLK) begin
+            ADDR <= addr;
+            CS_n <= 0;
+            RD_n <= 0;
+        end
+        repeat(2) @(posedge CLK);
+        data = DOUT;
+        busdir_n = BUSDIR_n;
+        @(posedge CLK) begin
+            RD_n <= 1;
+            CS_n <= 1;
+        end
+    endtask
+
+    int errors = 0;
+
+    task automatic check(input [7:0] addr, input [7:0] expect_data);
+        logic [7:0] data;
+        logic busdir_n;
+        scc_read(addr, data, busdir_n);
+        if(busdir_n || data !== expect_data) begin
+            $display("NG: addr=%02X data=%02X busdir_n=%0d expect=%02X", addr, data, busdir_n, expect_data);
+            errors++;
+        end
+    endtask
+
+    function [7:0] pattern(input [7:0] addr);
+        pattern = addr ^ 8'h5A;
+    endfunction
+
+    /***************************************************************
+     * テスト
+     ***************************************************************/
+    logic [4:0] pos;
+
+    initial begin
+        repeat(4) @(posedge CLK);
+        RESET_n <= 1;
+
+        // SCC-I モード : 00~9F がそれぞれ独立した波形
+        MODE_SCC_I <= 1;
+        for(int i = 0; i < 160; i++) scc_write(8'(i), pattern(8'(i)));
+        for(int i = 0; i < 160; i++) check(8'(i), pattern(8'(i)));
+
+        // SCC モード : 60~7F の書き込みは ch3,4 共通、A0~BF で ch4 を読む
+        MODE_SCC_I <= 0;
+        for(int i = 0; i < 32; i++) scc_write(8'(8'h60 + i), 8'(i));
+        for(int i = 0; i < 32; i++) check(8'(8'h60 + i), 8'(i));
+        for(int i = 0; i < 32; i++) check(8'(8'hA0 + i), 8'(i));
+
+        // 書き込み禁止 (TEST = 80h : ch3,4 のみ禁止)
+        scc_write(8'hE0, 8'h80);
+        scc_write(8'h00, 8'hAA);
+        scc_write(8'h60, 8'hAA);
+        scc_write(8'hE0, 8'h00);
+        check(8'h00, 8'hAA);
+        check(8'h60, 8'h00);
+
+        // 回転モード (TEST = 40h) : 読み出しアドレスが再生位置からの相対になる
+        for(int i = 0; i < 32; i++) scc_write(8'(i), 8'(i));
+        scc_write(8'h8F, 8'h01);
+        scc_write(8'hE0, 8'h20);        // 分周レジスタ書き込みで位置リセット
+        scc_write(8'h81, 8'h00);
+        scc_write(8'h80, 8'h01);        // 2 CLK_EN 毎に 1 サンプル進む
+        repeat(20 * CLK_EN_DIV) @(posedge CLK);
+        scc_write(8'hE0, 8'h40);
+        scc_write(8'h81, 8'h0F);        // 再生位置をほぼ止める
+        scc_write(8'h80, 8'hFF);
+        repeat(4 * CLK_EN_DIV) @(posedge CLK);
+        pos = u_scc.pos[0];
+        if(pos == 0) begin
+            $display("NG: wave position did not advance");
+            errors++;
+        end
+        for(int i = 0; i < 32; i++) check(8'(i), 8'(i + pos));
+        scc_write(8'h00, 8'hAA);        // 回転モード中は書き込み禁止
+        scc_write(8'hE0, 8'h00);
+        check(8'h00, 8'h00);
+
+        if(errors == 0) $display("OK");
+        else            $display("%0d errors", errors);
+        $finish;
+    end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,191 @@
+//
+// dac_i2s_tb.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/***********************************************************************
+ * I2S ステレオ出力のテストベンチ
+ *  SOUND_MIXER_MATRIX で左右に振り分けた信号を DAC_I2S で出力し、
+ *  I2S_RECEIVER で受信した値を確認する(16bit, 32bit)
+ *
+ *  シミュレーションには Gowin のプリミティブモデル(prim_sim.v)が必要
+ *   iverilog -g2012 -o dac_i2s_tb ../sound.sv ../dac_i2s.sv ../../signal/limiter.sv i2s_receiver.sv dac_i2s_tb.sv prim_sim.v
+ *   vvp dac_i2s_tb
+ ***********************************************************************/
+`timescale 1ns/1ps
+`default_nettype none
+
+module dac_i2s_tb;
+    localparam BCLK_DIV = 8;
+
+    logic       CLK = 0;
+    logic       RESET_n = 0;
+    logic       BCLK = 0;
+
+    always #5 CLK = !CLK;
+
+    logic [$clog2(BCLK_DIV)-1:0] bclk_cnt = 0;
+    always_ff @(posedge CLK) begin
+        bclk_cnt <= bclk_cnt + 1'd1;
+        if(bclk_cnt == BCLK_DIV / 2 - 1 || bclk_cnt == BCLK_DIV - 1) BCLK <= !BCLK;
+    end
+
+    /***************************************************************
+     * 左右の振り分け
+     *  入力 0 は左のみ 0dB、入力 1 は右のみ -6dB
+     ***************************************************************/
+    SOUND_IF #(.BIT_WIDTH(16)) In[0:1]();
+    SOUND_IF #(.BIT_WIDTH(16)) Out[0:1]();
+    logic [15:0] in_0 = 0;
+    logic [15:0] in_1 = 0;
+    assign In[0].Signal = in_0;
+    assign In[1].Signal = in_1;
+
+    SOUND_MIXER_MATRIX #(
+        .IN_COUNT       (2),
+        .OUT_COUNT      (2),
+        .GAIN_WIDTH     (8),
+        .GAIN_SHIFT     (7)
+    ) u_mixer (
+        .RESET_n,
+        .CLK,
+        .IN             (In),
+        .GAIN           ({ 8'd64, 8'd0, 8'd0, 8'd128 }),    // {R1, R0, L1, L0}
+        .OUT            (Out)
+    );
+
+    /***************************************************************
+     * 16bit
+     ***************************************************************/
+    wire        lrclk_16;
+    wire        din_16;
+    wire [15:0] l_16;
+    wire [15:0] r_16;
+    wire        valid_16;
+    DAC_I2S #(
+        .bit_width      (16)
+    ) u_dac_16 (
+        .CLK,
+        .RESET_n,
+        .IN_L           (Out[0]),
+        .IN_R           (Out[1]),
+        .BCLK,
+        .LRCLK          (lrclk_16),
+        .DIN            (din_16)
+    );
+
+    I2S_RECEIVER #(
+        .BIT_WIDTH      (16)
+    ) u_rx_16 (
+        .BCLK,
+        .LRCLK          (lrclk_16),
+        .DIN            (din_16),
+        .L              (l_16),
+        .R              (r_16),
+        .VALID          (valid_16)
+    );
+
+    /***************************************************************
+     * 32bit
+     ***************************************************************/
+    wire        lrclk_32;
+    wire        din_32;
+    wire [31:0] l_32;
+    wire [31:0] r_32;
+    wire        valid_32;
+    DAC_I2S #(
+        .bit_width      (32)
+    ) u_dac_32 (
+        .CLK,
+        .RESET_n,
+        .IN_L           (Out[0]),
+        .IN_R           (Out[1]),
+        .BCLK,
+        .LRCLK          (lrclk_32),
+        .DIN            (din_32)
+    );
+
+    I2S_RECEIVER #(
+        .BIT_WIDTH      (32)
+    ) u_rx_32 (
+        .BCLK,
+        .LRCLK          (lrclk_32),
+        .DIN            (din_32),
+        .L              (l_32),
+        .R              (r_32),
+        .VALID          (valid_32)
+    );
+
+    /***************************************************************
+     * テスト
+     ***************************************************************/
+    int errors = 0;
+
+    task automatic check(input [15:0] value_0, input [15:0] value_1);
+        logic [15:0] expect_l;
+        logic [15:0] expect_r;
+        in_0 = value_0;
+        in_1 = value_1;
+        expect_l = value_0;
+        expect_r = 16'($signed(value_1) >>> 1);
+
+        // 入力を変更してから 2フレーム分待つ(32bit 側)
+        repeat(3) @(valid_32);
+        if(l_16 != expect_l || r_16 != expect_r) begin
+            $display("NG 16bit: in=%04X,%04X L=%04X(%04X) R=%04X(%04X)", value_0, value_1, l_16, expect_l, r_16, expect_r);
+            errors++;
+        end
+        if(l_32 != { expect_l, 16'd0 } || r_32 != { expect_r, 16'd0 }) begin
+            $display("NG 32bit: in=%04X,%04X L=%08X(%04X0000) R=%08X(%04X0000)", value_0, value_1, l_32, expect_l, r_32, expect_r);
+            errors++;
+        end
+    endtask
+
+    initial begin
+        repeat(4) @(posedge CLK);
+        RESET_n <= 1;
+
+        check(16'h0000, 16'h0000);
+        check(16'h1234, 16'h0000);
+        check(16'h0000, 16'h4000);
+        check(16'h8000, 16'h8000);
+        check(16'h7FFF, 16'h7FFE);
+        for(int i = 0; i < 32; i++) check(16'($urandom), 16'($urandom));
+
+        if(errors == 0) $display("OK");
+        else            $display("%0d errors", errors);
+        $finish;
+    end
+
+endmodule
+
+`default_nettype wire
@@ -0,0 +1,83 @@
+//
+// i2s_receiver.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+`default_nettype none
+
+/***********************************************************************
+ * I2S レシーバー(シミュレーション用モデル)
+ *  BCLK の立ち上がりで LRCLK, DIN を取り込み、1ch 分のデータが揃う毎に
+ *  L または R を更新する(LRCLK=0 が左)
+ *  DELAY は LRCLK の変化から MSB までの BCLK 数
+ *  (0=左詰め(DAC_I2S の出力形式), 1=I2S フォーマット)
+ ***********************************************************************/
+module I2S_RECEIVER #(
+    parameter   BIT_WIDTH = 16,     // 1ch あたりのビット数
+    parameter   DELAY = 0
+) (
+    input wire                      BCLK,
+    input wire                      LRCLK,
+    input wire                      DIN,
+    output logic [BIT_WIDTH-1:0]    L = 0,
+    output logic [BIT_WIDTH-1:0]    R = 0,
+    output logic                    VALID = 0   // 右チャンネルを受信する毎に反転
+);
+    logic [DELAY:0]         lrclk_delay = 0;
+    logic                   prev_lrclk = 0;
+    logic [BIT_WIDTH-1:0]   shift_reg = 0;
+    logic                   started = 0;
+
+    wire lrclk = (DELAY == 0) ? LRCLK : lrclk_delay[DELAY-1];
+
+    always @(posedge BCLK) begin
+        // LRCLK が変化したら直前までのビット列を 1ch 分のデータとして出力
+        if(lrclk != prev_lrclk) begin
+            if(started) begin
+                if(prev_lrclk) begin
+                    R <= shift_reg;
+                    VALID <= !VALID;
+                end
+                else begin
+                    L <= shift_reg;
+                end
+            end
+            started <= 1;
+        end
+        prev_lrclk <= lrclk;
+        shift_reg <= { shift_reg[BIT_WIDTH-2:0], DIN };
+        lrclk_delay <= { lrclk_delay, LRCLK };
+    end
+
+endmodule
+
+`default_nettype wire
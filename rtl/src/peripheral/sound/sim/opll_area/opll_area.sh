@@ -0,0 +1,113 @@
+#!/bin/bash
+#
+# opll_area.sh
+#
+# BSD 3-Clause License
+#
+# Copyright (c) 2024, Shinobu Hashimoto
+#
+# IKAOPLL と VM2413 をオープンソースのツールチェーンで合成し、
+# 使用リソース(LUT/FF/BSRAM 等)と最大動作周波数を比較する
+#
+# 必要なもの
+#   yosys (synth_gowin), ghdl-yosys-plugin (VM2413 の VHDL 読み込み)
+#   nextpnr-himbaechel (任意, 無ければ最大動作周波数は表示しない)
+#
+# 使い方
+#   ./opll_area.sh [出力ディレクトリ]
+#
+# 環境変数
+#   FAMILY  synth_gowin の -family (既定値 gw2a)
+#   DEVICE  nextpnr のデバイス名 (既定値 TangNano20K の GW2AR-LV18QN88C8/I7)
+#   FREQ    nextpnr の目標周波数 MHz (既定値 21.48 : CLK_21M)
+#
+
+set -e
+
+cd "$(dirname "$0")"
+SRC=../..
+OUT=${1:-out}
+FAMILY=${FAMILY:-gw2a}
+DEVICE=${DEVICE:-GW2AR-LV18QN88C8/I7}
+PNR_FAMILY=${PNR_FAMILY:-GW2A-18C}
+FREQ=${FREQ:-21.48}
+
+mkdir -p "$OUT"
+
+if ! command -v yosys > /dev/null; then
+    echo "yosys not found" >&2
+    exit 1
+fi
+
+IKAOPLL_FILES="$SRC/IKAOPLL/IKAOPLL.v $(ls $SRC/IKAOPLL/IKAOPLL_modules/*.v)"
+# vm2413.vhd はパッケージなので最初に読む
+VM2413_FILES="$SRC/vm2413/vm2413.vhd $(ls $SRC/vm2413/*.vhd | grep -v '/vm2413\.vhd$')"
+
+#
+# 合成
+#
+synth() {
+    local name=$1 top=$2 read_cmd=$3 plugin=$4
+    echo "synthesizing $name ..." >&2
+    yosys -q $plugin -l "$OUT/$name.log" -p "
+        $read_cmd
+        read_verilog opll_area_$name.v
+        synth_gowin -family $FAMILY -top $top -json $OUT/$name.json
+        tee -q -o $OUT/$name.stat stat
+    "
+}
+
+synth ikaopll OPLL_AREA_IKAOPLL "read_verilog $IKAOPLL_FILES" ""
+synth vm2413  OPLL_AREA_VM2413  "ghdl -fsynopsys $VM2413_FILES -e opll" "-m ghdl"
+
+#
+# 配置配線(任意)
+#
+pnr() {
+    local name=$1
+    if ! command -v nextpnr-himbaechel > /dev/null; then
+        echo "-"
+        return
+    fi
+    echo "place and route $name ..." >&2
+    if nextpnr-himbaechel --device "$DEVICE" --vopt family="$PNR_FAMILY" \
+            --json "$OUT/$name.json" --freq "$FREQ" \
+            -l "$OUT/$name.pnr.log" > /dev/null 2>&1; then
+        grep "Max frequency for clock" "$OUT/$name.pnr.log" | tail -1 | sed 's/.*: *\([0-9.]*\) MHz.*/\1/'
+    else
+        echo "fail"
+    fi
+}
+
+#
+# stat の集計
+#  yosys のバージョンにより "数 セル名" と "セル名 数" の両方の書式がある
+#
+count() {
+    local stat=$1 pattern=$2
+    awk -v pat="^($pattern)\$" '
+        $1 ~ /^[0-9]+$/ && $2 ~ pat { n += $1 }
+        $2 ~ /^[0-9]+$/ && $1 ~ pat { n += $2 }
+        END { print n + 0 }
+    ' "$stat"
+}
+
+report() {
+    local name=$1 fmax=$2
+    local stat="$OUT/$name.stat"
+    printf "%-8s %6d %6d %6d %6d %6d %6d %8s\n" "$name" \
+        "$(count $stat 'LUT[1-4]')" \
+        "$(count $stat 'DFF[A-Z]*')" \
+        "$(count $stat 'ALU')" \
+        "$(count $stat 'RAM16S[A-Z0-9]*|RAM16SDP[0-9]*')" \
+        "$(count $stat 'DPB|DPX9B|SDPB|SDPX9B|SP|SPX9|pROM|pROMX9')" \
+        "$(count $stat 'MULT[A-Z0-9]*|MULTALU[A-Z0-9]*|MULTADDALU[A-Z0-9]*|ALU54D')" \
+        "$fmax"
+}
+
+FMAX_IKAOPLL=$(pnr ikaopll)
+FMAX_VM2413=$(pnr vm2413)
+
+printf "%-8s %6s %6s %6s %6s %6s %6s %8s\n" "core" "LUT" "FF" "ALU" "SSRAM" "BSRAM" "DSP" "Fmax"
+report ikaopll "$FMAX_IKAOPLL"
+report vm2413  "$FMAX_VM2413"
@@ -0,0 +1,92 @@
+//
+// opll_area_ikaopll.v
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/***********************************************************************
+ * リソース比較用 IKAOPLL ラッパー
+ *  cartridge_fm.sv と同じパラメータで IKAOPLL を接続する
+ ***********************************************************************/
+`default_nettype none
+
+module OPLL_AREA_IKAOPLL (
+    input wire          CLK,
+    input wire          CLK_EN,
+    input wire          RESET_n,
+    input wire          CS_n,
+    input wire          WR_n,
+    input wire          A0,
+    input wire [7:0]    DIN,
+    output reg [15:0]   OUT
+);
+    wire        dac_stb;
+    wire [15:0] dac_sig;
+
+    IKAOPLL #(
+        .FULLY_SYNCHRONOUS          (1'b1                       ),
+        .FAST_RESET                 (1'b1                       ),
+        .ALTPATCH_CONFIG_MODE       (1'b0                       ),
+        .USE_PIPELINED_MULTIPLIER   (1'b1                       )
+    ) u_opll (
+        .i_XIN_EMUCLK               (CLK                        ),
+        .o_XOUT                     (                           ),
+        .i_phiM_PCEN_n              (!CLK_EN                    ),
+        .i_IC_n                     (RESET_n                    ),
+        .i_ALTPATCH_EN              (1'b0                       ),
+        .i_CS_n                     (CS_n                       ),
+        .i_WR_n                     (WR_n                       ),
+        .i_A0                       (A0                         ),
+        .i_D                        (DIN                        ),
+        .o_D                        (                           ),
+        .o_D_OE                     (                           ),
+        .o_DAC_EN_MO                (                           ),
+        .o_DAC_EN_RO                (                           ),
+        .o_IMP_NOFLUC_SIGN          (                           ),
+        .o_IMP_NOFLUC_MAG           (                           ),
+        .o_IMP_FLUC_SIGNED_MO       (                           ),
+        .o_IMP_FLUC_SIGNED_RO       (                           ),
+        .i_ACC_SIGNED_MOVOL         (5'sd2                      ),
+        .i_ACC_SIGNED_ROVOL         (5'sd1                      ),
+        .o_ACC_SIGNED_STRB          (dac_stb                    ),
+        .o_ACC_SIGNED               (dac_sig                    )
+    );
+
+    reg dac_stb_delay;
+    always @(posedge CLK) dac_stb_delay <= dac_stb;
+
+    always @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)                        OUT <= 0;
+        else if(!dac_stb_delay && dac_stb)  OUT <= {dac_sig[12:0], 3'd0};
+    end
+endmodule
+
+`default_nettype wire
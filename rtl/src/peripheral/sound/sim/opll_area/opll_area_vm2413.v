@@ -0,0 +1,76 @@
+//
+// opll_area_vm2413.v
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+/***********************************************************************
+ * リソース比較用 VM2413 ラッパー
+ *  OPLL_AREA_IKAOPLL と同じポートで VM2413 を接続する
+ *  (cartridge_fm.sv の LPF_OPLL とリミッタは含まない)
+ ***********************************************************************/
+`default_nettype none
+
+module OPLL_AREA_VM2413 (
+    input wire          CLK,
+    input wire          CLK_EN,
+    input wire          RESET_n,
+    input wire          CS_n,
+    input wire          WR_n,
+    input wire          A0,
+    input wire [7:0]    DIN,
+    output reg [15:0]   OUT
+);
+    wire [9:0] mo;
+    wire [9:0] ro;
+
+    opll u_vm2413 (
+        .xin        (CLK),
+        .xout       (),
+        .xena       (CLK_EN),
+        .d          (DIN),
+        .a          (A0),
+        .cs_n       (CS_n),
+        .we_n       (WR_n),
+        .ic_n       (RESET_n),
+        .mo         (mo),
+        .ro         (ro)
+    );
+
+    wire [10:0] sum = {1'b0, mo} + {1'b0, ro} - 11'd1024;
+
+    always @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)    OUT <= 0;
+        else            OUT <= {sum, 5'd0};
+    end
+endmodule
+
+`default_nettype wire
@@ -47,6 +47,50 @@ interface SOUND_IF #(parameter BIT_WIDTH=10);
     endfunction
 endinterface
 
+/***********************************************************************
+ * ミキサー音量インターフェース
+ *  Gain     : 音量レジスタの値(SOUND_MIXER_MATRIX の GAIN と同じ並び)
+ *  LoadData : フラッシュに保存されていた音量(1ch あたり下位,上位の 2バイト)
+ *  Load     : 1 の間 LoadData を音量レジスタへ読み込む
+ ***********************************************************************/
+interface MIXER_IF #(parameter COUNT = 8, GAIN_WIDTH = 12);
+    logic [COUNT*GAIN_WIDTH-1:0]    Gain;
+    logic [7:0]                     LoadData[0:COUNT*2-1];
+    logic                           Load;
+
+    modport HOST  (output LoadData, Load, input  Gain);
+    modport DEVICE(input  LoadData, Load, output Gain);
+
+    // ダミー接続
+    function automatic void connect_dummy();
+        Load = 0;
+    endfunction
+endinterface
+
+/***********************************************************************
+ * 音源レジスタ書き込み通知インターフェース(VGM ロガー用)
+ *  WR   : 書き込みサイクルの終わりで 1 クロックだけ 1
+ *  PORT : レジスタの種類(SCC のみ使用, VGM の D2 コマンドのポート番号)
+ *  ADDR : レジスタ番号
+ *  DATA : 書き込みデータ
+ ***********************************************************************/
+interface SOUND_REG_IF;
+    logic       WR;
+    logic [7:0] PORT;
+    logic [7:0] ADDR;
+    logic [7:0] DATA;
+    modport IN  ( input  WR, PORT, ADDR, DATA );
+    modport OUT ( output WR, PORT, ADDR, DATA );
+
+    // ダミー出力
+    function automatic void connect_dummy();
+        WR = 0;
+        PORT = 0;
+        ADDR = 0;
+        DATA = 0;
+    endfunction
+endinterface
+
 /***********************************************************************
  * アッテネーターモジュール
  ***********************************************************************/
@@ -129,4 +173,335 @@ module SOUND_MIXER #(
 
 endmodule
 
+/***********************************************************************
+ * マトリクスミキサーモジュール
+ *  1個の乗算器を順番に使い、全ての入力 x 全ての出力の音量を計算して加算する
+ *  GAIN は出力毎に IN_COUNT 個並べる(出力 o, 入力 i の値は GAIN[(o*IN_COUNT+i)*GAIN_WIDTH +: GAIN_WIDTH])
+ *  GAIN の値は 2**GAIN_SHIFT で 0dB
+ ***********************************************************************/
+module SOUND_MIXER_MATRIX #(
+    parameter       IN_COUNT = 1,       // 入力数
+    parameter       OUT_COUNT = 1,      // 出力数
+    parameter       GAIN_WIDTH = 12,    // 音量のビット幅
+    parameter       GAIN_SHIFT = 10     // 音量の小数部のビット幅
+) (
+    input wire      CLK,
+    input wire      RESET_n,
+
+    SOUND_IF.IN     IN[0:IN_COUNT-1],   // 入力信号
+    input wire [OUT_COUNT*IN_COUNT*GAIN_WIDTH-1:0] GAIN,    // 音量
+    SOUND_IF.OUT    OUT[0:OUT_COUNT-1]  // 出力信号
+);
+    localparam IN_WIDTH  = $bits(IN[0].Signal);
+    localparam OUT_WIDTH = $bits(OUT[0].Signal);
+    localparam SUM_WIDTH = IN_WIDTH + (GAIN_WIDTH - GAIN_SHIFT) + $clog2(IN_COUNT + 1);
+    localparam IN_BITS   = (IN_COUNT  > 1) ? $clog2(IN_COUNT)  : 1;
+    localparam OUT_BITS  = (OUT_COUNT > 1) ? $clog2(OUT_COUNT) : 1;
+
+    /***************************************************************
+     * インターフェースを配列に変換
+     ***************************************************************/
+    wire [IN_WIDTH-1:0]     in_signal[0:IN_COUNT-1];
+    logic [OUT_WIDTH-1:0]   out_signal[0:OUT_COUNT-1];
+    generate
+        genvar in_ch;
+        for(in_ch = 0; in_ch < IN_COUNT; in_ch = in_ch + 1) begin: in_loop
+            assign in_signal[in_ch] = IN[in_ch].Signal;
+        end
+        genvar out_ch;
+        for(out_ch = 0; out_ch < OUT_COUNT; out_ch = out_ch + 1) begin: out_loop
+            assign OUT[out_ch].Signal = out_signal[out_ch];
+        end
+    endgenerate
+
+    /***************************************************************
+     * 計算する入力と出力の組み合わせ
+     ***************************************************************/
+    logic [IN_BITS-1:0]  in_index;
+    logic [OUT_BITS-1:0] out_index;
+    wire first = (in_index == 0);
+    wire last  = (in_index == IN_BITS'(IN_COUNT - 1));
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            in_index <= 0;
+            out_index <= 0;
+        end
+        else if(!last) begin
+            in_index <= in_index + 1'd1;
+        end
+        else begin
+            in_index <= 0;
+            out_index <= (out_index == OUT_BITS'(OUT_COUNT - 1)) ? 1'd0 : out_index + 1'd1;
+        end
+    end
+
+    /***************************************************************
+     * 乗算
+     ***************************************************************/
+    wire [17:0] sign = 18'd0 - 18'd1;
+    wire [17:0] zero = 18'd0;
+    wire [IN_WIDTH-1:0] in_value = in_signal[in_index];
+    wire [17:0] mul_a = {(in_value[IN_WIDTH-1] ? sign[17:IN_WIDTH] : zero[17:IN_WIDTH]), in_value};
+    wire [17:0] mul_b = 18'(GAIN[(out_index * IN_COUNT + in_index) * GAIN_WIDTH +: GAIN_WIDTH]);
+    logic [35:0] mul_out;
+    MULT18X18 mult18x18_inst (
+        .DOUT(mul_out),
+        .SOA(),
+        .SOB(),
+        .A(mul_a),
+        .B(mul_b),
+        .ASIGN(1'b1),
+        .BSIGN(1'b0),
+        .SIA(18'd0),
+        .SIB(18'd0),
+        .CE(1'b1),
+        .CLK(CLK),
+        .RESET(!RESET_n),
+        .ASEL(1'b0),
+        .BSEL(1'b0)
+    );
+
+    defparam mult18x18_inst.AREG = 1'b1;
+    defparam mult18x18_inst.BREG = 1'b1;
+    defparam mult18x18_inst.OUT_REG = 1'b1;
+    defparam mult18x18_inst.PIPE_REG = 1'b0;
+    defparam mult18x18_inst.ASIGN_REG = 1'b0;
+    defparam mult18x18_inst.BSIGN_REG = 1'b0;
+    defparam mult18x18_inst.SOA_REG = 1'b0;
+    defparam mult18x18_inst.MULT_RESET_MODE = "SYNC";
+
+    /***************************************************************
+     * 乗算器の遅延(2クロック)に合わせて組み合わせ情報を遅延
+     ***************************************************************/
+    logic [1:0]             first_delay;
+    logic [1:0]             last_delay;
+    logic [OUT_BITS-1:0]    out_index_delay[0:1];
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            first_delay <= 0;
+            last_delay <= 0;
+            out_index_delay[0] <= 0;
+            out_index_delay[1] <= 0;
+        end
+        else begin
+            first_delay <= { first_delay[0], first };
+            last_delay <= { last_delay[0], last };
+            out_index_delay[0] <= out_index;
+            out_index_delay[1] <= out_index_delay[0];
+        end
+    end
+
+    /***************************************************************
+     * 加算
+     *  小数部は入力毎に切り捨てる(ATT_CONST と同じ)
+     ***************************************************************/
+    wire [SUM_WIDTH-1:0] term = mul_out[SUM_WIDTH+GAIN_SHIFT-1:GAIN_SHIFT];
+    logic [SUM_WIDTH-1:0] sum;
+    wire [SUM_WIDTH-1:0] sum_next = first_delay[1] ? term : (sum + term);
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) sum <= 0;
+        else         sum <= sum_next;
+    end
+
+    /***************************************************************
+     * リミッタ
+     ***************************************************************/
+    wire [OUT_WIDTH-1:0] limited;
+    LIMITER #(
+        .IN_WIDTH(SUM_WIDTH),
+        .OUT_WIDTH(OUT_WIDTH)
+    ) u_limiter (
+        .IN(sum_next),
+        .OUT(limited)
+    );
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            for(int i = 0; i < OUT_COUNT; i++) out_signal[i] <= 0;
+        end
+        else if(last_delay[1]) begin
+            out_signal[out_index_delay[1]] <= limited;
+        end
+    end
+
+endmodule
+
+/***********************************************************************
+ * 補間フィルタモジュール
+ *  IN_EN 毎に更新される信号を CLK_EN 毎(RATIO 倍)のサンプルへ補間する
+ *  係数は長さ RATIO の箱型フィルタを ORDER 回畳み込んだもの(CIC と同じ特性)で、
+ *  合成時に計算する
+ *  1個の乗算器を ORDER タップで順番に使うので、CLK_EN の間隔は ORDER+3 クロック以上必要
+ ***********************************************************************/
+module SOUND_INTERPOLATOR #(
+    parameter       IN_WIDTH = 11,      // 入力のビット幅
+    parameter       OUT_WIDTH = 16,     // 出力のビット幅(IN_WIDTH 以上)
+    parameter       RATIO = 16,         // 補間倍率(2のべき乗)
+    parameter       ORDER = 4           // 箱型フィルタの畳み込み回数(タップ数)
+) (
+    input wire                      CLK,
+    input wire                      RESET_n,
+    input wire                      CLK_EN,     // 出力サンプルのタイミング
+    input wire                      IN_EN,      // 入力サンプルのタイミング(CLK_EN と同時に 1、IN は次のクロックで更新)
+    input wire [IN_WIDTH-1:0]       IN,
+    output reg [OUT_WIDTH-1:0]      OUT
+);
+    localparam RATIO_BITS = $clog2(RATIO);
+    localparam TAP_BITS   = (ORDER > 1) ? $clog2(ORDER) : 1;
+    localparam GAIN_BITS  = RATIO_BITS * (ORDER - 1);           // 位相毎の係数の合計は 2**GAIN_BITS
+    localparam SUM_WIDTH  = IN_WIDTH + GAIN_BITS + 1;
+    localparam SUM_SHIFT  = GAIN_BITS - (OUT_WIDTH - IN_WIDTH);
+
+    /***************************************************************
+     * 係数
+     *  n 番目の係数は 0~RATIO-1 の整数 ORDER 個の和が n になる組み合わせ数
+     ***************************************************************/
+    function automatic int binom(input int n, input int k);
+        binom = (n < k || k < 0) ? 0 : 1;
+        for(int i = 1; i <= k; i++) binom = binom * (n - k + i) / i;
+    endfunction
+
+    function automatic int coef(input int n);
+        coef = 0;
+        for(int j = 0; j <= ORDER; j++) begin
+            if(n - RATIO * j >= 0) coef = coef + ((j % 2) ? -1 : 1) * binom(ORDER, j) * binom(n - RATIO * j + ORDER - 1, ORDER - 1);
+        end
+    endfunction
+
+    wire [17:0] coef_rom[0:RATIO*ORDER-1];
+    generate
+        genvar coef_num;
+        for(coef_num = 0; coef_num < RATIO * ORDER; coef_num = coef_num + 1) begin: coef_loop
+            assign coef_rom[coef_num] = 18'(coef(coef_num));
+        end
+    endgenerate
+
+    /***************************************************************
+     * 入力履歴と位相
+     *  hist[k] は k 個前の入力
+     ***************************************************************/
+    logic [IN_WIDTH-1:0]    hist[0:ORDER-1];
+    logic [RATIO_BITS-1:0]  phase;
+    logic                   load;
+    logic                   start;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            load <= 0;
+            start <= 0;
+        end
+        else begin
+            load <= CLK_EN && IN_EN;
+            start <= CLK_EN;
+        end
+    end
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            for(int i = 0; i < ORDER; i++) hist[i] <= 0;
+            phase <= 0;
+        end
+        else if(load) begin
+            hist[0] <= IN;
+            for(int i = 1; i < ORDER; i++) hist[i] <= hist[i - 1];
+            phase <= 0;
+        end
+        else if(start) begin
+            phase <= phase + 1'd1;
+        end
+    end
+
+    /***************************************************************
+     * タップ
+     ***************************************************************/
+    logic [TAP_BITS-1:0]    tap;
+    logic                   busy;
+    wire first = busy && (tap == 0);
+    wire last  = busy && (tap == TAP_BITS'(ORDER - 1));
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            tap <= 0;
+            busy <= 0;
+        end
+        else if(start) begin
+            tap <= 0;
+            busy <= 1;
+        end
+        else if(last) begin
+            busy <= 0;
+        end
+        else if(busy) begin
+            tap <= tap + 1'd1;
+        end
+    end
+
+    /***************************************************************
+     * 乗算
+     ***************************************************************/
+    wire [17:0] sign = 18'd0 - 18'd1;
+    wire [17:0] zero = 18'd0;
+    wire [IN_WIDTH-1:0] in_value = hist[tap];
+    wire [17:0] mul_a = {(in_value[IN_WIDTH-1] ? sign[17:IN_WIDTH] : zero[17:IN_WIDTH]), in_value};
+    wire [17:0] mul_b = coef_rom[tap * RATIO + phase];
+    logic [35:0] mul_out;
+    MULT18X18 mult18x18_inst (
+        .DOUT(mul_out),
+        .SOA(),
+        .SOB(),
+        .A(mul_a),
+        .B(mul_b),
+        .ASIGN(1'b1),
+        .BSIGN(1'b0),
+        .SIA(18'd0),
+        .SIB(18'd0),
+        .CE(1'b1),
+        .CLK(CLK),
+        .RESET(!RESET_n),
+        .ASEL(1'b0),
+        .BSEL(1'b0)
+    );
+
+    defparam mult18x18_inst.AREG = 1'b1;
+    defparam mult18x18_inst.BREG = 1'b1;
+    defparam mult18x18_inst.OUT_REG = 1'b1;
+    defparam mult18x18_inst.PIPE_REG = 1'b0;
+    defparam mult18x18_inst.ASIGN_REG = 1'b0;
+    defparam mult18x18_inst.BSIGN_REG = 1'b0;
+    defparam mult18x18_inst.SOA_REG = 1'b0;
+    defparam mult18x18_inst.MULT_RESET_MODE = "SYNC";
+
+    /***************************************************************
+     * 乗算器の遅延(2クロック)に合わせてタップ情報を遅延
+     ***************************************************************/
+    logic [1:0] first_delay;
+    logic [1:0] last_delay;
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) begin
+            first_delay <= 0;
+            last_delay <= 0;
+        end
+        else begin
+            first_delay <= { first_delay[0], first };
+            last_delay <= { last_delay[0], last };
+        end
+    end
+
+    /***************************************************************
+     * 加算
+     *  係数の合計が 2**GAIN_BITS なのでオーバーフローしない
+     ***************************************************************/
+    wire [SUM_WIDTH-1:0] term = mul_out[SUM_WIDTH-1:0];
+    logic [SUM_WIDTH-1:0] sum;
+    wire [SUM_WIDTH-1:0] sum_next = first_delay[1] ? term : (sum + term);
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n) sum <= 0;
+        else         sum <= sum_next;
+    end
+
+    always_ff @(posedge CLK or negedge RESET_n) begin
+        if(!RESET_n)          OUT <= 0;
+        else if(last_delay[1]) OUT <= sum_next[SUM_SHIFT +: OUT_WIDTH];
+    end
+
+endmodule
+
 `default_nettype wire
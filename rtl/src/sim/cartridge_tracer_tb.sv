@@ -0,0 +1,224 @@
+//
+// cartridge_tracer_tb.sv
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+
+
+/***********************************************************************
+ * バストレーサーのテストベンチ
+ *  I/O ポートのレジスタ読み書きとリングバッファの読み出しを、
+ *  Z80 と同じく RD_n の終わりでデータを取り込んで確認する
+ *
+ *   iverilog -g2012 -o cartridge_tracer_tb ../peripheral/msx/bus.sv ../peripheral/ram/ram.sv ../cartridge_tracer.sv cartridge_tracer_tb.sv
+ *   vvp cartridge_tracer_tb
+ ***********************************************************************/
+`timescale 1ns/1ps
+`default_nettype none
+
+module cartridge_tracer_tb;
+    localparam [7:0] IO_BASE = 8'h2A;
+    localparam RD_CLOCKS = 60;          // RD_n の長さ(108MHz で約 2 T ステート)
+
+    logic CLK = 0;
+    logic RESET_n = 0;
+
+    always #4.63 CLK = !CLK;
+
+    /***************************************************************
+     * テスト対象
+     ***************************************************************/
+    BUS_IF  bus();
+    RAM_IF  ram();
+
+    CARTRIDGE_TRACER #(
+        .IO_BASE_ADDR   (IO_BASE),
+        .RAM_ADDR       (0),
+        .RAM_SIZE       (24'h01_0000)
+    ) u_tracer (
+        .RESET_n,
+        .CLK,
+        .Bus            (bus),
+        .Ram            (ram)
+    );
+
+    initial begin
+        bus.ADDR = 0;
+        bus.DIN = 0;
+        bus.RFSH_n = 1;
+        bus.RD_n = 1;
+        bus.WR_n = 1;
+        bus.MERQ_n = 1;
+        bus.IORQ_n = 1;
+        bus.CS1_n = 1;
+        bus.CS2_n = 1;
+        bus.CS12_n = 1;
+        bus.M1_n = 1;
+        bus.SLTSL_n = 1;
+        bus.RESET_n = 1;
+        bus.CLK = 0;
+        bus.CLK_EN = 0;
+        bus.CLK_21M = 0;
+        bus.CLK_EN_21M = 0;
+    end
+
+    /***************************************************************
+     * SD-RAM
+     *  OE_n/WE_n から数クロック後に ACK_n を返し、要求が下がったら戻す
+     ***************************************************************/
+    function [7:0] pattern(input [15:0] addr);
+        pattern = addr[7:0] ^ { addr[11:8], addr[15:12] } ^ 8'hC3;
+    endfunction
+
+    logic [31:0] mem[0:16383];
+    initial begin
+        for(int i = 0; i < 16384; i++) begin
+            mem[i] = { pattern(16'(i * 4 + 3)), pattern(16'(i * 4 + 2)), pattern(16'(i * 4 + 1)), pattern(16'(i * 4)) };
+        end
+    end
+
+    logic [1:0] ram_wait = 0;
+    initial ram.ACK_n = 1;
+    always @(posedge CLK) begin
+        if(ram.OE_n && ram.WE_n) begin
+            ram.ACK_n <= 1;
+            ram_wait <= 0;
+        end
+        else if(ram.ACK_n) begin
+            ram_wait <= ram_wait + 1'd1;
+            if(ram_wait == 2'd3) begin
+                ram.ACK_n <= 0;
+                if(!ram.OE_n) ram.DOUT <= mem[ram.ADDR[15:2]];
+                if(!ram.WE_n) mem[ram.ADDR[15:2]] <= ram.DIN;
+            end
+        end
+    end
+    assign ram.TIMING = 0;
+
+    /***************************************************************
+     * I/O 読み書き
+     ***************************************************************/
+    task automatic io_write(input [7:0] addr, input [7:0] data);
+        @(posedge CLK) begin
+            bus.ADDR <= { 8'h00, addr };
+            bus.DIN <= data;
+            bus.IORQ_n <= 0;
+            bus.WR_n <= 0;
+        end
+        repeat(RD_CLOCKS) @(posedge CLK);
+        @(posedge CLK) begin
+            bus.IORQ_n <= 1;
+            bus.WR_n <= 1;
+        end
+        repeat(30) @(posedge CLK);
+    endtask
+
+    // Z80 と同じく RD_n を上げる直前の DOUT を返す
+    task automatic io_read(input [7:0] addr, output [7:0] data);
+        @(posedge CLK) begin
+            bus.ADDR <= { 8'h00, addr };
+            bus.IORQ_n <= 0;
+            bus.RD_n <= 0;
+        end
+        repeat(RD_CLOCKS) @(posedge CLK);
+        data = bus.DOUT;
+        @(posedge CLK) begin
+            bus.IORQ_n <= 1;
+            bus.RD_n <= 1;
+        end
+        repeat(30) @(posedge CLK);
+    endtask
+
+    int errors = 0;
+
+    task automatic check(input string name, input [7:0] addr, input [7:0] expect_data);
+        logic [7:0] data;
+        io_read(addr, data);
+        if(data !== expect_data) begin
+            $display("NG: %s port=%02X data=%02X expect=%02X", name, addr, data, expect_data);
+            errors++;
+        end
+    endtask
+
+    /***************************************************************
+     * テスト
+     ***************************************************************/
+    initial begin
+        repeat(4) @(posedge CLK);
+        RESET_n <= 1;
+        repeat(4) @(posedge CLK);
+
+        // ステータス(停止中)
+        check("status", IO_BASE + 0, 8'h00);
+
+        // tntrace の検出と同じ順序 : 書いたレジスタをすぐに読み戻す
+        io_write(IO_BASE + 0, 8'h02);
+        io_write(IO_BASE + 1, 8'hA5);
+        io_write(IO_BASE + 0, 8'h02);
+        check("match_l", IO_BASE + 1, 8'hA5);
+
+        // 連続読み出しはレジスタ番号 +1
+        io_write(IO_BASE + 0, 8'h02);
+        io_write(IO_BASE + 1, 8'h11);
+        io_write(IO_BASE + 1, 8'h22);
+        io_write(IO_BASE + 1, 8'h33);
+        io_write(IO_BASE + 1, 8'h44);
+        io_write(IO_BASE + 0, 8'h02);
+        check("match_l", IO_BASE + 1, 8'h11);
+        check("match_h", IO_BASE + 1, 8'h22);
+        check("mask_l",  IO_BASE + 1, 8'h33);
+        check("mask_h",  IO_BASE + 1, 8'h44);
+
+        // バッファサイズ(64KB 単位)
+        io_write(IO_BASE + 0, 8'h0F);
+        check("size", IO_BASE + 1, 8'h01);
+
+        // リングバッファの読み出し : 32bit 境界を 2 回またぐ
+        io_write(IO_BASE + 0, 8'h10);
+        io_write(IO_BASE + 1, 8'h01);
+        io_write(IO_BASE + 1, 8'h01);
+        io_write(IO_BASE + 1, 8'h00);
+        for(int i = 0; i < 9; i++) check("data", IO_BASE + 1, pattern(16'(16'h0101 + i)));
+
+        // 読み出し位置はデータを読んだ分だけ進む
+        io_write(IO_BASE + 0, 8'h10);
+        check("rptr_l", IO_BASE + 1, 8'h0A);
+        check("rptr_m", IO_BASE + 1, 8'h01);
+
+        if(errors == 0) $display("OK");
+        else            $display("%0d errors", errors);
+        $finish;
+    end
+
+endmodule
+
+`default_nettype wire
@@ -229,11 +229,44 @@ module TNCART_BOARD_REV1_TOP (
     /***************************************************************
      * UMA
      ***************************************************************/
-    UMA_IF Uma();
+    // 3ch 目以降は有効な機能の分だけ用意する
+    localparam          UMA_TRACER              = 2;
+    localparam          UMA_VGM_LOGGER          = UMA_TRACER     + ((CONFIG::ENABLE_TRACER     != CONFIG::DISABLE) ? 1 : 0);
+    localparam          UMA_COUNT               = UMA_VGM_LOGGER + ((CONFIG::ENABLE_VGM_LOGGER != CONFIG::DISABLE) ? 1 : 0);
+
+    UMA_IF #(.COUNT(UMA_COUNT)) Uma();
     assign Uma.ADDR[0] = 0;                         // Uma[0] の SDRAM 先頭アドレス
     assign Uma.ADDR[1] = CONFIG::RAM_ADDR_VRAM;     // Uma[1] の SDRAM 先頭アドレス
 
     RAM_IF UmaRam[0:Uma.COUNT-1]();
+    RAM_IF TraceRam();
+    RAM_IF VgmLogRam();
+
+    if(CONFIG::ENABLE_TRACER) begin
+        assign Uma.ADDR[UMA_TRACER] = 0;            // バストレーサーの SDRAM 先頭アドレス
+        BYPASS_RAM u_bypass_trace (
+            .Primary    (UmaRam[UMA_TRACER]),
+            .Secondary  (TraceRam)
+        );
+    end
+    else begin
+        assign TraceRam.DOUT = 0;
+        assign TraceRam.ACK_n = 1;
+        assign TraceRam.TIMING = 0;
+    end
+
+    if(CONFIG::ENABLE_VGM_LOGGER) begin
+        assign Uma.ADDR[UMA_VGM_LOGGER] = 0;        // VGM ロガーの SDRAM 先頭アドレス
+        BYPASS_RAM u_bypass_vgm_log (
+            .Primary    (UmaRam[UMA_VGM_LOGGER]),
+            .Secondary  (VgmLogRam)
+        );
+    end
+    else begin
+        assign VgmLogRam.DOUT = 0;
+        assign VgmLogRam.ACK_n = 1;
+        assign VgmLogRam.TIMING = 0;
+    end
 
     if(ENABLE_UMA) begin
         UMA #(
@@ -255,9 +288,12 @@ module TNCART_BOARD_REV1_TOP (
             .Primary    (Ram),
             .Secondary  (UmaRam[0])
         );
-        assign UmaRam[1].DOUT = 0;
-        assign UmaRam[1].ACK_n = 1;
-        assign UmaRam[1].TIMING = 0;
+        genvar uma_ch;
+        for(uma_ch = 1; uma_ch < Uma.COUNT; uma_ch = uma_ch + 1) begin: uma_dummy
+            assign UmaRam[uma_ch].DOUT = 0;
+            assign UmaRam[uma_ch].ACK_n = 1;
+            assign UmaRam[uma_ch].TIMING = 0;
+        end
         assign Uma.CLK14M_EN = 0;
         assign Uma.CLK21M_EN = 0;
         assign Uma.CLK25M_EN = 0;
@@ -401,6 +437,8 @@ module TNCART_BOARD_REV1_TOP (
         .Bus,
         .Ram            (UmaRam[0]),
         .VideoRam       (UmaRam[1]),
+        .TraceRam       (TraceRam),
+        .VgmLogRam      (VgmLogRam),
         .UmaClock       (Uma),
         .TF,
         .LedNextor,
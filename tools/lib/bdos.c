@@ -33,19 +33,25 @@
 
 #include <string.h>
 #include "types.h"
+#include "host.h"
 #include "bdos.h"
 
+#define BDOS_BUFIN  (0x0A)
 #define BDOS_FOPEN  (0x0F)
 #define BDOS_FMAKE  (0x16)
 #define BDOS_FCLOSE (0x10)
 #define BDOS_RDSEQ  (0x14)
 #define BDOS_WRSEQ  (0x15)
 #define BDOS_SETDTA (0x1A)
+#define BDOS_RDBLK  (0x27)
 #define BDOS_OPEN   (0x43)
 #define BDOS_CREATE (0x44)
 #define BDOS_CLOSE  (0x45)
 #define BDOS_READ   (0x48)
 #define BDOS_WRITE  (0x49)
+#define BDOS_SEEK   (0x4A)
+#define BDOS_GENV   (0x6B)
+#define BDOS_SENV   (0x6C)
 #define BDOS_DOSVER (0x6F)
 #define BDOS_FFIRST (0x40)
 #define BDOS_TERM   (0x62)
@@ -54,9 +60,40 @@
 static uint8_t bdos_a;
 static uint8_t bdos_b;
 static uint8_t bdos_c;
-static uint16_t bdos_de;
-static uint16_t bdos_hl;
-static uint16_t bdos_ix;
+static uintptr_t bdos_de;
+static uintptr_t bdos_hl;
+static uintptr_t bdos_ix;
+
+#ifdef TNC_HOST
+/***********************************************
+ * BDOS コール(ホストビルド)
+ *  引数
+ *    c         : ファンクション番号
+ *    a, b      : A, B レジスタ値
+ *    de, hl, ix: DE, HL, IX レジスタ値
+ *  戻り値
+ *    A レジスタ値
+ ***********************************************/
+static int bdos_call_host(uint8_t num, uint8_t a, uint8_t b, uintptr_t de, uintptr_t hl, uintptr_t ix)
+{
+    HOST_REGS_t regs;
+    regs.a = a;
+    regs.b = b;
+    regs.c = num;
+    regs.de = de;
+    regs.hl = hl;
+    regs.ix = ix;
+    host_bdos(&regs);
+
+    bdos_a = regs.a;
+    bdos_b = regs.b;
+    bdos_c = regs.c;
+    bdos_de = regs.de;
+    bdos_hl = regs.hl;
+    bdos_ix = regs.ix;
+    return bdos_a;
+}
+#endif
 
 /***********************************************
  * BDOS コール
@@ -66,8 +103,11 @@ static uint16_t bdos_ix;
  *  戻り値
  *    A レジスタ値
  ***********************************************/
-static int bdos_call_de(uint8_t num, uint16_t de)
+static int bdos_call_de(uint8_t num, uintptr_t de)
 {
+#ifdef TNC_HOST
+    return bdos_call_host(num, 0, 0, de, 0, 0);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -110,6 +150,7 @@ __bdos_call:
 
     RET
 #endasm
+#endif
 }
 
 /***********************************************
@@ -122,6 +163,9 @@ __bdos_call:
  ***********************************************/
 static int bdos_call_b(uint8_t num, uint8_t b)
 {
+#ifdef TNC_HOST
+    return bdos_call_host(num, 0, b, 0, 0, 0);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -129,6 +173,7 @@ static int bdos_call_b(uint8_t num, uint8_t b)
     LD      C, (IX + 2)
     jp      __bdos_call
 #endasm
+#endif
 }
 
 /***********************************************
@@ -141,8 +186,11 @@ static int bdos_call_b(uint8_t num, uint8_t b)
  *  戻り値
  *    A レジスタ値
  ***********************************************/
-static int bdos_call_b_de_hl(uint8_t num, uint8_t b, uint16_t de, uint16_t hl)
+static int bdos_call_b_de_hl(uint8_t num, uint8_t b, uintptr_t de, uintptr_t hl)
 {
+#ifdef TNC_HOST
+    return bdos_call_host(num, 0, b, de, hl, 0);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -154,6 +202,7 @@ static int bdos_call_b_de_hl(uint8_t num, uint8_t b, uint16_t de, uint16_t hl)
     LD      C, (IX + 6)
     jp      __bdos_call
 #endasm
+#endif
 }
 
 /***********************************************
@@ -165,8 +214,11 @@ static int bdos_call_b_de_hl(uint8_t num, uint8_t b, uint16_t de, uint16_t hl)
  *  戻り値
  *    A レジスタ値
  ***********************************************/
-static int bdos_call_a_de(uint8_t num, uint8_t a, uint16_t de)
+static int bdos_call_a_de(uint8_t num, uint8_t a, uintptr_t de)
 {
+#ifdef TNC_HOST
+    return bdos_call_host(num, a, 0, de, 0, 0);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -176,6 +228,7 @@ static int bdos_call_a_de(uint8_t num, uint8_t a, uint16_t de)
     LD      C, (IX + 4)
     jp      __bdos_call
 #endasm
+#endif
 }
 
 /***********************************************
@@ -188,8 +241,11 @@ static int bdos_call_a_de(uint8_t num, uint8_t a, uint16_t de)
  *  戻り値
  *    A レジスタ値
  ***********************************************/
-static int bdos_call_a_b_de(uint8_t num, uint8_t a, uint8_t b, uint16_t de)
+static int bdos_call_a_b_de(uint8_t num, uint8_t a, uint8_t b, uintptr_t de)
 {
+#ifdef TNC_HOST
+    return bdos_call_host(num, a, b, de, 0, 0);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -200,6 +256,38 @@ static int bdos_call_a_b_de(uint8_t num, uint8_t a, uint8_t b, uint16_t de)
     LD      C, (IX + 6)
     jp      __bdos_call
 #endasm
+#endif
+}
+
+/***********************************************
+ * BDOS コール
+ *  引数
+ *    c         : ファンクション番号
+ *    a         : A レジスタ値
+ *    b         : B レジスタ値
+ *    de        : DE レジスタ値
+ *    hl        : HL レジスタ値
+ *  戻り値
+ *    A レジスタ値
+ ***********************************************/
+static int bdos_call_a_b_de_hl(uint8_t num, uint8_t a, uint8_t b, uintptr_t de, uintptr_t hl)
+{
+#ifdef TNC_HOST
+    return bdos_call_host(num, a, b, de, hl, 0);
+#else
+#asm
+    LD      IX, 2
+    ADD     IX, SP
+    LD      L, (IX + 0)
+    LD      H, (IX + 1)
+    LD      E, (IX + 2)
+    LD      D, (IX + 3)
+    LD      B, (IX + 4)
+    LD      A, (IX + 6)
+    LD      C, (IX + 8)
+    jp      __bdos_call
+#endasm
+#endif
 }
 
 /***********************************************
@@ -213,8 +301,11 @@ static int bdos_call_a_b_de(uint8_t num, uint8_t a, uint8_t b, uint16_t de)
  *  戻り値
  *    A レジスタ値
  ***********************************************/
-static int bdos_call_b_de_hl_ix(uint8_t num, uint8_t b, uint16_t de, uint16_t hl, uint16_t ix)
+static int bdos_call_b_de_hl_ix(uint8_t num, uint8_t b, uintptr_t de, uintptr_t hl, uintptr_t ix)
 {
+#ifdef TNC_HOST
+    return bdos_call_host(num, 0, b, de, hl, ix);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -230,6 +321,7 @@ static int bdos_call_b_de_hl_ix(uint8_t num, uint8_t b, uint16_t de, uint16_t hl
     POP     IX
     jp      __bdos_call
 #endasm
+#endif
 }
 
 static void make_fcb(BDOS_FILE_t *file, char *path)
@@ -284,7 +376,7 @@ int bdos_fopen(BDOS_FILE_t *file, char *path)
         make_fcb(file, path);
 
         // ファイルオープン
-        res = bdos_call_de(BDOS_FOPEN, (uint16_t)&file->dos1);
+        res = bdos_call_de(BDOS_FOPEN, (uintptr_t)&file->dos1);
         if(res) return res;
 
         //
@@ -296,11 +388,11 @@ int bdos_fopen(BDOS_FILE_t *file, char *path)
     else
     {
         // ファイルサイズを得る
-        if(0 != (res = bdos_call_b_de_hl_ix(BDOS_FFIRST, 0, (uint16_t)path, (uint16_t)path, (uint16_t)file->dos2.buffer))) return res;
+        if(0 != (res = bdos_call_b_de_hl_ix(BDOS_FFIRST, 0, (uintptr_t)path, (uintptr_t)path, (uintptr_t)file->dos2.buffer))) return res;
         file->dos2.file_size = *(uint32_t*)(bdos_ix + 21);
 
         // ファイルオープン
-        if(0 != (res = bdos_call_a_de(BDOS_OPEN, BDOS_OPEN_RDONLY, (uint16_t)path))) return res;
+        if(0 != (res = bdos_call_a_de(BDOS_OPEN, BDOS_OPEN_RDONLY, (uintptr_t)path))) return res;
         file->dos2.handle = bdos_b;
         return 0;
     }
@@ -329,14 +421,14 @@ int bdos_fcreate(BDOS_FILE_t *file, char *path)
         make_fcb(file, path);
 
         // ファイルオープン
-        return bdos_call_de(BDOS_FMAKE, (uint16_t)&file->dos1);
+        return bdos_call_de(BDOS_FMAKE, (uintptr_t)&file->dos1);
     }
     else
     {
         file->dos2.file_size = 0;
 
         // ファイルオープン
-        if(0 != (res = bdos_call_a_b_de(BDOS_CREATE, BDOS_OPEN_WRONLY, 0x80, (uint16_t)path))) return res;
+        if(0 != (res = bdos_call_a_b_de(BDOS_CREATE, BDOS_OPEN_WRONLY, 0x80, (uintptr_t)path))) return res;
         file->dos2.handle = bdos_b;
         return 0;
     }
@@ -355,7 +447,7 @@ int bdos_fclose(BDOS_FILE_t *file)
     if(file->type == TYPE_DOS1)
     {
         // ファイルクローズ
-        return bdos_call_de(BDOS_FCLOSE, (uint16_t)&file->dos1);
+        return bdos_call_de(BDOS_FCLOSE, (uintptr_t)&file->dos1);
     }
     else
     {
@@ -401,6 +493,48 @@ int bdos_eof(BDOS_FILE_t *file)
     return file->current_pos >= size ? 1 : 0;
 }
 
+/***********************************************
+ * FCB のシーケンシャルアクセス位置設定
+ *  引数
+ *    file      : 対象のファイル構造体
+ *    pos       : ファイル先頭からの位置(128 バイト単位)
+ ***********************************************/
+static void set_fcb_position(BDOS_FILE_t *file, uint32_t pos)
+{
+    // カレントブロック(128 レコード単位)とカレントレコード
+    uint32_t record = pos >> 7;
+    file->dos1.current_block = (uint8_t)(record >> 7);
+    file->dos1.reserved_13 = (uint8_t)(record >> 15);
+    file->dos1.reserved_32 = (uint8_t)(record & 0x7F);
+}
+
+/***********************************************
+ * 読み出し位置の変更
+ *  MSX-DOS1 では 128 バイト単位の位置のみ指定できる
+ *  引数
+ *    file      : 対象のファイル構造体
+ *    pos       : ファイル先頭からの位置
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int bdos_fseek(BDOS_FILE_t *file, uint32_t pos)
+{
+    int res;
+    if(file->type == TYPE_DOS1)
+    {
+        set_fcb_position(file, pos);
+    }
+    else
+    {
+        // ファイルポインタ移動(先頭から)
+        if(0 != (res = bdos_call_a_b_de_hl(BDOS_SEEK, 0, file->dos2.handle, (uint16_t)(pos >> 16), (uint16_t)pos))) return res;
+    }
+
+    file->current_pos = pos;
+    return 0;
+}
+
 /***********************************************
  * シーケンシャルリード
  *  引数
@@ -423,11 +557,11 @@ int bdos_fread(BDOS_FILE_t *file, uint16_t *readed)
     if(file->type == TYPE_DOS1)
     {
         // DTA アドレス設定
-        if(0 != (res = bdos_call_de(BDOS_SETDTA, (uint16_t)file->buffer))) return res;
+        if(0 != (res = bdos_call_de(BDOS_SETDTA, (uintptr_t)file->buffer))) return res;
 
 
         // 128バイトシーケンシャルリード
-        if(0 != (res = bdos_call_de(BDOS_RDSEQ, (uint16_t)&file->dos1))) return res;
+        if(0 != (res = bdos_call_de(BDOS_RDSEQ, (uintptr_t)&file->dos1))) return res;
 
         //
         readed_size = 128;
@@ -435,7 +569,7 @@ int bdos_fread(BDOS_FILE_t *file, uint16_t *readed)
     else
     {
         // 128バイトリード
-        if(0 != (res = bdos_call_b_de_hl(BDOS_READ, file->dos2.handle, (uint16_t)file->buffer, 128))) return res;
+        if(0 != (res = bdos_call_b_de_hl(BDOS_READ, file->dos2.handle, (uintptr_t)file->buffer, 128))) return res;
 
         //
         readed_size = bdos_hl;
@@ -460,7 +594,7 @@ int bdos_fread(BDOS_FILE_t *file, uint16_t *readed)
  *    0  : 成功
  *    !0 : 失敗
  ***********************************************/
-int bdos_fread_n(BDOS_FILE_t *file, uint16_t addr, uint16_t size, uint16_t *readed)
+int bdos_fread_n(BDOS_FILE_t *file, uintptr_t addr, uint16_t size, uint16_t *readed)
 {
     uint32_t remain = (file->type == TYPE_DOS1 ? file->dos1.file_size : file->dos2.file_size) - file->current_pos;
     if(remain == 0)
@@ -474,14 +608,20 @@ int bdos_fread_n(BDOS_FILE_t *file, uint16_t addr, uint16_t size, uint16_t *read
     if(file->type == TYPE_DOS1)
     {
         // DTA アドレス設定
-        if(0 != (res = bdos_call_de(BDOS_SETDTA, (uint16_t)file->buffer))) return res;
+        if(0 != (res = bdos_call_de(BDOS_SETDTA, addr))) return res;
 
+        // レコードサイズ 1 のランダムブロックリードで size バイト読み出す
+        file->dos1.record_size = 1;
+        file->dos1.random_record = file->current_pos;
+        res = bdos_call_b_de_hl(BDOS_RDBLK, 0, (uintptr_t)&file->dos1, size);
+        readed_size = bdos_hl;
 
-        // 128バイトシーケンシャルリード
-        if(0 != (res = bdos_call_de(BDOS_RDSEQ, (uint16_t)&file->dos1))) return res;
+        // bdos_fread() 用に 128 バイトレコードに戻す
+        file->dos1.record_size = 128;
+        set_fcb_position(file, file->current_pos + (uint32_t)readed_size);
 
-        //
-        readed_size = 128;
+        // ファイル終端で size に満たない場合もエラーになる
+        if(res != 0 && readed_size == 0) return res;
     }
     else
     {
@@ -517,11 +657,11 @@ int bdos_fwrite(BDOS_FILE_t *file, uint16_t *written)
     if(file->type == TYPE_DOS1)
     {
         // DTA アドレス設定
-        if(0 != (res = bdos_call_de(BDOS_SETDTA, (uint16_t)file->buffer))) return res;
+        if(0 != (res = bdos_call_de(BDOS_SETDTA, (uintptr_t)file->buffer))) return res;
 
 
         // 128バイトシーケンシャルライト
-        if(0 != (res = bdos_call_de(BDOS_WRSEQ, (uint16_t)&file->dos1))) return res;
+        if(0 != (res = bdos_call_de(BDOS_WRSEQ, (uintptr_t)&file->dos1))) return res;
 
         //
         write_size = 128;
@@ -529,7 +669,7 @@ int bdos_fwrite(BDOS_FILE_t *file, uint16_t *written)
     else
     {
         // 128バイトライト
-        if(0 != (res = bdos_call_b_de_hl(BDOS_WRITE, file->dos2.handle, (uint16_t)file->buffer, 128))) return res;
+        if(0 != (res = bdos_call_b_de_hl(BDOS_WRITE, file->dos2.handle, (uintptr_t)file->buffer, 128))) return res;
 
         //
         write_size = bdos_hl;
@@ -557,7 +697,7 @@ int bdos_fwrite(BDOS_FILE_t *file, uint16_t *written)
  *    0  : 終端ではない
  *    !0 : ファイルの終端
  ***********************************************/
-int bdos_set_about_handler(uint16_t addr)
+int bdos_set_about_handler(uintptr_t addr)
 {
     return bdos_call_de(BDOS_DEFAB, addr);
 }
@@ -574,3 +714,63 @@ int bdos_term(uint8_t code)
 {
     return bdos_call_b(BDOS_TERM, code);
 }
+
+/***********************************************
+ * 環境変数取得(MSX-DOS2 のみ)
+ *  引数
+ *    name          : 環境変数名
+ *    buf           : 値を格納するバッファ
+ *    size          : バッファのサイズ
+ *  戻り値
+ *    0  : 成功(未定義の時は空文字列)
+ *    !0 : 失敗
+ ***********************************************/
+int bdos_getenv(char *name, char *buf, uint8_t size)
+{
+    int res;
+    res = bdos_call_de(BDOS_DOSVER, 0);
+    if(res != 0 || bdos_b < 2) return -1;
+
+    return bdos_call_b_de_hl(BDOS_GENV, size, (uintptr_t)buf, (uintptr_t)name);
+}
+
+/***********************************************
+ * 環境変数設定(MSX-DOS2 のみ)
+ *  引数
+ *    name          : 環境変数名
+ *    value         : 設定する値
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int bdos_setenv(char *name, char *value)
+{
+    int res;
+    res = bdos_call_de(BDOS_DOSVER, 0);
+    if(res != 0 || bdos_b < 2) return -1;
+
+    return bdos_call_b_de_hl(BDOS_SENV, 0, (uintptr_t)value, (uintptr_t)name);
+}
+
+/***********************************************
+ * 1行入力
+ *  引数
+ *    buf           : 入力した文字列を格納するバッファ
+ *    size          : バッファのサイズ(3 以上, 入力できるのは size-3 文字)
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int bdos_gets(char *buf, uint8_t size)
+{
+    uint8_t len;
+    if(size < 3) return -1;
+
+    // +0 最大文字数, +1 入力した文字数, +2~ 文字列と CR
+    buf[0] = size - 3;
+    bdos_call_de(BDOS_BUFIN, (uintptr_t)buf);
+    len = buf[1];
+    memmove(buf, buf + 2, len);
+    buf[len] = '\0';
+    return 0;
+}
@@ -97,10 +97,14 @@ int bdos_fcreate(BDOS_FILE_t *file, char *path);
 int bdos_fclose(BDOS_FILE_t *file);
 int bdos_file_size(BDOS_FILE_t *file, uint32_t *size);
 int bdos_eof(BDOS_FILE_t *file);
+int bdos_fseek(BDOS_FILE_t *file, uint32_t pos);
 int bdos_fread(BDOS_FILE_t *file, uint16_t *readed);
-int bdos_fread_n(BDOS_FILE_t *file, uint16_t addr, uint16_t size, uint16_t *readed);
+int bdos_fread_n(BDOS_FILE_t *file, uintptr_t addr, uint16_t size, uint16_t *readed);
 int bdos_fwrite(BDOS_FILE_t *file, uint16_t *written);
-int bdos_set_about_handler(uint16_t addr);
+int bdos_set_about_handler(uintptr_t addr);
 int bdos_term(uint8_t code);
+int bdos_getenv(char *name, char *buf, uint8_t size);
+int bdos_setenv(char *name, char *value);
+int bdos_gets(char *buf, uint8_t size);
 
 #endif
@@ -0,0 +1,180 @@
+//
+// crc32.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include "types.h"
+#include "host.h"
+#include "crc32.h"
+
+//
+// CRC32 テーブル
+//  1KB のテーブルを 4 バイトの各桁毎の 256 バイトに分けて、256 バイト境界に連続して配置する
+//  (テーブル + 000h : bit7~0, +100h : bit15~8, +200h : bit23~16, +300h : bit31~24)
+//  下位アドレスをインデックス、上位アドレスを桁にすると 1 バイト毎の計算でアドレス計算が不要になる
+//
+static uint8_t crc32_table_buffer[256 * 5];
+static uint8_t crc32_table_page = 0;
+
+#define CRC32_TABLE ((uint8_t*)(((uintptr_t)crc32_table_buffer + 255) & ~(uintptr_t)0xFF))
+
+/***********************************************
+ * CRC32 テーブル作成
+ *  crc32_update() を使う前に一度呼び出す
+ ***********************************************/
+void crc32_init_table(void)
+{
+    uint8_t *table = CRC32_TABLE;
+    crc32_table_page = (uint8_t)((uintptr_t)table >> 8);
+
+    for(uint16_t i = 0; i < 256; i++)
+    {
+        uint32_t c = (uint32_t)i;
+        for(uint8_t bit = 0; bit < 8; bit++)
+        {
+            c = (c & 1) ? ((c >> 1) ^ (uint32_t)0xEDB88320) : (c >> 1);
+        }
+        table[i + 0x000] = (uint8_t)c;
+        table[i + 0x100] = (uint8_t)(c >> 8);
+        table[i + 0x200] = (uint8_t)(c >> 16);
+        table[i + 0x300] = (uint8_t)(c >> 24);
+    }
+}
+
+/***********************************************
+ * CRC32 計算
+ *  転送中のバッファを順に渡して計算を続ける
+ *  1 バイトあたり約 120 クロック
+ *  引数
+ *    crc       : 計算途中の CRC32 (初回は CRC32_INITIAL)
+ *    buf       : データ
+ *    size      : データのサイズ
+ ***********************************************/
+void crc32_update(uint32_t *crc, const uint8_t *buf, uint16_t size)
+{
+#ifdef TNC_HOST
+    const uint8_t *table = CRC32_TABLE;
+    uint32_t c = *crc;
+
+    host_cycles(HOST_T_CRC32 * size);
+
+    // 1 バイト毎に crc = table[(crc ^ data) & FFh] ^ (crc >> 8)
+    while(size-- > 0)
+    {
+        uint8_t i = (uint8_t)c ^ *buf++;
+        c = (c >> 8) ^ ((uint32_t)table[i + 0x000]
+                     | ((uint32_t)table[i + 0x100] << 8)
+                     | ((uint32_t)table[i + 0x200] << 16)
+                     | ((uint32_t)table[i + 0x300] << 24));
+    }
+    *crc = c;
+#else
+#asm
+    LD      IX, 2
+    ADD     IX, SP
+
+    ; サイズ 0 なら何もしない
+    LD      E, (IX + 0)     ;size
+    LD      D, (IX + 1)
+    LD      A, D
+    OR      E
+    RET     Z
+
+    ; DJNZ 用のループ回数 (B = 下位, C = 上位)
+    LD      B, E
+    DEC     DE
+    INC     D
+    LD      C, D
+
+    LD      L, (IX + 2)     ;buf
+    LD      H, (IX + 3)
+
+    ; 裏レジスタに CRC とテーブルを用意
+    ;   E = bit7~0, D = bit15~8, C = bit23~16, B = bit31~24
+    ;   H = テーブルの上位アドレス, L = インデックス
+    EXX
+    LD      L, (IX + 4)     ;crc
+    LD      H, (IX + 5)
+    LD      E, (HL)
+    INC     HL
+    LD      D, (HL)
+    INC     HL
+    LD      C, (HL)
+    INC     HL
+    LD      B, (HL)
+    LD      A, (_crc32_table_page)
+    LD      H, A
+    EXX
+
+    ; 1 バイト毎に crc = table[(crc ^ data) & FFh] ^ (crc >> 8)
+__crc32_loop:
+    LD      A, (HL)
+    INC     HL
+    EXX
+    XOR     E
+    LD      L, A
+    LD      A, (HL)         ;bit7~0
+    XOR     D
+    LD      E, A
+    INC     H
+    LD      A, (HL)         ;bit15~8
+    XOR     C
+    LD      D, A
+    INC     H
+    LD      A, (HL)         ;bit23~16
+    XOR     B
+    LD      C, A
+    INC     H
+    LD      B, (HL)         ;bit31~24
+    DEC     H
+    DEC     H
+    DEC     H
+    EXX
+    DJNZ    __crc32_loop
+    DEC     C
+    JR      NZ, __crc32_loop
+
+    ; 結果を書き戻す
+    EXX
+    LD      L, (IX + 4)     ;crc
+    LD      H, (IX + 5)
+    LD      (HL), E
+    INC     HL
+    LD      (HL), D
+    INC     HL
+    LD      (HL), C
+    INC     HL
+    LD      (HL), B
+    EXX
+#endasm
+#endif
+}
@@ -0,0 +1,94 @@
+//
+// host.h
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef _INCLUDE_HOST_H_
+#define _INCLUDE_HOST_H_
+
+#include "types.h"
+
+//
+// ホストビルド
+//  TNC_HOST を定義して Linux 等の C コンパイラでビルドすると、#asm のルーチンの代わりに
+//  C の実装を使い、BDOS コールとスロットアクセスは下記の関数(シミュレータ)を呼び出す
+//  (tools/tncrom/host/tncsim.c が BDOS と tnCart のレジスタを模擬する)
+//
+
+//
+// MSX のメモリ
+//  システムワーク(EXPTBL, JIFFY 等)や固定アドレスのバッファのアクセスに使う
+//
+#ifdef TNC_HOST
+extern uint8_t host_memory[0x10000];
+#define MSX_MEM(addr)       (&host_memory[(uint16_t)(addr)])
+#else
+#define MSX_MEM(addr)       ((uint8_t*)(addr))
+#endif
+
+#ifdef TNC_HOST
+//
+// BDOS コールのレジスタ
+//  ポインタを渡すので DE, HL, IX はホストのポインタの幅
+//
+typedef struct {
+    uint8_t     a;
+    uint8_t     b;
+    uint8_t     c;
+    uintptr_t   de;
+    uintptr_t   hl;
+    uintptr_t   ix;
+} HOST_REGS_t;
+
+void host_bdos(HOST_REGS_t *regs);                          // BDOS コール(0005h)
+uint8_t host_rdslt(uint8_t sltnum, uint16_t addr);          // BIOS RDSLT(000Ch)
+void host_wrslt(uint8_t sltnum, uint16_t addr, uint8_t data);   // BIOS WRSLT(0014h)
+void host_enaslt(uint8_t sltnum, uint16_t addr);            // BIOS ENASLT(0024h)
+void host_get_slot(uint8_t *slot);                          // ページ0~3 のスロット番号
+void host_set_slot(const uint8_t *slot);                    // A8h と拡張スロットレジスタを直接切り替え
+uint8_t host_read(uint16_t addr);                           // 現在のスロット構成で読み出し
+void host_write(uint16_t addr, uint8_t data);               // 現在のスロット構成で書き込み
+void host_reboot(void);                                     // リセット
+
+//
+// 処理時間の見積もり
+//  C の実装に置き換えた #asm のルーチンは、実機で掛かる T ステート数(M1 ウェイト込み)を
+//  命令表から数えた値で host_cycles() に渡す。実測値ではない
+//
+#define HOST_T_LDIR         23      // LDIR 1 バイト
+#define HOST_T_LZ4_TOKEN    385     // xfer_lz4() のトークン 1 つ(LDIR と長さの追加バイトを除く)
+#define HOST_T_LZ4_LENGTH   80      // xfer_lz4() の長さの追加バイト 1 つ
+#define HOST_T_CRC32        120     // crc32_update() 1 バイト
+
+void host_cycles(uint32_t t);                               // 処理時間の加算
+#endif
+
+#endif
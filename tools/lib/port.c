@@ -0,0 +1,71 @@
+//
+// port.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include "..\..\lib\types.h"
+#include "port.h"
+
+/***********************************************
+ * I/O ポートへ書き込み
+ *  引数
+ *    port      : ポート番号
+ *    data      : 書き込むデータ
+ ***********************************************/
+void port_write(uint8_t port, uint8_t data)
+{
+#asm
+    LD      IX, 2
+    ADD     IX, SP
+    LD      A, (IX+0)   ;data
+    LD      C, (IX+2)   ;port
+    OUT     (C), A
+#endasm
+}
+
+/***********************************************
+ * I/O ポートから読み出し
+ *  引数
+ *    port      : ポート番号
+ *  戻り値
+ *    読みだしたデータ
+ ***********************************************/
+uint8_t port_read(uint8_t port)
+{
+#asm
+    LD      IX, 2
+    ADD     IX, SP
+    LD      C, (IX+0)   ;port
+    IN      A, (C)
+    LD      H, 0
+    LD      L, A
+#endasm
+}
@@ -32,11 +32,15 @@
 //
 
 #include <string.h>
-#include "..\..\lib\types.h"
-#include "..\..\lib\rom_tools.h"
+#include "../../lib/types.h"
+#include "../../lib/host.h"
+#include "../../lib/rom_tools.h"
 
 static void reboot_2(void)
 {
+#ifdef TNC_HOST
+    host_reboot();
+#else
 #asm
     XOR     A
     OUT     (0F5h), A
@@ -45,10 +49,14 @@ static void reboot_2(void)
     LD      IX, 0000h
     CALL    001Ch
 #endasm
+#endif
 }
 
 static void reboot_2p(void)
 {
+#ifdef TNC_HOST
+    host_reboot();
+#else
 #asm
     LD      IY, (0FCC1h - 1)
     LD      IX, 017Ah
@@ -64,11 +72,12 @@ static void reboot_2p(void)
     LD      IX, 0000h
     CALL    001Ch
 #endasm
+#endif
 }
 
 void reboot(void)
 {
-    if(rdslt(*(uint8_t*)0xFCC1, 0x002D) >= 2)
+    if(rdslt(*MSX_MEM(0xFCC1), 0x002D) >= 2)
     {
         reboot_2p();
     }
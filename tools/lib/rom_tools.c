@@ -32,18 +32,35 @@
 //
 
 #include <string.h>
-#include "..\..\lib\types.h"
+#include "../../lib/types.h"
+#include "../../lib/host.h"
 //#include "rom_table.h"
 #include "rom_tools.h"
 
-#define RAMAD1      (*(uint8_t*)0xF342)
-#define RAMAD2      (*(uint8_t*)0xF343)
+#define RAMAD1      (*MSX_MEM(0xF342))
+#define RAMAD2      (*MSX_MEM(0xF343))
+
+//
+// スロット一括書き込み
+//  ページ0/1 をカートリッジに切り替えて直接書き込むので、ルーチンと
+//  書き込みリストはページ2(8000h~, プログラムの後ろの空き TPA)に置く
+//
+#define SLOT_WRITE_CODE     MSX_MEM(0x8000)     // ルーチンのコピー先
+#define SLOT_WRITE_LIST     MSX_MEM(0x8080)     // 書き込みリスト
+#define SLOT_WRITE_LIST_SIZE (256)
+
+static int slot_write_ready = 0;                // ルーチンをコピー済みか
+static uint8_t slot_write_sltnum;               // 書き込み先スロット番号
+static uint8_t *slot_write_ptr = SLOT_WRITE_LIST;   // 書き込みリストの末尾
 
 /***********************************************
  * Page1スロット切り替え
  ***********************************************/
 void slot_select_p1(uint8_t sltnum)
 {
+#ifdef TNC_HOST
+    host_enaslt(sltnum, 0x4000);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -51,6 +68,7 @@ void slot_select_p1(uint8_t sltnum)
     LD      HL, 4000h
     CALL    0024h
 #endasm
+#endif
 }
 
 /***********************************************
@@ -58,6 +76,9 @@ void slot_select_p1(uint8_t sltnum)
  ***********************************************/
 void slot_select_p2(uint8_t sltnum)
 {
+#ifdef TNC_HOST
+    host_enaslt(sltnum, 0x8000);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -65,6 +86,7 @@ void slot_select_p2(uint8_t sltnum)
     LD      HL, 8000h
     CALL    0024h
 #endasm
+#endif
 }
 
 /***********************************************
@@ -76,6 +98,9 @@ void slot_select_p2(uint8_t sltnum)
  ***********************************************/
 void wrtslt(uint8_t sltnum, uint16_t addr, uint8_t data)
 {
+#ifdef TNC_HOST
+    host_wrslt(sltnum, addr, data);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -85,6 +110,7 @@ void wrtslt(uint8_t sltnum, uint16_t addr, uint8_t data)
     LD      A, (IX+4)   ;sltnum
     CALL    0014h
 #endasm
+#endif
 }
 
 /***********************************************
@@ -97,6 +123,9 @@ void wrtslt(uint8_t sltnum, uint16_t addr, uint8_t data)
  ***********************************************/
 uint8_t rdslt(uint8_t sltnum, uint16_t addr)
 {
+#ifdef TNC_HOST
+    return host_rdslt(sltnum, addr);
+#else
 #asm
     LD      IX, 2
     ADD     IX, SP
@@ -107,24 +136,242 @@ uint8_t rdslt(uint8_t sltnum, uint16_t addr)
     LD      H, 0
     LD      L, A
 #endasm
+#endif
+}
+
+/***********************************************
+ * スロット一括書き込みルーチン
+ *  ページ2 にコピーして DI で呼び出す(位置に依存しないこと)
+ *  ページ0/1 をカートリッジに切り替えて書き込みリストの内容を LDIR で書き込み、
+ *  A8h と拡張スロットレジスタを元に戻す
+ *  入力
+ *    A  : スロット番号
+ *    HL : 書き込みリスト(ページ2/3)
+ *          +0 サイズ(0 で終了), +1 アドレス下位, +2 アドレス上位, +3~ データ
+ ***********************************************/
+#ifndef TNC_HOST
+static void slot_write_code(void)
+{
+#asm
+slot_write_code_start:
+    EXX                     ; 裏レジスタ HL = 書き込みリスト
+    LD      C, A            ; C = スロット番号
+    IN      A, (0A8h)
+    LD      B, A            ; B = 元の A8h
+    LD      A, C
+    AND     03h
+    LD      D, A
+    RLCA
+    RLCA
+    OR      D
+    LD      D, A            ; D = ページ0/1 の基本スロット
+    BIT     7, C
+    JR      Z, slot_write_primary
+
+    ; 拡張スロットレジスタはページ3 を基本スロットに切り替えて書く
+    ; (ページ3 のスタックは使えない)
+    RRCA
+    RRCA
+    AND     0C0h
+    LD      L, A
+    LD      A, B
+    AND     3Fh
+    OR      L
+    LD      L, A            ; L = ページ3 を切り替えた A8h
+    OUT     (0A8h), A
+    LD      A, (0FFFFh)
+    CPL
+    LD      E, A            ; E = 元の拡張スロットレジスタ
+    AND     0F0h
+    LD      H, A
+    LD      A, C
+    AND     0Ch
+    OR      H
+    LD      H, A
+    LD      A, C
+    AND     0Ch
+    RRCA
+    RRCA
+    OR      H
+    LD      (0FFFFh), A     ; ページ0/1 の拡張スロットを切り替え
+
+slot_write_primary:
+    LD      A, B
+    AND     0F0h
+    OR      D
+    OUT     (0A8h), A       ; ページ0/1 を切り替え
+    EXX
+
+slot_write_loop:
+    LD      A, (HL)
+    OR      A
+    JR      Z, slot_write_restore
+    INC     HL
+    LD      C, A
+    LD      B, 0
+    LD      E, (HL)
+    INC     HL
+    LD      D, (HL)
+    INC     HL
+    LDIR
+    JR      slot_write_loop
+
+slot_write_restore:
+    EXX
+    BIT     7, C
+    JR      Z, slot_write_restore_primary
+    LD      A, L
+    OUT     (0A8h), A
+    LD      A, E
+    LD      (0FFFFh), A
+
+slot_write_restore_primary:
+    LD      A, B
+    OUT     (0A8h), A
+    RET
+slot_write_code_end:
+#endasm
+}
+#endif
+
+/***********************************************
+ * スロット一括書き込みルーチンをページ2 にコピー
+ *  コピー先は SLOT_WRITE_CODE
+ ***********************************************/
+static void slot_write_init(void)
+{
+#ifdef TNC_HOST
+    // コピーは不要
+#else
+#asm
+    LD      HL, slot_write_code_start
+    LD      DE, 8000h
+    LD      BC, slot_write_code_end - slot_write_code_start
+    LDIR
+#endasm
+#endif
+}
+
+/***********************************************
+ * スロット一括書き込み実行
+ *  引数
+ *    sltnum    : スロット番号
+ ***********************************************/
+static void slot_write_exec(uint8_t sltnum)
+{
+#ifdef TNC_HOST
+    uint8_t save[4];
+    uint8_t slot[4];
+
+    // ページ0/1 をカートリッジに切り替えて書き込みリストの内容を書き込む
+    host_get_slot(save);
+    memcpy(slot, save, sizeof(slot));
+    slot[0] = slot[1] = sltnum;
+    host_set_slot(slot);
+    for(uint8_t *p = SLOT_WRITE_LIST; *p != 0; p += 3 + *p)
+    {
+        uint16_t addr = p[1] | ((uint16_t)p[2] << 8);
+        for(uint8_t i = 0; i < *p; i++) host_write(addr + i, p[3 + i]);
+    }
+    host_set_slot(save);
+#else
+#asm
+    LD      IX, 2
+    ADD     IX, SP
+    LD      A, (IX + 0)     ; sltnum
+    LD      HL, 8080h       ; SLOT_WRITE_LIST
+    DI
+    CALL    8000h           ; SLOT_WRITE_CODE
+    EI
+#endasm
+#endif
+}
+
+/***********************************************
+ * スロット一括書き込み開始
+ *  slot_write()/slot_write_byte() で書き込みリストに溜めて、
+ *  slot_write_end() でまとめて書き込む
+ *  (ページ0/1 のアドレスのみ, 書き込み順は登録順)
+ *  引数
+ *    sltnum    : スロット番号
+ ***********************************************/
+void slot_write_begin(uint8_t sltnum)
+{
+    if(!slot_write_ready)
+    {
+        slot_write_init();
+        slot_write_ready = 1;
+    }
+    slot_write_sltnum = sltnum;
+    slot_write_ptr = SLOT_WRITE_LIST;
+}
+
+/***********************************************
+ * スロット一括書き込み終了
+ *  書き込みリストの内容を書き込む
+ ***********************************************/
+void slot_write_end(void)
+{
+    if(slot_write_ptr == SLOT_WRITE_LIST) return;
+    *slot_write_ptr = 0;
+    slot_write_exec(slot_write_sltnum);
+    slot_write_ptr = SLOT_WRITE_LIST;
+}
+
+/***********************************************
+ * 書き込みリストに追加
+ *  リストが一杯なら先に書き込む
+ *  引数
+ *    addr      : 書き込むアドレス(0000h~7FFFh)
+ *    data      : 書き込むデータ
+ *    size      : 書き込むサイズ(1~252)
+ ***********************************************/
+void slot_write(uint16_t addr, const uint8_t *data, uint8_t size)
+{
+    if(slot_write_ptr + 3 + size + 1 > SLOT_WRITE_LIST + SLOT_WRITE_LIST_SIZE) slot_write_end();
+
+    *slot_write_ptr++ = size;
+    *slot_write_ptr++ = (uint8_t)addr;
+    *slot_write_ptr++ = (uint8_t)(addr >> 8);
+    memcpy(slot_write_ptr, data, size);
+    slot_write_ptr += size;
+}
+
+void slot_write_byte(uint16_t addr, uint8_t data)
+{
+    slot_write(addr, &data, 1);
 }
 
 /***********************************************
  * BANK#0 切り替え
+ *  上位バイトは 6800h (ASCII16 の属性では無視される)
  ***********************************************/
-void set_bank0_reg(uint8_t sltnum, uint8_t num)
+void set_bank0_reg(uint8_t sltnum, uint16_t num)
 {
-    wrtslt(sltnum, 0x6000, num);
+    slot_write_begin(sltnum);
+    slot_write_byte(0x6000, (uint8_t)num);
+    slot_write_byte(0x6800, (uint8_t)(num >> 8));
+    slot_write_end();
 }
 
 /***********************************************
  * BANK#1 切り替え
+ *  上位バイトは 7800h (ASCII16 の属性では無視される)
  ***********************************************/
-void set_bank1_reg(uint8_t sltnum, uint8_t num)
+void set_bank1_reg(uint8_t sltnum, uint16_t num)
 {
-    wrtslt(sltnum, 0x7000, num);
+    slot_write_begin(sltnum);
+    slot_write_byte(0x7000, (uint8_t)num);
+    slot_write_byte(0x7800, (uint8_t)(num >> 8));
+    slot_write_end();
 }
 
+//
+// コンフィグレーションレジスタのキー
+//
+static const uint8_t megarom_configure_key[4] = { 0xAB, 0xCD, 0x98, 0x76 };
+static const uint8_t megarom_configure_lock[4] = { 0x00, 0x00, 0x00, 0x00 };
+
 /***********************************************
  * コンフィグレーションレジスタのロック解除
  *  引数
@@ -132,10 +379,9 @@ void set_bank1_reg(uint8_t sltnum, uint8_t num)
  ***********************************************/
 void unlock_megarom_configure(uint8_t sltnum)
 {
-    wrtslt(sltnum, 0x0000, 0xAB);    
-    wrtslt(sltnum, 0x0001, 0xCD);    
-    wrtslt(sltnum, 0x0002, 0x98);    
-    wrtslt(sltnum, 0x0003, 0x76);    
+    slot_write_begin(sltnum);
+    slot_write(0x0000, megarom_configure_key, sizeof(megarom_configure_key));
+    slot_write_end();
 }
 
 /***********************************************
@@ -145,28 +391,53 @@ void unlock_megarom_configure(uint8_t sltnum)
  ***********************************************/
 void lock_megarom_configure(uint8_t sltnum)
 {
-    wrtslt(sltnum, 0x0000, 0x00);    
-    wrtslt(sltnum, 0x0001, 0x00);    
-    wrtslt(sltnum, 0x0002, 0x00);    
-    wrtslt(sltnum, 0x0003, 0x00);    
+    slot_write_begin(sltnum);
+    slot_write(0x0000, megarom_configure_lock, sizeof(megarom_configure_lock));
+    slot_write_end();
 }
 
 /***********************************************
  * ROM 属性を設定
+ *  ロック解除からロックまでを 1回のスロット切り替えで書き込む
  *  引数
  *    sltnum    : スロット番号
  *    rom_attr  : ROM 属性
  ***********************************************/
 void rom_attr_xfer(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr)
 {
-    uint8_t *p = (uint8_t*)rom_attr;
+    uint8_t reg[0x0020 - 0x0008];
 
-    unlock_megarom_configure(sltnum);
-    for(uint16_t addr = 0x000C; addr < 0x0020; addr++)
-    {
-        wrtslt(sltnum, addr, *p++);
-    }    
-    lock_megarom_configure(sltnum);
+    // 0008h~000Bh
+    reg[0] = rom_attr->val_mask_h;
+    reg[1] = rom_attr->sram_mask;
+    reg[2] = (uint8_t)rom_attr->high_addr;
+    reg[3] = (uint8_t)(rom_attr->high_addr >> 8);
+
+    // 000Ch~001Fh
+    memcpy(&reg[4], rom_attr, 0x0020 - 0x000C);
+
+    slot_write_begin(sltnum);
+    slot_write(0x0000, megarom_configure_key, sizeof(megarom_configure_key));
+    slot_write_byte(0x0004, rom_attr->sram_flags);
+    slot_write_byte(0x0005, rom_attr->sram_addr_mask);
+    slot_write(0x0008, reg, sizeof(reg));
+    slot_write(0x0000, megarom_configure_lock, sizeof(megarom_configure_lock));
+    slot_write_end();
+}
+
+/***********************************************
+ * SRAM 選択ビットを設定
+ *  引数
+ *    sltnum    : スロット番号
+ *    sram_mask : SRAM 選択ビット
+ ***********************************************/
+void set_sram_mask(uint8_t sltnum, uint8_t sram_mask)
+{
+    slot_write_begin(sltnum);
+    slot_write(0x0000, megarom_configure_key, sizeof(megarom_configure_key));
+    slot_write_byte(0x0009, sram_mask);
+    slot_write(0x0000, megarom_configure_lock, sizeof(megarom_configure_lock));
+    slot_write_end();
 }
 
 /***********************************************
@@ -177,13 +448,19 @@ void rom_attr_xfer(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr)
  ***********************************************/
 void init_bank_reg(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr)
 {
+    slot_write_begin(sltnum);
     for(int i = 0; i < 4; i++)
     {
         if(rom_attr->bank[i].addr != (uint16_t)0xFFFF)
         {
-            wrtslt(sltnum, rom_attr->bank[i].addr, rom_attr->bank[i].init_val);
+            slot_write_byte(rom_attr->bank[i].addr, rom_attr->bank[i].init_val);
+            if(rom_attr->val_mask_h != 0)
+            {
+                slot_write_byte(rom_attr->bank[i].addr ^ rom_attr->high_addr, rom_attr->bank[i].init_val_h);
+            }
         }
     }
+    slot_write_end();
 }
 
 /***********************************************
@@ -193,8 +470,12 @@ void init_bank_reg(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr)
  ***********************************************/
 void clear_rom(uint8_t sltnum)
 {
-    set_bank1_reg(sltnum, 1);   wrtslt(sltnum, 0x4000, 0);  wrtslt(sltnum, 0x6000, 0);
-    set_bank1_reg(sltnum, 0);   wrtslt(sltnum, 0x4000, 0);  wrtslt(sltnum, 0x6000, 0);
+    slot_write_begin(sltnum);
+    slot_write_byte(0x7000, 1);     slot_write_byte(0x7800, 0);
+    slot_write_byte(0x4000, 0);     slot_write_byte(0x6000, 0);
+    slot_write_byte(0x7000, 0);     slot_write_byte(0x7800, 0);
+    slot_write_byte(0x4000, 0);     slot_write_byte(0x6000, 0);
+    slot_write_end();
 }
 
 /***********************************************
@@ -207,6 +488,15 @@ void clear_rom(uint8_t sltnum)
  ***********************************************/
 void xfer_memory(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size)
 {
+#ifdef TNC_HOST
+    uint8_t *s = (uint8_t*)src;
+    uint16_t d = (uint16_t)(uintptr_t)dst;
+
+    host_cycles(HOST_T_LDIR * size);
+    host_enaslt(sltnum, 0x8000);
+    while(size-- > 0) host_write(d++, *s++);
+    host_enaslt(RAMAD2, 0x8000);
+#else
 #asm
     DI
 
@@ -233,20 +523,408 @@ void xfer_memory(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size)
 
     EI
 #endasm
+#endif
 }
 
+/***********************************************
+ * メモリ読み出し
+ *  引数
+ *    sltnum    : 転送元スロット番号
+ *    dst       : 転送先ポインタ
+ *    src       : 転送元アドレス
+ *    size      : 転送サイズ
+ ***********************************************/
+void read_memory(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size)
+{
+#ifdef TNC_HOST
+    uint8_t *d = (uint8_t*)dst;
+    uint16_t s = (uint16_t)(uintptr_t)src;
+
+    host_cycles(HOST_T_LDIR * size);
+    host_enaslt(sltnum, 0x8000);
+    while(size-- > 0) *d++ = host_read(s++);
+    host_enaslt(RAMAD2, 0x8000);
+#else
+#asm
+    DI
+
+    LD      IX, 2
+    ADD     IX, SP
+
+    PUSH    IX
+    LD      A, (IX + 6)     ; sltnum
+    LD      HL, 8000h
+    CALL    0024h
+    POP     IX
+
+    LD      C, (IX + 0)     ; size
+    LD      B, (IX + 1)
+    LD      L, (IX + 2)     ; src
+    LD      H, (IX + 3)
+    LD      E, (IX + 4)     ; dst
+    LD      D, (IX + 5)
+    LDIR
+
+    LD      A, (0F343h)
+    LD      HL, 8000h
+    CALL    0024h
+
+    EI
+#endasm
+#endif
+}
 
-uint32_t get_sdram_address(uint8_t sltnum)
+#ifndef TNC_HOST
+static uint16_t lz4_end;           // xfer_lz4() の入力終端
+#endif
+
+/***********************************************
+ * LZ4 ブロックを展開しながらメモリ転送
+ *  カートリッジのページ2に直接展開するので、一致データ(過去の出力)は
+ *  カートリッジから読み出す。一致データは同じブロック内に限る
+ *  引数
+ *    sltnum    : 転送先スロット番号
+ *    dst       : 転送先アドレス(8000h~BFFFh)
+ *    src       : LZ4 ブロック
+ *    size      : LZ4 ブロックのサイズ
+ *  戻り値
+ *    展開したサイズ
+ ***********************************************/
+uint16_t xfer_lz4(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size)
+{
+#ifdef TNC_HOST
+    uint8_t *s = (uint8_t*)src;
+    uint8_t *end = s + size;
+    uint16_t d = (uint16_t)(uintptr_t)dst;
+    uint16_t len;
+
+    host_enaslt(sltnum, 0x8000);
+    for(;;)
+    {
+        // トークン
+        uint8_t token = *s++;
+        host_cycles(HOST_T_LZ4_TOKEN);
+
+        // リテラル
+        len = token >> 4;
+        if(len == 15) do { len += *s; host_cycles(HOST_T_LZ4_LENGTH); } while(*s++ == 255);
+        host_cycles(HOST_T_LDIR * len);
+        while(len-- > 0) host_write(d++, *s++);
+
+        // ブロックの終端はリテラルで終わる
+        if(s >= end) break;
+
+        // 出力済みデータからコピー
+        uint16_t offset = s[0] | ((uint16_t)s[1] << 8);
+        s += 2;
+        len = token & 0x0F;
+        if(len == 15) do { len += *s; host_cycles(HOST_T_LZ4_LENGTH); } while(*s++ == 255);
+        host_cycles(HOST_T_LDIR * (len + 4));
+        for(len += 4; len > 0; len--, d++) host_write(d, host_read(d - offset));
+    }
+    host_enaslt(RAMAD2, 0x8000);
+
+    return d - (uint16_t)(uintptr_t)dst;
+#else
+#asm
+    DI
+
+    LD      IX, 2
+    ADD     IX, SP
+
+    PUSH    IX
+    LD      A, (IX + 6)     ; sltnum
+    LD      HL, 8000h
+    CALL    0024h
+    POP     IX
+
+    LD      L, (IX + 2)     ; src
+    LD      H, (IX + 3)
+    LD      C, (IX + 0)     ; size
+    LD      B, (IX + 1)
+    PUSH    HL
+    ADD     HL, BC
+    LD      (_lz4_end), HL
+    POP     HL
+    LD      E, (IX + 4)     ; dst
+    LD      D, (IX + 5)
+
+__xfer_lz4_loop:
+    ; トークン
+    LD      A, (HL)
+    INC     HL
+    PUSH    AF
+
+    ; リテラル長(上位 4bit)
+    RRCA
+    RRCA
+    RRCA
+    RRCA
+    AND     0Fh
+    JR      Z, __xfer_lz4_match
+    LD      B, 0
+    LD      C, A
+    CP      15
+    CALL    Z, __xfer_lz4_length
+    LDIR
+
+__xfer_lz4_match:
+    ; ブロックの終端はリテラルで終わる
+    PUSH    HL
+    LD      BC, (_lz4_end)
+    OR      A
+    SBC     HL, BC
+    POP     HL
+    JR      NC, __xfer_lz4_done
+
+    ; オフセット
+    LD      C, (HL)
+    INC     HL
+    LD      B, (HL)
+    INC     HL
+
+    ; 一致長(下位 4bit + 4)
+    POP     AF
+    PUSH    BC
+    AND     0Fh
+    LD      B, 0
+    LD      C, A
+    CP      15
+    CALL    Z, __xfer_lz4_length
+    INC     BC
+    INC     BC
+    INC     BC
+    INC     BC
+
+    ; 出力済みデータからコピー(重なりがあっても LDIR は 1 バイトずつ進むので問題ない)
+    EX      (SP), HL        ; HL = オフセット, (SP) = 入力ポインタ
+    PUSH    DE
+    EX      DE, HL
+    OR      A
+    SBC     HL, DE          ; HL = 出力ポインタ - オフセット
+    POP     DE
+    LDIR
+    POP     HL
+    JR      __xfer_lz4_loop
+
+    ; 長さの追加バイト(255 の間続く)
+__xfer_lz4_length:
+    LD      A, (HL)
+    INC     HL
+    PUSH    AF
+    ADD     A, C
+    LD      C, A
+    JR      NC, __xfer_lz4_length_nc
+    INC     B
+__xfer_lz4_length_nc:
+    POP     AF
+    INC     A
+    JR      Z, __xfer_lz4_length
+    RET
+
+__xfer_lz4_done:
+    POP     AF
+
+    ; 展開したサイズ
+    LD      L, (IX + 4)     ; dst
+    LD      H, (IX + 5)
+    EX      DE, HL
+    OR      A
+    SBC     HL, DE
+    PUSH    HL
+
+    LD      A, (0F343h)
+    LD      HL, 8000h
+    CALL    0024h
+
+    POP     HL
+    EI
+#endasm
+#endif
+}
+
+/***********************************************
+ * ROM イメージの CRC32 をカートリッジで計算
+ *  メガロム領域の先頭から size バイトの CRC32 を
+ *  転送レジスタの "@CR\r" コマンドで計算する
+ *  引数
+ *    sltnum    : スロット番号
+ *    size      : サイズ
+ *    crc       : CRC32 の格納先
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗(CRC32 に対応していない)
+ ***********************************************/
+int calc_rom_crc32(uint8_t sltnum, uint32_t size, uint32_t *crc)
 {
+    char *cmd = "@CR\r";
+    uint8_t reg[3];
+    CARTRIDGE_ID_t id;
+
+    // 識別レジスタの機能フラグで CRC32 を計算できるか確認する
+    if(read_cartridge_id(sltnum, &id) != 0 || (id.features & FEATURE_CRC32) == 0) return -1;
+
+    // RAM アドレス(メガロム領域の先頭 003Ch~003Dh)とサイズ
     unlock_megarom_configure(sltnum);
+    reg[0] = 0x00;
+    reg[1] = rdslt(sltnum, 0x003C);
+    reg[2] = rdslt(sltnum, 0x003D);
+    slot_write_begin(sltnum);
+    slot_write(0x0020, reg, sizeof(reg));
+    reg[0] = (uint8_t)size;
+    reg[1] = (uint8_t)(size >> 8);
+    reg[2] = (uint8_t)(size >> 16);
+    slot_write(0x0026, reg, sizeof(reg));
+
+    // コマンドは同じアドレスに 1バイトずつ書く
+    while(*cmd != '\0') slot_write_byte(0x003F, *cmd++);
+    slot_write_end();
 
-    uint32_t addr =
-         (uint32_t)rdslt(sltnum, 0x0008)        |
-        ((uint32_t)rdslt(sltnum, 0x0009) <<  8) |
-        ((uint32_t)rdslt(sltnum, 0x000A) << 16) |
-        ((uint32_t)rdslt(sltnum, 0x000B) << 24);
+    // 計算が終わるのを待つ
+    while(rdslt(sltnum, 0x003F) & 0x01);
+
+    *crc = 0;
+    for(uint16_t addr = 0x002F; addr >= 0x002C; addr--) *crc = (*crc << 8) | rdslt(sltnum, addr);
 
     lock_megarom_configure(sltnum);
+    return 0;
+}
 
-    return addr;
+/***********************************************
+ * メガロム領域のサイズ
+ *  メガロム設定レジスタ 003Eh(16KB 単位)から読み出す
+ *  引数
+ *    sltnum    : スロット番号
+ *  戻り値
+ *    メガロム領域のバイト数(読み出せない時は MEGAROM_SIZE_DEFAULT)
+ ***********************************************/
+uint32_t get_megarom_size(uint8_t sltnum)
+{
+    uint8_t banks;
+
+    unlock_megarom_configure(sltnum);
+    banks = rdslt(sltnum, 0x003E);
+    lock_megarom_configure(sltnum);
+
+    return banks != 0 ? (uint32_t)banks << 14 : MEGAROM_SIZE_DEFAULT;
+}
+
+/***********************************************
+ * 識別レジスタ読み出し
+ *  メガロム設定レジスタ 0078h~007Fh はロック中も読み出せるので、
+ *  書き込まずにカートリッジかどうかを判定できる
+ *  引数
+ *    sltnum    : 読み出すスロット番号
+ *    id        : 識別情報を格納する変数のポインタ(NULL 可)
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗(識別レジスタが無い)
+ ***********************************************/
+int read_cartridge_id(uint8_t sltnum, CARTRIDGE_ID_t *id)
+{
+    if(rdslt(sltnum, 0x0078) != 'T') return -1;
+    if(rdslt(sltnum, 0x0079) != 'N') return -1;
+    if(rdslt(sltnum, 0x007A) != 'C') return -1;
+
+    if(id != NULL)
+    {
+        id->board_id = rdslt(sltnum, 0x007B);
+        id->version  = rdslt(sltnum, 0x007C);
+        id->features = rdslt(sltnum, 0x007D) | ((uint16_t)rdslt(sltnum, 0x007E) << 8);
+    }
+    return 0;
+}
+
+/***********************************************
+ * カートリッジチェック
+ *  引数
+ *    sltnum    : チェックするスロット番号
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int check_cartridge(uint8_t sltnum)
+{
+    int res = -1;
+    uint8_t save[4];
+
+#ifndef TNC_HOST
+#asm
+    DI
+#endasm
+#endif
+
+    // 元データを取得
+    for(uint16_t addr = 0; addr < sizeof(save); addr++) save[addr] = rdslt(sltnum, addr);
+
+    // RAM かどうかをチェックする
+    wrtslt(sltnum, 0, 0xAA);
+    if(rdslt(sltnum, 0) == 0xAA) goto err;
+    wrtslt(sltnum, 0, 0x55);
+    if(rdslt(sltnum, 0) == 0x55) goto err;
+
+    // UNLOCK して読み出しデータが変化するかチェック
+    wrtslt(sltnum, 0, 0xAB);
+    wrtslt(sltnum, 1, 0xCD);
+    wrtslt(sltnum, 2, 0x98);
+    wrtslt(sltnum, 3, 0x76);
+    if(rdslt(sltnum, 0) != 0xAB) goto err;
+    if(rdslt(sltnum, 1) != 0xCD) goto err;
+    if(rdslt(sltnum, 2) != 0x98) goto err;
+    if(rdslt(sltnum, 3) != 0x76) goto err;
+
+    // LOCK して読み出しデータが変化するかチェック
+    wrtslt(sltnum, 0, 0x00);
+    wrtslt(sltnum, 1, 0x00);
+    wrtslt(sltnum, 2, 0x00);
+    wrtslt(sltnum, 3, 0x00);
+    if(rdslt(sltnum, 0) == 0xAB) goto err;
+    if(rdslt(sltnum, 1) == 0xCD) goto err;
+    if(rdslt(sltnum, 2) == 0x98) goto err;
+    if(rdslt(sltnum, 3) == 0x76) goto err;
+
+    //
+    res = 0;
+
+err:
+    // 元データに戻す
+    for(uint16_t addr = 0; addr < sizeof(save); addr++) wrtslt(sltnum, addr, save[addr]);
+
+#ifndef TNC_HOST
+#asm
+    EI
+#endasm
+#endif
+
+    return res;
+}
+
+/***********************************************
+ * カートリッジを探す
+ *  引数
+ *    sltnum    : 見つかったスロット番号を格納する変数のポインタ
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int search_cartridge(uint8_t *sltnum)
+{
+    // 識別レジスタで探し、見つからなければ古いビットストリームとして書き込みで確認する
+    for(int pass = 0; pass < 2; pass++)
+    {
+        for(uint8_t primary = 0; primary < 4; primary++)
+        {
+            uint8_t expanded = (*MSX_MEM(0xFCC1 + primary) & 0x80) ? 4 : 1;
+            for(uint8_t secondary = 0; secondary < expanded; secondary++)
+            {
+                uint8_t slt = expanded > 1 ? (0x80 | primary | (secondary << 2)) : primary;
+                if((pass == 0 ? read_cartridge_id(slt, NULL) : check_cartridge(slt)) == 0)
+                {
+                    if(sltnum != NULL) *sltnum = slt;
+                    return 0;
+                }
+            }
+        }
+    }
+    return -1;
 }
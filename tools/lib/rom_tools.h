@@ -34,12 +34,12 @@
 #ifndef _INCLUDE_ROM_TOOLS_H_
 #define _INCLUDE_ROM_TOOLS_H_
 
-#include "..\..\lib\types.h"
+#include "../../lib/types.h"
 
 typedef struct {
     uint16_t    addr;
     uint8_t     init_val;
-    uint8_t     reserved;
+    uint8_t     init_val_h;
 } ROM_ATTR_BANK_t;
 
 typedef const struct {
@@ -47,6 +47,11 @@ typedef const struct {
     uint8_t         val_mask;
     uint16_t        addr_mask;
     ROM_ATTR_BANK_t bank[4];
+    uint8_t         val_mask_h;     // 上位バンクレジスタのマスク(0 なら 8bit バンクレジスタ)
+    uint16_t        high_addr;      // 上位バンクレジスタのアドレス(バンクレジスタアドレスとの XOR)
+    uint8_t         sram_mask;      // SRAM 選択ビット(0 なら SRAM なし, SRAM_MASK_ROM_SIZE なら ROM サイズから決める)
+    uint8_t         sram_flags;     // SRAM フラグ(SRAM_FLAG_*)
+    uint8_t         sram_addr_mask; // SRAM アドレスマスク上位(A12~A8, 1Fh=8KB/07h=2KB)
     char            *name;
 } ROM_ATTR_t;
 
@@ -61,19 +66,68 @@ typedef ROM_ATTR_t *ROM_ATTR_PTR_t;
 #define FLAG_ENABLE_CONTINUOUS  (1<<6)
 #define FLAG_ENABLE             (1<<7)
 
+#define SRAM_FLAG_WRITE_4000    (1<<0)
+#define SRAM_FLAG_WRITE_6000    (1<<1)
+#define SRAM_FLAG_WRITE_8000    (1<<2)
+#define SRAM_FLAG_WRITE_A000    (1<<3)
+#define SRAM_FLAG_PAGE_4K       (1<<4)
+
+#define SRAM_MASK_ROM_SIZE      (0xFF)
+
+#define MEGAROM_SIZE_DEFAULT    ((uint32_t)3 * 1024 * 1024)     // config.sv の RAM_SIZE_MEGAROM の標準値
+
+typedef struct {
+    uint8_t     board_id;       // ボード ID(BOARD_ID_*)
+    uint8_t     version;        // ファームウェアバージョン
+    uint16_t    features;       // 機能フラグ(FEATURE_*)
+} CARTRIDGE_ID_t;
+
+#define BOARD_ID_TNCART_REV1    (0x00)
+#define BOARD_ID_TNCART_REV2    (0x01)
+#define BOARD_ID_WT101C         (0x10)
+#define BOARD_ID_WT102D         (0x11)
+
+#define FEATURE_MEGAROM         (1<<0)
+#define FEATURE_SCC             (1<<1)
+#define FEATURE_FM              (1<<2)
+#define FEATURE_NEXTOR          (1<<3)
+#define FEATURE_RAM             (1<<4)
+#define FEATURE_RAM_DMA         (1<<5)
+#define FEATURE_PSG             (1<<6)
+#define FEATURE_V9990           (1<<7)
+#define FEATURE_PAC_WRITE       (1<<8)
+#define FEATURE_TRACER          (1<<9)
+#define FEATURE_VGM_LOGGER      (1<<10)
+#define FEATURE_DAC_STEREO      (1<<11)
+#define FEATURE_FM_NOWAIT       (1<<12)
+#define FEATURE_CRC32           (1<<13)
+#define FEATURE_SCC_I           (1<<14)
+#define FEATURE_RAM_LARGE       (0x8000)
+
 
 void slot_select_p1(uint8_t sltnum);
 void slot_select_p2(uint8_t sltnum);
 void wrtslt(uint8_t sltnum, uint16_t addr, uint8_t data);
 uint8_t rdslt(uint8_t sltnum, uint16_t addr);
-void set_bank0_reg(uint8_t sltnum, uint8_t num);
-void set_bank1_reg(uint8_t sltnum, uint8_t num);
+void slot_write_begin(uint8_t sltnum);
+void slot_write(uint16_t addr, const uint8_t *data, uint8_t size);
+void slot_write_byte(uint16_t addr, uint8_t data);
+void slot_write_end(void);
+void set_bank0_reg(uint8_t sltnum, uint16_t num);
+void set_bank1_reg(uint8_t sltnum, uint16_t num);
 void unlock_megarom_configure(uint8_t sltnum);
 void lock_megarom_configure(uint8_t sltnum);
 void rom_attr_xfer(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr);
+void set_sram_mask(uint8_t sltnum, uint8_t sram_mask);
 void init_bank_reg(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr);
 void clear_rom(uint8_t sltnum);
 void xfer_memory(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size);
-uint32_t get_sdram_address(uint8_t sltnum);
+void read_memory(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size);
+uint16_t xfer_lz4(uint8_t sltnum, VOID_PTR_t dst, VOID_PTR_t src, size_t size);
+int calc_rom_crc32(uint8_t sltnum, uint32_t size, uint32_t *crc);
+uint32_t get_megarom_size(uint8_t sltnum);
+int read_cartridge_id(uint8_t sltnum, CARTRIDGE_ID_t *id);
+int check_cartridge(uint8_t sltnum);
+int search_cartridge(uint8_t *sltnum);
 
 #endif
\ No newline at end of file
@@ -129,7 +129,7 @@ int get_sltnum(uint8_t *result, char *p)
  ***********************************************/
 int get_hex(uint32_t *result, char *p, int width)
 {
-    uint16_t val = 0;
+    uint32_t val = 0;
     int count = 0;
 
     while(1)
@@ -149,6 +149,7 @@ int get_hex(uint32_t *result, char *p, int width)
         {
             val <<= 4;
             val |= n;
+            count++;
         }
         else
         {
@@ -156,6 +157,8 @@ int get_hex(uint32_t *result, char *p, int width)
         }
     }    
 
+    if(count == 0) return -1;
+    *result = val;
     return 0;
 }
 
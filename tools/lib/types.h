@@ -34,12 +34,24 @@
 #ifndef _INCLUDE_TYPES_H_
 #define _INCLUDE_TYPES_H_
 
+#ifdef TNC_HOST
+// ホストビルド(tools/lib/host.h)ではホストの型を使う
+#include <stdint.h>
+#include <stddef.h>
+
+#define PRI32   ""          // printf の 32bit 整数の長さ修飾子
+#else
 typedef unsigned char uint8_t;
 typedef signed char int8_t;
 typedef unsigned short uint16_t;
 typedef signed short int16_t;
 typedef unsigned long uint32_t;
 typedef signed long int32_t;
+typedef unsigned short uintptr_t;
+
+#define PRI32   "l"         // printf の 32bit 整数の長さ修飾子
+#endif
+
 typedef void *VOID_PTR_t;
 
 #endif
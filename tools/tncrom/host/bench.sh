@@ -0,0 +1,117 @@
+#!/bin/bash
+#
+# bench.sh
+#
+# BSD 3-Clause License
+#
+# Copyright (c) 2024, Shinobu Hashimoto
+#
+# tncrom の ROM イメージ読み込みを tncsim で実行し、無圧縮/圧縮イメージ、
+# MSX-DOS1/MSX-DOS2 の組み合わせ毎に BDOS コール、インタースロットコール、
+# スロット切り替え、カートリッジとファイルの転送バイト数を比較する
+# 読み込み後のメガロム RAM は元の ROM イメージと比べる(compare が NG ならエラー)
+# oversize はメガロム RAM(3MB)より 16KB 大きいイメージで、tncrom が転送前に弾けば OK
+# outside はメガロム RAM の外のバンクに書き込もうとしたバイト数(0 でなければエラー)
+# est-ms は tncsim が命令表と呼び出し回数から見積もった実機の処理時間(ミリ秒)で、実測値ではない
+#
+# 必要なもの
+#   cc (gcc または clang)
+#
+# 使い方
+#   ./bench.sh [-T ROMタイプ] ROMイメージ...
+#
+# 環境変数
+#   OUT     ビルドと作業用のディレクトリ (既定値 out)
+#   CC      C コンパイラ (既定値 cc)
+#   MEDIA   est-ms に加えるメディアの読み出し速度 KB/s (既定値 0 = 加えない)
+#
+
+set -e
+
+TYPE=()
+if [ "$1" = "-T" ]; then
+    TYPE=(-T "$2")
+    shift 2
+fi
+if [ $# -eq 0 ]; then
+    echo "usage: $0 [-T type] rom..." >&2
+    exit 1
+fi
+
+ROMS=()
+for f in "$@"; do
+    ROMS+=("$(realpath "$f")")
+done
+
+cd "$(dirname "$0")"
+SRC=../src
+LIB=../../lib
+OUT=${OUT:-out}
+CC=${CC:-cc}
+MEDIA=${MEDIA:-0}
+
+mkdir -p "$OUT/work"
+
+#
+# ビルド
+#
+echo "building ..." >&2
+$CC -O2 -Wall -Wextra -o "$OUT/lz4rom" lz4rom.c
+$CC -O2 -Wall -Wextra -DTNC_HOST -I$SRC -o "$OUT/tncsim" tncsim.c \
+    $SRC/main.c $SRC/config.c $SRC/detect.c $SRC/param.c $SRC/rom_table.c $SRC/romdb.c \
+    $LIB/bdos.c $LIB/tools.c $LIB/rom_tools.c $LIB/crc32.c $LIB/reboot.c
+
+#
+# 読み込み
+#  作業ディレクトリには MSX-DOS1 の FCB で開ける 8.3 形式の名前でコピーする
+#
+FAIL=0
+
+run() {
+    local label=$1 sim_opts=$2 file=$3
+    shift 3
+    if ! "$OUT/tncsim" -d "$OUT/work" -t "$label" -r "$MEDIA" -c "$OUT/work/BENCH.ROM" $sim_opts -- "${TYPE[@]}" "$@" "$file"; then
+        FAIL=1
+    fi
+}
+
+# 大きすぎるイメージは tncrom の失敗(終了コード 1)が正しい結果
+run_oversize() {
+    local label=$1 sim_opts=$2 file=$3
+    shift 3
+    local status=0
+    "$OUT/tncsim" -d "$OUT/work" -t "$label" -r "$MEDIA" $sim_opts -- "${TYPE[@]}" "$@" "$file" || status=$?
+    if [ $status -ne 1 ]; then
+        FAIL=1
+    fi
+}
+
+format() {
+    awk -F'\t' '{ printf "%-14s %-5s %6s %6s %7s %6s %6s %7s %7s %9s %9s %9s %7s %7s %8s\n", $1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14, $15 }'
+}
+
+for rom in "${ROMS[@]}"; do
+    cp "$rom" "$OUT/work/BENCH.ROM"
+    "$OUT/lz4rom" "$OUT/work/BENCH.ROM" "$OUT/work/BENCH.RLZ" > /dev/null
+    { while :; do cat "$OUT/work/BENCH.ROM"; done; } 2> /dev/null | head -c $((3 * 1024 * 1024 + 16384)) > "$OUT/work/OVER.ROM"
+
+    echo
+    echo "$(basename "$rom") ($(stat -c %s "$rom") bytes, compressed $(stat -c %s "$OUT/work/BENCH.RLZ") bytes)"
+    printf "case\tDOS\tresult\tBDOS\tinterslot\tRDSLT\tWRSLT\tENASLT\tswitch\tcart-wr\tcart-rd\tfile-rd\toutside\test-ms\tcompare\n" | format
+    {
+        for dos in 2 1; do
+            opt=""
+            [ $dos = 1 ] && opt="-1"
+            run raw             "$opt"                  BENCH.ROM
+            run raw-verify      "$opt"                  BENCH.ROM -V
+            run lz4             "$opt"                  BENCH.RLZ
+            run lz4-verify      "$opt"                  BENCH.RLZ -V
+            run old-bitstream   "$opt -o"               BENCH.ROM
+            run_oversize oversize "$opt"                OVER.ROM
+            [ $dos = 2 ] && run slot-cached "-e TNCART=10" BENCH.ROM
+        done
+    } > "$OUT/work/result.txt"      # パイプにすると FAIL がサブシェルで失われる
+    format < "$OUT/work/result.txt"
+done
+
+exit $FAIL
@@ -0,0 +1,409 @@
+//
+// lz4rom.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// Linux 用 ROM イメージ圧縮ツール
+//  ROM イメージを 8KB 毎に LZ4 ブロック形式で圧縮し、tncrom が転送しながら展開できる形式にする
+//  各ブロックは独立しているので、tncrom はカートリッジのページ2に直接展開できる
+//  形式は tools/tncrom/src/lz4rom.h を参照
+//
+// cc -O2 -o lz4rom lz4rom.c
+// ./lz4rom [-d] input output
+//   -d    展開する(確認用)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define LZ4ROM_MAGIC            "TNCLZ4"
+#define LZ4ROM_VERSION          (1)
+#define LZ4ROM_BLOCK_SHIFT      (13)
+#define LZ4ROM_BLOCK_SIZE       (1 << LZ4ROM_BLOCK_SHIFT)
+#define LZ4ROM_HEADER_SIZE      (16)
+#define LZ4ROM_BLOCK_STORED     (0x8000)
+#define LZ4ROM_BLOCK_SIZE_MASK  (0x7FFF)
+
+// LZ4 ブロック形式の制約
+#define MIN_MATCH               (4)
+#define LAST_LITERALS           (5)     // 最後の 5 バイトはリテラル
+#define MF_LIMIT                (12)    // 最後の一致はブロック終端の 12 バイト以上前から始まる
+
+#define HASH_BITS               (12)
+#define MAX_CHAIN               (1024)
+
+// Z80 展開ルーチン(xfer_lz4)の処理時間の目安(T ステート)
+#define CLK_TOKEN               (350)   // トークン 1 個あたり
+#define CLK_LENGTH              (60)    // 長さの追加バイト 1 個あたり
+#define CLK_BYTE                (21)    // LDIR 1 バイトあたり
+#define Z80_CLOCK               (3579545.0)
+
+typedef struct {
+    uint32_t    tokens;
+    uint32_t    length_bytes;
+    uint32_t    copy_bytes;
+} STAT_t;
+
+static STAT_t stat;
+
+/***********************************************
+ * CRC32 (tncrom と同じ多項式 EDB88320h)
+ ***********************************************/
+static uint32_t crc32(const uint8_t *buf, size_t size)
+{
+    static uint32_t table[256];
+    if(table[1] == 0)
+    {
+        for(uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for(int bit = 0; bit < 8; bit++) c = (c & 1) ? ((c >> 1) ^ 0xEDB88320) : (c >> 1);
+            table[i] = c;
+        }
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i = 0; i < size; i++) crc = table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFF;
+}
+
+static void put16(uint8_t *p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put32(uint8_t *p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+static uint32_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t *p) { return get16(p) | (get16(p + 2) << 16); }
+
+static uint32_t hash4(const uint8_t *p)
+{
+    uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/***********************************************
+ * LZ4 の長さ(15 以上は 255 の追加バイトで続ける)
+ ***********************************************/
+static uint8_t *put_length(uint8_t *op, size_t len)
+{
+    len -= 15;
+    while(len >= 255) { *op++ = 255; len -= 255; stat.length_bytes++; }
+    *op++ = (uint8_t)len;
+    stat.length_bytes++;
+    return op;
+}
+
+static uint8_t *put_sequence(uint8_t *op, const uint8_t *lit, size_t lit_len, size_t offset, size_t match_len)
+{
+    uint8_t *token = op++;
+    *token = (uint8_t)((lit_len >= 15 ? 15 : lit_len) << 4);
+    if(lit_len >= 15) op = put_length(op, lit_len);
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+    stat.tokens++;
+    stat.copy_bytes += lit_len;
+
+    // 最後のシーケンスはリテラルのみ
+    if(match_len == 0) return op;
+
+    put16(op, offset);
+    op += 2;
+    size_t ml = match_len - MIN_MATCH;
+    *token |= (uint8_t)(ml >= 15 ? 15 : ml);
+    if(ml >= 15) op = put_length(op, ml);
+    stat.copy_bytes += match_len;
+    return op;
+}
+
+/***********************************************
+ * 最長一致を探す(ハッシュチェイン)
+ ***********************************************/
+static size_t find_match(const uint8_t *src, size_t pos, size_t match_end, const int *head, const int *chain, size_t *offset)
+{
+    size_t best = 0;
+    int cand = head[hash4(src + pos)];
+    for(int depth = 0; cand >= 0 && depth < MAX_CHAIN; depth++, cand = chain[cand])
+    {
+        size_t len = 0;
+        while(pos + len < match_end && src[cand + len] == src[pos + len]) len++;
+        if(len > best)
+        {
+            best = len;
+            *offset = pos - cand;
+        }
+    }
+    return best;
+}
+
+/***********************************************
+ * 1 ブロック圧縮
+ *  戻り値
+ *    圧縮後のサイズ
+ ***********************************************/
+static size_t compress_block(const uint8_t *src, size_t size, uint8_t *dst)
+{
+    static int head[1 << HASH_BITS];
+    static int chain[LZ4ROM_BLOCK_SIZE];
+    uint8_t *op = dst;
+    size_t anchor = 0;
+    size_t pos = 0;
+
+    memset(head, 0xFF, sizeof(head));
+
+    // 一致を探せる範囲と、一致が伸ばせる範囲
+    size_t search_end = size > MF_LIMIT ? size - MF_LIMIT + 1 : 0;
+    size_t match_end = size > LAST_LITERALS ? size - LAST_LITERALS : 0;
+
+    size_t inserted = 0;
+    while(pos < search_end)
+    {
+        // pos までをハッシュに登録
+        for(; inserted < pos; inserted++)
+        {
+            uint32_t h = hash4(src + inserted);
+            chain[inserted] = head[h];
+            head[h] = (int)inserted;
+        }
+
+        size_t offset = 0;
+        size_t len = find_match(src, pos, match_end, head, chain, &offset);
+        if(len < MIN_MATCH)
+        {
+            pos++;
+            continue;
+        }
+
+        // 1 バイト先の方が長く一致するなら今の位置はリテラルにする(遅延評価)
+        if(pos + 1 < search_end)
+        {
+            uint32_t h = hash4(src + pos);
+            chain[pos] = head[h];
+            head[h] = (int)pos;
+            inserted = pos + 1;
+
+            size_t next_offset = 0;
+            size_t next_len = find_match(src, pos + 1, match_end, head, chain, &next_offset);
+            if(next_len > len + 1)
+            {
+                pos++;
+                continue;
+            }
+        }
+
+        op = put_sequence(op, src + anchor, pos - anchor, offset, len);
+        pos += len;
+        anchor = pos;
+    }
+
+    // 残りはリテラル
+    return (size_t)(put_sequence(op, src + anchor, size - anchor, 0, 0) - dst);
+}
+
+/***********************************************
+ * 1 ブロック展開(確認用, xfer_lz4 と同じ処理)
+ ***********************************************/
+static size_t decompress_block(const uint8_t *src, size_t size, uint8_t *dst, size_t dst_size)
+{
+    const uint8_t *ip = src;
+    const uint8_t *end = src + size;
+    uint8_t *op = dst;
+
+    for(;;)
+    {
+        uint8_t token = *ip++;
+        size_t len = token >> 4;
+        if(len == 15) { uint8_t b; do { b = *ip++; len += b; } while(b == 255); }
+        if(op + len > dst + dst_size || ip + len > end) return (size_t)-1;
+        memcpy(op, ip, len);
+        op += len;
+        ip += len;
+        if(ip >= end) break;
+
+        size_t offset = get16(ip);
+        ip += 2;
+        len = (token & 15) + MIN_MATCH;
+        if((token & 15) == 15) { uint8_t b; do { b = *ip++; len += b; } while(b == 255); }
+        if(offset == 0 || offset > (size_t)(op - dst) || op + len > dst + dst_size) return (size_t)-1;
+        for(size_t i = 0; i < len; i++, op++) *op = op[-(long)offset];
+    }
+    return (size_t)(op - dst);
+}
+
+static uint8_t *load_file(const char *path, size_t *size)
+{
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL) { perror(path); return NULL; }
+    fseek(fp, 0, SEEK_END);
+    *size = (size_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *buf = malloc(*size ? *size : 1);
+    if(buf == NULL || fread(buf, 1, *size, fp) != *size) { perror(path); fclose(fp); free(buf); return NULL; }
+    fclose(fp);
+    return buf;
+}
+
+static int save_file(const char *path, const uint8_t *buf, size_t size)
+{
+    FILE *fp = fopen(path, "wb");
+    if(fp == NULL || fwrite(buf, 1, size, fp) != size || fclose(fp) != 0) { perror(path); return 1; }
+    return 0;
+}
+
+/***********************************************
+ * 圧縮
+ ***********************************************/
+static int compress(const char *in, const char *out)
+{
+    size_t size;
+    uint8_t *src = load_file(in, &size);
+    if(src == NULL) return 1;
+
+    size_t blocks = (size + LZ4ROM_BLOCK_SIZE - 1) >> LZ4ROM_BLOCK_SHIFT;
+    uint8_t *dst = malloc(LZ4ROM_HEADER_SIZE + blocks * (LZ4ROM_BLOCK_SIZE + 2) + 64);
+    if(dst == NULL) { perror("malloc"); return 1; }
+
+    // ヘッダ
+    memset(dst, 0, LZ4ROM_HEADER_SIZE);
+    memcpy(dst, LZ4ROM_MAGIC, 6);
+    dst[6] = LZ4ROM_VERSION;
+    dst[7] = LZ4ROM_BLOCK_SHIFT;
+    put32(dst + 8, (uint32_t)size);
+    put32(dst + 12, crc32(src, size));
+    size_t pos = LZ4ROM_HEADER_SIZE;
+
+    // ブロック毎に圧縮(小さくならないブロックは無圧縮)
+    size_t stored = 0;
+    uint8_t work[LZ4ROM_BLOCK_SIZE * 2];
+    for(size_t off = 0; off < size; off += LZ4ROM_BLOCK_SIZE)
+    {
+        size_t len = size - off < LZ4ROM_BLOCK_SIZE ? size - off : LZ4ROM_BLOCK_SIZE;
+        STAT_t save = stat;
+        size_t clen = compress_block(src + off, len, work);
+
+        uint8_t check[LZ4ROM_BLOCK_SIZE];
+        if(clen < len && decompress_block(work, clen, check, sizeof(check)) == len && memcmp(check, src + off, len) == 0)
+        {
+            put16(dst + pos, (uint32_t)clen);
+            memcpy(dst + pos + 2, work, clen);
+            pos += 2 + clen;
+        }
+        else
+        {
+            stat = save;
+            stat.copy_bytes += len;
+            put16(dst + pos, LZ4ROM_BLOCK_STORED | (uint32_t)len);
+            memcpy(dst + pos + 2, src + off, len);
+            pos += 2 + len;
+            stored++;
+        }
+    }
+
+    if(save_file(out, dst, pos)) return 1;
+
+    // 転送量と展開時間の目安
+    double clocks = (double)stat.tokens * CLK_TOKEN + (double)stat.length_bytes * CLK_LENGTH + (double)stat.copy_bytes * CLK_BYTE;
+    double raw_clocks = (double)size * CLK_BYTE;
+    printf("%s: %zu -> %zu bytes (%.1f%%), %zu blocks (%zu stored)\n", in, size, pos, size ? pos * 100.0 / size : 0.0, blocks, stored);
+    printf("file read  : %zu -> %zu sectors\n", (size + 511) / 512, (pos + 511) / 512);
+    printf("Z80 xfer   : %.2f -> %.2f sec at 3.58MHz (excluding disk access)\n", raw_clocks / Z80_CLOCK, clocks / Z80_CLOCK);
+
+    free(src);
+    free(dst);
+    return 0;
+}
+
+/***********************************************
+ * 展開(確認用)
+ ***********************************************/
+static int decompress(const char *in, const char *out)
+{
+    size_t size;
+    uint8_t *src = load_file(in, &size);
+    if(src == NULL) return 1;
+    if(size < LZ4ROM_HEADER_SIZE || memcmp(src, LZ4ROM_MAGIC, 6) != 0 || src[6] != LZ4ROM_VERSION || src[7] != LZ4ROM_BLOCK_SHIFT)
+    {
+        fprintf(stderr, "%s: not a compressed ROM image\n", in);
+        return 1;
+    }
+
+    size_t rom_size = get32(src + 8);
+    uint8_t *dst = malloc(rom_size ? rom_size : 1);
+    if(dst == NULL) { perror("malloc"); return 1; }
+
+    size_t pos = LZ4ROM_HEADER_SIZE;
+    for(size_t off = 0; off < rom_size; off += LZ4ROM_BLOCK_SIZE)
+    {
+        size_t len = rom_size - off < LZ4ROM_BLOCK_SIZE ? rom_size - off : LZ4ROM_BLOCK_SIZE;
+        if(pos + 2 > size) goto broken;
+        uint32_t info = get16(src + pos);
+        size_t clen = info & LZ4ROM_BLOCK_SIZE_MASK;
+        pos += 2;
+        if(pos + clen > size) goto broken;
+        if(info & LZ4ROM_BLOCK_STORED)
+        {
+            if(clen != len) goto broken;
+            memcpy(dst + off, src + pos, len);
+        }
+        else if(decompress_block(src + pos, clen, dst + off, len) != len) goto broken;
+        pos += clen;
+    }
+
+    if(crc32(dst, rom_size) != get32(src + 12)) goto broken;
+    return save_file(out, dst, rom_size);
+
+broken:
+    fprintf(stderr, "%s: broken image\n", in);
+    return 1;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: lz4rom [-d] input output\n"
+                    "  -d    decompress\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int decompress_flag = 0;
+    const char *in = NULL;
+    const char *out = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-d") == 0) decompress_flag = 1;
+        else if(argv[i][0] == '-') { usage(); return 1; }
+        else if(in == NULL) in = argv[i];
+        else if(out == NULL) out = argv[i];
+        else { usage(); return 1; }
+    }
+    if(in == NULL || out == NULL) { usage(); return 1; }
+
+    return decompress_flag ? decompress(in, out) : compress(in, out);
+}
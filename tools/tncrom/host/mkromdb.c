@@ -0,0 +1,497 @@
+//
+// mkromdb.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// Linux 用 ROM データベース作成ツール
+//  openMSX の softwaredb.xml 形式の XML と ROM イメージから TNCROM.DB を作成する
+//  softwaredb には SHA1 しか無いので、ROM イメージの SHA1 で XML を引いてタイプを決め、
+//  tncrom が転送中に計算する CRC32 とサイズをキーにして書き出す
+//  形式は tools/tncrom/src/romdb.h を参照
+//
+// cc -O2 -o mkromdb mkromdb.c
+// ./mkromdb [-o TNCROM.DB] [-q CRC32=QUIRK[,QUIRK]...] softwaredb.xml ROMFILE...
+//   QUIRK : SCC (SCC 音源を有効にする), WRITABLE (ROM 領域への書き込みを許可する)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+
+#define ROMDB_MAGIC             "TNCROMDB"
+#define ROMDB_VERSION           (1)
+#define ROMDB_RECORD_SIZE       (64)
+#define ROMDB_TYPE_SIZE         (16)
+#define ROMDB_TITLE_SIZE        (36)
+
+#define ROMDB_QUIRK_SCC         (1<<0)
+#define ROMDB_QUIRK_WRITABLE    (1<<1)
+
+#define MAX_QUIRKS              (256)
+
+typedef struct {
+    char        sha1[41];
+    char        type[32];
+    long        start;
+    char        title[ROMDB_TITLE_SIZE];
+} DUMP_t;
+
+typedef struct {
+    uint32_t    crc;
+    uint32_t    size;
+    uint8_t     quirks;
+    char        type[ROMDB_TYPE_SIZE];
+    char        title[ROMDB_TITLE_SIZE];
+} RECORD_t;
+
+typedef struct {
+    uint32_t    crc;
+    uint8_t     quirks;
+} QUIRK_t;
+
+static DUMP_t *dumps = NULL;
+static size_t dump_count = 0;
+static QUIRK_t quirks[MAX_QUIRKS];
+static int quirk_count = 0;
+
+/***********************************************
+ * CRC32 (tncrom と同じ多項式 EDB88320h)
+ ***********************************************/
+static uint32_t crc32(const uint8_t *buf, size_t size)
+{
+    static uint32_t table[256];
+    if(table[1] == 0)
+    {
+        for(uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for(int bit = 0; bit < 8; bit++) c = (c & 1) ? ((c >> 1) ^ 0xEDB88320) : (c >> 1);
+            table[i] = c;
+        }
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t i = 0; i < size; i++) crc = table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFF;
+}
+
+/***********************************************
+ * SHA1 (softwaredb の照合用)
+ ***********************************************/
+#define ROL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void sha1_block(uint32_t h[5], const uint8_t *p)
+{
+    uint32_t w[80];
+    for(int i = 0; i < 16; i++) w[i] = ((uint32_t)p[i*4] << 24) | ((uint32_t)p[i*4+1] << 16) | ((uint32_t)p[i*4+2] << 8) | p[i*4+3];
+    for(int i = 16; i < 80; i++) w[i] = ROL(w[i-3] ^ w[i-8] ^ w[i-14] ^ w[i-16], 1);
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for(int i = 0; i < 80; i++)
+    {
+        uint32_t f, k;
+        if(i < 20)      { f = (b & c) | (~b & d);           k = 0x5A827999; }
+        else if(i < 40) { f = b ^ c ^ d;                    k = 0x6ED9EBA1; }
+        else if(i < 60) { f = (b & c) | (b & d) | (c & d);  k = 0x8F1BBCDC; }
+        else            { f = b ^ c ^ d;                    k = 0xCA62C1D6; }
+        uint32_t t = ROL(a, 5) + f + e + k + w[i];
+        e = d; d = c; c = ROL(b, 30); b = a; a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+}
+
+static void sha1(const uint8_t *buf, size_t size, char *out)
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t last[128];
+    size_t pos = 0;
+
+    for(; pos + 64 <= size; pos += 64) sha1_block(h, buf + pos);
+
+    // 終端処理
+    size_t rest = size - pos;
+    size_t last_size = (rest < 56) ? 64 : 128;
+    memset(last, 0, sizeof(last));
+    memcpy(last, buf + pos, rest);
+    last[rest] = 0x80;
+    uint64_t bits = (uint64_t)size * 8;
+    for(int i = 0; i < 8; i++) last[last_size - 1 - i] = (uint8_t)(bits >> (i * 8));
+    for(size_t i = 0; i < last_size; i += 64) sha1_block(h, last + i);
+
+    for(int i = 0; i < 5; i++) sprintf(out + i * 8, "%08x", h[i]);
+}
+
+/***********************************************
+ * XML 読み込み
+ *  softwaredb.xml の <software> 毎に <title> と、<rom>/<megarom> の
+ *  <type>, <start>, <hash> だけを拾う簡易パーサ
+ ***********************************************/
+static const char *find_tag(const char *p, const char *end, const char *tag)
+{
+    size_t len = strlen(tag);
+    while((p = strstr(p, tag)) != NULL && p < end)
+    {
+        // <tag> か <tag 属性...> のみ
+        if(p[len] == '>' || p[len] == ' ') return p;
+        p += len;
+    }
+    return NULL;
+}
+
+static void get_text(const char *p, const char *end, const char *tag, char *out, size_t out_size)
+{
+    out[0] = '\0';
+    p = find_tag(p, end, tag);
+    if(p == NULL) return;
+    p = strchr(p, '>');
+    if(p == NULL || p >= end) return;
+    p++;
+
+    // 実体参照をデコードしながらコピー
+    size_t n = 0;
+    while(p < end && *p != '<' && n + 1 < out_size)
+    {
+        static const struct { const char *ref; char ch; } refs[] = {
+            { "&amp;", '&' }, { "&lt;", '<' }, { "&gt;", '>' }, { "&quot;", '"' }, { "&apos;", '\'' }
+        };
+        char ch = *p++;
+        if(ch == '&')
+        {
+            for(size_t i = 0; i < sizeof(refs) / sizeof(refs[0]); i++)
+            {
+                size_t len = strlen(refs[i].ref);
+                if(strncmp(p - 1, refs[i].ref, len) == 0) { ch = refs[i].ch; p += len - 1; break; }
+            }
+        }
+        // MSX-DOS で表示できない文字は '?' にする
+        out[n++] = ((uint8_t)ch < 0x20 || (uint8_t)ch >= 0x7F) ? '?' : ch;
+    }
+    out[n] = '\0';
+
+    // 前後の空白を除く
+    while(n > 0 && isspace((uint8_t)out[n - 1])) out[--n] = '\0';
+    size_t skip = 0;
+    while(isspace((uint8_t)out[skip])) skip++;
+    memmove(out, out + skip, n - skip + 1);
+}
+
+static void add_dump(const char *title, const char *p, const char *end)
+{
+    char start[16];
+    DUMP_t d;
+
+    memset(&d, 0, sizeof(d));
+    snprintf(d.title, sizeof(d.title), "%s", title);
+    get_text(p, end, "<type", d.type, sizeof(d.type));
+    get_text(p, end, "<hash", d.sha1, sizeof(d.sha1));
+    get_text(p, end, "<start", start, sizeof(start));
+    d.start = start[0] ? strtol(start, NULL, 0) : -1;
+    for(char *s = d.sha1; *s; s++) *s = (char)tolower((uint8_t)*s);
+    if(strlen(d.sha1) != 40) return;
+
+    dumps = realloc(dumps, (dump_count + 1) * sizeof(DUMP_t));
+    if(dumps == NULL) { perror("realloc"); exit(1); }
+    dumps[dump_count++] = d;
+}
+
+static int load_xml(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL) { perror(path); return 1; }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *xml = malloc(size + 1);
+    if(xml == NULL || fread(xml, 1, size, fp) != (size_t)size) { perror(path); fclose(fp); return 1; }
+    xml[size] = '\0';
+    fclose(fp);
+
+    const char *p = xml;
+    while((p = find_tag(p, xml + size, "<software")) != NULL)
+    {
+        const char *end = strstr(p, "</software>");
+        if(end == NULL) break;
+
+        char title[ROMDB_TITLE_SIZE];
+        get_text(p, end, "<title", title, sizeof(title));
+
+        // <rom> または <megarom> 毎に登録
+        const char *q = p;
+        for(;;)
+        {
+            const char *rom = find_tag(q, end, "<rom");
+            const char *megarom = find_tag(q, end, "<megarom");
+            const char *tag = (rom == NULL) ? megarom : (megarom == NULL || rom < megarom) ? rom : megarom;
+            if(tag == NULL) break;
+            const char *tag_end = strstr(tag, tag == rom ? "</rom>" : "</megarom>");
+            if(tag_end == NULL || tag_end > end) break;
+            add_dump(title, tag, tag_end);
+            q = tag_end;
+        }
+        p = end;
+    }
+
+    free(xml);
+    return 0;
+}
+
+/***********************************************
+ * softwaredb のタイプを tncrom の ROM タイプ識別子にする
+ *  戻り値
+ *    ROM タイプ識別子(対応していない場合は NULL)
+ ***********************************************/
+static const char *convert_type(const DUMP_t *d, size_t size)
+{
+    static const struct { const char *db; const char *tncrom; } types[] = {
+        { "ASCII8",         "ASCII8"        },
+        { "ASCII16",        "ASCII16"       },
+        { "Konami",         "KONAMI_WO_SCC" },
+        { "KonamiSCC",      "KONAMI"        },
+        { "RType",          "R-TYPE"        },
+        { "NEO8",           "NEO8"          },
+        { "NEO16",          "NEO16"         },
+        { "ASCII8SRAM8",    "ASCII8_SRAM"   },
+        { "ASCII16SRAM2",   "ASCII16_SRAM2" },
+        { "ASCII16SRAM8",   "ASCII16_SRAM8" },
+        { "KoeiSRAM8",      "KOEI"          },
+        { "GameMaster2",    "GAME_MASTER2"  },
+    };
+
+    // タイプ指定なしは 32KB 以下のバンク切り替えなし ROM
+    if(d->type[0] == '\0' || strcasecmp(d->type, "Normal") == 0 || strcasecmp(d->type, "Mirrored") == 0)
+    {
+        if(size <= 16384) return (d->start == 0x8000) ? "16K2" : "16K";
+        if(size <= 32768 && (d->start == -1 || d->start == 0x4000)) return "32K";
+        return NULL;
+    }
+
+    for(size_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        if(strcasecmp(d->type, types[i].db) == 0) return types[i].tncrom;
+    }
+    return NULL;
+}
+
+/***********************************************
+ * -q オプションの解析
+ ***********************************************/
+static int parse_quirk(const char *arg)
+{
+    char *p;
+    if(quirk_count >= MAX_QUIRKS) return 1;
+
+    QUIRK_t *q = &quirks[quirk_count];
+    q->crc = (uint32_t)strtoul(arg, &p, 16);
+    q->quirks = 0;
+    if(*p++ != '=') return 1;
+
+    while(*p != '\0')
+    {
+        size_t len = strcspn(p, ",");
+        if(len == 3 && strncasecmp(p, "SCC", len) == 0) q->quirks |= ROMDB_QUIRK_SCC;
+        else if(len == 8 && strncasecmp(p, "WRITABLE", len) == 0) q->quirks |= ROMDB_QUIRK_WRITABLE;
+        else return 1;
+        p += len;
+        if(*p == ',') p++;
+    }
+
+    quirk_count++;
+    return 0;
+}
+
+static uint8_t get_quirks(uint32_t crc)
+{
+    for(int i = 0; i < quirk_count; i++)
+    {
+        if(quirks[i].crc == crc) return quirks[i].quirks;
+    }
+    return 0;
+}
+
+/***********************************************
+ * ROM イメージを読み込んでレコードを作る
+ *  戻り値
+ *    0  : 成功
+ *    !0 : データベースに無い/対応していないタイプ
+ ***********************************************/
+static int make_record(const char *path, RECORD_t *r)
+{
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL) { perror(path); return 1; }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *buf = malloc(size ? size : 1);
+    if(buf == NULL || fread(buf, 1, size, fp) != (size_t)size) { perror(path); fclose(fp); free(buf); return 1; }
+    fclose(fp);
+
+    char hash[41];
+    sha1(buf, size, hash);
+    memset(r, 0, sizeof(RECORD_t));
+    r->crc = crc32(buf, size);
+    r->size = (uint32_t)size;
+    free(buf);
+
+    for(size_t i = 0; i < dump_count; i++)
+    {
+        if(strcmp(dumps[i].sha1, hash) != 0) continue;
+
+        const char *type = convert_type(&dumps[i], size);
+        if(type == NULL)
+        {
+            fprintf(stderr, "%s: unsupported type %s (%s)\n", path, dumps[i].type[0] ? dumps[i].type : "Normal", dumps[i].title);
+            return 1;
+        }
+        snprintf(r->type, sizeof(r->type), "%s", type);
+        snprintf(r->title, sizeof(r->title), "%s", dumps[i].title);
+        r->quirks = get_quirks(r->crc);
+        return 0;
+    }
+
+    fprintf(stderr, "%s: not found in database (sha1 %s)\n", path, hash);
+    return 1;
+}
+
+static int compare_record(const void *a, const void *b)
+{
+    const RECORD_t *p = a;
+    const RECORD_t *q = b;
+    if(p->crc != q->crc) return (p->crc < q->crc) ? -1 : 1;
+    if(p->size != q->size) return (p->size < q->size) ? -1 : 1;
+    return 0;
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/***********************************************
+ * データベース書き出し
+ *  64 バイト固定長, 先頭がヘッダ, 以降 (CRC32, サイズ) の昇順
+ ***********************************************/
+static int write_db(const char *path, const RECORD_t *records, size_t count)
+{
+    uint8_t raw[ROMDB_RECORD_SIZE];
+    FILE *fp = fopen(path, "wb");
+    if(fp == NULL) { perror(path); return 1; }
+
+    memset(raw, 0, sizeof(raw));
+    memcpy(raw, ROMDB_MAGIC, 8);
+    raw[8] = ROMDB_VERSION;
+    raw[10] = ROMDB_RECORD_SIZE;
+    put32(raw + 12, (uint32_t)count);
+    fwrite(raw, 1, sizeof(raw), fp);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        memset(raw, 0, sizeof(raw));
+        put32(raw + 0, records[i].crc);
+        put32(raw + 4, records[i].size);
+        raw[8] = records[i].quirks;
+        memcpy(raw + 12, records[i].type, ROMDB_TYPE_SIZE - 1);
+        memcpy(raw + 28, records[i].title, ROMDB_TITLE_SIZE - 1);
+        fwrite(raw, 1, sizeof(raw), fp);
+    }
+
+    // MSX-DOS1 は 128 バイト単位で読むので奇数レコードの後ろを埋める
+    if(((count + 1) & 1) != 0)
+    {
+        memset(raw, 0, sizeof(raw));
+        fwrite(raw, 1, sizeof(raw), fp);
+    }
+
+    if(fclose(fp) != 0) { perror(path); return 1; }
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: mkromdb [-o output] [-q crc32=quirk[,quirk]] softwaredb.xml romfile...\n"
+                    "  -o output        output file (default TNCROM.DB)\n"
+                    "  -q crc32=quirks  set quirks (SCC, WRITABLE) for the ROM image\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *out = "TNCROM.DB";
+    const char *xml = NULL;
+    RECORD_t *records = NULL;
+    size_t count = 0;
+    int errors = 0;
+
+    int i;
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-o") == 0 && i + 1 < argc) out = argv[++i];
+        else if(strcmp(argv[i], "-q") == 0 && i + 1 < argc)
+        {
+            if(parse_quirk(argv[++i])) { fprintf(stderr, "invalid quirk %s\n", argv[i]); return 1; }
+        }
+        else if(argv[i][0] == '-') { usage(); return 1; }
+        else break;
+    }
+    if(i >= argc) { usage(); return 1; }
+    xml = argv[i++];
+
+    if(load_xml(xml)) return 1;
+    fprintf(stderr, "%zu dumps in %s\n", dump_count, xml);
+
+    records = malloc((argc - i + 1) * sizeof(RECORD_t));
+    if(records == NULL) { perror("malloc"); return 1; }
+    for(; i < argc; i++)
+    {
+        if(make_record(argv[i], &records[count]) == 0) count++;
+        else errors++;
+    }
+
+    // 並べ替えて重複(同じイメージ)を除く
+    qsort(records, count, sizeof(RECORD_t), compare_record);
+    size_t n = 0;
+    for(size_t j = 0; j < count; j++)
+    {
+        if(n > 0 && compare_record(&records[n - 1], &records[j]) == 0) continue;
+        records[n++] = records[j];
+    }
+
+    if(write_db(out, records, n)) return 1;
+    fprintf(stderr, "%zu records written to %s (%d skipped)\n", n, out, errors);
+
+    free(records);
+    free(dumps);
+    return 0;
+}
@@ -0,0 +1,869 @@
+//
+// tncsim.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// Linux 用 tncrom シミュレータ
+//  tncrom と tools/lib を TNC_HOST でビルドし(#asm のルーチンは C の実装に置き換わる)、
+//  BDOS(ホストのファイル)、スロット構成、tnCart のメガロム設定レジスタとメガロム RAM を模擬して
+//  ROM イメージの読み込みを実行する
+//  読み込み毎に BDOS コール、インタースロットコール、スロット切り替え、転送バイト数を数えて表示する
+//  実機の処理時間は命令表と呼び出し回数からの見積もり(est.)で、実測値ではない
+//  無圧縮/圧縮イメージ、MSX-DOS1/MSX-DOS2 の組み合わせの比較は bench.sh を使う
+//
+// cc -O2 -DTNC_HOST -I../src -o tncsim tncsim.c ../src/main.c ../src/config.c ../src/detect.c ../src/param.c ../src/rom_table.c ../src/romdb.c ../../lib/bdos.c ../../lib/tools.c ../../lib/rom_tools.c ../../lib/crc32.c ../../lib/reboot.c
+// ./tncsim [-1] [-o] [-s slot] [-d dir] [-e name=value] [-c file] [-r KB/s] [-t label] -- [tncrom の引数]
+//   -1    MSX-DOS1 として動作する(既定値は MSX-DOS2)
+//   -o    識別レジスタと CRC32 計算の無い古いビットストリームとして動作する
+//   -s    tnCart を挿す基本スロット(既定値 1, メガロムは拡張スロット 0)
+//   -d    MSX のカレントディレクトリにするディレクトリ(既定値 .)
+//   -e    環境変数を設定する(MSX-DOS2 のみ, 例: -e TNCART=10)
+//   -c    読み込み後にメガロム RAM の内容をファイルと比べる
+//   -r    処理時間の見積もりに加えるメディアの読み出し速度(KB/s, 既定値 0 = 加えない)
+//   -t    tncrom の出力を捨て、集計を 1 行(タブ区切り, 先頭は label)で出力する
+// 終了コード
+//   0     成功
+//   1     tncrom が失敗したか、-c の比較が一致しない
+//   2     メガロム RAM(RAM_SIZE_MEGAROM)の外のバンクに書き込もうとした
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <setjmp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include "../../lib/types.h"
+#include "../../lib/host.h"
+#include "../../lib/bdos.h"
+#include "../../lib/rom_tools.h"
+
+int tncrom_main(int argc, char *argv[]);
+
+//
+// スロット構成
+//  0 : MAIN-ROM(基本スロット), 3-0 : RAM(TPA), tnCart : 拡張スロット(メガロムは x-0)
+//
+#define SLOT_MAIN_ROM           (0x00)
+#define SLOT_RAM                (0x83)
+#define EXPTBL                  (0xFCC1)
+#define RAMAD0                  (0xF341)
+
+//
+// tnCart
+//
+#define CART_RAM_SIZE           (0x300000)          // メガロム RAM(config.sv の RAM_SIZE_MEGAROM, 003Eh で読み出す)
+#define CART_RAM_ADDR           (0x400000)          // SD-RAM 上のメガロム領域の先頭(config.sv の RAM_ADDR_MEGAROM, 003Ch~003Dh で読み出す)
+#define CART_FIRMWARE_VERSION   (0x01)
+#define CART_FEATURES           (FEATURE_MEGAROM | FEATURE_SCC | FEATURE_FM | FEATURE_NEXTOR | FEATURE_RAM | FEATURE_PSG | \
+                                 FEATURE_V9990 | FEATURE_PAC_WRITE | FEATURE_CRC32 | FEATURE_SCC_I)
+
+static const uint8_t cart_key[4] = { 0xAB, 0xCD, 0x98, 0x76 };
+
+typedef struct {
+    uint8_t     sltnum;         // メガロムのスロット番号
+    int         legacy;         // 識別レジスタと CRC32 計算が無い
+    uint8_t     reg[0x80];      // メガロム設定レジスタ
+    uint8_t     cmd[4];         // 転送コマンド(003Fh に書いた最後の 4 文字)
+    uint16_t    bank[4];        // バンクレジスタ
+    uint8_t     *ram;           // メガロム RAM
+} CART_t;
+
+static CART_t cart;
+
+//
+// BDOS
+//
+#define BDOS_ERR_NOFIL          (0xD7)
+#define BDOS_ERR_EOF            (0xC7)
+#define BDOS_ERR_IHAND          (0xE5)
+#define BDOS_ERR_NHAND          (0xDC)
+#define BDOS_ERR_ELONG          (0xBC)
+#define BDOS_ERR_IBDOS          (0xDF)
+
+#define HANDLE_COUNT            (16)
+#define FCB_COUNT               (8)
+#define ENV_COUNT               (16)
+
+typedef struct {
+    BDOS_FCB_t  *fcb;
+    FILE        *fp;
+} FCB_FILE_t;
+
+static int dos1_flag = 0;
+static const char *root_dir = ".";
+static const char *compare_path = NULL;    // -c の比較ファイル(setjmp をまたぐので main のローカルにしない)
+static const char *summary_label = NULL;   // -t の見出し
+static FILE *handle[HANDLE_COUNT];
+static FCB_FILE_t fcb_file[FCB_COUNT];
+static uint8_t *dta;
+static char env_name[ENV_COUNT][32];
+static char env_value[ENV_COUNT][256];
+static jmp_buf term_jmp;
+static int term_code;
+
+//
+// MSX のメモリ(RAM スロット)
+//
+uint8_t host_memory[0x10000];
+static uint8_t page_slot[4];
+
+//
+// 集計
+//
+typedef struct {
+    uint32_t    bdos[256];      // BDOS ファンクション毎の呼び出し回数
+    uint32_t    bdos_total;
+    uint32_t    rdslt;          // BIOS RDSLT
+    uint32_t    wrslt;          // BIOS WRSLT
+    uint32_t    enaslt;         // BIOS ENASLT
+    uint32_t    slot_switch;    // A8h/拡張スロットレジスタの直接切り替え
+    uint32_t    cart_write;     // カートリッジへ書き込んだバイト数
+    uint32_t    cart_read;      // カートリッジから読み出したバイト数
+    uint32_t    file_read;      // ファイルから読み出したバイト数
+    uint32_t    outside;        // メガロム RAM の外に書き込もうとしたバイト数
+    uint32_t    reboot;
+    uint64_t    cycles;         // 処理時間の見積もり(T ステート)
+} COUNT_t;
+
+static COUNT_t count;
+
+//
+// 処理時間の見積もり(T ステート, M1 ウェイト込み)
+//  tools/lib の #asm ルーチンの分は host_cycles() で加算される
+//  BIOS と BDOS は呼び出し 1 回あたりの概算で、ファイルの読み出しはセクタバッファからの
+//  転送(LDIR 相当)だけを数える。ディスクのアクセス時間は -r で速度を指定したときだけ加える
+//  tncrom の C のコード(パラメータ解析, 判別等)は含まない
+//
+#define Z80_CLOCK       3579545
+#define T_RDSLT         250
+#define T_WRSLT         250
+#define T_ENASLT        400
+#define T_SLOT_SWITCH   100     // A8h と拡張スロットレジスタの直接切り替え
+#define T_BDOS_DOS1     600
+#define T_BDOS_DOS2     1500    // マッパのページ切り替えがあるので DOS1 より重い
+
+static uint32_t media_rate = 0; // メディアの読み出し速度(KB/s)
+
+static const char *bdos_name(uint8_t c)
+{
+    switch(c)
+    {
+        case 0x0A:  return "BUFIN";
+        case 0x0F:  return "FOPEN";
+        case 0x10:  return "FCLOSE";
+        case 0x14:  return "RDSEQ";
+        case 0x15:  return "WRSEQ";
+        case 0x16:  return "FMAKE";
+        case 0x1A:  return "SETDTA";
+        case 0x27:  return "RDBLK";
+        case 0x40:  return "FFIRST";
+        case 0x43:  return "OPEN";
+        case 0x44:  return "CREATE";
+        case 0x45:  return "CLOSE";
+        case 0x48:  return "READ";
+        case 0x49:  return "WRITE";
+        case 0x4A:  return "SEEK";
+        case 0x62:  return "TERM";
+        case 0x63:  return "DEFAB";
+        case 0x6B:  return "GENV";
+        case 0x6C:  return "SENV";
+        case 0x6F:  return "DOSVER";
+        default:    return "?";
+    }
+}
+
+/***********************************************
+ * CRC32 (tncrom と同じ多項式 EDB88320h)
+ ***********************************************/
+static uint32_t crc32_ram(uint32_t addr, uint32_t size)
+{
+    static uint32_t table[256];
+    if(table[1] == 0)
+    {
+        for(uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for(int bit = 0; bit < 8; bit++) c = (c & 1) ? ((c >> 1) ^ 0xEDB88320) : (c >> 1);
+            table[i] = c;
+        }
+    }
+
+    uint32_t crc = 0xFFFFFFFF;
+    for(uint32_t i = 0; i < size; i++)
+    {
+        uint8_t data = addr + i < CART_RAM_SIZE ? cart.ram[addr + i] : 0xFF;
+        crc = table[(crc ^ data) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+/***********************************************
+ * tnCart メガロム
+ *  megarom_configure.sv / megarom_controller.sv の動作のうち、
+ *  tncrom が使う設定レジスタ、バンクレジスタ、メガロム RAM を模擬する
+ ***********************************************/
+static uint16_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get24(const uint8_t *p) { return get16(p) | ((uint32_t)p[2] << 16); }
+
+static int cart_unlocked(void)
+{
+    return memcmp(cart.reg, cart_key, sizeof(cart_key)) == 0;
+}
+
+// メガロム領域の先頭からのオフセット(CART_RAM_SIZE 以上ならメガロム RAM の外)
+static uint32_t cart_offset(uint16_t addr)
+{
+    if(cart.reg[0x0C] & FLAG_BANK_SIZE)
+    {
+        return ((uint32_t)cart.bank[(addr >> 15) & 1] << 14) | (addr & 0x3FFF);
+    }
+    else
+    {
+        return ((uint32_t)cart.bank[((addr >> 14) & 2) | ((addr >> 13) & 1)] << 13) | (addr & 0x1FFF);
+    }
+}
+
+static int cart_selected(uint16_t addr)
+{
+    uint8_t flags = cart.reg[0x0C];
+    if(!(flags & FLAG_ENABLE)) return 0;
+    if(addr >= 0x4000 && addr < 0x8000) return !(flags & FLAG_CS1_MASK);
+    if(addr >= 0x8000 && addr < 0xC000) return !(flags & FLAG_CS2_MASK);
+    return 0;
+}
+
+static uint8_t cart_read(uint16_t addr)
+{
+    count.cart_read++;
+
+    if(addr < 0x0080)
+    {
+        // 識別レジスタ(ロック中も読み出せる)
+        if(!cart.legacy && addr >= 0x0078)
+        {
+            switch(addr)
+            {
+                case 0x78:  return 'T';
+                case 0x79:  return 'N';
+                case 0x7A:  return 'C';
+                case 0x7B:  return BOARD_ID_TNCART_REV2;
+                case 0x7C:  return CART_FIRMWARE_VERSION;
+                case 0x7D:  return (uint8_t)CART_FEATURES;
+                case 0x7E:  return (uint8_t)(CART_FEATURES >> 8);
+                default:    return 0x00;
+            }
+        }
+        if(!cart_unlocked()) return 0xFF;
+        switch(addr)
+        {
+            case 0x3C:  return (uint8_t)(CART_RAM_ADDR >> 8);
+            case 0x3D:  return (uint8_t)(CART_RAM_ADDR >> 16);
+            case 0x3E:  return cart.legacy ? 0x00 : (uint8_t)(CART_RAM_SIZE >> 14);
+            case 0x3F:  return 0x00;    // 転送完了
+            default:    return cart.reg[addr];
+        }
+    }
+
+    // メガロム RAM の外は何も無い(megarom_controller.sv の rom_in_range)
+    if(!cart_selected(addr) || cart_offset(addr) >= CART_RAM_SIZE) return 0xFF;
+    return cart.ram[cart_offset(addr)];
+}
+
+static void cart_write(uint16_t addr, uint8_t data)
+{
+    count.cart_write++;
+
+    if(addr < 0x0080)
+    {
+        // キー(0000h~0003h)はロック中も書き込める
+        if(addr < 0x0004) { cart.reg[addr] = data; return; }
+        if(!cart_unlocked()) return;
+        if(addr == 0x3F)
+        {
+            memmove(cart.cmd, cart.cmd + 1, sizeof(cart.cmd) - 1);
+            cart.cmd[sizeof(cart.cmd) - 1] = data;
+            if(!cart.legacy && memcmp(cart.cmd, "@CR\r", 4) == 0)
+            {
+                uint32_t crc = crc32_ram(get24(&cart.reg[0x20]) - CART_RAM_ADDR, get24(&cart.reg[0x26]));
+                for(int i = 0; i < 4; i++) cart.reg[0x2C + i] = (uint8_t)(crc >> (i * 8));
+            }
+            return;
+        }
+        if(addr < 0x0078) cart.reg[addr] = data;
+        return;
+    }
+
+    if(!(cart.reg[0x0C] & FLAG_ENABLE)) return;
+
+    // バンクレジスタ
+    uint16_t addr_mask = get16(&cart.reg[0x0E]);
+    uint16_t high_addr = get16(&cart.reg[0x0A]);
+    for(int i = 0; i < 4; i++)
+    {
+        uint16_t bank_addr = get16(&cart.reg[0x10 + i * 4]);
+        if((addr & addr_mask) == bank_addr)
+        {
+            cart.bank[i] = (cart.bank[i] & 0xF00) | (data & cart.reg[0x0D]);
+        }
+        if((addr & addr_mask) == (bank_addr ^ high_addr))
+        {
+            cart.bank[i] = (cart.bank[i] & 0x0FF) | (((uint16_t)data << 8) & ((uint16_t)cart.reg[0x08] << 8) & 0xF00);
+        }
+    }
+
+    // ROM 領域への書き込み(メガロム RAM の外はハードウェアが捨てるが、tncrom の誤りとして数える)
+    if(cart_selected(addr) && !(cart.reg[0x0C] & FLAG_WRITE_PROTECT))
+    {
+        if(cart_offset(addr) < CART_RAM_SIZE) cart.ram[cart_offset(addr)] = data;
+        else count.outside++;
+    }
+}
+
+/***********************************************
+ * スロットアクセス
+ ***********************************************/
+static uint8_t sim_slot_read(uint8_t sltnum, uint16_t addr)
+{
+    if(sltnum == SLOT_RAM) return host_memory[addr];
+    if(sltnum == cart.sltnum) return cart_read(addr);
+    if(sltnum == SLOT_MAIN_ROM)
+    {
+        // 002Bh : 60Hz, 002Dh : MSX2
+        if(addr == 0x002B) return 0x00;
+        if(addr == 0x002D) return 0x01;
+    }
+    return 0xFF;
+}
+
+static void sim_slot_write(uint8_t sltnum, uint16_t addr, uint8_t data)
+{
+    if(sltnum == SLOT_RAM) host_memory[addr] = data;
+    else if(sltnum == cart.sltnum) cart_write(addr, data);
+}
+
+uint8_t host_rdslt(uint8_t sltnum, uint16_t addr)
+{
+    count.rdslt++;
+    count.cycles += T_RDSLT;
+    return sim_slot_read(sltnum, addr);
+}
+
+void host_wrslt(uint8_t sltnum, uint16_t addr, uint8_t data)
+{
+    count.wrslt++;
+    count.cycles += T_WRSLT;
+    sim_slot_write(sltnum, addr, data);
+}
+
+void host_enaslt(uint8_t sltnum, uint16_t addr)
+{
+    count.enaslt++;
+    count.cycles += T_ENASLT;
+    page_slot[addr >> 14] = sltnum;
+}
+
+void host_get_slot(uint8_t *slot)
+{
+    memcpy(slot, page_slot, sizeof(page_slot));
+}
+
+void host_set_slot(const uint8_t *slot)
+{
+    count.slot_switch++;
+    count.cycles += T_SLOT_SWITCH;
+    memcpy(page_slot, slot, sizeof(page_slot));
+}
+
+uint8_t host_read(uint16_t addr)
+{
+    return sim_slot_read(page_slot[addr >> 14], addr);
+}
+
+void host_write(uint16_t addr, uint8_t data)
+{
+    sim_slot_write(page_slot[addr >> 14], addr, data);
+}
+
+void host_cycles(uint32_t t)
+{
+    count.cycles += t;
+}
+
+void host_reboot(void)
+{
+    count.reboot++;
+}
+
+/***********************************************
+ * MSX のパスからホストのファイルを開く
+ *  ドライブ名を除き、見つからなければ大文字小文字を区別せずに探す
+ ***********************************************/
+static FILE *open_file(const char *path, const char *mode)
+{
+    char name[1024];
+    char dir[1024];
+
+    if(path[0] != '\0' && path[1] == ':') path += 2;
+    snprintf(name, sizeof(name), "%s/%s", root_dir, path);
+    for(char *p = name; *p != '\0'; p++) if(*p == '\\') *p = '/';
+
+    FILE *fp = fopen(name, mode);
+    if(fp != NULL || mode[0] == 'w') return fp;
+
+    char *base = strrchr(name, '/');
+    snprintf(dir, sizeof(dir), "%.*s", (int)(base - name), name);
+    DIR *d = opendir(dir);
+    if(d == NULL) return NULL;
+    for(struct dirent *e; (e = readdir(d)) != NULL; )
+    {
+        if(strcasecmp(e->d_name, base + 1) == 0)
+        {
+            if(snprintf(name, sizeof(name), "%s/%s", dir, e->d_name) < (int)sizeof(name)) fp = fopen(name, mode);
+            break;
+        }
+    }
+    closedir(d);
+    return fp;
+}
+
+static uint32_t file_size(FILE *fp)
+{
+    long pos = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, pos, SEEK_SET);
+    return (uint32_t)size;
+}
+
+/***********************************************
+ * FCB
+ ***********************************************/
+static void fcb_to_path(BDOS_FCB_t *fcb, char *path)
+{
+    int len = 0;
+    for(int i = 0; i < 8 && fcb->file_name[i] != ' '; i++) path[len++] = fcb->file_name[i];
+    if(fcb->file_ext[0] != ' ') path[len++] = '.';
+    for(int i = 0; i < 3 && fcb->file_ext[i] != ' '; i++) path[len++] = fcb->file_ext[i];
+    path[len] = '\0';
+}
+
+static FCB_FILE_t *find_fcb(BDOS_FCB_t *fcb)
+{
+    for(int i = 0; i < FCB_COUNT; i++) if(fcb_file[i].fcb == fcb && fcb_file[i].fp != NULL) return &fcb_file[i];
+    return NULL;
+}
+
+static uint8_t fcb_open(BDOS_FCB_t *fcb, const char *mode)
+{
+    char path[16];
+    FCB_FILE_t *f = find_fcb(fcb);
+    if(f == NULL) for(int i = 0; i < FCB_COUNT; i++) if(fcb_file[i].fp == NULL) { f = &fcb_file[i]; break; }
+    if(f == NULL) return 0xFF;
+
+    fcb_to_path(fcb, path);
+    if(f->fp != NULL) fclose(f->fp);
+    f->fcb = fcb;
+    f->fp = open_file(path, mode);
+    if(f->fp == NULL) return 0xFF;
+
+    fcb->current_block = 0;
+    fcb->reserved_13 = 0;
+    fcb->reserved_32 = 0;
+    fcb->record_size = 128;
+    fcb->file_size = file_size(f->fp);
+    return 0x00;
+}
+
+// シーケンシャルアクセスのレコード位置(カレントブロック * 128 + カレントレコード)
+static uint32_t fcb_record(BDOS_FCB_t *fcb)
+{
+    return ((((uint32_t)fcb->reserved_13 << 8) | fcb->current_block) << 7) | fcb->reserved_32;
+}
+
+static void fcb_set_record(BDOS_FCB_t *fcb, uint32_t record)
+{
+    fcb->current_block = (uint8_t)(record >> 7);
+    fcb->reserved_13 = (uint8_t)(record >> 15);
+    fcb->reserved_32 = (uint8_t)(record & 0x7F);
+}
+
+/***********************************************
+ * BDOS コール
+ ***********************************************/
+static char *env_find(const char *name)
+{
+    for(int i = 0; i < ENV_COUNT; i++) if(env_name[i][0] != '\0' && strcasecmp(env_name[i], name) == 0) return env_value[i];
+    return NULL;
+}
+
+static int env_set(const char *name, const char *value)
+{
+    char *p = env_find(name);
+    if(p == NULL)
+    {
+        for(int i = 0; i < ENV_COUNT && p == NULL; i++)
+        {
+            if(env_name[i][0] == '\0')
+            {
+                snprintf(env_name[i], sizeof(env_name[i]), "%s", name);
+                p = env_value[i];
+            }
+        }
+        if(p == NULL) return -1;
+    }
+    snprintf(p, sizeof(env_value[0]), "%s", value);
+    return 0;
+}
+
+void host_bdos(HOST_REGS_t *regs)
+{
+    uint8_t c = regs->c;
+    uint8_t res = 0;
+    FCB_FILE_t *f;
+    BDOS_FCB_t *fcb = (BDOS_FCB_t*)regs->de;
+    char *de = (char*)regs->de;
+    FILE *fp = regs->b < HANDLE_COUNT ? handle[regs->b] : NULL;
+    size_t n;
+
+    count.bdos[c]++;
+    count.bdos_total++;
+    count.cycles += dos1_flag ? T_BDOS_DOS1 : T_BDOS_DOS2;
+
+    // MSX-DOS1 に無いファンクション
+    if(dos1_flag && c >= 0x40)
+    {
+        regs->a = 0x00;
+        regs->b = 0x00;
+        return;
+    }
+
+    switch(c)
+    {
+        case 0x0A:  // BUFIN
+            {
+                char line[256];
+                uint8_t max = (uint8_t)de[0];
+                if(fgets(line, sizeof(line), stdin) == NULL) line[0] = '\0';
+                line[strcspn(line, "\r\n")] = '\0';
+                n = strlen(line) > max ? max : strlen(line);
+                de[1] = (char)n;
+                memcpy(&de[2], line, n);
+                de[2 + n] = '\r';
+            }
+            break;
+
+        case 0x0F:  // FOPEN
+            res = fcb_open(fcb, "rb");
+            break;
+
+        case 0x16:  // FMAKE
+            res = fcb_open(fcb, "wb");
+            break;
+
+        case 0x10:  // FCLOSE
+            if((f = find_fcb(fcb)) == NULL) { res = 0xFF; break; }
+            fclose(f->fp);
+            f->fp = NULL;
+            break;
+
+        case 0x1A:  // SETDTA
+            dta = (uint8_t*)regs->de;
+            break;
+
+        case 0x14:  // RDSEQ
+            if((f = find_fcb(fcb)) == NULL) { res = 0xFF; break; }
+            fseek(f->fp, (long)fcb_record(fcb) * 128, SEEK_SET);
+            n = fread(dta, 1, 128, f->fp);
+            count.file_read += n;
+            count.cycles += HOST_T_LDIR * n;
+            if(n == 0) { res = 0x01; break; }
+            memset(dta + n, 0, 128 - n);
+            fcb_set_record(fcb, fcb_record(fcb) + 1);
+            break;
+
+        case 0x15:  // WRSEQ
+            if((f = find_fcb(fcb)) == NULL) { res = 0xFF; break; }
+            fseek(f->fp, (long)fcb_record(fcb) * 128, SEEK_SET);
+            if(fwrite(dta, 1, 128, f->fp) != 128) { res = 0x01; break; }
+            fcb_set_record(fcb, fcb_record(fcb) + 1);
+            break;
+
+        case 0x27:  // RDBLK
+            {
+                uint32_t record_size = fcb->record_size != 0 ? fcb->record_size : 128;
+                uint16_t records = (uint16_t)regs->hl;
+                if((f = find_fcb(fcb)) == NULL) { res = 0xFF; break; }
+                fseek(f->fp, (long)(fcb->random_record * record_size), SEEK_SET);
+                n = fread(dta, 1, records * record_size, f->fp);
+                count.file_read += n;
+                count.cycles += HOST_T_LDIR * n;
+                regs->hl = n / record_size;
+                fcb->random_record += n / record_size;
+                if(regs->hl < records) res = 0x01;
+            }
+            break;
+
+        case 0x40:  // FFIRST
+            {
+                uint8_t *fib = (uint8_t*)regs->ix;
+                if((fp = open_file(de, "rb")) == NULL) { res = BDOS_ERR_NOFIL; break; }
+                uint32_t size = file_size(fp);
+                fclose(fp);
+                memset(fib, 0, 64);
+                fib[0] = 0xFF;
+                snprintf((char*)&fib[1], 13, "%s", de);
+                for(int i = 0; i < 4; i++) fib[21 + i] = (uint8_t)(size >> (i * 8));
+            }
+            break;
+
+        case 0x43:  // OPEN
+        case 0x44:  // CREATE
+            {
+                int h;
+                for(h = 0; h < HANDLE_COUNT && handle[h] != NULL; h++);
+                if(h >= HANDLE_COUNT) { res = BDOS_ERR_NHAND; break; }
+                if((handle[h] = open_file(de, c == 0x43 ? "rb" : "wb")) == NULL) { res = BDOS_ERR_NOFIL; break; }
+                regs->b = (uint8_t)h;
+            }
+            break;
+
+        case 0x45:  // CLOSE
+            if(fp == NULL) { res = BDOS_ERR_IHAND; break; }
+            fclose(fp);
+            handle[regs->b] = NULL;
+            break;
+
+        case 0x48:  // READ
+            if(fp == NULL) { res = BDOS_ERR_IHAND; break; }
+            n = fread(de, 1, (uint16_t)regs->hl, fp);
+            count.file_read += n;
+            count.cycles += HOST_T_LDIR * n;
+            regs->hl = n;
+            if(n == 0) res = BDOS_ERR_EOF;
+            break;
+
+        case 0x49:  // WRITE
+            if(fp == NULL) { res = BDOS_ERR_IHAND; break; }
+            regs->hl = fwrite(de, 1, (uint16_t)regs->hl, fp);
+            break;
+
+        case 0x4A:  // SEEK
+            {
+                int whence = regs->a == 0 ? SEEK_SET : regs->a == 1 ? SEEK_CUR : SEEK_END;
+                long offset = (long)(int32_t)(((uint32_t)(uint16_t)regs->de << 16) | (uint16_t)regs->hl);
+                if(fp == NULL) { res = BDOS_ERR_IHAND; break; }
+                fseek(fp, offset, whence);
+                regs->de = (uint16_t)(ftell(fp) >> 16);
+                regs->hl = (uint16_t)ftell(fp);
+            }
+            break;
+
+        case 0x62:  // TERM
+            term_code = regs->b;
+            longjmp(term_jmp, 1);
+
+        case 0x63:  // DEFAB
+            break;
+
+        case 0x6B:  // GENV
+            {
+                char *value = env_find((char*)regs->hl);
+                if(value == NULL) value = "";
+                if(strlen(value) + 1 > regs->b) { res = BDOS_ERR_ELONG; break; }
+                strcpy(de, value);
+            }
+            break;
+
+        case 0x6C:  // SENV
+            if(env_set((char*)regs->hl, de)) res = BDOS_ERR_ELONG;
+            break;
+
+        case 0x6F:  // DOSVER
+            regs->b = 2;
+            regs->c = 0x31;
+            break;
+
+        default:
+            fprintf(stderr, "tncsim: unsupported BDOS function %02Xh\n", c);
+            res = BDOS_ERR_IBDOS;
+            break;
+    }
+
+    regs->a = res;
+}
+
+/***********************************************
+ * メガロム RAM とファイルを比べる
+ ***********************************************/
+static const char *compare_file(const char *path)
+{
+    if(path == NULL) return "-";
+
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL) { perror(path); return "ERROR"; }
+
+    uint32_t size = file_size(fp);
+    uint8_t *buf = malloc(size ? size : 1);
+    int ok = buf != NULL && fread(buf, 1, size, fp) == size && size <= CART_RAM_SIZE && memcmp(buf, cart.ram, size) == 0;
+    fclose(fp);
+    free(buf);
+    return ok ? "OK" : "NG";
+}
+
+/***********************************************
+ * 処理時間の見積もり
+ *  戻り値
+ *    ミリ秒(-r を指定したときはメディアの読み出し時間を含む)
+ ***********************************************/
+static double estimate_ms(void)
+{
+    double ms = (double)count.cycles * 1000.0 / Z80_CLOCK;
+    if(media_rate != 0) ms += (double)count.file_read * 1000.0 / (media_rate * 1024.0);
+    return ms;
+}
+
+/***********************************************
+ * 集計出力
+ ***********************************************/
+static void output_report(int res, const char *compare)
+{
+    printf("\n--- tncsim ---\n");
+    printf("DOS              : %s\n", dos1_flag ? "MSX-DOS1" : "MSX-DOS2");
+    printf("result           : %d%s\n", res, count.reboot ? " (reboot)" : "");
+    printf("BDOS calls       : %u\n", count.bdos_total);
+    for(int i = 0; i < 256; i++)
+    {
+        if(count.bdos[i] != 0) printf("  %02Xh %-10s : %u\n", i, bdos_name(i), count.bdos[i]);
+    }
+    printf("inter-slot calls : %u (RDSLT %u, WRSLT %u, ENASLT %u)\n", count.rdslt + count.wrslt + count.enaslt, count.rdslt, count.wrslt, count.enaslt);
+    printf("slot switches    : %u\n", count.slot_switch);
+    printf("cartridge write  : %u bytes\n", count.cart_write);
+    printf("cartridge read   : %u bytes\n", count.cart_read);
+    printf("file read        : %u bytes\n", count.file_read);
+    printf("outside write    : %u bytes%s\n", count.outside, count.outside ? " (ERROR)" : "");
+    printf("est. Z80 time    : %llu T (%.0f ms%s)\n", (unsigned long long)count.cycles, estimate_ms(),
+        media_rate != 0 ? " with media" : ", no media access");
+    printf("compare          : %s\n", compare);
+}
+
+static void output_line(const char *label, int res, const char *compare)
+{
+    printf("%s\t%s\t%d\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%u\t%.0f\t%s\n", label, dos1_flag ? "DOS1" : "DOS2", res,
+        count.bdos_total, count.rdslt + count.wrslt + count.enaslt, count.rdslt, count.wrslt, count.enaslt,
+        count.slot_switch, count.cart_write, count.cart_read, count.file_read, count.outside, estimate_ms(), compare);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: tncsim [-1] [-o] [-s slot] [-d dir] [-e name=value] [-c file] [-r KB/s] [-t label] -- [tncrom args]\n"
+                    "  -1    MSX-DOS1\n"
+                    "  -o    old bitstream (no ID register, no CRC32)\n"
+                    "  -s    primary slot of tnCart (1~2)\n"
+                    "  -d    current directory\n"
+                    "  -e    set environment variable\n"
+                    "  -c    compare megarom RAM with file\n"
+                    "  -r    media read speed for the time estimate (KB/s)\n"
+                    "  -t    output one line summary\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int primary = 1;
+    int i;
+
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--") == 0) { i++; break; }
+        else if(strcmp(argv[i], "-1") == 0) dos1_flag = 1;
+        else if(strcmp(argv[i], "-o") == 0) cart.legacy = 1;
+        else if(strcmp(argv[i], "-s") == 0 && i + 1 < argc) primary = atoi(argv[++i]);
+        else if(strcmp(argv[i], "-d") == 0 && i + 1 < argc) root_dir = argv[++i];
+        else if(strcmp(argv[i], "-c") == 0 && i + 1 < argc) compare_path = argv[++i];
+        else if(strcmp(argv[i], "-r") == 0 && i + 1 < argc) media_rate = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) summary_label = argv[++i];
+        else if(strcmp(argv[i], "-e") == 0 && i + 1 < argc && strchr(argv[i + 1], '=') != NULL)
+        {
+            char *p = strchr(argv[++i], '=');
+            *p = '\0';
+            env_set(argv[i], p + 1);
+        }
+        else { usage(); return 1; }
+    }
+    if(primary < 1 || primary > 2) { usage(); return 1; }
+
+    // スロット構成
+    memset(&host_memory[EXPTBL], 0x00, 4);
+    host_memory[EXPTBL + primary] = 0x80;
+    host_memory[EXPTBL + 3] = 0x80;
+    memset(&host_memory[RAMAD0], SLOT_RAM, 4);
+    memset(page_slot, SLOT_RAM, sizeof(page_slot));
+
+    // tnCart(電源投入直後)
+    cart.sltnum = (uint8_t)(0x80 | primary);
+    cart.ram = calloc(CART_RAM_SIZE, 1);
+    if(cart.ram == NULL) { perror("calloc"); return 1; }
+    cart.reg[0x0C] = FLAG_WRITE_PROTECT | FLAG_BANK_SIZE | FLAG_CS1_MASK | FLAG_CS2_MASK;
+    memset(&cart.reg[0x10], 0xFF, 0x10);
+
+    // tncrom 実行
+    char *tncrom_argv[64] = { "TNCROM" };
+    int tncrom_argc = 1;
+    for(; i < argc && tncrom_argc < 63; i++) tncrom_argv[tncrom_argc++] = argv[i];
+
+    int stdout_fd = -1;
+    if(summary_label != NULL)
+    {
+        fflush(stdout);
+        stdout_fd = dup(1);
+        int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, 1);
+        close(null_fd);
+    }
+
+    int res = setjmp(term_jmp) == 0 ? tncrom_main(tncrom_argc, tncrom_argv) : term_code;
+
+    if(stdout_fd >= 0)
+    {
+        fflush(stdout);
+        dup2(stdout_fd, 1);
+        close(stdout_fd);
+    }
+
+    const char *compare = res == 0 ? compare_file(compare_path) : "-";
+    if(summary_label != NULL) output_line(summary_label, res, compare);
+    else output_report(res, compare);
+
+    if(count.outside != 0) return 2;
+    return res != 0 || strcmp(compare, "NG") == 0 || strcmp(compare, "ERROR") == 0;
+}
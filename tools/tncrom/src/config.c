@@ -34,8 +34,8 @@
 #include <stdio.h>
 #include <string.h>
 #include <stddef.h>
-#include "..\..\lib\bdos.h"
-#include "..\..\lib\tools.h"
+#include "../../lib/bdos.h"
+#include "../../lib/tools.h"
 #include "config.h"
 #include "message.h"
 
@@ -47,10 +47,16 @@ typedef struct {
 
 static BDOS_FILE_t conf_file;
 CONFIG_t config;
+CONFIG_ENTRY_t config_entry[CONFIG_MAX_ENTRY];
+int config_entry_count;
+char config_entry_name[CONFIG_NAME_SIZE];
 
 static const CONFIG_FORMAT_t config_fmt[] = {
     {   "FILE",     config.rom_file,    sizeof(config.rom_file) },
     {   "TYPE",     config.rom_type,    sizeof(config.rom_type) },
+    {   "SLOT",     config.slot,        sizeof(config.slot)     },
+    {   "FLAGS",    config.flags,       sizeof(config.flags)    },
+    {   "SCC",      config.scc,         sizeof(config.scc)      },
     {   NULL,       NULL,               0                       }
 };
 
@@ -65,14 +71,36 @@ static enum {
     STATE_VALUE_GET,
     STATE_VALUE_SKIP_POST_SPACE,
     STATE_COMPLETE,
+    STATE_SECTION_GET,
     STATE_COMMENT
 } state;
 
+#define IS_EOL(ch)  ((ch) == 13 || (ch) == 10)
+
 static char name[8];
 static int name_len;
 static int value_len;
 static const CONFIG_FORMAT_t *item;
 
+static uint32_t conf_pos;           // 処理中の文字のファイル位置
+static int conf_entry;              // 読み込むエントリ番号(-1 ならセクション見出しの索引を作る)
+static int in_section;              // セクション内を処理中か
+static int in_entry;                // 読み込むエントリのセクション内を処理中か
+static char *section_name;          // セクション名の格納先(NULL なら記録しない)
+static int section_len;
+
+/***********************************************
+ * 設定ファイルの 1文字処理
+ *  最初のセクションより前の項目と読み込むエントリのセクション内の項目を読み込み、
+ *  それ以外のセクション内の行は見出し以外を読み飛ばす
+ *  config_entry_count は見出しを数える(読み込み時は読み込むエントリの番号から数え始める)
+ *  引数
+ *    ch        : 処理する文字
+ *  戻り値
+ *    0  : 継続
+ *    1  : 終了(読み込むエントリか索引の終わり)
+ *    -1 : 失敗
+ ***********************************************/
 static int config_process(char ch)
 {
     //
@@ -80,13 +108,36 @@ static int config_process(char ch)
     //
     if(state == STATE_COMMENT)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             state = STATE_NAME_BEGIN;
         }
         return 0;
     }
 
+    //
+    // セクション見出し([名前])
+    //
+    if(state == STATE_SECTION_GET)
+    {
+        if(IS_EOL(ch))
+        {
+            goto err;
+        }
+        else if(ch == ']')
+        {
+            // 見出しの後ろは読み飛ばす
+            config_entry_count++;
+            state = STATE_COMMENT;
+        }
+        else if(section_name != NULL && section_len < CONFIG_NAME_SIZE - 1)
+        {
+            section_name[section_len++] = ch;
+            section_name[section_len] = '\0';
+        }
+        return 0;
+    }
+
     //
     // キー名を取得
     //
@@ -99,7 +150,7 @@ static int config_process(char ch)
 
     if(state == STATE_NAME_SKIP_PRE_SPACE)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             state = STATE_NAME_BEGIN;
             return 0;
@@ -109,15 +160,48 @@ static int config_process(char ch)
             state = STATE_COMMENT;
             return 0;
         }
+        else if(ch == '[')
+        {
+            section_name = NULL;
+            if(conf_entry >= 0)
+            {
+                // 読み込むエントリの次の見出しで終わる
+                if(in_entry) return 1;
+                in_entry = config_entry_count == conf_entry;
+                if(in_entry) section_name = config_entry_name;
+            }
+            else
+            {
+                // 索引に見出しの位置を記録する(一覧に載らないエントリは -E でしか選べない)
+                if(config_entry_count >= CONFIG_MAX_ENTRY)
+                {
+                    printf(MSG_CONF_TOO_MANY_ENTRY, CONFIG_MAX_ENTRY);
+                    return -1;
+                }
+                config_entry[config_entry_count].offset = conf_pos;
+                section_name = config_entry[config_entry_count].name;
+            }
+            in_section = 1;
+            section_len = 0;
+            if(section_name != NULL) section_name[0] = '\0';
+            state = STATE_SECTION_GET;
+            return 0;
+        }
         else if(ch > 32)
         {
+            // 読み込むエントリ以外のセクション内の項目は解釈しない
+            if(in_section && !in_entry)
+            {
+                state = STATE_COMMENT;
+                return 0;
+            }
             state = STATE_NAME_GET;
         }
     }
 
     if(state == STATE_NAME_GET)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             goto err;
         }
@@ -132,7 +216,7 @@ static int config_process(char ch)
         }
         else
         {
-            if(name_len < sizeof(name)){
+            if(name_len < (int)sizeof(name) - 1){
                 name[name_len++] = ch;
                 name[name_len] = '\0';
             }
@@ -142,7 +226,7 @@ static int config_process(char ch)
 
     if(state == STATE_NAME_SKIP_POST_SPACE)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             goto err;
         }
@@ -186,7 +270,7 @@ static int config_process(char ch)
     //
     if(state == STATE_VALUE_SKIP_PRE_SPACE)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             state = STATE_COMPLETE;
         }
@@ -202,7 +286,7 @@ static int config_process(char ch)
 
     if(state == STATE_VALUE_GET)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             state = STATE_COMPLETE;
         }
@@ -212,7 +296,7 @@ static int config_process(char ch)
         }
         else
         {
-            if(value_len < item->buffer_size)
+            if(value_len < item->buffer_size - 1)
             {
                 item->buffer[value_len++] = ch;
                 item->buffer[value_len] = '\0';
@@ -222,7 +306,7 @@ static int config_process(char ch)
 
     if(state == STATE_VALUE_SKIP_POST_SPACE)
     {
-        if(ch == 13)
+        if(IS_EOL(ch))
         {
             state = STATE_COMPLETE;
         }
@@ -248,11 +332,26 @@ err:
 
 }
 
-int load_config_file(char *config_path)
+/***********************************************
+ * 設定ファイルを先頭または指定位置から処理する
+ *  引数
+ *    config_path   : 設定ファイルのパス
+ *    offset        : 処理を始めるファイル位置
+ *    section       : offset の後に最初に現れるセクションの番号
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int process_config_file(char *config_path, uint32_t offset, int section)
 {
     int res;
+    uint16_t skip;
 
-    memset(&config, 0, sizeof(CONFIG_t));
+    state = STATE_NAME_BEGIN;
+    in_section = 0;
+    in_entry = 0;
+    config_entry_count = section;
+    config_entry_name[0] = '\0';
 
     if(0 != (res = bdos_fopen(&conf_file, config_path)))
     {
@@ -260,6 +359,16 @@ int load_config_file(char *config_path)
         return res;
     }
 
+    // MSX-DOS1 は 128 バイト単位でしか移動できないので、端数は読み飛ばす
+    skip = offset & 127;
+    conf_pos = offset - skip;
+    if(conf_pos != 0 && 0 != (res = bdos_fseek(&conf_file, conf_pos)))
+    {
+        bdos_fclose(&conf_file);
+        printf(MSG_CONF_ERR_READ);
+        return res;
+    }
+
     while(!bdos_eof(&conf_file))
     {
         uint16_t readed;
@@ -270,17 +379,65 @@ int load_config_file(char *config_path)
             return res;
         }
 
-        char *p = conf_file.buffer;
+        char *p = (char*)conf_file.buffer;
+        for(; skip > 0 && readed > 0; skip--, readed--, p++) conf_pos++;
         while(readed-- > 0)
         {
-            if(config_process(*p++)){
+            res = config_process(*p++);
+            conf_pos++;
+            if(res < 0)
+            {
                 bdos_fclose(&conf_file);
                 return -1;
             }
+            if(res > 0) goto done;
         }
     }
 
+done:
     bdos_fclose(&conf_file);
 
     return 0;
 }
+
+/***********************************************
+ * 設定ファイル読み込み
+ *  最初のセクションより前の項目を読み込む
+ *  entry を指定した時は同じ 1回の読み出しでそのエントリのセクションを読み込み、
+ *  次のセクションの見出しで読み出しを終える
+ *  (config_entry_count が entry より小さければエントリが無い)
+ *  entry が 0 の時はセクション見出しの位置と名前の索引(config_entry)を作る
+ *  (CONFIG_MAX_ENTRY を超えるセクションがあれば失敗)
+ *  引数
+ *    config_path   : 設定ファイルのパス
+ *    entry         : 読み込むエントリ番号(1~, 0 なら索引を作る)
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int load_config_file(char *config_path, int entry)
+{
+    memset(&config, 0, sizeof(CONFIG_t));
+    conf_entry = entry - 1;
+
+    return process_config_file(config_path, 0, 0);
+}
+
+/***********************************************
+ * 設定ファイルのエントリ読み込み
+ *  load_config_file() で作った索引の位置から次のセクションまでを読み込む
+ *  (セクションより前の項目は既定値として残る)
+ *  引数
+ *    config_path   : 設定ファイルのパス
+ *    entry         : エントリ番号(0~config_entry_count-1)
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+int load_config_entry(char *config_path, int entry)
+{
+    if(entry < 0 || entry >= config_entry_count) return -1;
+    conf_entry = entry;
+
+    return process_config_file(config_path, config_entry[entry].offset, entry);
+}
@@ -34,15 +34,30 @@
 #ifndef _INCLUDE_CONFIG_H_
 #define _INCLUDE_CONFIG_H_
 
-#include "..\..\lib\types.h"
+#include "../../lib/types.h"
+
+#define CONFIG_MAX_ENTRY    (40)        // 索引(メニュー)に載せるセクション数, -E はこれを超えても選べる
+#define CONFIG_NAME_SIZE    (24)        // 索引に載せるセクション名の長さ('\0' を含む)
 
 typedef struct {
     char    rom_file[256];
     char    rom_type[32];
+    char    slot[4];
+    char    flags[16];
+    char    scc[8];
 } CONFIG_t;
 
+typedef struct {
+    uint32_t    offset;                 // セクション見出しのファイル位置
+    char        name[CONFIG_NAME_SIZE];
+} CONFIG_ENTRY_t;
+
 extern CONFIG_t config;
+extern CONFIG_ENTRY_t config_entry[CONFIG_MAX_ENTRY];
+extern int config_entry_count;
+extern char config_entry_name[CONFIG_NAME_SIZE];     // 読み込んだエントリのセクション名
 
-int load_config_file(char *config_path);
+int load_config_file(char *config_path, int entry);
+int load_config_entry(char *config_path, int entry);
 
 #endif
@@ -0,0 +1,214 @@
+//
+// detect.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <string.h>
+#include "../../lib/types.h"
+#include "../../lib/rom_tools.h"
+#include "rom_table.h"
+#include "detect.h"
+
+//
+// ROM タイプの自動判定
+//  転送中のデータから LD (nnnn),A (32h nn nn) を探し、書き込み先のアドレスで
+//  バンク切り替え方式を推定する
+//  32KB 以下の ROM はサイズとヘッダ("AB" と INIT アドレス)で決める
+//
+
+enum {
+    DETECT_KONAMI = 0,      // 5000h/7000h/9000h/B000h
+    DETECT_KONAMI_WO_SCC,   // 4000h/6000h/8000h/A000h
+    DETECT_ASCII16,         // 6000h/7000h/77FFh
+    DETECT_ASCII8,          // 6000h/6800h/7000h/7800h
+    DETECT_COUNT
+};
+
+// 同点の時は先に書いたものを優先(ASCII16 と ASCII8 が同点なら ASCII16)
+static const ROM_ATTR_PTR_t detect_attr[DETECT_COUNT] = {
+    &ROM_ATTR_KONAMI,
+    &ROM_ATTR_KONAMI_wo_SCC,
+    &ROM_ATTR_ASCII16,
+    &ROM_ATTR_ASCII8
+};
+
+static uint16_t score[DETECT_COUNT];
+static uint32_t detect_pos;         // 判定済のサイズ
+static uint8_t  pending;            // 前回のデータの末尾で見つかった命令の残りバイト数(0~2)
+static uint8_t  pending_lo;         // 前回のデータの末尾の書き込み先アドレス下位
+static uint8_t  header[10];         // 先頭のヘッダ("AB", INIT, STATEMENT, DEVICE, TEXT)
+
+/***********************************************
+ * 判定の初期化
+ ***********************************************/
+void detect_init(void)
+{
+    memset(score, 0, sizeof(score));
+    detect_pos = 0;
+    pending = 0;
+    header[0] = 0;
+}
+
+/***********************************************
+ * 書き込み先アドレスの集計
+ ***********************************************/
+static void count_addr(uint8_t lo, uint8_t hi)
+{
+    if(lo == 0xFF && hi == 0x77)
+    {
+        score[DETECT_ASCII16]++;
+        return;
+    }
+    if(lo != 0x00) return;
+
+    switch(hi)
+    {
+        case 0x50:
+        case 0x90:
+        case 0xB0:
+            score[DETECT_KONAMI]++;
+            break;
+        case 0x40:
+        case 0x80:
+        case 0xA0:
+            score[DETECT_KONAMI_WO_SCC]++;
+            break;
+        case 0x68:
+        case 0x78:
+            score[DETECT_ASCII8]++;
+            break;
+        case 0x60:
+            score[DETECT_KONAMI_WO_SCC]++;
+            score[DETECT_ASCII8]++;
+            score[DETECT_ASCII16]++;
+            break;
+        case 0x70:
+            score[DETECT_KONAMI]++;
+            score[DETECT_ASCII8]++;
+            score[DETECT_ASCII16]++;
+            break;
+    }
+}
+
+/***********************************************
+ * 転送データの判定
+ *  ファイルの先頭から順番に呼ぶこと
+ *  引数
+ *    buf       : 転送データ
+ *    size      : サイズ
+ ***********************************************/
+void detect_scan(const uint8_t *buf, uint16_t size)
+{
+    const uint8_t *p = buf;
+    const uint8_t *end = buf + size;
+
+    if(size == 0) return;
+
+    // ヘッダ
+    if(detect_pos == 0 && size >= sizeof(header))
+    {
+        memcpy(header, buf, sizeof(header));
+    }
+    detect_pos += size;
+
+    // 前回の末尾で途切れた命令
+    if(pending == 2 && size == 1)
+    {
+        pending_lo = p[0];
+        pending = 1;
+        return;
+    }
+    if(pending == 2)      count_addr(p[0], p[1]);
+    else if(pending == 1) count_addr(pending_lo, p[0]);
+    pending = 0;
+
+    // 32h を memchr で探す(1 バイトずつ比較するより速い)
+    while(p < end)
+    {
+        p = memchr(p, 0x32, end - p);
+        if(p == NULL) break;
+
+        uint16_t remain = end - p - 1;
+        if(remain >= 2)
+        {
+            count_addr(p[1], p[2]);
+        }
+        else
+        {
+            // 次のデータに続く
+            pending = 2 - remain;
+            if(remain == 1) pending_lo = p[1];
+            break;
+        }
+        p++;
+    }
+}
+
+/***********************************************
+ * 判定結果
+ *  戻り値
+ *    ROM 属性
+ ***********************************************/
+ROM_ATTR_PTR_t detect_rom_type(void)
+{
+    int has_header = (header[0] == 'A' && header[1] == 'B');
+
+    if(detect_pos <= (uint32_t)0x4000)
+    {
+        // 16KB 以下はヘッダの INIT アドレス(INIT が無ければ BASIC の TEXT アドレス)が
+        // 8000h 以降なら 8000h~BFFFh、それ以外は 4000h~7FFFh に置く
+        uint16_t init = header[2] | (header[3] << 8);
+        if(has_header && (init >= 0x8000 || (init == 0 && header[9] >= 0x80))) return &ROM_ATTR_NORMAL16_P2;
+        return &ROM_ATTR_NORMAL16_P1;
+    }
+
+    if(detect_pos <= (uint32_t)0x8000)
+    {
+        return &ROM_ATTR_NORMAL32;
+    }
+
+    // ASCII8/ASCII16 は他の方式と重なる書き込みが多いので 1 引く
+    if(score[DETECT_ASCII8]) score[DETECT_ASCII8]--;
+    if(score[DETECT_ASCII16]) score[DETECT_ASCII16]--;
+
+    uint8_t best = DETECT_ASCII8;   // 判定できない場合は ASCII8
+    uint16_t best_score = 0;
+    for(uint8_t i = 0; i < DETECT_COUNT; i++)
+    {
+        if(score[i] > best_score)
+        {
+            best = i;
+            best_score = score[i];
+        }
+    }
+    return detect_attr[best];
+}
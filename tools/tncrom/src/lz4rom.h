@@ -0,0 +1,63 @@
+//
+// lz4rom.h
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#ifndef _INCLUDE_LZ4ROM_H_
+#define _INCLUDE_LZ4ROM_H_
+
+#include "../../lib/types.h"
+
+//
+// 圧縮 ROM イメージ
+//  Linux で tools/tncrom/host/lz4rom.c を使って作成する
+//  ヘッダに続いて、元のイメージを 8KB 毎に区切ったブロックが並ぶ
+//  各ブロックは 2 バイトのブロック情報と、LZ4 ブロック形式(ブロック内のみ参照)か無圧縮のデータ
+//  数値はすべてリトルエンディアン
+//
+#define LZ4ROM_MAGIC            "TNCLZ4"
+#define LZ4ROM_VERSION          (1)
+#define LZ4ROM_BLOCK_SHIFT      (13)                    // ブロックサイズ 8KB
+#define LZ4ROM_BLOCK_SIZE       (1 << LZ4ROM_BLOCK_SHIFT)
+
+#define LZ4ROM_BLOCK_STORED     (0x8000)                // ブロック情報 bit15 : 無圧縮
+#define LZ4ROM_BLOCK_SIZE_MASK  (0x7FFF)                // ブロック情報 bit14~0 : データサイズ
+
+typedef struct {
+    char        magic[6];       // "TNCLZ4"
+    uint8_t     version;        // LZ4ROM_VERSION
+    uint8_t     block_shift;    // LZ4ROM_BLOCK_SHIFT
+    uint32_t    size;           // 元のイメージのサイズ
+    uint32_t    crc;            // 元のイメージの CRC32
+} LZ4ROM_HEADER_t;
+
+#endif
@@ -31,29 +31,41 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //
 
-// zcc +msx -subtype=msxdos -O3 -o../bin/TNCROM.COM main.c ..\..\lib\bdos.c ..\..\lib\tools.c ..\..\lib\rom_tools.c ..\..\lib\reboot.c rom_table.c config.c param.c
+// zcc +msx -subtype=msxdos -O3 -o../bin/TNCROM.COM main.c ..\..\lib\bdos.c ..\..\lib\tools.c ..\..\lib\rom_tools.c ..\..\lib\reboot.c ..\..\lib\crc32.c rom_table.c detect.c romdb.c config.c param.c
 
 #include <stdio.h>
 #include <string.h>
-#include "..\..\lib\types.h"
-#include "..\..\lib\bdos.h"
-#include "..\..\lib\tools.h"
-#include "..\..\lib\rom_tools.h"
-#include "..\..\lib\reboot.h"
+#include "../../lib/types.h"
+#include "../../lib/host.h"
+#include "../../lib/bdos.h"
+#include "../../lib/tools.h"
+#include "../../lib/rom_tools.h"
+#include "../../lib/reboot.h"
+#include "../../lib/crc32.h"
 #include "rom_table.h"
+#include "detect.h"
+#include "romdb.h"
+#include "lz4rom.h"
 #include "config.h"
 #include "param.h"
 #include "message.h"
 
 #define VERSION (7)
 
+#define DEFAULT_DB_FILE "TNCROM.DB"
+#define SLOT_ENV_NAME   "TNCART"    // 見つけたカートリッジのスロットを記録する環境変数
+
+#ifdef TNC_HOST
+#define main tncrom_main            // ホストビルドではシミュレータ(tools/tncrom/host/tncsim.c)から呼び出す
+#endif
+
 
 static MAIN_PARAM_t main_param;     // パラメータ
 static BDOS_FILE_t rom_file;        // ROM ファイルアクセス用
 
 #define BUFFER_SIZE (8192)
 #if 1
-static uint8_t *buffer = (uint8_t*)(0x8000 - BUFFER_SIZE);
+static uint8_t *buffer = MSX_MEM(0x8000 - BUFFER_SIZE);
 #else
 static uint8_t buffer[BUFFER_SIZE];
 #endif
@@ -61,6 +73,7 @@ static uint8_t buffer[BUFFER_SIZE];
 //
 // データ書き込み用の ROM 設定
 //
+//  256 バンクを超えるイメージを転送できるように、6800h/7800h を上位バンクレジスタにする
 static const ROM_ATTR_t ROM_ATTR_ASCII16_WO_WP = {
     (uint8_t)(FLAG_ENABLE | FLAG_BANK_SIZE),
     (uint8_t)0xFF,
@@ -71,9 +84,24 @@ static const ROM_ATTR_t ROM_ATTR_ASCII16_WO_WP = {
         { (uint16_t)0xFFFF, 0, 0 },
         { (uint16_t)0xFFFF, 0, 0 }
     },
+    (uint8_t)0x0F,
+    (uint16_t)0x0800,
+    (uint8_t)0x00,
+    (uint8_t)0x00,
+    (uint8_t)0x00,
     "---"
 };
 
+static uint32_t rom_size = 0;       // 転送した ROM イメージのサイズ(SRAM 選択ビットの計算用)
+static int hash_flag = 0;           // 転送中に Z80 で CRC32 を計算するかどうか(-V 指定時, CRC32 非対応のカートリッジで ROM データベースを使う時)
+static int romdb_flag = 0;          // ROM データベースを使うかどうか
+static uint32_t rom_crc;            // 転送した ROM イメージの CRC32
+static int rom_crc_valid = 0;       // rom_crc が有効か(圧縮イメージのヘッダ, または転送中に計算した時)
+static int detect_flag = 0;         // 転送中に ROM タイプを判定するかどうか(圧縮イメージの読み戻し用)
+static int scc_mode = -1;           // 設定ファイルの SCC 指定(FLAG_SCC, FLAG_SCC_I の組み合わせ, -1 なら ROM タイプのまま)
+
+#define JIFFY (*(volatile uint16_t*)MSX_MEM(0xFC9E))
+
 /***********************************************
  * ROM を有効にする
  *  引数
@@ -92,6 +120,22 @@ static void set_rom_enable(uint8_t sltnum, int enable, int enable_continuous)
     lock_megarom_configure(sltnum);
 }
 
+/***********************************************
+ * SCC 音源の設定
+ *  引数
+ *    sltnum    : スロット番号
+ *    scc_flags : FLAG_SCC, FLAG_SCC_I の組み合わせ
+ ***********************************************/
+static void set_rom_scc(uint8_t sltnum, uint8_t scc_flags)
+{
+    unlock_megarom_configure(sltnum);
+    uint8_t flags = rdslt(sltnum, 0x0C);
+    flags &= ~(FLAG_SCC | FLAG_SCC_I);
+    flags |= scc_flags;
+    wrtslt(sltnum, 0x0C, flags);
+    lock_megarom_configure(sltnum);
+}
+
 /***********************************************
  * 1バンク分(16KB)転送
  *  引数
@@ -102,7 +146,7 @@ static void set_rom_enable(uint8_t sltnum, int enable, int enable_continuous)
  *    0  : 成功
  *    !0 : 失敗
  ***********************************************/
-static int xfer_bank(uint8_t sltnum, uint8_t bank, BDOS_FILE_t *file, uint32_t pending)
+static int xfer_bank(uint8_t sltnum, uint16_t bank, BDOS_FILE_t *file, uint32_t pending)
 {
     int res;
     uint16_t addr = (uint16_t)0x8000;
@@ -120,14 +164,18 @@ static int xfer_bank(uint8_t sltnum, uint8_t bank, BDOS_FILE_t *file, uint32_t p
             while(size > 0)
             {
                 // read
-                res = bdos_fread_n(file, (uint16_t)buffer, size, &readed);
+                res = bdos_fread_n(file, (uintptr_t)buffer, size, &readed);
                 if(0 != res) {
                     printf(MSG_ERR_FILEREAD);
                     return res;
                 }
 
+                // ROM タイプ判定
+                detect_scan(buffer, readed);
+                if(hash_flag) crc32_update(&rom_crc, buffer, readed);
+
                 // データを転送
-                xfer_memory(sltnum, (VOID_PTR_t)addr, buffer, readed);
+                xfer_memory(sltnum, (VOID_PTR_t)(uintptr_t)addr, buffer, readed);
 
                 // 次の準備
                 addr += (uint16_t)readed;
@@ -145,8 +193,12 @@ static int xfer_bank(uint8_t sltnum, uint8_t bank, BDOS_FILE_t *file, uint32_t p
                 return res;
             }
 
+            // ROM タイプ判定
+            detect_scan(file->buffer, readed);
+            if(hash_flag) crc32_update(&rom_crc, file->buffer, readed);
+
             // データを転送
-            xfer_memory(sltnum, (VOID_PTR_t)addr, file->buffer, readed);
+            xfer_memory(sltnum, (VOID_PTR_t)(uintptr_t)addr, file->buffer, readed);
 
             // 次の準備
             addr += (uint16_t)readed;
@@ -159,6 +211,103 @@ static int xfer_bank(uint8_t sltnum, uint8_t bank, BDOS_FILE_t *file, uint32_t p
     return 0;
 }
 
+/***********************************************
+ * 指定サイズ読み出し
+ *  引数
+ *    file      : 読み出すファイル
+ *    buf       : 読み出し先
+ *    size      : 読み出すサイズ
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int read_file(BDOS_FILE_t *file, uint8_t *buf, uint16_t size)
+{
+    int res;
+    uint16_t readed;
+
+    while(size > 0)
+    {
+        if(0 != (res = bdos_fread_n(file, (uintptr_t)buf, size, &readed))) return res;
+        if(readed == 0) return -1;
+        buf += readed;
+        size -= readed;
+    }
+    return 0;
+}
+
+/***********************************************
+ * 圧縮イメージの 1バンク分(16KB)転送
+ *  8KB のブロック毎に読み出し、カートリッジに直接展開する
+ *  引数
+ *    sltnum    : スロット番号
+ *    bank      : バンク番号
+ *    file      : 転送元のファイル
+ *    pending   : 残りサイズ(展開後)
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int xfer_bank_lz4(uint8_t sltnum, uint16_t bank, BDOS_FILE_t *file, uint32_t pending)
+{
+    int res;
+    uint16_t addr = (uint16_t)0x8000;
+    uint16_t remain = pending > 16384 ? 16384 : pending;
+
+    // バンク切り替え
+    set_bank1_reg(sltnum, bank);
+
+    while(remain > 0)
+    {
+        uint16_t size = remain > LZ4ROM_BLOCK_SIZE ? LZ4ROM_BLOCK_SIZE : remain;
+        uint16_t info;
+
+        // ブロック情報とデータを読み出し
+        if(0 != (res = read_file(file, (uint8_t*)&info, sizeof(info)))
+        || (info & LZ4ROM_BLOCK_SIZE_MASK) > BUFFER_SIZE
+        || 0 != (res = read_file(file, buffer, info & LZ4ROM_BLOCK_SIZE_MASK)))
+        {
+            printf(MSG_ERR_FILEREAD);
+            return res != 0 ? res : 1;
+        }
+
+        if(info & LZ4ROM_BLOCK_STORED)
+        {
+            if((info & LZ4ROM_BLOCK_SIZE_MASK) != size)
+            {
+                printf(MSG_ERR_LZ4ROM);
+                return 1;
+            }
+
+            // 無圧縮ブロックはそのまま転送
+            detect_scan(buffer, size);
+            xfer_memory(sltnum, (VOID_PTR_t)(uintptr_t)addr, buffer, size);
+        }
+        else
+        {
+            // カートリッジに展開
+            if(xfer_lz4(sltnum, (VOID_PTR_t)(uintptr_t)addr, buffer, info & LZ4ROM_BLOCK_SIZE_MASK) != size)
+            {
+                printf(MSG_ERR_LZ4ROM);
+                return 1;
+            }
+
+            // ROM タイプ判定は展開したデータを読み戻して行う
+            if(detect_flag)
+            {
+                read_memory(sltnum, buffer, (VOID_PTR_t)(uintptr_t)addr, size);
+                detect_scan(buffer, size);
+            }
+        }
+
+        // 次の準備
+        addr += size;
+        remain -= size;
+    }
+
+    return 0;
+}
+
 /***********************************************
  * ファイル転送
  *  引数
@@ -171,8 +320,11 @@ static int xfer_bank(uint8_t sltnum, uint8_t bank, BDOS_FILE_t *file, uint32_t p
 static int xfer_file(uint8_t sltnum, BDOS_FILE_t *file)
 {
     int res;
-    uint8_t bank = 0;
+    uint16_t bank = 0;
     uint32_t size;
+    uint16_t readed;
+    LZ4ROM_HEADER_t *header = (LZ4ROM_HEADER_t*)buffer;
+    int lz4_flag = 0;
 
     // ファイルサイズを得る    
     if(0 != (res = bdos_file_size(file, &size)))
@@ -180,9 +332,46 @@ static int xfer_file(uint8_t sltnum, BDOS_FILE_t *file)
         printf(MSG_ERR_GETFILESIZE);
         return res;
     }
+
+    // ROM タイプ判定と CRC32 の計算は転送と同時に行う
+    detect_init();
+    rom_crc = CRC32_INITIAL;
+    rom_crc_valid = hash_flag;
+
+    // 圧縮イメージならヘッダから展開後のサイズと CRC32 を得る
+    if(size >= (uint32_t)sizeof(LZ4ROM_HEADER_t)
+    && 0 == bdos_fread_n(file, (uintptr_t)header, sizeof(LZ4ROM_HEADER_t), &readed)
+    && readed == sizeof(LZ4ROM_HEADER_t)
+    && 0 == memcmp(header->magic, LZ4ROM_MAGIC, sizeof(header->magic)))
+    {
+        if(header->version != LZ4ROM_VERSION || header->block_shift != LZ4ROM_BLOCK_SHIFT || header->size == 0)
+        {
+            printf(MSG_ERR_LZ4ROM);
+            return 1;
+        }
+        size = header->size;
+        rom_crc = crc32_final(header->crc);
+        rom_crc_valid = 1;
+        lz4_flag = 1;
+        printf(MSG_PROP_LZ4ROM, size);
+    }
+    else if(0 != (res = bdos_fseek(file, 0)))
+    {
+        printf(MSG_ERR_FILEREAD);
+        return res;
+    }
+    rom_size = size;
+
+    // メガロム領域を超えるイメージは他の領域(BIOS, VRAM 等)を壊すので転送前に弾く
+    uint32_t max_size = get_megarom_size(sltnum);
+    if(size > max_size)
+    {
+        printf(MSG_ERR_ROM_TOO_LARGE, max_size);
+        return 1;
+    }
     
     // バンク1のバンクレジスタを設定時にバンク0のデータが化けるので、Bank0を予め最終バンクに切り替え
-    uint8_t last_bank = ((size - (uint32_t)1) >> 14) & 255;
+    uint16_t last_bank = (uint16_t)((size - (uint32_t)1) >> 14);
     set_bank0_reg(sltnum, last_bank);
 
     while(size > (uint32_t)0)
@@ -190,7 +379,8 @@ static int xfer_file(uint8_t sltnum, BDOS_FILE_t *file)
         printf(MSG_PROGRESS, bank);
 
         // 16KB 転送
-        if(0 != (res = xfer_bank(sltnum, bank, file, size))) return res;
+        res = lz4_flag ? xfer_bank_lz4(sltnum, bank, file, size) : xfer_bank(sltnum, bank, file, size);
+        if(0 != res) return res;
 
         // 次の準備
         bank++;
@@ -204,6 +394,57 @@ static int xfer_file(uint8_t sltnum, BDOS_FILE_t *file)
     return 0;
 }
 
+/***********************************************
+ * ROM 属性の追加設定
+ *  引数
+ *    sltnum    : スロット番号
+ *    quirks    : ROM データベースの追加設定(ROMDB_QUIRK_*)
+ ***********************************************/
+static void set_rom_quirks(uint8_t sltnum, uint8_t quirks)
+{
+    unlock_megarom_configure(sltnum);
+    uint8_t flags = rdslt(sltnum, 0x0C);
+    if(quirks & ROMDB_QUIRK_SCC) flags |= FLAG_SCC;
+    if(quirks & ROMDB_QUIRK_WRITABLE) flags &= ~FLAG_WRITE_PROTECT;
+    wrtslt(sltnum, 0x0C, flags);
+    lock_megarom_configure(sltnum);
+}
+
+/***********************************************
+ * ROM データベースから ROM 属性を探す
+ *  CRC32 は圧縮イメージのヘッダか転送中に計算した値を使い、
+ *  どちらも無い時はカートリッジで計算する
+ *  引数
+ *    sltnum    : スロット番号
+ *    quirks    : 追加設定の格納先
+ *  戻り値
+ *    ROM 属性(見つからない場合は NULL)
+ ***********************************************/
+static ROM_ATTR_PTR_t lookup_rom_db(uint8_t sltnum, uint8_t *quirks)
+{
+    static ROMDB_RECORD_t record;
+    ROM_ATTR_PTR_t rom_attr;
+    uint32_t crc;
+
+    *quirks = 0;
+    if(!romdb_flag) return NULL;
+
+    if(rom_crc_valid) crc = crc32_final(rom_crc);
+    else if(calc_rom_crc32(sltnum, rom_size, &crc)) return NULL;
+    printf(MSG_PROP_ROM_CRC, crc);
+    if(romdb_lookup(crc, rom_size, &record)) return NULL;
+
+    if(search_keyword((VOID_PTR_t*)&rom_attr, rom_attr_table, record.type))
+    {
+        printf(MSG_ROMDB_UNKNOWN_TYPE, record.type);
+        return NULL;
+    }
+
+    printf(MSG_PROP_ROM_TITLE, record.title);
+    *quirks = record.quirks;
+    return rom_attr;
+}
+
 /***********************************************
  * ヘッダー消去
  *  引数
@@ -228,11 +469,71 @@ static void disable_header(uint8_t sltnum)
     }
 }
 
+/***********************************************
+ * ROM サイズから SRAM 選択ビットを決める
+ *  ROM のバンク数以上の最小の 2 のべき乗のビットを SRAM 選択ビットにする
+ *  (ASCII8/ASCII16 の SRAM 付き ROM は ROM のバンク番号の次のビットで SRAM を選択する)
+ *  引数
+ *    rom_attr  : ROM 属性
+ *  戻り値
+ *    SRAM 選択ビット(ROM サイズが不明な場合は 80h)
+ ***********************************************/
+static uint8_t sram_mask_from_rom_size(ROM_ATTR_PTR_t rom_attr)
+{
+    uint32_t bank_count = (rom_attr->flags & FLAG_BANK_SIZE) ? (rom_size + (uint32_t)16383) >> 14 : (rom_size + (uint32_t)8191) >> 13;
+    uint8_t mask = 1;
+
+    if(bank_count == 0) return 0x80;
+    while(mask < (uint8_t)0x80 && (uint32_t)mask < bank_count) mask <<= 1;
+    return mask;
+}
+
+/***********************************************
+ * 転送時間出力
+ *  引数
+ *    ticks     : JIFFY のカウント数
+ ***********************************************/
+static void output_time(uint16_t ticks)
+{
+    // MAIN-ROM 002Bh の bit7 が 1 なら 50Hz
+    uint8_t hz = (rdslt(*MSX_MEM(0xFCC1), 0x002B) & 0x80) ? 50 : 60;
+    printf(MSG_PROP_TIME, ticks / hz, (ticks % hz) * 100 / hz);
+}
+
+/***********************************************
+ * 転送した ROM イメージの確認
+ *  カートリッジで計算した CRC32 と転送中に計算した CRC32 を比べる
+ *  引数
+ *    sltnum    : スロット番号
+ *  戻り値
+ *    0  : 成功(カートリッジが CRC32 に対応していない場合を含む)
+ *    !0 : 失敗
+ ***********************************************/
+static int verify_rom_image(uint8_t sltnum)
+{
+    uint32_t crc;
+    uint32_t file_crc = crc32_final(rom_crc);
+
+    if(calc_rom_crc32(sltnum, rom_size, &crc))
+    {
+        printf(MSG_ERR_VERIFY_SUPPORT);
+        return 0;
+    }
+
+    printf(MSG_PROP_VERIFY, crc, crc == file_crc ? MSG_VERIFY_OK : MSG_VERIFY_NG);
+    if(crc != file_crc)
+    {
+        printf(MSG_ERR_VERIFY, file_crc);
+        return 1;
+    }
+    return 0;
+}
+
 /***********************************************
  * イメージファイル転送
  *  引数
  *    sltnum              : スロット番号
- *    rom_attr            : ROM 属性
+ *    rom_attr            : ROM 属性(NULL なら転送したデータから判定する)
  *    path                : 転送元ファイルのファイル
  *    disable_header_flag : ヘッダの無効化フラグ
  *  戻り値
@@ -242,6 +543,10 @@ static void disable_header(uint8_t sltnum)
 static int load_rom_image(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr, char *path, int disable_header_flag)
 {
     int res = 0;
+    uint8_t quirks = 0;
+    uint16_t start_time;
+
+    detect_flag = (rom_attr == NULL);
 
     if(disable_header_flag)
     {
@@ -265,7 +570,12 @@ static int load_rom_image(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr, char *path, i
         rom_attr_xfer(sltnum, &ROM_ATTR_ASCII16_WO_WP);
 
         // ファイルを転送
+        start_time = JIFFY;
         res = xfer_file(sltnum, &rom_file);
+        if(res == 0) output_time(JIFFY - start_time);
+
+        // 転送したデータの確認
+        if(res == 0 && main_param.verify_flag) res = verify_rom_image(sltnum);
 
         // ファイルを閉じる
         bdos_fclose(&rom_file);
@@ -282,6 +592,14 @@ static int load_rom_image(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr, char *path, i
     }
     else
     {
+        // ROM タイプ自動判定(データベースに無ければ転送したデータから判定)
+        if(rom_attr == NULL)
+        {
+            rom_attr = lookup_rom_db(sltnum, &quirks);
+            if(rom_attr == NULL) rom_attr = detect_rom_type();
+            printf(MSG_PROP_ROM_TYPE, rom_attr->name);
+        }
+
         // バンク切り替えなし ROM で正しくデータが読めるようにバンク 0 を戻す
         rom_attr_xfer(sltnum, &ROM_ATTR_ASCII16);
         set_bank0_reg(sltnum, 0);
@@ -289,6 +607,18 @@ static int load_rom_image(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr, char *path, i
         // ROM 属性設定
         rom_attr_xfer(sltnum, rom_attr);
 
+        // SRAM 選択ビットを ROM サイズから決める
+        if(rom_attr->sram_mask == (uint8_t)SRAM_MASK_ROM_SIZE)
+        {
+            set_sram_mask(sltnum, sram_mask_from_rom_size(rom_attr));
+        }
+
+        // データベースの追加設定
+        if(quirks != 0)
+        {
+            set_rom_quirks(sltnum, quirks);
+        }
+
         // SCC-I モードレジスタ初期化
         if(rom_attr->flags & FLAG_SCC_I)
         {
@@ -303,99 +633,116 @@ static int load_rom_image(uint8_t sltnum, ROM_ATTR_PTR_t rom_attr, char *path, i
 }
 
 /***********************************************
- * カートリッジチェック
+ * カートリッジを探す
+ *  見つけたスロットを環境変数 TNCART に記録しておき、次回からは
+ *  識別レジスタを読むだけで確認して全スロットの検索を省略する
+ *  (環境変数は MSX-DOS2 のみ)
  *  引数
- *    sltnum    : チェックするスロット番号
+ *    sltnum    : 見つかったスロット番号を格納する変数のポインタ
  *  戻り値
  *    0  : 成功
  *    !0 : 失敗
  ***********************************************/
-int check_cartridge(uint8_t sltnum)
+static int find_cartridge(uint8_t *sltnum)
 {
-    int res = -1;
-    uint8_t save[4];
-
-#asm
-    DI
-#endasm
-
-    // 元データを取得
-    for(uint16_t addr = 0; addr < sizeof(save); addr++) save[addr] = rdslt(sltnum, addr);
-
-    // RAM かどうかをチェックする
-    wrtslt(sltnum, 0, 0xAA);
-    if(rdslt(sltnum, 0) == 0xAA) goto err;
-    wrtslt(sltnum, 0, 0x55);
-    if(rdslt(sltnum, 0) == 0x55) goto err;
-
-    // UNLOCK して読み出しデータが変化するかチェック
-    wrtslt(sltnum, 0, 0xAB);
-    wrtslt(sltnum, 1, 0xCD);
-    wrtslt(sltnum, 2, 0x98);
-    wrtslt(sltnum, 3, 0x76);
-    if(rdslt(sltnum, 0) != 0xAB) goto err;
-    if(rdslt(sltnum, 1) != 0xCD) goto err;
-    if(rdslt(sltnum, 2) != 0x98) goto err;
-    if(rdslt(sltnum, 3) != 0x76) goto err;
-
-    // LOCK して読み出しデータが変化するかチェック
-    wrtslt(sltnum, 0, 0x00);
-    wrtslt(sltnum, 1, 0x00);
-    wrtslt(sltnum, 2, 0x00);
-    wrtslt(sltnum, 3, 0x00);
-    if(rdslt(sltnum, 0) == 0xAB) goto err;
-    if(rdslt(sltnum, 1) == 0xCD) goto err;
-    if(rdslt(sltnum, 2) == 0x98) goto err;
-    if(rdslt(sltnum, 3) == 0x76) goto err;
-
-    //
-    res = 0;
-
-err:
-    // 元データに戻す
-    for(uint16_t addr = 0; addr < sizeof(save); addr++) wrtslt(sltnum, addr, save[addr]);
-
-#asm
-    EI
-#endasm
+    char env[8];
+    uint8_t slt;
 
-    return res;
+    // 記録したスロットを識別レジスタで確認する
+    if(bdos_getenv(SLOT_ENV_NAME, env, sizeof(env)) == 0 && get_sltnum(&slt, env) == 0 && read_cartridge_id(slt, NULL) == 0)
+    {
+        *sltnum = slt;
+        return 0;
+    }
+
+    if(search_cartridge(&slt)) return -1;
+
+    // -S と同じ形式(基本スロット, 拡張スロットの順)で記録する
+    env[0] = '0' + (slt & 3);
+    env[1] = '0' + ((slt >> 2) & 3);
+    env[(slt & 0x80) ? 2 : 1] = '\0';
+    bdos_setenv(SLOT_ENV_NAME, env);
+
+    *sltnum = slt;
+    return 0;
 }
 
 /***********************************************
- * カートリッジを探す
+ * 設定ファイルのエントリを選ぶ
  *  引数
- *    sltnum    : 見つかったスロット番号を格納する変数のポインタ
+ *    なし
+ *  戻り値
+ *    選んだエントリ番号(1~, 0 なら無効)
+ ***********************************************/
+static int select_config_entry(void)
+{
+    char line[8];
+    int entry = 0;
+
+    for(int i = 0; i < config_entry_count; i++)
+    {
+        printf(MSG_CONF_MENU_ITEM, i + 1, config_entry[i].name);
+    }
+    printf(MSG_CONF_MENU_PROMPT, config_entry_count);
+    bdos_gets(line, sizeof(line));
+    printf("\n");
+
+    for(char *p = line; *p >= '0' && *p <= '9'; p++) entry = entry * 10 + (*p - '0');
+    return entry;
+}
+
+/***********************************************
+ * 設定ファイルのスロット、オプション、SCC を反映する
+ *  (コマンドラインの指定を優先する)
+ *  引数
+ *    なし
  *  戻り値
  *    0  : 成功
  *    !0 : 失敗
  ***********************************************/
-int search_cartridge(uint8_t *sltnum)
+static int apply_config(void)
 {
-    for(uint8_t primary = 0; primary < 4; primary++)
+    // スロット
+    if(main_param.sltnum == (uint8_t)0xFF && config.slot[0] != '\0')
     {
-        if(*(uint8_t*)(0xFCC1 + primary) & 0x80)
+        if(get_sltnum(&main_param.sltnum, config.slot))
         {
-            for(uint8_t secondary = 0; secondary < 4; secondary++)
-            {
-                uint8_t slt = 0x80 | primary | (secondary << 2);
-                if(check_cartridge(slt) == 0)
-                {
-                    if(sltnum != NULL) *sltnum = slt;
-                    return 0;
-                }
-            }
+            printf(MSG_PARAM_INVALID_SLOT, config.slot);
+            return 1;
+        }
+    }
+
+    // オプション(コマンドラインのスイッチと同じ文字, "," 区切りも可)
+    for(char *p = config.flags; *p != '\0'; p++)
+    {
+        if(*p == ',') continue;
+        switch(*p & ~0x20)
+        {
+            case 'R':   main_param.reset_flag = 1;              break;
+            case 'O':   main_param.once_flag = 1;               break;
+            case 'V':   main_param.verify_flag = 1;             break;
+            case 'D':   main_param.disable_header_flag = 1;     break;
+            case 'N':   main_param.nofile_flag = 1;             break;
+            default:
+                printf(MSG_CONF_INVALID_FLAG, *p);
+                return 1;
         }
+    }
+
+    // SCC(未指定なら ROM タイプのまま)
+    if(config.scc[0] != '\0')
+    {
+        if(strcmpi(config.scc, "OFF") == 0)         scc_mode = 0;
+        else if(strcmpi(config.scc, "SCC") == 0)    scc_mode = FLAG_SCC;
+        else if(strcmpi(config.scc, "SCC_I") == 0)  scc_mode = FLAG_SCC | FLAG_SCC_I;
         else
         {
-            if(check_cartridge(primary) == 0)
-            {
-                if(sltnum != NULL) *sltnum = primary;
-                return 0;
-            }
+            printf(MSG_CONF_INVALID_SCC, config.scc);
+            return 1;
         }
     }
-    return -1;
+
+    return 0;
 }
 
 /***********************************************
@@ -448,6 +795,7 @@ int main(int argc, char *argv[])
 {
     char *rom_file = NULL;
     char *rom_type = NULL;
+    char *db_file = NULL;
     ROM_ATTR_PTR_t rom_attr = NULL;
 
     // バージョン出力
@@ -475,14 +823,37 @@ int main(int argc, char *argv[])
     if(main_param.use_conf_file)
     {
         // コンフィグレーションファイルから ROM ファイルパスを得る
-        if(load_config_file(main_param.rom_file))
+        // (-E の指定があれば同じ読み出しでそのエントリも読み込む)
+        if(load_config_file(main_param.rom_file, main_param.entry))
         {
             return 1;
         }
 
+        // セクションがあればエントリを選んで読み込む
+        if(config_entry_count > 0)
+        {
+            if(main_param.entry == 0)
+            {
+                if(load_config_entry(main_param.rom_file, select_config_entry() - 1))
+                {
+                    printf(MSG_CONF_INVALID_ENTRY);
+                    return 1;
+                }
+            }
+            else if(config_entry_count < main_param.entry)
+            {
+                printf(MSG_CONF_INVALID_ENTRY);
+                return 1;
+            }
+            printf(MSG_PROP_CONF_ENTRY, config_entry_name);
+        }
+
         // コンフィグレーションファイルで指定された ROM ファイルとタイプを使用
         rom_file = config.rom_file;
         rom_type = config.rom_type;
+
+        // スロット、オプション、SCC の設定
+        if(apply_config()) return 1;
     }
     else
     {
@@ -493,17 +864,44 @@ int main(int argc, char *argv[])
     // コマンドラインから ROM タイプを指定している場合
     if(main_param.rom_type[0] != '\0') rom_type = main_param.rom_type;
 
-    // ROM タイプ名から属性を探す
-    if(search_keyword((VOID_PTR_t*)&rom_attr, rom_attr_table, rom_type))
+    // ROM タイプ名から属性を探す(未指定または AUTO なら転送時に判定する)
+    if(rom_type == NULL || rom_type[0] == '\0' || strcmpi(rom_type, "AUTO") == 0)
+    {
+        if(main_param.nofile_flag || rom_file[0] == '\0')
+        {
+            printf(MSG_AUTO_NEED_FILE);
+            return 1;
+        }
+
+        // ROM データベースがあれば転送した ROM イメージの CRC32 で検索する
+        db_file = main_param.db_file[0] != '\0' ? main_param.db_file : DEFAULT_DB_FILE;
+        if(romdb_open(db_file) == 0)
+        {
+            romdb_flag = 1;
+        }
+        else if(main_param.db_file[0] != '\0')
+        {
+            printf(MSG_ROMDB_ERR_OPEN, db_file);
+            return 1;
+        }
+    }
+    else if(search_keyword((VOID_PTR_t*)&rom_attr, rom_attr_table, rom_type))
     {
         printf(MSG_UNKNOWN_ROM_TYPE, rom_type);
         return 1;
     }
 
+    // 転送したデータを確認する時は転送中に CRC32 を計算する
+    if(main_param.verify_flag && !main_param.nofile_flag && rom_file[0] != '\0')
+    {
+        crc32_init_table();
+        hash_flag = 1;
+    }
+
     // コマンドラインでカートリッジスロットが指定されていない場合はカートリッジを探す
     if(main_param.sltnum == (uint8_t)0xFF)
     {
-        if(search_cartridge(&main_param.sltnum))
+        if(find_cartridge(&main_param.sltnum))
         {
             printf(MSG_CARTRIDGE_NOT_FOUND);
             return 1;
@@ -512,19 +910,32 @@ int main(int argc, char *argv[])
 
     // ROM イメージファイルの転送
     char buff[8];
+    CARTRIDGE_ID_t cart_id;
     printf(MSG_PROP_SLOT, slot_to_str(buff, sizeof(buff), main_param.sltnum));
+    cart_id.features = 0;
+    if(read_cartridge_id(main_param.sltnum, &cart_id) == 0) printf(MSG_PROP_CARTRIDGE, cart_id.board_id, cart_id.version >> 4, cart_id.version & 0x0F);
     printf(MSG_PROP_ROM_FILE, rom_file);
-    printf(MSG_PROP_ROM_TYPE, rom_attr->name);
-    if(bdos_set_about_handler((uint16_t)abort_handler))
+    printf(MSG_PROP_ROM_TYPE, rom_attr != NULL ? rom_attr->name : MSG_ROM_TYPE_AUTO);
+    if(romdb_flag) printf(MSG_PROP_ROM_DB, db_file);
+
+    // CRC32 を計算できないカートリッジでは、データベースの検索用に転送中に CRC32 を計算する
+    if(romdb_flag && !hash_flag && (cart_id.features & FEATURE_CRC32) == 0)
+    {
+        crc32_init_table();
+        hash_flag = 1;
+    }
+    if(bdos_set_about_handler((uintptr_t)abort_handler))
     {
         printf(MSG_HANDLER_ERROR);
         return 1;        
     }
     int res = load_rom_image(main_param.sltnum, rom_attr, main_param.nofile_flag ? NULL : rom_file, main_param.disable_header_flag);
     bdos_set_about_handler(0);
+    romdb_close();
 
     if(res == 0)
     {
+        if(scc_mode >= 0) set_rom_scc(main_param.sltnum, (uint8_t)scc_mode);
         set_rom_enable(main_param.sltnum, 1, !main_param.once_flag);
     }
 
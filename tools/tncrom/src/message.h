@@ -36,19 +36,30 @@
 
 #define MSG_VERSION             "ROM loader for tnCart v%d.%02d\n"\
                                 "\n"
-#define MSG_USAGE               "USAGE: TNCROM -S [SLOT] -T [TYPE] {-R} {-C} [FILE]\n"
+#define MSG_USAGE               "USAGE: TNCROM -S [SLOT] {-T [TYPE]} {-B [DB]} {-V} {-R} {-C {-E [ENTRY]}} [FILE]\n"
 #define MSG_HELP                "OPTION:\n"\
                                 "  -H           show help message\n"\
                                 "  -R           reboot computer\n"\
                                 "  -O           valid until hardware reset\n"\
                                 "  -C           use configuration file\n"\
+                                "  -E [entry]   select entry of configuration file\n"\
                                 "  -N           not transfer ROM file\n"\
                                 "  -D           disable header area\n"\
+                                "  -V           verify ROM image by CRC32\n"\
                                 "  -S [slot]    set slot number\n"\
-                                "  -T [type]    set ROM type\n"
+                                "  -T [type]    set ROM type(AUTO or omitted: detect)\n"\
+                                "  -B [file]    ROM database for AUTO(default: TNCROM.DB)\n"
 #define MSG_UNKNOWN_ROM_TYPE    "unknown rom type(%s).\n"
+#define MSG_AUTO_NEED_FILE      "rom type detection needs rom image file.\n"
+#define MSG_ROM_TYPE_AUTO       "AUTO"
+#define MSG_PROP_ROM_DB         "DATABASE : %s\n"
+#define MSG_PROP_ROM_CRC        "CRC32    : %08" PRI32 "X\n"
+#define MSG_PROP_ROM_TITLE      "TITLE    : %s\n"
+#define MSG_ROMDB_ERR_OPEN      "can not open rom database(%s).\n"
+#define MSG_ROMDB_UNKNOWN_TYPE  "unknown rom type in database(%s).\n"
 #define MSG_CARTRIDGE_NOT_FOUND "cartridge not found.\n"
 #define MSG_PROP_SLOT           "SLOT     : %s\n"
+#define MSG_PROP_CARTRIDGE      "BOARD    : %02X (firmware v%d.%d)\n"
 #define MSG_PROP_ROM_FILE       "ROM FILE : %s\n"
 #define MSG_PROP_ROM_TYPE       "ROM TYPE : %s\n"
 #define MSG_HANDLER_ERROR       "can not set handler.\n"
@@ -59,15 +70,32 @@
 #define MSG_PROGRESS            "\rbank %d"
 #define MSG_PROGRESS_TERM       "\r"
 #define MSG_ERR_FILEOPEN        "can not open rom image file(%s).\n"
+#define MSG_ERR_LZ4ROM          "compressed rom image is broken.\n"
+#define MSG_ERR_ROM_TOO_LARGE   "rom image is too large (max %" PRI32 "u bytes).\n"
+#define MSG_PROP_LZ4ROM         "LZ4 IMAGE: %" PRI32 "u bytes\n"
+#define MSG_PROP_TIME           "TIME     : %u.%02u sec\n"
+#define MSG_PROP_VERIFY         "VERIFY   : %08" PRI32 "X %s\n"
+#define MSG_VERIFY_OK           "OK"
+#define MSG_VERIFY_NG           "NG"
+#define MSG_ERR_VERIFY          "rom image verify error(file: %08" PRI32 "X).\n"
+#define MSG_ERR_VERIFY_SUPPORT  "CRC32 is not supported by this cartridge.\n"
 
 #define MSG_PARAM_MULTI_FILE    "multiple files specified.\n"
 #define MSG_PARAM_PATH_TOO_LONG "invalid file name(%s).\n"
 #define MSG_PARAM_INVALID_SLOT  "invalid slot format(%s).\n"
+#define MSG_PARAM_INVALID_ENTRY "invalid entry number(%s).\n"
 #define MSG_PARAM_UNKNOWN       "unknwon option(-%c)\n"
 
 #define MSG_CONF_UNKOWN_KEY     "unknown parameter name %s."
 #define MSG_CONF_INVALID_FORMAT "configuration file format error.\n"
 #define MSG_CONF_ERR_OPEN       "can not open configuration file(%s).\n"
 #define MSG_CONF_ERR_READ       "configuration file reading error.\n"
+#define MSG_CONF_INVALID_ENTRY  "invalid entry number.\n"
+#define MSG_CONF_TOO_MANY_ENTRY "too many entries for the menu(max %d), use -E.\n"
+#define MSG_CONF_INVALID_FLAG   "unknown flag in configuration file(%c).\n"
+#define MSG_CONF_INVALID_SCC    "unknown SCC mode in configuration file(%s).\n"
+#define MSG_CONF_MENU_ITEM      "%2d: %s\n"
+#define MSG_CONF_MENU_PROMPT    "select entry(1-%d): "
+#define MSG_PROP_CONF_ENTRY     "ENTRY    : %s\n"
 
 #endif
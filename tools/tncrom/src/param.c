@@ -33,7 +33,7 @@
 
 #include <stdio.h>
 #include <string.h>
-#include "..\..\lib\tools.h"
+#include "../../lib/tools.h"
 #include "param.h"
 #include "message.h"
 
@@ -89,6 +89,8 @@ int parse_param(MAIN_PARAM_t *param, int argc, char *argv[])
             {
                 case 'T':
                 case 'S':
+                case 'B':
+                case 'E':
                     next_state = state;
                     state = 0;
                     break;
@@ -154,6 +156,13 @@ int parse_param(MAIN_PARAM_t *param, int argc, char *argv[])
                 param->nofile_flag = 1;
                 break;
 
+            //
+            // 転送後にカートリッジで CRC32 を計算して確認
+            //
+            case 'V':
+                param->verify_flag = 1;
+                break;
+
             //
             // 設定ファイルを使用
             //
@@ -198,6 +207,34 @@ int parse_param(MAIN_PARAM_t *param, int argc, char *argv[])
                 }
                 break;
 
+            //
+            // ROM データベースファイル指定
+            //
+            case 'B':
+                if(strlen(argv[i]) >= sizeof(param->db_file))
+                {
+                    printf(MSG_PARAM_PATH_TOO_LONG, argv[i]);
+                    return 1;
+                }
+                strncpy(param->db_file, argv[i], sizeof(param->db_file));
+                break;
+
+            //
+            // 設定ファイルのエントリ番号指定
+            //
+            case 'E':
+                param->entry = 0;
+                for(char *p = argv[i]; *p != '\0'; p++)
+                {
+                    if(*p < '0' || *p > '9' || param->entry >= 25)
+                    {
+                        printf(MSG_PARAM_INVALID_ENTRY, argv[i]);
+                        return 1;
+                    }
+                    param->entry = param->entry * 10 + (*p - '0');
+                }
+                break;
+
             //
             // 未定義のオプション
             //            
@@ -34,7 +34,7 @@
 #ifndef _INCLUDE_PARAM_H_
 #define _INCLUDE_PARAM_H_
 
-#include "..\..\lib\types.h"
+#include "../../lib/types.h"
 
 typedef struct {
     int         use_conf_file;
@@ -43,9 +43,12 @@ typedef struct {
     int         help_flag;
     int         nofile_flag;
     int         disable_header_flag;
+    int         verify_flag;
     uint8_t     sltnum;
+    uint8_t     entry;
     char        rom_type[32];
     char        rom_file[256];
+    char        db_file[64];
 } MAIN_PARAM_t;
 
 int parse_param(MAIN_PARAM_t *param, int argc, char *argv[]);
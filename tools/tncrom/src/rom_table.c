@@ -32,8 +32,8 @@
 //
 
 #include <string.h>
-#include "..\..\lib\tools.h"
-#include "..\..\lib\rom_tools.h"
+#include "../../lib/tools.h"
+#include "../../lib/rom_tools.h"
 
 /***********************************************
  * NORMAL 32KB
@@ -43,11 +43,16 @@ const ROM_ATTR_t ROM_ATTR_NORMAL32 = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0x0000,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "NO BANK 32KB"
 };
 
@@ -59,11 +64,16 @@ const ROM_ATTR_t ROM_ATTR_NORMAL16_P1 = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0x0000,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "NO BANK 16KB(4000h~)"
 };
 
@@ -75,11 +85,16 @@ const ROM_ATTR_t ROM_ATTR_NORMAL16_P2 = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0x0000,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "NO BANK 16KB(8000h~)"
 };
 
@@ -91,11 +106,16 @@ const ROM_ATTR_t ROM_ATTR_ASCII16 = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x7000, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "ASCII 16KB"
 };
 
@@ -107,11 +127,16 @@ const ROM_ATTR_t ROM_ATTR_ASCII8 = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x6800, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x7000, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x7800, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x6800, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7800, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "ASCII 8KB"
 };
 
@@ -123,11 +148,16 @@ const ROM_ATTR_t ROM_ATTR_KONAMI = {
     (uint8_t)0x3F,                                  // BANK VALUE MASK
     (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0x5000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x7000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x9000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xB000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0x5000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x9000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xB000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "KONAMI 8KB with SCC sound"                     // NAME
 };
 
@@ -139,11 +169,16 @@ const ROM_ATTR_t ROM_ATTR_KONAMI_SCC_I = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0x5000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x7000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x9000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xB000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0x5000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x9000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xB000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "KONAMI SCC-I"                                  // NAME
 };
 
@@ -155,11 +190,16 @@ const ROM_ATTR_t ROM_ATTR_KONAMI_wo_SCC = {
     (uint8_t)0x3F,                                  // BANK VALUE MASK
     (uint16_t)0xE000,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x6000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x8000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xA000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x6000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x8000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xA000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "KONAMI 8KB without SCC sound"                  // NAME
 };
 
@@ -171,14 +211,173 @@ const ROM_ATTR_t ROM_ATTR_RTYPE = {
     (uint8_t)0xFF,                                  // BANK VALUE MASK
     (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
     {
-        { (uint16_t)0x6000, 15, 0 },                // BANK #0 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0x7000,  0, 0 },                // BANK #1 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF,  0, 0 },                // BANK #2 REGISTER ADDRESS, INITIAL VALUE, RESERVED
-        { (uint16_t)0xFFFF,  0, 0 }                 // BANK #3 REGISTER ADDRESS, INITIAL VALUE, RESERVED
+        { (uint16_t)0x6000, 15, 0 },                // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000,  0, 0 },                // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF,  0, 0 },                // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF,  0, 0 }                 // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
     },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
     "ASCII 16KB(R-TYPE)"
 };
 
+/***********************************************
+ * NEO-8 (12bit 8KB bank, 4000h~BFFFh only)
+ *  5000h~7FFFh(1000h/9000h/D000h mirror) : even=low byte, odd=high byte
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_NEO8 = {
+    (uint8_t)(FLAG_WRITE_PROTECT),                  // FLAGS
+    (uint8_t)0xFF,                                  // BANK VALUE MASK
+    (uint16_t)0x3801,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0x2000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x2800, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x3000, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x3800, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x0F,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0001,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
+    "NEO-8 8KB"
+};
+
+/***********************************************
+ * NEO-16 (12bit 16KB bank, 4000h~BFFFh only)
+ *  5000h~7FFFh(1000h/9000h/D000h mirror) : even=low byte, odd=high byte
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_NEO16 = {
+    (uint8_t)(FLAG_WRITE_PROTECT | FLAG_BANK_SIZE), // FLAGS
+    (uint8_t)0xFF,                                  // BANK VALUE MASK
+    (uint16_t)0x3001,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0x2000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x3000, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x0F,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0001,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x00,                                  // SRAM SELECT BIT
+    (uint8_t)0x00,                                  // SRAM FLAGS
+    (uint8_t)0x00,                                  // SRAM ADDRESS MASK(HIGH)
+    "NEO-16 16KB"
+};
+
+/***********************************************
+ * ASCII 8KB with 8KB SRAM
+ *  SRAM select bit = ROM bank count, SRAM write : 8000h~BFFFh
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_ASCII8_SRAM = {
+    (uint8_t)(FLAG_WRITE_PROTECT),                  // FLAGS
+    (uint8_t)0xFF,                                  // BANK VALUE MASK
+    (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x6800, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7800, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)SRAM_MASK_ROM_SIZE,                    // SRAM SELECT BIT
+    (uint8_t)(SRAM_FLAG_WRITE_8000 | SRAM_FLAG_WRITE_A000), // SRAM FLAGS
+    (uint8_t)0x1F,                                  // SRAM ADDRESS MASK(HIGH)
+    "ASCII 8KB with SRAM"
+};
+
+/***********************************************
+ * KOEI (ASCII 8KB with 8KB SRAM)
+ *  SRAM select bit = ROM bank count, SRAM write : 4000h~5FFFh, 8000h~BFFFh
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_KOEI = {
+    (uint8_t)(FLAG_WRITE_PROTECT),                  // FLAGS
+    (uint8_t)0xFF,                                  // BANK VALUE MASK
+    (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x6800, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7800, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)SRAM_MASK_ROM_SIZE,                    // SRAM SELECT BIT
+    (uint8_t)(SRAM_FLAG_WRITE_4000 | SRAM_FLAG_WRITE_8000 | SRAM_FLAG_WRITE_A000), // SRAM FLAGS
+    (uint8_t)0x1F,                                  // SRAM ADDRESS MASK(HIGH)
+    "KOEI 8KB with SRAM"
+};
+
+/***********************************************
+ * ASCII 16KB with 2KB SRAM
+ *  SRAM select bit = 10h, SRAM write : 8000h~BFFFh
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_ASCII16_SRAM2 = {
+    (uint8_t)(FLAG_WRITE_PROTECT | FLAG_BANK_SIZE), // FLAGS
+    (uint8_t)0xFF,                                  // BANK VALUE MASK
+    (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x10,                                  // SRAM SELECT BIT
+    (uint8_t)(SRAM_FLAG_WRITE_8000 | SRAM_FLAG_WRITE_A000), // SRAM FLAGS
+    (uint8_t)0x07,                                  // SRAM ADDRESS MASK(HIGH)
+    "ASCII 16KB with 2KB SRAM"
+};
+
+/***********************************************
+ * ASCII 16KB with 8KB SRAM
+ *  SRAM select bit = ROM bank count, SRAM write : 8000h~BFFFh
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_ASCII16_SRAM8 = {
+    (uint8_t)(FLAG_WRITE_PROTECT | FLAG_BANK_SIZE), // FLAGS
+    (uint8_t)0xFF,                                  // BANK VALUE MASK
+    (uint16_t)0xF800,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0x6000, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x7000, 0, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xFFFF, 0, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)SRAM_MASK_ROM_SIZE,                    // SRAM SELECT BIT
+    (uint8_t)(SRAM_FLAG_WRITE_8000 | SRAM_FLAG_WRITE_A000), // SRAM FLAGS
+    (uint8_t)0x1F,                                  // SRAM ADDRESS MASK(HIGH)
+    "ASCII 16KB with 8KB SRAM"
+};
+
+/***********************************************
+ * KONAMI GAME MASTER 2 (8KB SRAM)
+ *  bit4 = SRAM, bit5 = SRAM 4KB page, SRAM write : B000h~BFFFh
+ ***********************************************/
+const ROM_ATTR_t ROM_ATTR_GAME_MASTER2 = {
+    (uint8_t)(FLAG_WRITE_PROTECT),                  // FLAGS
+    (uint8_t)0x0F,                                  // BANK VALUE MASK
+    (uint16_t)0xF000,                               // BANK REGISTER ADDRESS MASK
+    {
+        { (uint16_t)0xFFFF, 0, 0 },                 // BANK #0 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x6000, 1, 0 },                 // BANK #1 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0x8000, 2, 0 },                 // BANK #2 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+        { (uint16_t)0xA000, 3, 0 }                  // BANK #3 REGISTER ADDRESS, INITIAL VALUE, INITIAL VALUE(HIGH)
+    },
+    (uint8_t)0x00,                                  // BANK VALUE MASK(HIGH)
+    (uint16_t)0x0000,                               // HIGH BANK REGISTER ADDRESS(XOR)
+    (uint8_t)0x10,                                  // SRAM SELECT BIT
+    (uint8_t)(SRAM_FLAG_WRITE_A000 | SRAM_FLAG_PAGE_4K), // SRAM FLAGS
+    (uint8_t)0x1F,                                  // SRAM ADDRESS MASK(HIGH)
+    "KONAMI GAME MASTER 2 with SRAM"
+};
+
 /***********************************************
  * TABLE
  ***********************************************/
@@ -192,5 +391,12 @@ const KEYWORD_PARAM_t    rom_attr_table[] = {
     {   "KONAMI_SCC_I",  (void*)&ROM_ATTR_KONAMI_SCC_I },
     {   "KONAMI_WO_SCC", (void*)&ROM_ATTR_KONAMI_wo_SCC},
     {   "R-TYPE",        (void*)&ROM_ATTR_RTYPE        },
+    {   "NEO8",          (void*)&ROM_ATTR_NEO8         },
+    {   "NEO16",         (void*)&ROM_ATTR_NEO16        },
+    {   "ASCII8_SRAM",   (void*)&ROM_ATTR_ASCII8_SRAM  },
+    {   "ASCII16_SRAM2", (void*)&ROM_ATTR_ASCII16_SRAM2},
+    {   "ASCII16_SRAM8", (void*)&ROM_ATTR_ASCII16_SRAM8},
+    {   "KOEI",          (void*)&ROM_ATTR_KOEI         },
+    {   "GAME_MASTER2",  (void*)&ROM_ATTR_GAME_MASTER2 },
     {   NULL,            NULL                          }
 };
@@ -34,10 +34,16 @@
 #ifndef _INCLUDE_ROM_TABLE_H_
 #define _INCLUDE_ROM_TABLE_H_
 
-#include "..\..\lib\tools.h"
-#include "..\..\lib\rom_tools.h"
+#include "../../lib/tools.h"
+#include "../../lib/rom_tools.h"
 
+extern const ROM_ATTR_t ROM_ATTR_NORMAL32;
+extern const ROM_ATTR_t ROM_ATTR_NORMAL16_P1;
+extern const ROM_ATTR_t ROM_ATTR_NORMAL16_P2;
 extern const ROM_ATTR_t ROM_ATTR_ASCII16;
+extern const ROM_ATTR_t ROM_ATTR_ASCII8;
+extern const ROM_ATTR_t ROM_ATTR_KONAMI;
+extern const ROM_ATTR_t ROM_ATTR_KONAMI_wo_SCC;
 extern const KEYWORD_PARAM_t rom_attr_table[];
 
 #endif
@@ -0,0 +1,162 @@
+//
+// romdb.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#include <string.h>
+#include "../../lib/types.h"
+#include "../../lib/bdos.h"
+#include "romdb.h"
+
+static BDOS_FILE_t db_file;         // データベースファイルアクセス用
+static uint32_t db_count = 0;       // レコード数
+static int db_opened = 0;           // オープン済みフラグ
+static uint32_t db_cached = 0;      // file.buffer に読み込み済みのブロック番号 + 1 (0 なら未読み込み)
+
+/***********************************************
+ * レコード読み出し
+ *  128 バイト単位で読み出すので、ブロックには 2 レコード入っている
+ *  直前と同じブロックなら読み出しを省略する
+ *  引数
+ *    index     : 読み出すレコード番号(0 はヘッダ)
+ *  戻り値
+ *    レコードのポインタ(NULL なら読み出し失敗)
+ ***********************************************/
+static uint8_t *read_record(uint32_t index)
+{
+    uint32_t block = index >> 1;
+    uint16_t readed;
+
+    if(db_cached != block + 1)
+    {
+        db_cached = 0;
+        if(bdos_fseek(&db_file, block << 7)) return NULL;
+        if(bdos_fread(&db_file, &readed)) return NULL;
+        if(readed < (uint16_t)((index & 1) ? 128 : 64)) return NULL;
+        db_cached = block + 1;
+    }
+
+    return db_file.buffer + ((index & 1) ? ROMDB_RECORD_SIZE : 0);
+}
+
+/***********************************************
+ * データベースファイルを開く
+ *  引数
+ *    path      : データベースファイルのパス
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗(ファイルが無いか形式が違う)
+ ***********************************************/
+int romdb_open(char *path)
+{
+    int res;
+    ROMDB_HEADER_t *header;
+
+    romdb_close();
+
+    if(0 != (res = bdos_fopen(&db_file, path))) return res;
+    db_opened = 1;
+    db_cached = 0;
+
+    // ヘッダ確認
+    header = (ROMDB_HEADER_t*)read_record(0);
+    if(header == NULL
+    || memcmp(header->magic, ROMDB_MAGIC, sizeof(header->magic)) != 0
+    || header->version != ROMDB_VERSION
+    || header->record_size != ROMDB_RECORD_SIZE)
+    {
+        romdb_close();
+        return 1;
+    }
+    db_count = header->count;
+
+    return 0;
+}
+
+/***********************************************
+ * データベースファイルを閉じる
+ ***********************************************/
+void romdb_close(void)
+{
+    if(db_opened)
+    {
+        bdos_fclose(&db_file);
+        db_opened = 0;
+    }
+}
+
+/***********************************************
+ * レコード検索
+ *  (CRC32, サイズ) を二分探索する
+ *  レコード数が 4096 でも 128 バイトの読み出し 12 回程度で見つかる
+ *  引数
+ *    crc       : ROM イメージの CRC32
+ *    size      : ROM イメージのサイズ
+ *    record    : 見つかったレコードの格納先
+ *  戻り値
+ *    0  : 見つかった
+ *    !0 : 見つからない
+ ***********************************************/
+int romdb_lookup(uint32_t crc, uint32_t size, ROMDB_RECORD_t *record)
+{
+    uint32_t lo = 0;
+    uint32_t hi = db_count;
+
+    if(!db_opened) return 1;
+
+    while(lo < hi)
+    {
+        uint32_t mid = (lo + hi) >> 1;
+
+        // レコード番号 0 はヘッダなので +1
+        ROMDB_RECORD_t *p = (ROMDB_RECORD_t*)read_record(mid + 1);
+        if(p == NULL) return 1;
+
+        if(p->crc < crc || (p->crc == crc && p->size < size))
+        {
+            lo = mid + 1;
+        }
+        else if(p->crc == crc && p->size == size)
+        {
+            memcpy(record, p, sizeof(ROMDB_RECORD_t));
+            record->type[sizeof(record->type) - 1] = '\0';
+            record->title[sizeof(record->title) - 1] = '\0';
+            return 0;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,74 @@
+//
+// romdb.h
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#ifndef _INCLUDE_ROMDB_H_
+#define _INCLUDE_ROMDB_H_
+
+#include "../../lib/types.h"
+
+//
+// ROM データベースファイル(TNCROM.DB)
+//  Linux で tools/tncrom/host/mkromdb.c を使って softwaredb 形式の XML から作成する
+//  64 バイト固定長で、先頭はヘッダ、続いて (CRC32, サイズ) の昇順に並べたレコード
+//  数値はすべてリトルエンディアン
+//
+#define ROMDB_MAGIC             "TNCROMDB"
+#define ROMDB_VERSION           (1)
+#define ROMDB_RECORD_SIZE       (64)
+
+#define ROMDB_QUIRK_SCC         (1<<0)      // SCC 音源を有効にする
+#define ROMDB_QUIRK_WRITABLE    (1<<1)      // ROM 領域への書き込みを許可する
+
+typedef struct {
+    char        magic[8];       // "TNCROMDB"
+    uint16_t    version;        // ROMDB_VERSION
+    uint16_t    record_size;    // ROMDB_RECORD_SIZE
+    uint32_t    count;          // レコード数
+    uint8_t     reserved[48];
+} ROMDB_HEADER_t;
+
+typedef struct {
+    uint32_t    crc;            // ROM イメージ全体の CRC32
+    uint32_t    size;           // ROM イメージのサイズ
+    uint8_t     quirks;         // ROMDB_QUIRK_*
+    uint8_t     reserved[3];
+    char        type[16];       // ROM タイプ識別子(NUL 終端)
+    char        title[36];      // タイトル(NUL 終端)
+} ROMDB_RECORD_t;
+
+int romdb_open(char *path);
+void romdb_close(void);
+int romdb_lookup(uint32_t crc, uint32_t size, ROMDB_RECORD_t *record);
+
+#endif
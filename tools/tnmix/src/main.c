@@ -0,0 +1,415 @@
+//
+// main.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// zcc +msx -subtype=msxdos -O3 -o../bin/TNMIX.COM main.c ..\..\lib\tools.c ..\..\lib\rom_tools.c
+
+#include <stdio.h>
+#include <string.h>
+#include "..\..\lib\types.h"
+#include "..\..\lib\tools.h"
+#include "..\..\lib\rom_tools.h"
+#include "message.h"
+
+#define VERSION (1)
+
+//
+// MEGAROM_CONFIGURE のレジスタ
+//
+#define REG_XFER_RAM_ADDR       (0x0020)
+#define REG_XFER_FLASH_ADDR     (0x0023)
+#define REG_XFER_SIZE           (0x0026)
+#define REG_XFER_WDATA          (0x0029)
+#define REG_XFER_CONTROL        (0x003F)
+#define REG_XFER_STATUS         (0x003F)
+#define REG_MIXER_GAIN          (0x0040)
+#define REG_MIXER_FLASH_ADDR    (0x0050)
+#define REG_MIXER_RAM_ADDR      (0x0052)
+
+#define STATUS_BUSY             (1<<0)
+
+#define GAIN_COUNT              (8)
+#define GAIN_MAX                (0x0FFF)
+#define SAVE_SIZE               (GAIN_COUNT * 2 + 2)
+
+//
+// 音量の名前とレジスタ番号
+//  番号 = 出力(EXT=0, INT=1) x 4 + 入力(SCC=0, FM 内蔵=1, FM 外部=2, PSG=3)
+//
+typedef const struct {
+    char        *name;
+    uint8_t     index;
+} GAIN_NAME_t;
+
+static GAIN_NAME_t gain_name_table[] = {
+    { "EXT.SCC", 0 },
+    { "EXT.FM",  2 },
+    { "EXT.PSG", 3 },
+    { "INT.SCC", 4 },
+    { "INT.FM",  5 },
+    { "INT.PSG", 7 },
+    { NULL,      0 }
+};
+
+//
+// パラメータ
+//
+typedef struct {
+    uint8_t     help_flag;
+    uint8_t     save_flag;
+    uint8_t     clear_flag;
+    uint8_t     sltnum;
+    uint8_t     gain_count;
+    uint8_t     gain_index[GAIN_COUNT];
+    uint16_t    gain_value[GAIN_COUNT];
+} MAIN_PARAM_t;
+
+static MAIN_PARAM_t main_param;     // パラメータ
+
+/***********************************************
+ * 音量レジスタ
+ ***********************************************/
+static uint16_t read_gain(uint8_t sltnum, uint8_t index)
+{
+    uint16_t addr = REG_MIXER_GAIN + index * 2;
+    return (uint16_t)rdslt(sltnum, addr) | ((uint16_t)rdslt(sltnum, addr + 1) << 8);
+}
+
+static void write_gain(uint8_t sltnum, uint8_t index, uint16_t gain)
+{
+    uint16_t addr = REG_MIXER_GAIN + index * 2;
+    wrtslt(sltnum, addr, (uint8_t)gain);
+    wrtslt(sltnum, addr + 1, (uint8_t)(gain >> 8));
+}
+
+/***********************************************
+ * 音量レジスタがあるかチェック
+ *  上位バイトの未使用ビットは常に 0 になる
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int check_mixer(uint8_t sltnum)
+{
+    for(uint8_t i = 0; i < GAIN_COUNT; i++)
+    {
+        if(read_gain(sltnum, i) > GAIN_MAX) return -1;
+    }
+    return 0;
+}
+
+/***********************************************
+ * 転送レジスタ
+ ***********************************************/
+static void write_reg24(uint8_t sltnum, uint16_t addr, uint32_t val)
+{
+    wrtslt(sltnum, addr + 0, (uint8_t)val);
+    wrtslt(sltnum, addr + 1, (uint8_t)(val >> 8));
+    wrtslt(sltnum, addr + 2, (uint8_t)(val >> 16));
+}
+
+static uint32_t read_addr(uint8_t sltnum, uint16_t addr)
+{
+    return ((uint32_t)rdslt(sltnum, addr) << 8) | ((uint32_t)rdslt(sltnum, addr + 1) << 16);
+}
+
+/***********************************************
+ * 転送コマンド実行
+ *  引数
+ *    sltnum    : スロット番号
+ *    cmd       : コマンド文字列("@FL\r" 等)
+ ***********************************************/
+static void xfer_command(uint8_t sltnum, char *cmd)
+{
+    while(*cmd != '\0') wrtslt(sltnum, REG_XFER_CONTROL, *cmd++);
+    while(rdslt(sltnum, REG_XFER_STATUS) & STATUS_BUSY);
+}
+
+/***********************************************
+ * 音量をフラッシュに保存
+ *  作業領域へ 1バイトずつ書いてから、セクタを消去して書き込む
+ *   +0~+15 : 音量
+ *   +16    : 合計
+ *   +17    : 合計の反転
+ ***********************************************/
+static void save_gains(uint8_t sltnum)
+{
+    uint32_t ram_addr = read_addr(sltnum, REG_MIXER_RAM_ADDR);
+    uint32_t flash_addr = read_addr(sltnum, REG_MIXER_FLASH_ADDR);
+    uint8_t sum = 0;
+
+    write_reg24(sltnum, REG_XFER_SIZE, 1);
+    for(uint8_t i = 0; i < SAVE_SIZE; i++)
+    {
+        uint8_t data;
+        if(i < GAIN_COUNT * 2)          data = rdslt(sltnum, REG_MIXER_GAIN + i);
+        else if(i == GAIN_COUNT * 2)    data = sum;
+        else                            data = ~sum;
+        if(i < GAIN_COUNT * 2) sum += data;
+
+        write_reg24(sltnum, REG_XFER_RAM_ADDR, ram_addr + i);
+        wrtslt(sltnum, REG_XFER_WDATA, data);
+        xfer_command(sltnum, "@FL\r");
+    }
+
+    write_reg24(sltnum, REG_XFER_FLASH_ADDR, flash_addr);
+    xfer_command(sltnum, "@ES\r");
+
+    write_reg24(sltnum, REG_XFER_RAM_ADDR, ram_addr);
+    write_reg24(sltnum, REG_XFER_SIZE, SAVE_SIZE);
+    xfer_command(sltnum, "@WR\r");
+}
+
+/***********************************************
+ * 保存した音量を消去
+ ***********************************************/
+static void clear_gains(uint8_t sltnum)
+{
+    write_reg24(sltnum, REG_XFER_FLASH_ADDR, read_addr(sltnum, REG_MIXER_FLASH_ADDR));
+    xfer_command(sltnum, "@ES\r");
+}
+
+/***********************************************
+ * 音量出力
+ ***********************************************/
+static void output_gains(uint8_t sltnum)
+{
+    for(GAIN_NAME_t *p = gain_name_table; p->name != NULL; p++)
+    {
+        uint16_t gain = read_gain(sltnum, p->index);
+        printf(MSG_GAIN, p->name, gain, (unsigned int)(((uint32_t)gain * 100 + 512) >> 10));
+    }
+}
+
+/***********************************************
+ * 音量パラメータ取得
+ *  引数
+ *    param     : パラメータ構造体
+ *    p         : "名前=値" 形式の文字列
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int get_gain_param(MAIN_PARAM_t *param, char *p)
+{
+    char name[16];
+    char *value = strchr(p, '=');
+    uint32_t val;
+
+    if(value == NULL || (size_t)(value - p) >= sizeof(name))
+    {
+        printf(MSG_PARAM_UNKNOWN_NAME, p);
+        return 1;
+    }
+    memcpy(name, p, value - p);
+    name[value - p] = '\0';
+    value++;
+
+    GAIN_NAME_t *n = gain_name_table;
+    while(n->name != NULL && strcmpi(n->name, name) != 0) n++;
+    if(n->name == NULL)
+    {
+        printf(MSG_PARAM_UNKNOWN_NAME, name);
+        return 1;
+    }
+
+    if(get_hex(&val, value, 3))
+    {
+        printf(MSG_PARAM_INVALID_GAIN, value);
+        return 1;
+    }
+
+    if(param->gain_count >= GAIN_COUNT)
+    {
+        printf(MSG_PARAM_TOO_MANY);
+        return 1;
+    }
+    param->gain_index[param->gain_count] = n->index;
+    param->gain_value[param->gain_count] = (uint16_t)val;
+    param->gain_count++;
+    return 0;
+}
+
+/***********************************************
+ * コマンドラインのチェック
+ *  引数
+ *    param     : パラメータ構造体
+ *    argc      :
+ *    argv      :
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int parse_param(MAIN_PARAM_t *param, int argc, char *argv[])
+{
+    uint8_t next_state = 0;
+
+    memset(param, 0, sizeof(MAIN_PARAM_t));
+    param->sltnum = 0xFF;
+
+    for(int i = 1; i < argc; i++)
+    {
+        uint8_t state = 0;
+        if(next_state == 0 && (argv[i][0] == '/' || argv[i][0] == '-'))
+        {
+            //
+            // オプションスイッチ処理
+            //
+            state = argv[i][1];
+            if(state >= 'a' && state <= 'z') state &= ~0x20;
+
+            // パラメータ付き?
+            switch(state)
+            {
+                case 'S':
+                    next_state = state;
+                    state = 0;
+                    break;
+            }
+        }
+        else if(next_state != 0)
+        {
+            //
+            // 次回処理が指定されていた場合
+            //
+            state = next_state;                     // 今回処理する内容
+            next_state = 0;                         // 次回は何もしない
+        }
+        else
+        {
+            //
+            // オプションスイッチなしで指定されたパラメータは音量として処理する
+            //
+            if(get_gain_param(param, argv[i])) return 1;
+        }
+
+        switch(state)
+        {
+            case 0:
+                break;
+
+            case 'H':
+                param->help_flag = 1;
+                break;
+
+            case 'W':
+                param->save_flag = 1;
+                break;
+
+            case 'C':
+                param->clear_flag = 1;
+                break;
+
+            case 'S':
+                if(get_sltnum(&param->sltnum, argv[i]))
+                {
+                    printf(MSG_PARAM_INVALID_SLOT, argv[i]);
+                    return 1;
+                }
+                break;
+
+            default:
+                printf(MSG_PARAM_UNKNOWN, state);
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+/***********************************************
+ * main
+ ***********************************************/
+int main(int argc, char *argv[])
+{
+    // バージョン出力
+    printf(MSG_VERSION, VERSION / 100, VERSION % 100);
+
+    // コマンドラインをパース
+    if(parse_param(&main_param, argc, argv)) return 1;
+
+    // ヘルプ出力
+    if(main_param.help_flag)
+    {
+        printf(MSG_USAGE);
+        printf(MSG_HELP);
+        return 0;
+    }
+
+    // コマンドラインでカートリッジスロットが指定されていない場合はカートリッジを探す
+    if(main_param.sltnum == (uint8_t)0xFF)
+    {
+        if(search_cartridge(&main_param.sltnum))
+        {
+            printf(MSG_CARTRIDGE_NOT_FOUND);
+            return 1;
+        }
+    }
+
+    char buff[8];
+    printf(MSG_PROP_SLOT, slot_to_str(buff, sizeof(buff), main_param.sltnum));
+
+    int res = 0;
+    unlock_megarom_configure(main_param.sltnum);
+    if(check_mixer(main_param.sltnum))
+    {
+        printf(MSG_NOT_SUPPORTED);
+        res = 1;
+    }
+    else
+    {
+        // 音量を設定
+        for(uint8_t i = 0; i < main_param.gain_count; i++)
+        {
+            write_gain(main_param.sltnum, main_param.gain_index[i], main_param.gain_value[i]);
+        }
+
+        // 保存/消去
+        if(main_param.clear_flag)
+        {
+            printf(MSG_CLEAR);
+            clear_gains(main_param.sltnum);
+        }
+        if(main_param.save_flag)
+        {
+            printf(MSG_SAVE);
+            save_gains(main_param.sltnum);
+        }
+
+        output_gains(main_param.sltnum);
+        printf(MSG_COMPLETE);
+    }
+    lock_megarom_configure(main_param.sltnum);
+
+    return res;
+}
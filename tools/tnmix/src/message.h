@@ -0,0 +1,64 @@
+//
+// message.h
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef _INCLUDE_MESSAGE_H_
+#define _INCLUDE_MESSAGE_H_
+
+#define MSG_VERSION             "Mixer setting for tnCart v%d.%02d\n"\
+                                "\n"
+#define MSG_USAGE               "USAGE: TNMIX {-S [SLOT]} {-W} {-C} {[NAME]=[GAIN]}\n"
+#define MSG_HELP                "OPTION:\n"\
+                                "  -H           show help message\n"\
+                                "  -S [slot]    set slot number\n"\
+                                "  -W           save gains to flash memory\n"\
+                                "  -C           clear saved gains\n"\
+                                "               (use default at next power on)\n"\
+                                "NAME:\n"\
+                                "  EXT.SCC EXT.FM EXT.PSG INT.SCC INT.FM INT.PSG\n"\
+                                "GAIN:\n"\
+                                "  hex, 400 = 0dB\n"
+#define MSG_CARTRIDGE_NOT_FOUND "cartridge not found.\n"
+#define MSG_NOT_SUPPORTED       "mixer registers not supported.\n"
+#define MSG_PROP_SLOT           "SLOT     : %s\n"
+#define MSG_GAIN                "%-8s : %03X (%u%%)\n"
+#define MSG_SAVE                "saving gains.\n"
+#define MSG_CLEAR               "clearing saved gains.\n"
+#define MSG_COMPLETE            "complete.\n"
+
+#define MSG_PARAM_INVALID_SLOT  "invalid slot format(%s).\n"
+#define MSG_PARAM_INVALID_GAIN  "invalid gain(%s).\n"
+#define MSG_PARAM_UNKNOWN_NAME  "unknown name(%s).\n"
+#define MSG_PARAM_TOO_MANY      "too many gains.\n"
+#define MSG_PARAM_UNKNOWN       "unknwon option(-%c)\n"
+
+#endif
@@ -0,0 +1,190 @@
+//
+// trcdec.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Linux 用 バストレースデコーダ
+//  TNTRACE -W で保存したファイルを読みやすい形式に変換し、アドレス毎のアクセス回数を集計する
+//
+// cc -O2 -o trcdec trcdec.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ENTRY_SIZE      (8)
+#define TYPE_WRITE      (1<<0)
+#define TYPE_IO         (1<<1)
+#define TYPE_M1         (1<<2)
+#define TYPE_SLOT       (1<<3)
+
+#define KIND_MEM_RD     (0)
+#define KIND_MEM_WR     (1)
+#define KIND_IO_RD      (2)
+#define KIND_IO_WR      (3)
+#define KIND_M1         (4)
+#define KIND_COUNT      (5)
+
+static const char *kind_name[KIND_COUNT] = { "MEM RD", "MEM WR", "IO RD ", "IO WR ", "M1    " };
+
+typedef struct {
+    uint16_t    addr;
+    uint8_t     data;
+    uint8_t     type;
+    uint32_t    time;
+} ENTRY_t;
+
+typedef struct {
+    uint32_t    count;
+    uint32_t    addr;
+} HOTSPOT_t;
+
+static uint32_t counts[KIND_COUNT][65536];
+
+static int get_kind(const ENTRY_t *e)
+{
+    if(e->type & TYPE_IO) return (e->type & TYPE_WRITE) ? KIND_IO_WR : KIND_IO_RD;
+    if(e->type & TYPE_WRITE) return KIND_MEM_WR;
+    if(e->type & TYPE_M1) return KIND_M1;
+    return KIND_MEM_RD;
+}
+
+static int compare_hotspot(const void *a, const void *b)
+{
+    const HOTSPOT_t *p = a;
+    const HOTSPOT_t *q = b;
+    if(p->count != q->count) return (p->count < q->count) ? 1 : -1;
+    return (p->addr > q->addr) ? 1 : -1;
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: trcdec [-q] [-n count] file\n"
+                    "  -q        do not print trace, statistics only\n"
+                    "  -n count  number of hot spots to print per kind (default 16)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = NULL;
+    int quiet = 0;
+    int top = 16;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "-q") == 0) quiet = 1;
+        else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) top = atoi(argv[++i]);
+        else if(argv[i][0] == '-') { usage(); return 1; }
+        else path = argv[i];
+    }
+    if(path == NULL) { usage(); return 1; }
+
+    // 表示件数はアドレス空間(64KB)の範囲に収める
+    if(top < 0) top = 0;
+    if(top > 65536) top = 65536;
+
+    FILE *fp = fopen(path, "rb");
+    if(fp == NULL) { perror(path); return 1; }
+
+    // 読み込み
+    ENTRY_t *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    uint8_t raw[ENTRY_SIZE];
+    while(fread(raw, 1, sizeof(raw), fp) == sizeof(raw))
+    {
+        if(count == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 4096;
+            entries = realloc(entries, capacity * sizeof(ENTRY_t));
+            if(entries == NULL) { perror("realloc"); return 1; }
+        }
+        ENTRY_t *e = &entries[count++];
+        e->addr = (uint16_t)(raw[0] | (raw[1] << 8));
+        e->data = raw[2];
+        e->type = raw[3];
+        e->time = (uint32_t)raw[4] | ((uint32_t)raw[5] << 8) | ((uint32_t)raw[6] << 16) | ((uint32_t)raw[7] << 24);
+    }
+    fclose(fp);
+
+    // MSX-DOS の 128 バイト単位の書き込みで付いた末尾の 0 を除く
+    while(count > 0)
+    {
+        const ENTRY_t *e = &entries[count - 1];
+        if(e->addr || e->data || e->type || e->time) break;
+        count--;
+    }
+
+    // トレース出力
+    uint32_t first = count ? entries[0].time : 0;
+    uint32_t prev = first;
+    if(!quiet) printf("    #       clock   delta  kind   addr data\n");
+    for(size_t i = 0; i < count; i++)
+    {
+        const ENTRY_t *e = &entries[i];
+        int kind = get_kind(e);
+        counts[kind][e->addr]++;
+        if(!quiet)
+        {
+            printf("%5zu %11u %7u  %s %04X %02X%s\n",
+                    i, e->time - first, e->time - prev, kind_name[kind], e->addr, e->data,
+                    (e->type & TYPE_SLOT) ? " *" : "");
+        }
+        prev = e->time;
+    }
+
+    // 集計出力
+    printf("\n%zu entries, %u clocks (%.3f ms at 3.579545MHz)\n",
+            count, prev - first, (double)(prev - first) / 3579.545);
+    for(int kind = 0; kind < KIND_COUNT; kind++)
+    {
+        static HOTSPOT_t hot[65536];
+        uint32_t total = 0;
+        for(uint32_t addr = 0; addr < 65536; addr++)
+        {
+            hot[addr].count = counts[kind][addr];
+            hot[addr].addr = addr;
+            total += hot[addr].count;
+        }
+        if(total == 0) continue;
+        qsort(hot, 65536, sizeof(HOTSPOT_t), compare_hotspot);
+
+        printf("\n%s: %u accesses\n", kind_name[kind], total);
+        for(int i = 0; i < top && hot[i].count > 0; i++)
+        {
+            printf("  %04X %10u %6.2f%%\n", hot[i].addr, hot[i].count, hot[i].count * 100.0 / total);
+        }
+    }
+
+    free(entries);
+    return 0;
+}
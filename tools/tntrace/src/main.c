@@ -0,0 +1,447 @@
+//
+// main.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// zcc +msx -subtype=msxdos -O3 -o../bin/TNTRACE.COM main.c ..\..\lib\bdos.c ..\..\lib\tools.c ..\..\lib\port.c
+
+#include <stdio.h>
+#include <string.h>
+#include "..\..\lib\types.h"
+#include "..\..\lib\bdos.h"
+#include "..\..\lib\tools.h"
+#include "..\..\lib\port.h"
+#include "message.h"
+
+#define VERSION (1)
+
+//
+// バストレーサーの I/O ポート
+//
+#define PORT_INDEX              (0x2A)      // W: レジスタ番号, R: ステータス
+#define PORT_DATA               (0x2B)      // RW: レジスタ
+
+#define REG_CONTROL             (0x00)
+#define REG_FILTER              (0x01)
+#define REG_MATCH               (0x02)
+#define REG_MASK                (0x04)
+#define REG_TRIG                (0x06)
+#define REG_TRIG_TYPE           (0x08)
+#define REG_POST                (0x09)
+#define REG_WPTR                (0x0B)
+#define REG_DROP                (0x0E)
+#define REG_SIZE                (0x0F)
+#define REG_RPTR                (0x10)
+#define REG_READ_DATA           (0x13)
+
+#define CONTROL_RUN             (1<<0)
+#define CONTROL_TRIG_EN         (1<<1)
+#define CONTROL_CLEAR           (1<<7)
+
+#define STATUS_RUN              (1<<0)
+#define STATUS_TRIGGERED        (1<<1)
+#define STATUS_WRAPPED          (1<<2)
+#define STATUS_BUSY             (1<<7)
+
+#define ENTRY_SIZE              (8)
+
+//
+// パラメータ
+//
+typedef struct {
+    uint8_t     help_flag;
+    uint8_t     start_flag;
+    uint8_t     stop_flag;
+    uint8_t     filter_flag;
+    uint8_t     trigger_flag;
+    uint8_t     filter;
+    uint16_t    match;
+    uint16_t    mask;
+    uint16_t    trig_addr;
+    uint8_t     trig_type;
+    uint16_t    post_count;
+    char        save_file[64];
+} MAIN_PARAM_t;
+
+static MAIN_PARAM_t main_param;     // パラメータ
+static BDOS_FILE_t save_file;       // 保存ファイル
+
+/***********************************************
+ * レジスタ書き込み
+ ***********************************************/
+static void write_reg(uint8_t index, uint8_t data)
+{
+    port_write(PORT_INDEX, index);
+    port_write(PORT_DATA, data);
+}
+
+static void write_reg16(uint8_t index, uint16_t data)
+{
+    port_write(PORT_INDEX, index);
+    port_write(PORT_DATA, (uint8_t)data);
+    port_write(PORT_DATA, (uint8_t)(data >> 8));
+}
+
+/***********************************************
+ * レジスタ読み込み
+ ***********************************************/
+static uint8_t read_reg(uint8_t index)
+{
+    port_write(PORT_INDEX, index);
+    return port_read(PORT_DATA);
+}
+
+static uint32_t read_reg24(uint8_t index)
+{
+    uint32_t val;
+    port_write(PORT_INDEX, index);
+    val  = (uint32_t)port_read(PORT_DATA);
+    val |= (uint32_t)port_read(PORT_DATA) << 8;
+    val |= (uint32_t)port_read(PORT_DATA) << 16;
+    return val;
+}
+
+/***********************************************
+ * バストレーサーがあるかチェック
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int check_tracer(void)
+{
+    uint8_t save = read_reg(REG_MATCH);
+    write_reg(REG_MATCH, 0xA5);
+    if(read_reg(REG_MATCH) != 0xA5) return -1;
+    write_reg(REG_MATCH, 0x5A);
+    if(read_reg(REG_MATCH) != 0x5A) return -1;
+    write_reg(REG_MATCH, save);
+    return 0;
+}
+
+/***********************************************
+ * 記録件数
+ ***********************************************/
+static uint32_t get_buffer_entries(void)
+{
+    return ((uint32_t)read_reg(REG_SIZE) << 16) / ENTRY_SIZE;
+}
+
+static uint32_t get_entries(void)
+{
+    if(port_read(PORT_INDEX) & STATUS_WRAPPED) return get_buffer_entries();
+    return read_reg24(REG_WPTR);
+}
+
+/***********************************************
+ * 記録停止
+ ***********************************************/
+static void stop_trace(void)
+{
+    write_reg(REG_CONTROL, read_reg(REG_CONTROL) & ~CONTROL_RUN);
+
+    // SD-RAM への書き込み完了を待つ
+    while(port_read(PORT_INDEX) & STATUS_BUSY);
+}
+
+/***********************************************
+ * 記録開始
+ ***********************************************/
+static void start_trace(void)
+{
+    stop_trace();
+    if(main_param.filter_flag)
+    {
+        write_reg(REG_FILTER, main_param.filter);
+        write_reg16(REG_MATCH, main_param.match);
+        write_reg16(REG_MASK, main_param.mask);
+    }
+    if(main_param.trigger_flag)
+    {
+        write_reg16(REG_TRIG, main_param.trig_addr);
+        write_reg(REG_TRIG_TYPE, main_param.trig_type);
+        write_reg16(REG_POST, main_param.post_count);
+    }
+    write_reg(REG_CONTROL, CONTROL_CLEAR | CONTROL_RUN | (main_param.trigger_flag ? CONTROL_TRIG_EN : 0));
+}
+
+/***********************************************
+ * 状態出力
+ ***********************************************/
+static void output_status(void)
+{
+    uint8_t status = port_read(PORT_INDEX);
+    printf(MSG_STATUS,
+            (status & STATUS_RUN) ? MSG_STATUS_RUN : MSG_STATUS_STOP,
+            (status & STATUS_TRIGGERED) ? MSG_STATUS_TRIGGERED : "",
+            (status & STATUS_WRAPPED) ? MSG_STATUS_WRAPPED : "",
+            get_entries(),
+            get_buffer_entries(),
+            (unsigned int)read_reg(REG_DROP));
+}
+
+/***********************************************
+ * バッファをファイルに保存
+ *  古い記録から順に保存する
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int save_trace(char *path)
+{
+    int res;
+    uint32_t entries = get_entries();
+    uint32_t pos = 0;
+
+    // 一周している時は次の記録位置が一番古い記録
+    if(port_read(PORT_INDEX) & STATUS_WRAPPED) pos = read_reg24(REG_WPTR) * ENTRY_SIZE;
+
+    printf(MSG_SAVE, entries, path);
+    if(0 != (res = bdos_fcreate(&save_file, path)))
+    {
+        printf(MSG_ERR_FILECREATE, path);
+        return res;
+    }
+
+    // 読み出し位置を設定
+    port_write(PORT_INDEX, REG_RPTR);
+    port_write(PORT_DATA, (uint8_t)pos);
+    port_write(PORT_DATA, (uint8_t)(pos >> 8));
+    port_write(PORT_DATA, (uint8_t)(pos >> 16));
+
+    // 128 バイト単位で保存
+    uint32_t remain = entries * ENTRY_SIZE;
+    while(remain > 0)
+    {
+        uint16_t written;
+        uint16_t size = remain > sizeof(save_file.buffer) ? sizeof(save_file.buffer) : (uint16_t)remain;
+
+        port_write(PORT_INDEX, REG_READ_DATA);
+        for(uint16_t i = 0; i < size; i++) save_file.buffer[i] = port_read(PORT_DATA);
+        if(size < sizeof(save_file.buffer)) memset(save_file.buffer + size, 0, sizeof(save_file.buffer) - size);
+
+        if(0 != (res = bdos_fwrite(&save_file, &written)))
+        {
+            printf(MSG_ERR_FILEWRITE);
+            bdos_fclose(&save_file);
+            return res;
+        }
+        remain -= size;
+        if(((remain / ENTRY_SIZE) & 0x3FF) == 0) printf(MSG_PROGRESS, remain / ENTRY_SIZE);
+    }
+    printf(MSG_PROGRESS_TERM);
+
+    return bdos_fclose(&save_file);
+}
+
+/***********************************************
+ * HEX パラメータ取得
+ ***********************************************/
+static int get_hex_param(uint16_t *result, char *p)
+{
+    uint32_t val;
+    if(get_hex(&val, p, 4))
+    {
+        printf(MSG_PARAM_INVALID_HEX, p);
+        return 1;
+    }
+    *result = (uint16_t)val;
+    return 0;
+}
+
+/***********************************************
+ * コマンドラインのチェック
+ *  引数
+ *    param     : パラメータ構造体
+ *    argc      :
+ *    argv      :
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int parse_param(MAIN_PARAM_t *param, int argc, char *argv[])
+{
+    uint8_t next_state = 0;
+    uint16_t val;
+
+    memset(param, 0, sizeof(MAIN_PARAM_t));
+    param->filter = 0x0F;
+
+    for(int i = 1; i < argc; i++)
+    {
+        uint8_t state = 0;
+        if(next_state == 0 && (argv[i][0] == '/' || argv[i][0] == '-'))
+        {
+            //
+            // オプションスイッチ処理
+            //
+            state = argv[i][1];
+            if(state >= 'a' && state <= 'z') state &= ~0x20;
+
+            // パラメータ付き?
+            switch(state)
+            {
+                case 'W':
+                case 'F':
+                case 'A':
+                case 'M':
+                case 'T':
+                case 'Y':
+                case 'P':
+                    next_state = state;
+                    state = 0;
+                    break;
+            }
+        }
+        else if(next_state != 0)
+        {
+            //
+            // 次回処理が指定されていた場合
+            //
+            state = next_state;                     // 今回処理する内容
+            next_state = 0;                         // 次回は何もしない
+        }
+
+        switch(state)
+        {
+            case 0:
+                break;
+
+            case 'H':
+                param->help_flag = 1;
+                break;
+
+            case 'G':
+                param->start_flag = 1;
+                break;
+
+            case 'E':
+                param->stop_flag = 1;
+                break;
+
+            case 'W':
+                if(strlen(argv[i]) >= sizeof(param->save_file))
+                {
+                    printf(MSG_PARAM_PATH_TOO_LONG, argv[i]);
+                    return 1;
+                }
+                strncpy(param->save_file, argv[i], sizeof(param->save_file));
+                break;
+
+            case 'F':
+                if(get_hex_param(&val, argv[i])) return 1;
+                param->filter = (uint8_t)val;
+                param->filter_flag = 1;
+                break;
+
+            case 'A':
+                if(get_hex_param(&param->match, argv[i])) return 1;
+                param->filter_flag = 1;
+                break;
+
+            case 'M':
+                if(get_hex_param(&param->mask, argv[i])) return 1;
+                param->filter_flag = 1;
+                break;
+
+            case 'T':
+                if(get_hex_param(&param->trig_addr, argv[i])) return 1;
+                if(param->trig_type == 0) param->trig_type = 0x0F;
+                param->trigger_flag = 1;
+                break;
+
+            case 'Y':
+                if(get_hex_param(&val, argv[i])) return 1;
+                param->trig_type = (uint8_t)val;
+                param->trigger_flag = 1;
+                break;
+
+            case 'P':
+                if(get_hex_param(&param->post_count, argv[i])) return 1;
+                param->trigger_flag = 1;
+                break;
+
+            default:
+                printf(MSG_PARAM_UNKNOWN, state);
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+/***********************************************
+ * main
+ ***********************************************/
+int main(int argc, char *argv[])
+{
+    // バージョン出力
+    printf(MSG_VERSION, VERSION / 100, VERSION % 100);
+
+    // コマンドラインをパース
+    if(parse_param(&main_param, argc, argv)) return 1;
+
+    // ヘルプ出力
+    if(main_param.help_flag)
+    {
+        printf(MSG_USAGE);
+        printf(MSG_HELP);
+        return 0;
+    }
+
+    // バストレーサーの確認
+    if(check_tracer())
+    {
+        printf(MSG_TRACER_NOT_FOUND);
+        return 1;
+    }
+
+    // 停止と保存
+    if(main_param.stop_flag || main_param.save_file[0] != '\0')
+    {
+        stop_trace();
+        printf(MSG_STOP);
+    }
+    if(main_param.save_file[0] != '\0')
+    {
+        if(save_trace(main_param.save_file)) return 1;
+        printf(MSG_COMPLETE);
+    }
+
+    // 開始
+    if(main_param.start_flag)
+    {
+        start_trace();
+        printf(MSG_START);
+    }
+
+    output_status();
+    return 0;
+}
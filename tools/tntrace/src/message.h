@@ -0,0 +1,73 @@
+//
+// message.h
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#ifndef _INCLUDE_MESSAGE_H_
+#define _INCLUDE_MESSAGE_H_
+
+#define MSG_VERSION             "Bus tracer for tnCart v%d.%02d\n"\
+                                "\n"
+#define MSG_USAGE               "USAGE: TNTRACE {-G} {-E} {-W [FILE]} {options}\n"
+#define MSG_HELP                "OPTION:\n"\
+                                "  -H           show help message\n"\
+                                "  -G           clear buffer and start tracing\n"\
+                                "  -E           stop tracing\n"\
+                                "  -W [file]    stop tracing and save buffer\n"\
+                                "  -F [hex]     filter flags(1=MEM RD,2=MEM WR,\n"\
+                                "               4=IO RD,8=IO WR,10=SLOT,20=NO M1)\n"\
+                                "  -A [hex]     address to compare\n"\
+                                "  -M [hex]     address mask\n"\
+                                "  -T [hex]     trigger address\n"\
+                                "  -Y [hex]     trigger type(same as -F bit3-0)\n"\
+                                "  -P [hex]     entries after trigger\n"
+#define MSG_STATUS              "STATUS   : %s%s%s\n"\
+                                "ENTRIES  : %lu / %lu\n"\
+                                "DROPPED  : %u\n"
+#define MSG_STATUS_RUN          "running"
+#define MSG_STATUS_STOP         "stopped"
+#define MSG_STATUS_TRIGGERED    ", triggered"
+#define MSG_STATUS_WRAPPED      ", wrapped"
+#define MSG_TRACER_NOT_FOUND    "tracer not found.\n"
+#define MSG_START               "tracing started.\n"
+#define MSG_STOP                "tracing stopped.\n"
+#define MSG_SAVE                "saving %lu entries to %s.\n"
+#define MSG_PROGRESS            "\r%lu"
+#define MSG_PROGRESS_TERM       "\r"
+#define MSG_COMPLETE            "complete.\n"
+#define MSG_ERR_FILECREATE      "can not create file(%s).\n"
+#define MSG_ERR_FILEWRITE       "file write error.\n"
+
+#define MSG_PARAM_PATH_TOO_LONG "invalid file name(%s).\n"
+#define MSG_PARAM_INVALID_HEX   "invalid number(%s).\n"
+#define MSG_PARAM_UNKNOWN       "unknwon option(-%c)\n"
+
+#endif
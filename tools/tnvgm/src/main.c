@@ -0,0 +1,590 @@
+//
+// main.c
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+// zcc +msx -subtype=msxdos -O3 -o../bin/TNVGM.COM main.c ..\..\lib\bdos.c ..\..\lib\tools.c ..\..\lib\port.c
+
+#include <stdio.h>
+#include <string.h>
+#include "..\..\lib\types.h"
+#include "..\..\lib\bdos.h"
+#include "..\..\lib\tools.h"
+#include "..\..\lib\port.h"
+#include "message.h"
+
+#define VERSION (1)
+
+//
+// VGM ロガーの I/O ポート
+//
+#define PORT_INDEX              (0x28)      // W: レジスタ番号, R: ステータス
+#define PORT_DATA               (0x29)      // RW: レジスタ
+
+#define REG_CONTROL             (0x00)
+#define REG_FILTER              (0x01)
+#define REG_WPTR                (0x02)
+#define REG_DROP                (0x05)
+#define REG_SIZE                (0x06)
+#define REG_RPTR                (0x08)
+#define REG_READ_DATA           (0x0B)
+
+#define CONTROL_RUN             (1<<0)
+#define CONTROL_CLEAR           (1<<7)
+
+#define STATUS_RUN              (1<<0)
+#define STATUS_WRAPPED          (1<<2)
+#define STATUS_BUSY             (1<<7)
+
+#define BLOCK_SIZE              (256)       // コマンドはこの境界をまたがない
+
+//
+// VGM
+//
+#define VGM_CMD_YM2413          (0x51)
+#define VGM_CMD_WAIT            (0x61)
+#define VGM_CMD_END             (0x66)
+#define VGM_CMD_DATA_BLOCK      (0x67)      // ロガーの詰め物
+#define VGM_CMD_AY8910          (0xA0)
+#define VGM_CMD_K051649         (0xD2)
+
+#define VGM_VERSION             (0x00000161)
+#define VGM_HEADER_SIZE         (0x100)
+#define VGM_OFS_EOF             (0x04)
+#define VGM_OFS_VERSION         (0x08)
+#define VGM_OFS_YM2413_CLOCK    (0x10)
+#define VGM_OFS_TOTAL_SAMPLES   (0x18)
+#define VGM_OFS_DATA            (0x34)
+#define VGM_OFS_AY8910_CLOCK    (0x74)
+#define VGM_OFS_AY8910_TYPE     (0x78)
+#define VGM_OFS_AY8910_FLAGS    (0x79)
+#define VGM_OFS_K051649_CLOCK   (0x9C)
+
+#define CLOCK_YM2413            (3579545UL)
+#define CLOCK_AY8910            (1789773UL)
+#define CLOCK_K051649           (1789773UL)
+#define CLOCK_K052539           (0x80000000UL)  // SCC-I
+#define K051649_PORT_SCC_I      (4)             // SCC-I の波形
+
+#define CHIP_PSG                (1<<0)
+#define CHIP_OPLL               (1<<1)
+#define CHIP_SCC                (1<<2)
+#define CHIP_SCC_I              (1<<3)
+
+//
+// パラメータ
+//
+typedef struct {
+    uint8_t     help_flag;
+    uint8_t     start_flag;
+    uint8_t     stop_flag;
+    uint8_t     filter_flag;
+    uint8_t     filter;
+    char        save_file[64];
+} MAIN_PARAM_t;
+
+//
+// 記録の集計結果
+//
+typedef struct {
+    uint32_t    samples;            // 演奏時間(44.1kHz のサンプル数)
+    uint32_t    bytes;              // 詰め物を除いたコマンドのバイト数
+    uint8_t     chips;              // 使われた音源
+} VGM_INFO_t;
+
+static MAIN_PARAM_t main_param;     // パラメータ
+static BDOS_FILE_t save_file;       // 保存ファイル
+static uint8_t save_count;          // 保存ファイルのバッファに溜まったバイト数
+static uint32_t buffer_size;        // 記録バッファのサイズ
+static uint32_t read_pos;           // 記録バッファの読み出し位置
+static uint8_t vgm_header[VGM_HEADER_SIZE];
+
+/***********************************************
+ * レジスタ書き込み
+ ***********************************************/
+static void write_reg(uint8_t index, uint8_t data)
+{
+    port_write(PORT_INDEX, index);
+    port_write(PORT_DATA, data);
+}
+
+/***********************************************
+ * レジスタ読み込み
+ ***********************************************/
+static uint8_t read_reg(uint8_t index)
+{
+    port_write(PORT_INDEX, index);
+    return port_read(PORT_DATA);
+}
+
+static uint32_t read_reg24(uint8_t index)
+{
+    uint32_t val;
+    port_write(PORT_INDEX, index);
+    val  = (uint32_t)port_read(PORT_DATA);
+    val |= (uint32_t)port_read(PORT_DATA) << 8;
+    val |= (uint32_t)port_read(PORT_DATA) << 16;
+    return val;
+}
+
+/***********************************************
+ * VGM ロガーがあるかチェック
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int check_logger(void)
+{
+    uint8_t save = read_reg(REG_RPTR);
+    write_reg(REG_RPTR, 0xA5);
+    if(read_reg(REG_RPTR) != 0xA5) return -1;
+    write_reg(REG_RPTR, 0x5A);
+    if(read_reg(REG_RPTR) != 0x5A) return -1;
+    write_reg(REG_RPTR, save);
+    return 0;
+}
+
+/***********************************************
+ * 記録バッファのサイズと記録量
+ ***********************************************/
+static uint32_t get_buffer_size(void)
+{
+    uint32_t blocks;
+    port_write(PORT_INDEX, REG_SIZE);
+    blocks  = (uint32_t)port_read(PORT_DATA);
+    blocks |= (uint32_t)port_read(PORT_DATA) << 8;
+    return blocks * BLOCK_SIZE;
+}
+
+static uint32_t get_bytes(void)
+{
+    if(port_read(PORT_INDEX) & STATUS_WRAPPED) return buffer_size;
+    return read_reg24(REG_WPTR);
+}
+
+/***********************************************
+ * 記録停止
+ ***********************************************/
+static void stop_logging(void)
+{
+    write_reg(REG_CONTROL, read_reg(REG_CONTROL) & ~CONTROL_RUN);
+
+    // SD-RAM への書き込み完了を待つ
+    while(port_read(PORT_INDEX) & STATUS_BUSY);
+}
+
+/***********************************************
+ * 記録開始
+ ***********************************************/
+static void start_logging(void)
+{
+    stop_logging();
+    if(main_param.filter_flag) write_reg(REG_FILTER, main_param.filter);
+    write_reg(REG_CONTROL, CONTROL_CLEAR | CONTROL_RUN);
+}
+
+/***********************************************
+ * 状態出力
+ ***********************************************/
+static void output_status(void)
+{
+    uint8_t status = port_read(PORT_INDEX);
+    printf(MSG_STATUS,
+            (status & STATUS_RUN) ? MSG_STATUS_RUN : MSG_STATUS_STOP,
+            (status & STATUS_WRAPPED) ? MSG_STATUS_WRAPPED : "",
+            get_bytes(),
+            buffer_size,
+            (unsigned int)read_reg(REG_DROP));
+}
+
+/***********************************************
+ * 記録バッファの読み出し
+ *  バッファの終わりで先頭に戻る
+ ***********************************************/
+static void set_read_pos(uint32_t pos)
+{
+    read_pos = pos;
+    port_write(PORT_INDEX, REG_RPTR);
+    port_write(PORT_DATA, (uint8_t)pos);
+    port_write(PORT_DATA, (uint8_t)(pos >> 8));
+    port_write(PORT_DATA, (uint8_t)(pos >> 16));
+    port_write(PORT_INDEX, REG_READ_DATA);
+}
+
+static uint8_t read_byte(void)
+{
+    uint8_t data = port_read(PORT_DATA);
+    if(++read_pos == buffer_size) set_read_pos(0);
+    return data;
+}
+
+/***********************************************
+ * 保存ファイルへ出力
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int flush_file(void)
+{
+    int res;
+    uint16_t written;
+
+    if(save_count == 0) return 0;
+    if(save_count < sizeof(save_file.buffer)) memset(save_file.buffer + save_count, 0, sizeof(save_file.buffer) - save_count);
+    save_count = 0;
+    if(0 != (res = bdos_fwrite(&save_file, &written))) printf(MSG_ERR_FILEWRITE);
+    return res;
+}
+
+static int put_byte(uint8_t data)
+{
+    save_file.buffer[save_count++] = data;
+    if(save_count < sizeof(save_file.buffer)) return 0;
+    return flush_file();
+}
+
+/***********************************************
+ * 記録を VGM のコマンド列として読む
+ *  詰め物を読み飛ばし、save が !0 の時はファイルへ出力する
+ *  引数
+ *    info      : 集計結果
+ *    start     : 読み出し開始位置(コマンドの先頭)
+ *    length    : 読み出すバイト数
+ *    save      : ファイルへ出力するか
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int scan_log(VGM_INFO_t *info, uint32_t start, uint32_t length, uint8_t save)
+{
+    uint8_t cmd[7];
+    uint8_t len;
+
+    memset(info, 0, sizeof(VGM_INFO_t));
+    set_read_pos(start);
+
+    while(length > 0)
+    {
+        uint32_t pos = read_pos;
+        cmd[0] = read_byte();
+        switch(cmd[0])
+        {
+            case VGM_CMD_WAIT:
+            case VGM_CMD_AY8910:
+            case VGM_CMD_YM2413:
+                len = 3;
+                break;
+            case VGM_CMD_K051649:
+                len = 4;
+                break;
+            case VGM_CMD_DATA_BLOCK:
+                len = 7;
+                break;
+            default:
+                printf(MSG_ERR_BROKEN, pos, cmd[0]);
+                return -1;
+        }
+        if(length < len) break;                     // 記録の途中で停止した時
+        for(uint8_t i = 1; i < len; i++) cmd[i] = read_byte();
+        length -= len;
+
+        switch(cmd[0])
+        {
+            case VGM_CMD_DATA_BLOCK:
+            {
+                // 詰め物を読み飛ばす
+                uint32_t skip = (uint32_t)cmd[3] | ((uint32_t)cmd[4] << 8) | ((uint32_t)cmd[5] << 16) | ((uint32_t)cmd[6] << 24);
+                if(skip > length) skip = length;
+                length -= skip;
+                set_read_pos((read_pos + skip) % buffer_size);
+                continue;
+            }
+            case VGM_CMD_WAIT:
+                info->samples += (uint32_t)cmd[1] | ((uint32_t)cmd[2] << 8);
+                break;
+            case VGM_CMD_AY8910:
+                info->chips |= CHIP_PSG;
+                break;
+            case VGM_CMD_YM2413:
+                info->chips |= CHIP_OPLL;
+                break;
+            case VGM_CMD_K051649:
+                info->chips |= (cmd[1] == K051649_PORT_SCC_I) ? (CHIP_SCC | CHIP_SCC_I) : CHIP_SCC;
+                break;
+        }
+        info->bytes += len;
+
+        if(save)
+        {
+            for(uint8_t i = 0; i < len; i++) if(put_byte(cmd[i])) return -1;
+            if((length & 0xFFF) < len) printf(MSG_PROGRESS, length);
+        }
+    }
+    return 0;
+}
+
+/***********************************************
+ * VGM ヘッダ作成
+ ***********************************************/
+static void set_header32(uint16_t offset, uint32_t value)
+{
+    vgm_header[offset + 0] = (uint8_t)value;
+    vgm_header[offset + 1] = (uint8_t)(value >> 8);
+    vgm_header[offset + 2] = (uint8_t)(value >> 16);
+    vgm_header[offset + 3] = (uint8_t)(value >> 24);
+}
+
+static void make_header(VGM_INFO_t *info)
+{
+    memset(vgm_header, 0, sizeof(vgm_header));
+    memcpy(vgm_header, "Vgm ", 4);
+    set_header32(VGM_OFS_EOF, VGM_HEADER_SIZE + info->bytes + 1 - VGM_OFS_EOF);
+    set_header32(VGM_OFS_VERSION, VGM_VERSION);
+    set_header32(VGM_OFS_TOTAL_SAMPLES, info->samples);
+    set_header32(VGM_OFS_DATA, VGM_HEADER_SIZE - VGM_OFS_DATA);
+    if(info->chips & CHIP_OPLL) set_header32(VGM_OFS_YM2413_CLOCK, CLOCK_YM2413);
+    if(info->chips & CHIP_PSG)
+    {
+        set_header32(VGM_OFS_AY8910_CLOCK, CLOCK_AY8910);
+        vgm_header[VGM_OFS_AY8910_TYPE] = 0x00;     // AY-3-8910
+        vgm_header[VGM_OFS_AY8910_FLAGS] = 0x01;    // Legacy Output
+    }
+    if(info->chips & CHIP_SCC) set_header32(VGM_OFS_K051649_CLOCK, CLOCK_K051649 | ((info->chips & CHIP_SCC_I) ? CLOCK_K052539 : 0));
+}
+
+/***********************************************
+ * 記録を VGM ファイルに保存
+ *  古い記録から順に保存する
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int save_vgm(char *path)
+{
+    int res;
+    VGM_INFO_t info;
+    uint32_t start = 0;
+    uint32_t length = get_bytes();
+
+    // 一周している時は次の記録位置の次のブロックの先頭が一番古いコマンド
+    if(port_read(PORT_INDEX) & STATUS_WRAPPED)
+    {
+        uint32_t wptr = read_reg24(REG_WPTR);
+        uint16_t skip = (BLOCK_SIZE - (uint16_t)(wptr % BLOCK_SIZE)) % BLOCK_SIZE;
+        start = (wptr + skip) % buffer_size;
+        length = buffer_size - skip;
+    }
+
+    // 長さと演奏時間を集計
+    printf(MSG_SCAN, length);
+    if(scan_log(&info, start, length, 0)) return -1;
+
+    printf(MSG_SAVE, info.samples, path);
+    if(0 != (res = bdos_fcreate(&save_file, path)))
+    {
+        printf(MSG_ERR_FILECREATE, path);
+        return res;
+    }
+
+    // ヘッダ, コマンド, 終了コマンドの順に保存
+    save_count = 0;
+    make_header(&info);
+    for(uint16_t i = 0; i < sizeof(vgm_header); i++)
+    {
+        if(0 != (res = put_byte(vgm_header[i]))) break;
+    }
+    if(res == 0) res = scan_log(&info, start, length, 1);
+    if(res == 0) res = put_byte(VGM_CMD_END);
+    if(res == 0) res = flush_file();
+    printf(MSG_PROGRESS_TERM);
+
+    if(res)
+    {
+        bdos_fclose(&save_file);
+        return res;
+    }
+    return bdos_fclose(&save_file);
+}
+
+/***********************************************
+ * HEX パラメータ取得
+ ***********************************************/
+static int get_hex_param(uint16_t *result, char *p)
+{
+    uint32_t val;
+    if(get_hex(&val, p, 4))
+    {
+        printf(MSG_PARAM_INVALID_HEX, p);
+        return 1;
+    }
+    *result = (uint16_t)val;
+    return 0;
+}
+
+/***********************************************
+ * コマンドラインのチェック
+ *  引数
+ *    param     : パラメータ構造体
+ *    argc      :
+ *    argv      :
+ *  戻り値
+ *    0  : 成功
+ *    !0 : 失敗
+ ***********************************************/
+static int parse_param(MAIN_PARAM_t *param, int argc, char *argv[])
+{
+    uint8_t next_state = 0;
+    uint16_t val;
+
+    memset(param, 0, sizeof(MAIN_PARAM_t));
+    param->filter = CHIP_PSG | CHIP_OPLL | CHIP_SCC;
+
+    for(int i = 1; i < argc; i++)
+    {
+        uint8_t state = 0;
+        if(next_state == 0 && (argv[i][0] == '/' || argv[i][0] == '-'))
+        {
+            //
+            // オプションスイッチ処理
+            //
+            state = argv[i][1];
+            if(state >= 'a' && state <= 'z') state &= ~0x20;
+
+            // パラメータ付き?
+            switch(state)
+            {
+                case 'W':
+                case 'F':
+                    next_state = state;
+                    state = 0;
+                    break;
+            }
+        }
+        else if(next_state != 0)
+        {
+            //
+            // 次回処理が指定されていた場合
+            //
+            state = next_state;                     // 今回処理する内容
+            next_state = 0;                         // 次回は何もしない
+        }
+
+        switch(state)
+        {
+            case 0:
+                break;
+
+            case 'H':
+                param->help_flag = 1;
+                break;
+
+            case 'G':
+                param->start_flag = 1;
+                break;
+
+            case 'E':
+                param->stop_flag = 1;
+                break;
+
+            case 'W':
+                if(strlen(argv[i]) >= sizeof(param->save_file))
+                {
+                    printf(MSG_PARAM_PATH_TOO_LONG, argv[i]);
+                    return 1;
+                }
+                strncpy(param->save_file, argv[i], sizeof(param->save_file));
+                break;
+
+            case 'F':
+                if(get_hex_param(&val, argv[i])) return 1;
+                param->filter = (uint8_t)val;
+                param->filter_flag = 1;
+                break;
+
+            default:
+                printf(MSG_PARAM_UNKNOWN, state);
+                return 1;
+        }
+    }
+
+    return 0;
+}
+
+/***********************************************
+ * main
+ ***********************************************/
+int main(int argc, char *argv[])
+{
+    // バージョン出力
+    printf(MSG_VERSION, VERSION / 100, VERSION % 100);
+
+    // コマンドラインをパース
+    if(parse_param(&main_param, argc, argv)) return 1;
+
+    // ヘルプ出力
+    if(main_param.help_flag)
+    {
+        printf(MSG_USAGE);
+        printf(MSG_HELP);
+        return 0;
+    }
+
+    // VGM ロガーの確認
+    if(check_logger())
+    {
+        printf(MSG_LOGGER_NOT_FOUND);
+        return 1;
+    }
+    buffer_size = get_buffer_size();
+
+    // 停止と保存
+    if(main_param.stop_flag || main_param.save_file[0] != '\0')
+    {
+        stop_logging();
+        printf(MSG_STOP);
+    }
+    if(main_param.save_file[0] != '\0')
+    {
+        if(save_vgm(main_param.save_file)) return 1;
+        printf(MSG_COMPLETE);
+    }
+
+    // 開始
+    if(main_param.start_flag)
+    {
+        start_logging();
+        printf(MSG_START);
+    }
+
+    output_status();
+    return 0;
+}
@@ -0,0 +1,69 @@
+//
+// message.h
+//
+// BSD 3-Clause License
+// 
+// Copyright (c) 2024, Shinobu Hashimoto
+// 
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+
+#ifndef _INCLUDE_MESSAGE_H_
+#define _INCLUDE_MESSAGE_H_
+
+#define MSG_VERSION             "VGM logger for tnCart v%d.%02d\n"\
+                                "\n"
+#define MSG_USAGE               "USAGE: TNVGM {-G} {-E} {-W [FILE]} {options}\n"
+#define MSG_HELP                "OPTION:\n"\
+                                "  -H           show help message\n"\
+                                "  -G           clear buffer and start logging\n"\
+                                "  -E           stop logging\n"\
+                                "  -W [file]    stop logging and save as VGM\n"\
+                                "  -F [hex]     chips to log(1=PSG,2=OPLL,4=SCC)\n"
+#define MSG_STATUS              "STATUS   : %s%s\n"\
+                                "BYTES    : %lu / %lu\n"\
+                                "DROPPED  : %u\n"
+#define MSG_STATUS_RUN          "running"
+#define MSG_STATUS_STOP         "stopped"
+#define MSG_STATUS_WRAPPED      ", wrapped"
+#define MSG_LOGGER_NOT_FOUND    "VGM logger not found.\n"
+#define MSG_START               "logging started.\n"
+#define MSG_STOP                "logging stopped.\n"
+#define MSG_SCAN                "scanning %lu bytes.\n"
+#define MSG_SAVE                "saving %lu samples to %s.\n"
+#define MSG_PROGRESS            "\r%lu"
+#define MSG_PROGRESS_TERM       "\r"
+#define MSG_COMPLETE            "complete.\n"
+#define MSG_ERR_BROKEN          "broken log at %06lX(%02X).\n"
+#define MSG_ERR_FILECREATE      "can not create file(%s).\n"
+#define MSG_ERR_FILEWRITE       "file write error.\n"
+
+#define MSG_PARAM_PATH_TOO_LONG "invalid file name(%s).\n"
+#define MSG_PARAM_INVALID_HEX   "invalid number(%s).\n"
+#define MSG_PARAM_UNKNOWN       "unknwon option(-%c)\n"
+
+#endif